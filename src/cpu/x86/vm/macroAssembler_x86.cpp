@@ -1300,6 +1300,70 @@ void MacroAssembler::biased_locking_exit(Register obj_reg, Register temp_reg, La
   jcc(Assembler::equal, done);
 }
 
+void MacroAssembler::lightweight_lock(Register obj, Register hdr, Register thread, Register tmp, Label& slow) {
+  assert(UseLightweightLocking, "why call this otherwise?");
+  assert(hdr == rax, "header must be in rax for cmpxchg");
+  assert_different_registers(obj, hdr, thread, tmp);
+
+  // Load the header first: C1 records an implicit null check at the
+  // start of this sequence.
+  movptr(hdr, Address(obj, oopDesc::mark_offset_in_bytes()));
+
+  // Check that the lock stack has room for obj. Comparing against
+  // end_offset() - 1 lets us use 'greater', which leaves ZF clear on the
+  // way to the slow path; C2 relies on that.
+  cmpl(Address(thread, JavaThread::lock_stack_top_offset()), LockStack::end_offset() - 1);
+  jcc(Assembler::greater, slow);
+
+  // Expect an unlocked header and try to swing it to fast-locked (00).
+  // Anything else -- fast-locked, inflated or a concurrently changed
+  // header -- fails the CAS and takes the slow path.
+  movptr(tmp, hdr);
+  andptr(tmp, ~(int32_t)markOopDesc::lock_mask_in_place);
+  orptr(hdr, markOopDesc::unlocked_value);
+  if (os::is_MP()) {
+    lock();
+  }
+  cmpxchgptr(tmp, Address(obj, oopDesc::mark_offset_in_bytes()));
+  jcc(Assembler::notEqual, slow);
+
+  // Push obj onto the lock stack. The top is an offset from the thread.
+  movl(tmp, Address(thread, JavaThread::lock_stack_top_offset()));
+  movptr(Address(thread, tmp, Address::times_1), obj);
+  incrementl(tmp, oopSize);
+  movl(Address(thread, JavaThread::lock_stack_top_offset()), tmp);
+}
+
+void MacroAssembler::lightweight_unlock(Register obj, Register hdr, Register thread, Register tmp, Label& slow) {
+  assert(UseLightweightLocking, "why call this otherwise?");
+  assert(hdr == rax, "header must be in rax for cmpxchg");
+  assert_different_registers(obj, hdr, thread, tmp);
+
+  // The fast path only handles obj on top of the lock stack. The slot
+  // below an empty stack holds a sentinel that never matches an oop.
+  movl(tmp, Address(thread, JavaThread::lock_stack_top_offset()));
+  cmpptr(obj, Address(thread, tmp, Address::times_1, -oopSize));
+  jcc(Assembler::notEqual, slow);
+
+  // If another thread inflated obj, the runtime takes the monitor over.
+  movptr(hdr, Address(obj, oopDesc::mark_offset_in_bytes()));
+  testptr(hdr, markOopDesc::monitor_value);
+  jcc(Assembler::notZero, slow);
+
+  // Swing the header back to unlocked; this fails if obj is inflated
+  // concurrently.
+  movptr(tmp, hdr);
+  orptr(tmp, markOopDesc::unlocked_value);
+  if (os::is_MP()) {
+    lock();
+  }
+  cmpxchgptr(tmp, Address(obj, oopDesc::mark_offset_in_bytes()));
+  jcc(Assembler::notEqual, slow);
+
+  // Pop obj from the lock stack.
+  subl(Address(thread, JavaThread::lock_stack_top_offset()), oopSize);
+}
+
 #ifdef COMPILER2
 
 #if INCLUDE_RTM_OPT
@@ -1784,33 +1848,47 @@ void MacroAssembler::fast_lock(Register objReg, Register boxReg, Register tmpReg
 
     movptr(tmpReg, Address(objReg, 0));          // [FETCH]
     testptr(tmpReg, markOopDesc::monitor_value); // inflated vs stack-locked|neutral|biased
-    jccb(Assembler::notZero, IsInflated);
+    jcc(Assembler::notZero, IsInflated);
 
-    // Attempt stack-locking ...
-    orptr (tmpReg, markOopDesc::unlocked_value);
-    movptr(Address(boxReg, 0), tmpReg);          // Anticipate successful CAS
-    if (os::is_MP()) {
-      lock();
-    }
-    cmpxchgptr(boxReg, Address(objReg, 0));      // Updates tmpReg
-    if (counters != NULL) {
-      cond_inc32(Assembler::equal,
-                 ExternalAddress((address)counters->fast_path_entry_count_addr()));
-    }
-    jcc(Assembler::equal, DONE_LABEL);           // Success
-
-    // Recursive locking.
-    // The object is stack-locked: markword contains stack pointer to BasicLock.
-    // Locked by current thread if difference with current SP is less than one page.
-    subptr(tmpReg, rsp);
-    // Next instruction set ZFlag == 1 (Success) if difference is less then one page.
-    andptr(tmpReg, (int32_t) (NOT_LP64(0xFFFFF003) LP64_ONLY(7 - os::vm_page_size())) );
-    movptr(Address(boxReg, 0), tmpReg);
-    if (counters != NULL) {
-      cond_inc32(Assembler::equal,
-                 ExternalAddress((address)counters->fast_path_entry_count_addr()));
+#ifdef _LP64
+    if (UseLightweightLocking) {
+      // Attempt fast-locking; the box is not used.
+      Label slow;
+      lightweight_lock(objReg, tmpReg, r15_thread, scrReg, slow);
+      xorptr(tmpReg, tmpReg);                    // set ZFlag == 1 (Success)
+      jmp(DONE_LABEL);
+      bind(slow);
+      testptr(objReg, objReg);                   // obj != NULL: ZFlag == 0 (Failure)
+      jmp(DONE_LABEL);
+    } else
+#endif // _LP64
+    {
+      // Attempt stack-locking ...
+      orptr (tmpReg, markOopDesc::unlocked_value);
+      movptr(Address(boxReg, 0), tmpReg);          // Anticipate successful CAS
+      if (os::is_MP()) {
+        lock();
+      }
+      cmpxchgptr(boxReg, Address(objReg, 0));      // Updates tmpReg
+      if (counters != NULL) {
+        cond_inc32(Assembler::equal,
+                   ExternalAddress((address)counters->fast_path_entry_count_addr()));
+      }
+      jcc(Assembler::equal, DONE_LABEL);           // Success
+
+      // Recursive locking.
+      // The object is stack-locked: markword contains stack pointer to BasicLock.
+      // Locked by current thread if difference with current SP is less than one page.
+      subptr(tmpReg, rsp);
+      // Next instruction set ZFlag == 1 (Success) if difference is less then one page.
+      andptr(tmpReg, (int32_t) (NOT_LP64(0xFFFFF003) LP64_ONLY(7 - os::vm_page_size())) );
+      movptr(Address(boxReg, 0), tmpReg);
+      if (counters != NULL) {
+        cond_inc32(Assembler::equal,
+                   ExternalAddress((address)counters->fast_path_entry_count_addr()));
+      }
+      jmp(DONE_LABEL);
     }
-    jmp(DONE_LABEL);
 
     bind(IsInflated);
     // The object is inflated. tmpReg contains pointer to ObjectMonitor* + 2(monitor_value)
@@ -2061,11 +2139,14 @@ void MacroAssembler::fast_unlock(Register objReg, Register boxReg, Register tmpR
     }
 #endif
 
-    cmpptr(Address(boxReg, 0), (int32_t)NULL_WORD); // Examine the displaced header
-    jcc   (Assembler::zero, DONE_LABEL);            // 0 indicates recursive stack-lock
+    if (!UseLightweightLocking) {
+      // With lightweight locking the box is not used and recursion inflates.
+      cmpptr(Address(boxReg, 0), (int32_t)NULL_WORD); // Examine the displaced header
+      jcc   (Assembler::zero, DONE_LABEL);            // 0 indicates recursive stack-lock
+    }
     movptr(tmpReg, Address(objReg, 0));             // Examine the object's markword
     testptr(tmpReg, markOopDesc::monitor_value);    // Inflated?
-    jccb  (Assembler::zero, Stacked);
+    jcc   (Assembler::zero, Stacked);
 
     // It's inflated.
 #if INCLUDE_RTM_OPT
@@ -2277,9 +2358,20 @@ void MacroAssembler::fast_unlock(Register objReg, Register boxReg, Register tmpR
     }
 
     bind  (Stacked);
-    movptr(tmpReg, Address (boxReg, 0));      // re-fetch
-    if (os::is_MP()) { lock(); }
-    cmpxchgptr(tmpReg, Address(objReg, 0)); // Uses RAX which is box
+    if (UseLightweightLocking) {
+      // It's fast-locked.
+      Label slow;
+      lightweight_unlock(objReg, boxReg, r15_thread, tmpReg, slow);
+      xorptr(boxReg, boxReg);                 // set ICC.ZF=1 to indicate success
+      jmpb  (DONE_LABEL);
+      bind  (slow);
+      testptr(objReg, objReg);                // obj != NULL: set ICC.ZF=0 to indicate failure
+      jmpb  (DONE_LABEL);
+    } else {
+      movptr(tmpReg, Address (boxReg, 0));      // re-fetch
+      if (os::is_MP()) { lock(); }
+      cmpxchgptr(tmpReg, Address(objReg, 0)); // Uses RAX which is box
+    }
 
     if (EmitSync & 65536) {
        bind (CheckSucc);
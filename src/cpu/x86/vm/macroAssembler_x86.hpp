@@ -658,6 +658,13 @@ class MacroAssembler: public Assembler {
                            Label& done, Label* slow_case = NULL,
                            BiasedLockingCounters* counters = NULL);
   void biased_locking_exit (Register obj_reg, Register temp_reg, Label& done);
+
+  // Lightweight locking (UseLightweightLocking): swing the mark word of obj
+  // between unlocked and fast-locked and push/pop obj on the lock stack of
+  // thread. Branches to slow if the fast path does not apply.
+  // hdr must be rax (used by cmpxchg); hdr and tmp are KILLED.
+  void lightweight_lock  (Register obj, Register hdr, Register thread, Register tmp, Label& slow);
+  void lightweight_unlock(Register obj, Register hdr, Register thread, Register tmp, Label& slow);
 #ifdef COMPILER2
   // Code used by cmpFastLock and cmpFastUnlock mach instructions in .ad file.
   // See full desription in macroAssembler_x86.cpp.
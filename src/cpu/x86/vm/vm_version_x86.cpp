@@ -638,6 +638,13 @@ void VM_Version::get_processor_features() {
   }
 
 #if INCLUDE_RTM_OPT
+  if (UseRTMLocking && UseLightweightLocking) {
+    // The RTM paths in fast_lock() elide stack locks and inflated monitors,
+    // they do not know about the lock stack.
+    warning("RTM locking is not supported with lightweight locking"
+            "; ignoring UseRTMLocking flag." );
+    FLAG_SET_DEFAULT(UseRTMLocking, false);
+  }
   if (UseRTMLocking) {
     if (is_intel_family_core()) {
       if ((_model == CPU_MODEL_HASWELL_E3) ||
@@ -138,6 +138,9 @@ typedef struct Nmethod_t {
   Vframe_t vframes[MAX_VFRAMES_CNT];
 } Nmethod_t;
 
+/* A segmented code cache has at most three code heaps */
+#define MAX_CODE_HEAPS 3
+
 struct jvm_agent {
   struct ps_prochandle* P;
 
@@ -150,16 +153,17 @@ struct jvm_agent {
   uint64_t Use_Compressed_Oops_address;
   uint64_t Universe_narrow_oop_base_address;
   uint64_t Universe_narrow_oop_shift_address;
-  uint64_t CodeCache_heap_address;
+  uint64_t CodeCache_heaps_address;
 
   /* Volatiles */
   uint8_t  Use_Compressed_Oops;
   uint64_t Universe_narrow_oop_base;
   uint32_t Universe_narrow_oop_shift;
-  uint64_t CodeCache_low;
-  uint64_t CodeCache_high;
-  uint64_t CodeCache_segmap_low;
-  uint64_t CodeCache_segmap_high;
+  int32_t  Number_of_heaps;
+  uint64_t Heap_low[MAX_CODE_HEAPS];
+  uint64_t Heap_high[MAX_CODE_HEAPS];
+  uint64_t Heap_segmap_low[MAX_CODE_HEAPS];
+  uint64_t Heap_segmap_high[MAX_CODE_HEAPS];
 
   int32_t  SIZE_CodeCache_log2_segment;
 
@@ -278,8 +282,9 @@ static int parse_vmstructs(jvm_agent_t* J) {
     }
 
     if (vmp->typeName[0] == 'C' && strcmp("CodeCache", vmp->typeName) == 0) {
-      if (strcmp("_heap", vmp->fieldName) == 0) {
-        err = read_pointer(J, vmp->address, &J->CodeCache_heap_address);
+      /* Read _heaps field of type GrowableArray<CodeHeap*>*      */
+      if (strcmp("_heaps", vmp->fieldName) == 0) {
+        err = read_pointer(J, vmp->address, &J->CodeCache_heaps_address);
       }
     } else if (vmp->typeName[0] == 'U' && strcmp("Universe", vmp->typeName) == 0) {
       if (strcmp("_narrow_oop._base", vmp->fieldName) == 0) {
@@ -318,7 +323,9 @@ static int find_symbol(jvm_agent_t* J, const char *name, uint64_t* valuep) {
 }
 
 static int read_volatiles(jvm_agent_t* J) {
-  uint64_t ptr;
+  int i;
+  uint64_t heap_array;
+  uint64_t code_heap_address;
   int err;
 
   err = find_symbol(J, "UseCompressedOops", &J->Use_Compressed_Oops_address);
@@ -334,22 +341,41 @@ static int read_volatiles(jvm_agent_t* J) {
   err = ps_pread(J->P,  J->Universe_narrow_oop_shift_address, &J->Universe_narrow_oop_shift, sizeof(uint32_t));
   CHECK_FAIL(err);
 
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_memory +
-                     OFFSET_VirtualSpace_low, &J->CodeCache_low);
-  CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_memory +
-                     OFFSET_VirtualSpace_high, &J->CodeCache_high);
+  /* CodeCache_heaps_address points to a GrowableArray<CodeHeap*>: _data
+     is the array of CodeHeap pointers and _len the number of code heaps */
+  err = read_pointer(J, J->CodeCache_heaps_address + OFFSET_GrowableArray_CodeHeap_data,
+                     &heap_array);
   CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_segmap +
-                     OFFSET_VirtualSpace_low, &J->CodeCache_segmap_low);
-  CHECK_FAIL(err);
-  err = read_pointer(J, J->CodeCache_heap_address + OFFSET_CodeHeap_segmap +
-                     OFFSET_VirtualSpace_high, &J->CodeCache_segmap_high);
+  err = ps_pread(J->P, J->CodeCache_heaps_address + OFFSET_GrowableArray_CodeHeap_len,
+                 &J->Number_of_heaps, sizeof(J->Number_of_heaps));
   CHECK_FAIL(err);
+  if (J->Number_of_heaps < 0 || J->Number_of_heaps > MAX_CODE_HEAPS) {
+    J->Number_of_heaps = 0;
+    return -1;
+  }
 
-  err = ps_pread(J->P, J->CodeCache_heap_address + OFFSET_CodeHeap_log2_segment_size,
-                 &J->SIZE_CodeCache_log2_segment, sizeof(J->SIZE_CodeCache_log2_segment));
-  CHECK_FAIL(err);
+  for (i = 0; i < J->Number_of_heaps; ++i) {
+    err = read_pointer(J, heap_array + i * POINTER_SIZE, &code_heap_address);
+    CHECK_FAIL(err);
+
+    err = read_pointer(J, code_heap_address + OFFSET_CodeHeap_memory +
+                       OFFSET_VirtualSpace_low, &J->Heap_low[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, code_heap_address + OFFSET_CodeHeap_memory +
+                       OFFSET_VirtualSpace_high, &J->Heap_high[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, code_heap_address + OFFSET_CodeHeap_segmap +
+                       OFFSET_VirtualSpace_low, &J->Heap_segmap_low[i]);
+    CHECK_FAIL(err);
+    err = read_pointer(J, code_heap_address + OFFSET_CodeHeap_segmap +
+                       OFFSET_VirtualSpace_high, &J->Heap_segmap_high[i]);
+    CHECK_FAIL(err);
+
+    /* The segment size is the same for all code heaps */
+    err = ps_pread(J->P, code_heap_address + OFFSET_CodeHeap_log2_segment_size,
+                   &J->SIZE_CodeCache_log2_segment, sizeof(J->SIZE_CodeCache_log2_segment));
+    CHECK_FAIL(err);
+  }
 
   return PS_OK;
 
@@ -358,28 +384,46 @@ static int read_volatiles(jvm_agent_t* J) {
 }
 
 
+static int codeheap_contains(int heap_num, jvm_agent_t* J, uint64_t ptr) {
+  return (J->Heap_low[heap_num] <= ptr && ptr < J->Heap_high[heap_num]);
+}
+
 static int codecache_contains(jvm_agent_t* J, uint64_t ptr) {
+  int i;
   /* make sure the code cache is up to date */
-  return (J->CodeCache_low <= ptr && ptr < J->CodeCache_high);
+  for (i = 0; i < J->Number_of_heaps; ++i) {
+    if (codeheap_contains(i, J, ptr)) {
+      return 1;
+    }
+  }
+  return 0;
 }
 
-static uint64_t segment_for(jvm_agent_t* J, uint64_t p) {
-  return (p - J->CodeCache_low) >> J->SIZE_CodeCache_log2_segment;
+static uint64_t segment_for(int heap_num, jvm_agent_t* J, uint64_t p) {
+  return (p - J->Heap_low[heap_num]) >> J->SIZE_CodeCache_log2_segment;
 }
 
-static uint64_t block_at(jvm_agent_t* J, int i) {
-  return J->CodeCache_low + (i << J->SIZE_CodeCache_log2_segment);
+static uint64_t block_at(int heap_num, jvm_agent_t* J, int i) {
+  return J->Heap_low[heap_num] + (i << J->SIZE_CodeCache_log2_segment);
 }
 
 static int find_start(jvm_agent_t* J, uint64_t ptr, uint64_t *startp) {
   int err;
+  int i;
 
   *startp = 0;
-  if (J->CodeCache_low <= ptr && ptr < J->CodeCache_high) {
+  for (i = 0; i < J->Number_of_heaps; ++i) {
     int32_t used;
-    uint64_t segment = segment_for(J, ptr);
-    uint64_t block = J->CodeCache_segmap_low;
+    uint64_t segment;
+    uint64_t block;
     uint8_t tag;
+
+    if (!codeheap_contains(i, J, ptr)) {
+      continue;
+    }
+
+    segment = segment_for(i, J, ptr);
+    block = J->Heap_segmap_low[i];
     err = ps_pread(J->P, block + segment, &tag, sizeof(tag));
     CHECK_FAIL(err);
     if (tag == 0xff)
@@ -389,12 +433,13 @@ static int find_start(jvm_agent_t* J, uint64_t ptr, uint64_t *startp) {
       CHECK_FAIL(err);
       segment -= tag;
     }
-    block = block_at(J, segment);
+    block = block_at(i, J, segment);
     err = ps_pread(J->P, block + OFFSET_HeapBlockHeader_used, &used, sizeof(used));
     CHECK_FAIL(err);
     if (used) {
       *startp = block + SIZE_HeapBlockHeader;
     }
+    return PS_OK;
   }
   return PS_OK;
 
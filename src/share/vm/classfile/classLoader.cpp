@@ -28,6 +28,7 @@
 #include "classfile/classLoader.hpp"
 #include "classfile/classLoaderExt.hpp"
 #include "classfile/classLoaderData.inline.hpp"
+#include "classfile/classPathIndex.hpp"
 #include "classfile/javaClasses.hpp"
 #if INCLUDE_CDS
 #include "classfile/sharedPathsMiscInfo.hpp"
@@ -50,6 +51,7 @@
 #include "oops/symbol.hpp"
 #include "prims/jvm_misc.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/compilationPolicy.hpp"
 #include "runtime/fprofiler.hpp"
 #include "runtime/handles.hpp"
@@ -253,25 +255,72 @@ ClassFileStream* ClassPathDirEntry::open_stream(const char* name, TRAPS) {
 
 ClassPathZipEntry::ClassPathZipEntry(jzfile* zip, const char* zip_name) : ClassPathEntry() {
   _zip = zip;
+  _mapped = NULL;
+  char *copy = NEW_C_HEAP_ARRAY(char, strlen(zip_name)+1, mtClass);
+  strcpy(copy, zip_name);
+  _zip_name = copy;
+}
+
+ClassPathZipEntry::ClassPathZipEntry(ClassPathMappedJar* mapped, const char* zip_name) : ClassPathEntry() {
+  _zip = NULL;
+  _mapped = mapped;
   char *copy = NEW_C_HEAP_ARRAY(char, strlen(zip_name)+1, mtClass);
   strcpy(copy, zip_name);
   _zip_name = copy;
 }
 
 ClassPathZipEntry::~ClassPathZipEntry() {
-  if (ZipClose != NULL) {
+  if (ZipClose != NULL && _zip != NULL) {
     (*ZipClose)(_zip);
   }
+  if (_mapped != NULL) {
+    delete _mapped;
+  }
   FREE_C_HEAP_ARRAY(char, _zip_name, mtClass);
 }
 
+// The zip archive of a mapped jar is only opened for its compressed
+// entries and for walking all entries.
+jzfile* ClassPathZipEntry::zip() {
+  if (_zip == NULL && _mapped != NULL) {
+    char* error_msg = NULL;
+    jzfile* zip = (*ZipOpen)(_mapped->path(), &error_msg);
+    if (zip == NULL || error_msg != NULL) {
+      return NULL;
+    }
+    if (Atomic::cmpxchg_ptr(zip, &_zip, NULL) != NULL && ZipClose != NULL) {
+      (*ZipClose)(zip); // opened by another thread
+    }
+  }
+  return _zip;
+}
+
 u1* ClassPathZipEntry::open_entry(const char* name, jint* filesize, bool nul_terminate, TRAPS) {
+  if (_mapped != NULL) {
+    ClassPathMappedJar::Entry mapped_entry;
+    if (!_mapped->find(name, &mapped_entry)) {
+      return NULL;
+    }
+    if (mapped_entry._stored && mapped_entry._data != NULL) {
+      // Stored entries are used in place.
+      *filesize = (jint)mapped_entry._size;
+      if (!nul_terminate) {
+        return (u1*)mapped_entry._data;
+      }
+      u1* buffer = NEW_RESOURCE_ARRAY(u1, mapped_entry._size + 1);
+      memcpy(buffer, mapped_entry._data, mapped_entry._size);
+      buffer[mapped_entry._size] = 0;
+      return buffer;
+    }
+  }
     // enable call to C land
   JavaThread* thread = JavaThread::current();
   ThreadToNativeFromVM ttn(thread);
+  jzfile* zip_file = zip();
+  if (zip_file == NULL) return NULL;
   // check whether zip archive contains name
   jint name_len;
-  jzentry* entry = (*FindEntry)(_zip, name, filesize, &name_len);
+  jzentry* entry = (*FindEntry)(zip_file, name, filesize, &name_len);
   if (entry == NULL) return NULL;
   u1* buffer;
   char name_buf[128];
@@ -284,12 +333,12 @@ u1* ClassPathZipEntry::open_entry(const char* name, jint* filesize, bool nul_ter
 
   // file found, get pointer to the entry in mmapped jar file.
   if (ReadMappedEntry == NULL ||
-      !(*ReadMappedEntry)(_zip, entry, &buffer, filename)) {
+      !(*ReadMappedEntry)(zip_file, entry, &buffer, filename)) {
       // mmapped access not available, perhaps due to compression,
       // read contents into resource array
       int size = (*filesize) + ((nul_terminate) ? 1 : 0);
       buffer = NEW_RESOURCE_ARRAY(u1, size);
-      if (!(*ReadEntry)(_zip, entry, buffer, filename)) return NULL;
+      if (!(*ReadEntry)(zip_file, entry, buffer, filename)) return NULL;
   }
 
   // return result
@@ -316,8 +365,10 @@ void ClassPathZipEntry::contents_do(void f(const char* name, void* context), voi
   JavaThread* thread = JavaThread::current();
   HandleMark  handle_mark(thread);
   ThreadToNativeFromVM ttn(thread);
+  jzfile* zip_file = zip();
+  if (zip_file == NULL) return;
   for (int n = 0; ; n++) {
-    jzentry * ze = ((*GetNextEntry)(_zip, n));
+    jzentry * ze = ((*GetNextEntry)(zip_file, n));
     if (ze == NULL) break;
     (*f)(ze->name, context);
   }
@@ -663,14 +714,25 @@ ClassPathEntry* ClassLoader::create_class_path_entry(const char *path, const str
       }
     }
     char* error_msg = NULL;
-    jzfile* zip;
+    jzfile* zip = NULL;
+    ClassPathMappedJar* mapped = NULL;
     {
       // enable call to C land
       ThreadToNativeFromVM ttn(thread);
       HandleMark hm(thread);
-      zip = (*ZipOpen)(canonical_path, &error_msg);
+      if (UseClassPathIndex) {
+        mapped = ClassPathMappedJar::open(canonical_path);
+      }
+      if (mapped == NULL) {
+        zip = (*ZipOpen)(canonical_path, &error_msg);
+      }
     }
-    if (zip != NULL && error_msg == NULL) {
+    if (mapped != NULL) {
+      new_entry = new ClassPathZipEntry(mapped, path);
+      if (TraceClassLoading || TraceClassPaths) {
+        tty->print_cr("[Opened %s]", path);
+      }
+    } else if (zip != NULL && error_msg == NULL) {
       new_entry = new ClassPathZipEntry(zip, path);
       if (TraceClassLoading || TraceClassPaths) {
         tty->print_cr("[Opened %s]", path);
@@ -713,13 +775,22 @@ ClassPathZipEntry* ClassLoader::create_class_path_zip_entry(const char *path) {
       char canonical_path[JVM_MAXPATHLEN];
       if (get_canonical_path(path, canonical_path, JVM_MAXPATHLEN)) {
         char* error_msg = NULL;
-        jzfile* zip;
+        jzfile* zip = NULL;
+        ClassPathMappedJar* mapped = NULL;
         {
           // enable call to C land
           JavaThread* thread = JavaThread::current();
           ThreadToNativeFromVM ttn(thread);
           HandleMark hm(thread);
-          zip = (*ZipOpen)(canonical_path, &error_msg);
+          if (UseClassPathIndex) {
+            mapped = ClassPathMappedJar::open(canonical_path);
+          }
+          if (mapped == NULL) {
+            zip = (*ZipOpen)(canonical_path, &error_msg);
+          }
+        }
+        if (mapped != NULL) {
+          return new ClassPathZipEntry(mapped, canonical_path);
         }
         if (zip != NULL && error_msg == NULL) {
           // create using canonical path
@@ -752,6 +823,9 @@ void ClassLoader::add_to_list(ClassPathEntry *new_entry) {
       _last_entry->set_next(new_entry);
       _last_entry = new_entry;
     }
+    if (ClassPathIndex::is_enabled()) {
+      ClassPathIndex::add_entry(new_entry);
+    }
   }
   _num_entries ++;
 }
@@ -765,7 +839,9 @@ bool ClassLoader::update_class_path_entry_list(const char *path,
     // File or directory found
     ClassPathEntry* new_entry = NULL;
     Thread* THREAD = Thread::current();
-    new_entry = create_class_path_entry(path, &st, LazyBootClassLoader, throw_exception, CHECK_(false));
+    // The index needs the jars open to know their packages.
+    bool lazy = LazyBootClassLoader && !UseClassPathIndex;
+    new_entry = create_class_path_entry(path, &st, lazy, throw_exception, CHECK_(false));
     if (new_entry == NULL) {
       return false;
     }
@@ -1101,17 +1177,24 @@ instanceKlassHandle ClassLoader::load_classfile(Symbol* h_name, TRAPS) {
     PerfClassTraceTime vmtimer(perf_sys_class_lookup_time(),
                                ((JavaThread*) THREAD)->get_thread_stat()->perf_timers_addr(),
                                PerfClassTraceTime::CLASS_LOAD);
-    e = _first_entry;
-    while (e != NULL) {
-      stream = e->open_stream(file_name, CHECK_NULL);
+    if (ClassPathIndex::is_enabled()) {
+      stream = ClassPathIndex::open_stream(file_name, &classpath_index, &e, CHECK_NULL);
       if (!context.check(stream, classpath_index)) {
         return h; // NULL
       }
-      if (stream != NULL) {
-        break;
+    } else {
+      e = _first_entry;
+      while (e != NULL) {
+        stream = e->open_stream(file_name, CHECK_NULL);
+        if (!context.check(stream, classpath_index)) {
+          return h; // NULL
+        }
+        if (stream != NULL) {
+          break;
+        }
+        e = e->next();
+        ++classpath_index;
       }
-      e = e->next();
-      ++classpath_index;
     }
   }
 
@@ -1436,12 +1519,13 @@ void ClassPathZipEntry::compile_the_world(Handle loader, TRAPS) {
 
 // Version that works for JDK 1.3.x
 void ClassPathZipEntry::compile_the_world13(Handle loader, TRAPS) {
-  real_jzfile13* zip = (real_jzfile13*) _zip;
+  real_jzfile13* zip = (real_jzfile13*) this->zip();
+  if (zip == NULL) return;
   tty->print_cr("CompileTheWorld : Compiling all classes in %s", zip->name);
   tty->cr();
   // Iterate over all entries in zip file
   for (int n = 0; ; n++) {
-    real_jzentry13 * ze = (real_jzentry13 *)((*GetNextEntry)(_zip, n));
+    real_jzentry13 * ze = (real_jzentry13 *)((*GetNextEntry)((jzfile*)zip, n));
     if (ze == NULL) break;
     ClassLoader::compile_the_world_in(ze->name, loader, CHECK);
   }
@@ -1450,12 +1534,13 @@ void ClassPathZipEntry::compile_the_world13(Handle loader, TRAPS) {
 
 // Version that works for JDK 1.2.x
 void ClassPathZipEntry::compile_the_world12(Handle loader, TRAPS) {
-  real_jzfile12* zip = (real_jzfile12*) _zip;
+  real_jzfile12* zip = (real_jzfile12*) this->zip();
+  if (zip == NULL) return;
   tty->print_cr("CompileTheWorld : Compiling all classes in %s", zip->name);
   tty->cr();
   // Iterate over all entries in zip file
   for (int n = 0; ; n++) {
-    real_jzentry12 * ze = (real_jzentry12 *)((*GetNextEntry)(_zip, n));
+    real_jzentry12 * ze = (real_jzentry12 *)((*GetNextEntry)((jzfile*)zip, n));
     if (ze == NULL) break;
     ClassLoader::compile_the_world_in(ze->name, loader, CHECK);
   }
@@ -1471,7 +1556,8 @@ bool ClassPathZipEntry::is_rt_jar() {
 
 // JDK 1.3 version
 bool ClassPathZipEntry::is_rt_jar13() {
-  real_jzfile13* zip = (real_jzfile13*) _zip;
+  real_jzfile13* zip = (real_jzfile13*) this->zip();
+  if (zip == NULL) return false;
   int len = (int)strlen(zip->name);
   // Check whether zip name ends in "rt.jar"
   // This will match other archives named rt.jar as well, but this is
@@ -1481,7 +1567,8 @@ bool ClassPathZipEntry::is_rt_jar13() {
 
 // JDK 1.2 version
 bool ClassPathZipEntry::is_rt_jar12() {
-  real_jzfile12* zip = (real_jzfile12*) _zip;
+  real_jzfile12* zip = (real_jzfile12*) this->zip();
+  if (zip == NULL) return false;
   int len = (int)strlen(zip->name);
   // Check whether zip name ends in "rt.jar"
   // This will match other archives named rt.jar as well, but this is
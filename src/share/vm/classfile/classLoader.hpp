@@ -98,15 +98,21 @@ typedef struct {
 } jzentry;
 
 
+class ClassPathMappedJar;
+
 class ClassPathZipEntry: public ClassPathEntry {
  private:
-  jzfile* _zip;              // The zip archive
-  const char*   _zip_name;   // Name of zip archive
+  jzfile* volatile    _zip;     // The zip archive, opened on demand if mapped
+  ClassPathMappedJar* _mapped;  // The mapped archive (UseClassPathIndex), or NULL
+  const char*   _zip_name;      // Name of zip archive
+  jzfile* zip();
  public:
   bool is_jar_file()  { return true;  }
   const char* name()  { return _zip_name; }
   ClassPathZipEntry(jzfile* zip, const char* zip_name);
+  ClassPathZipEntry(ClassPathMappedJar* mapped, const char* zip_name);
   ~ClassPathZipEntry();
+  ClassPathMappedJar* mapped_jar() { return _mapped; }
   u1* open_entry(const char* name, jint* filesize, bool nul_terminate, TRAPS);
   ClassFileStream* open_stream(const char* name, TRAPS);
   void contents_do(void f(const char* name, void* context), void* context);
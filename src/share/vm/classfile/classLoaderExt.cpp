@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderExt.hpp"
+#include "classfile/sharedClassUtil.hpp"
+#include "runtime/arguments.hpp"
+
+jshort ClassLoaderExt::_app_paths_start_index = max_jshort;
+bool   ClassLoaderExt::_has_app_classes = false;
+
+void ClassLoaderExt::setup_search_paths() {
+  assert(DumpSharedSpaces, "only called while dumping");
+
+  // The boot class path has already been set up.
+  int count = 0;
+  for (ClassPathEntry* e = _first_entry; e != NULL; e = e->next()) {
+    count++;
+  }
+  _app_paths_start_index = (jshort)count;
+
+  if (UseAppCDS) {
+    const char* app_class_path = Arguments::get_appclasspath();
+    SharedPathsMiscInfoExt* info = (SharedPathsMiscInfoExt*)_shared_paths_misc_info;
+    info->add_app_classpath(app_class_path);
+    if (app_class_path[0] != '\0') {
+      setup_search_path(app_class_path);
+    }
+  }
+}
+
+bool ClassLoaderExt::check(Context* context, ClassFileStream* stream, int classpath_index) {
+  if (stream != NULL && is_app_path(classpath_index) &&
+      SharedClassUtil::is_classpath_entry_signed(classpath_index)) {
+    // The code signers are not archived, so classes of a signed jar are
+    // left to the system class loader.
+    tty->print_cr("Preload Warning: Skipping %s from signed JAR", context->class_name());
+    return false;
+  }
+  return true;
+}
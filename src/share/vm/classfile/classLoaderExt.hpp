@@ -28,25 +28,55 @@
 #include "classfile/classLoader.hpp"
 
 class ClassLoaderExt: public ClassLoader { // AllStatic
+  CDS_ONLY(friend class FileMapHeaderExt;)
+private:
+#if INCLUDE_CDS
+  // Index of the first app class path entry in the shared path table. The
+  // boot class path entries come first. While dumping with UseAppCDS the
+  // app class path entries are appended to the boot loader's search list,
+  // so app classes are loaded and archived by the boot loader.
+  static jshort _app_paths_start_index;
+  static bool   _has_app_classes;
+#endif
+
 public:
 
   class Context {
+    const char* _class_name;
     const char* _file_name;
   public:
     Context(const char* class_name, const char* file_name, TRAPS) {
+      _class_name = class_name;
       _file_name = file_name;
     }
 
+    const char* class_name() {
+      return _class_name;
+    }
+
     bool check(ClassFileStream* stream, const int classpath_index) {
-      return true;
+      CDS_ONLY(return ClassLoaderExt::check(this, stream, classpath_index);)
+      NOT_CDS(return true;)
     }
 
     bool should_verify(int classpath_index) {
-      return false;
+      // App classes are verified as if they were loaded by the system
+      // class loader, since they are not verified again at run time.
+      CDS_ONLY(return is_app_path(classpath_index);)
+      NOT_CDS(return false;)
     }
 
     instanceKlassHandle record_result(const int classpath_index,
                                       ClassPathEntry* e, instanceKlassHandle result, TRAPS) {
+#if INCLUDE_CDS
+      if (is_app_path(classpath_index)) {
+        // The package belongs to the system class loader at run time, so
+        // it is not added to the boot loader's package table.
+        ClassLoaderExt::set_has_app_classes();
+        result->set_shared_classpath_index(classpath_index);
+        return result;
+      }
+#endif
       if (ClassLoader::add_package(_file_name, classpath_index, THREAD)) {
         if (DumpSharedSpaces) {
           result->set_shared_classpath_index(classpath_index);
@@ -66,7 +96,20 @@ public:
   static void append_boot_classpath(ClassPathEntry* new_entry) {
     ClassLoader::add_to_list(new_entry);
   }
-  static void setup_search_paths() {}
+  static void setup_search_paths() NOT_CDS_RETURN;
+
+#if INCLUDE_CDS
+  static bool check(Context* context, ClassFileStream* stream, int classpath_index);
+
+  static jshort app_paths_start_index() { return _app_paths_start_index; }
+  // True for the app class path entries searched by the boot loader
+  // while dumping.
+  static bool is_app_path(int classpath_index) {
+    return DumpSharedSpaces && classpath_index >= _app_paths_start_index;
+  }
+  static bool has_app_classes()         { return _has_app_classes; }
+  static void set_has_app_classes()     { _has_app_classes = true; }
+#endif
 
   static void init_lookup_cache(TRAPS) {}
   static void copy_lookup_cache_to_archive(char** top, char* end) {}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classFileStream.hpp"
+#include "classfile/classLoader.hpp"
+#include "classfile/classPathIndex.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+
+// Zip format constants, as in zip_util.h
+enum {
+  LOCSIG   = 0x04034b50,     // local file header
+  LOCHDR   = 30,
+  LOCNAM   = 26,
+  LOCEXT   = 28,
+
+  CENSIG   = 0x02014b50,     // central directory header
+  CENHDR   = 46,
+  CENFLG   = 8,
+  CENHOW   = 10,
+  CENSIZ   = 20,
+  CENLEN   = 24,
+  CENNAM   = 28,
+  CENEXT   = 30,
+  CENCOM   = 32,
+  CENOFF   = 42,
+
+  ENDSIG   = 0x06054b50,     // end of central directory record
+  ENDHDR   = 22,
+  ENDTOT   = 10,
+  ENDSIZ   = 12,
+  ENDOFF   = 16,
+  ENDCOM   = 20,
+
+  STORED   = 0,
+  DEFLATED = 8
+};
+
+// Zip fields are little-endian and not aligned.
+static inline u2 get_u2(const u1* p) {
+  return (u2)(p[0] | (p[1] << 8));
+}
+
+static inline u4 get_u4(const u1* p) {
+  return (u4)get_u2(p) | ((u4)get_u2(p + 2) << 16);
+}
+
+ClassPathMappedJar::ClassPathMappedJar(const char* path, char* base, size_t size) {
+  char* copy = NEW_C_HEAP_ARRAY(char, strlen(path) + 1, mtClass);
+  strcpy(copy, path);
+  _path = copy;
+  _base = base;
+  _size = size;
+  _loc_base = 0;
+  _cen = 0;
+  _count = 0;
+  _table = NULL;
+  _table_mask = 0;
+}
+
+ClassPathMappedJar::~ClassPathMappedJar() {
+  os::unmap_memory(_base, _size);
+  if (_table != NULL) {
+    FREE_C_HEAP_ARRAY(u4, _table, mtClass);
+  }
+  FREE_C_HEAP_ARRAY(char, _path, mtClass);
+}
+
+ClassPathMappedJar* ClassPathMappedJar::open(const char* path) {
+  struct stat st;
+  if (os::stat(path, &st) != 0 || st.st_size < ENDHDR || (julong)st.st_size > max_juint) {
+    return NULL;
+  }
+  int fd = os::open(path, 0, 0);
+  if (fd < 0) {
+    return NULL;
+  }
+  size_t size = (size_t)st.st_size;
+  char* base = os::map_memory(fd, path, 0, NULL, size, true, false);
+  os::close(fd);
+  if (base == NULL) {
+    return NULL;
+  }
+  ClassPathMappedJar* jar = new ClassPathMappedJar(path, base, size);
+  if (!jar->parse_central_directory()) {
+    delete jar;
+    return NULL;
+  }
+  return jar;
+}
+
+bool ClassPathMappedJar::parse_central_directory() {
+  // The end record is the last thing in the file but for a comment of at
+  // most 64K.
+  size_t low = (_size > (size_t)ENDHDR + 0xFFFF) ? _size - ENDHDR - 0xFFFF : 0;
+  size_t end = _size - ENDHDR;
+  while (get_u4(cen_at(end)) != ENDSIG ||
+         end + ENDHDR + get_u2(cen_at(end) + ENDCOM) != _size) {
+    if (end == low) {
+      return false;
+    }
+    end--;
+  }
+
+  const u1* endrec = cen_at(end);
+  if (get_u2(endrec + ENDTOT) == 0xFFFF ||
+      get_u4(endrec + ENDSIZ) == 0xFFFFFFFF ||
+      get_u4(endrec + ENDOFF) == 0xFFFFFFFF) {
+    return false; // zip64
+  }
+  size_t cen_len = get_u4(endrec + ENDSIZ);
+  size_t cen_off = get_u4(endrec + ENDOFF);
+  if (cen_len > end || end - cen_len < cen_off) {
+    return false;
+  }
+  _cen = end - cen_len;
+  // Anything before the archive (a launcher stub, say) shifts all offsets.
+  _loc_base = _cen - cen_off;
+
+  // Check the entries before trusting any offset in them.
+  int count = 0;
+  for (size_t pos = _cen; pos < end; count++) {
+    if (end - pos < CENHDR) {
+      return false;
+    }
+    const u1* cen = cen_at(pos);
+    u2 how = get_u2(cen + CENHOW);
+    if (get_u4(cen) != CENSIG ||
+        (get_u2(cen + CENFLG) & 1) != 0 ||       // encrypted
+        (how != STORED && how != DEFLATED) ||
+        get_u4(cen + CENLEN) > (u4)max_jint ||
+        get_u4(cen + CENSIZ) > (u4)max_jint) {
+      return false;
+    }
+    size_t len = CENHDR + get_u2(cen + CENNAM) + get_u2(cen + CENEXT) + get_u2(cen + CENCOM);
+    if (end - pos < len) {
+      return false;
+    }
+    pos += len;
+  }
+  if (count > 0 && _cen == 0) {
+    return false; // offset 0 marks unused slots
+  }
+  _count = count;
+
+  int table_size = 16;
+  while (table_size < 2 * count) {
+    table_size *= 2;
+  }
+  _table = NEW_C_HEAP_ARRAY(u4, table_size, mtClass);
+  memset(_table, 0, table_size * sizeof(u4));
+  _table_mask = table_size - 1;
+
+  for (size_t pos = _cen; pos < end; ) {
+    const u1* cen = cen_at(pos);
+    int name_len = get_u2(cen + CENNAM);
+    unsigned int h = hash((const char*)cen + CENHDR, name_len);
+    int i = h & _table_mask;
+    while (_table[i] != 0) {
+      i = (i + 1) & _table_mask;
+    }
+    _table[i] = (u4)pos;
+    pos += CENHDR + name_len + get_u2(cen + CENEXT) + get_u2(cen + CENCOM);
+  }
+  return true;
+}
+
+bool ClassPathMappedJar::find(const char* name, Entry* entry) const {
+  int name_len = (int)strlen(name);
+  unsigned int h = hash(name, name_len);
+  for (int i = h & _table_mask; _table[i] != 0; i = (i + 1) & _table_mask) {
+    const u1* cen = cen_at(_table[i]);
+    if (get_u2(cen + CENNAM) != name_len || memcmp(cen + CENHDR, name, name_len) != 0) {
+      continue;
+    }
+    u4 csize = get_u4(cen + CENSIZ);
+    entry->_size = get_u4(cen + CENLEN);
+    entry->_stored = get_u2(cen + CENHOW) == STORED;
+    entry->_data = NULL;
+    size_t loc = _loc_base + get_u4(cen + CENOFF);
+    if (loc <= _size - LOCHDR && get_u4(cen_at(loc)) == LOCSIG) {
+      const u1* lochdr = cen_at(loc);
+      size_t data = loc + LOCHDR + get_u2(lochdr + LOCNAM) + get_u2(lochdr + LOCEXT);
+      if (data <= _size && _size - data >= csize &&
+          (!entry->_stored || csize == entry->_size)) {
+        entry->_data = cen_at(data);
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+void ClassPathMappedJar::packages_do(void f(const char* name, int len, void* context),
+                                     void* context) const {
+  const char* last = NULL;
+  int last_len = -1;
+  size_t pos = _cen;
+  for (int n = 0; n < _count; n++) {
+    const u1* cen = cen_at(pos);
+    const char* name = (const char*)cen + CENHDR;
+    int name_len = get_u2(cen + CENNAM);
+    pos += CENHDR + name_len + get_u2(cen + CENEXT) + get_u2(cen + CENCOM);
+    if (name_len == 0 || name[name_len - 1] == '/') {
+      continue; // directory
+    }
+    int len = name_len - 1;
+    while (len > 0 && name[len] != '/') {
+      len--;
+    }
+    if (len != last_len || memcmp(name, last, len) != 0) {
+      f(name, len, context);
+      last = name;
+      last_len = len;
+    }
+  }
+}
+
+
+// An entry of the boot class path, listed under a package of a mapped jar
+// or in the list of entries that are not indexed.
+class ClassPathPackage : public CHeapObj<mtClass> {
+ public:
+  const char*       _name;      // in the jar mapping, NULL if not indexed
+  int               _len;
+  unsigned int      _hash;
+  int               _position;  // in the boot class path
+  ClassPathEntry*   _entry;
+  ClassPathPackage* volatile _next;
+
+  ClassPathPackage(const char* name, int len, unsigned int hash,
+                   int position, ClassPathEntry* entry) :
+    _name(name), _len(len), _hash(hash), _position(position), _entry(entry), _next(NULL) {}
+
+  ClassPathPackage* next() const {
+    return (ClassPathPackage*)OrderAccess::load_ptr_acquire(&_next);
+  }
+
+  bool matches(const char* name, int len, unsigned int hash) const {
+    return _hash == hash && _len == len && memcmp(_name, name, len) == 0;
+  }
+};
+
+ClassPathPackage** ClassPathIndex::_table = NULL;
+ClassPathPackage*  ClassPathIndex::_unindexed = NULL;
+int                ClassPathIndex::_entry_count = 0;
+
+class ClassPathIndexContext : public StackObj {
+ public:
+  ClassPathEntry* _entry;
+  int             _position;
+  int             _packages;
+  ClassPathIndexContext(ClassPathEntry* entry, int position) :
+    _entry(entry), _position(position), _packages(0) {}
+};
+
+void ClassPathIndex::append(ClassPathPackage** list, ClassPathPackage* node) {
+  assert_locked_or_safepoint(ClassPathIndex_lock);
+  ClassPathPackage* volatile* tail = list;
+  while (*tail != NULL) {
+    tail = &(*tail)->_next;
+  }
+  OrderAccess::release_store_ptr(tail, node);
+}
+
+void ClassPathIndex::add_package(const char* name, int len, void* context) {
+  ClassPathIndexContext* ctx = (ClassPathIndexContext*)context;
+  unsigned int hash = ClassPathMappedJar::hash(name, len);
+  ClassPathPackage** bucket = &_table[hash % table_size];
+  for (ClassPathPackage* p = *bucket; p != NULL; p = p->_next) {
+    if (p->_position == ctx->_position && p->matches(name, len, hash)) {
+      return; // the jar's entries of this package are not contiguous
+    }
+  }
+  append(bucket, new ClassPathPackage(name, len, hash, ctx->_position, ctx->_entry));
+  ctx->_packages++;
+}
+
+void ClassPathIndex::add_entry(ClassPathEntry* entry) {
+  MutexLockerEx ml(ClassPathIndex_lock, Mutex::_no_safepoint_check_flag);
+  if (_table == NULL) {
+    ClassPathPackage** table = NEW_C_HEAP_ARRAY(ClassPathPackage*, table_size, mtClass);
+    memset(table, 0, table_size * sizeof(ClassPathPackage*));
+    OrderAccess::release_store_ptr(&_table, table);
+  }
+  int position = _entry_count++;
+
+  ClassPathMappedJar* jar = NULL;
+  if (!entry->is_lazy() && entry->is_jar_file()) {
+    jar = ((ClassPathZipEntry*)entry)->mapped_jar();
+  }
+  if (jar == NULL) {
+    append(&_unindexed, new ClassPathPackage(NULL, 0, 0, position, entry));
+    if (TraceClassPaths) {
+      tty->print_cr("[Not indexed %s]", entry->name());
+    }
+    return;
+  }
+
+  ClassPathIndexContext ctx(entry, position);
+  jar->packages_do(add_package, &ctx);
+  if (TraceClassPaths) {
+    tty->print_cr("[Indexed %s: %d packages]", entry->name(), ctx._packages);
+  }
+}
+
+ClassFileStream* ClassPathIndex::open_stream(const char* file_name, int* classpath_index,
+                                             ClassPathEntry** cpe, TRAPS) {
+  ClassPathPackage** table = (ClassPathPackage**)OrderAccess::load_ptr_acquire(&_table);
+  if (table == NULL) {
+    return NULL; // empty boot class path
+  }
+  const char* slash = strrchr(file_name, '/');
+  int len = (slash == NULL) ? 0 : (int)(slash - file_name);
+  unsigned int hash = ClassPathMappedJar::hash(file_name, len);
+
+  // Both lists are in class path order; walk them together.
+  ClassPathPackage* p = (ClassPathPackage*)OrderAccess::load_ptr_acquire(&table[hash % table_size]);
+  while (p != NULL && !p->matches(file_name, len, hash)) {
+    p = p->next();
+  }
+  ClassPathPackage* u = (ClassPathPackage*)OrderAccess::load_ptr_acquire(&_unindexed);
+  while (p != NULL || u != NULL) {
+    ClassPathPackage* node;
+    if (u == NULL || (p != NULL && p->_position < u->_position)) {
+      node = p;
+      do {
+        p = p->next();
+      } while (p != NULL && !p->matches(file_name, len, hash));
+    } else {
+      node = u;
+      u = u->next();
+    }
+    ClassFileStream* stream = node->_entry->open_stream(file_name, CHECK_NULL);
+    if (stream != NULL) {
+      *classpath_index = node->_position;
+      *cpe = node->_entry;
+      return stream;
+    }
+  }
+  return NULL;
+}
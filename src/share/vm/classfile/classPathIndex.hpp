@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_CLASSFILE_CLASSPATHINDEX_HPP
+#define SHARE_VM_CLASSFILE_CLASSPATHINDEX_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/globals.hpp"
+#include "utilities/exceptions.hpp"
+
+class ClassFileStream;
+class ClassPathEntry;
+class ClassPathPackage;
+
+// A jar file of the boot class path, mapped read-only. The central
+// directory is parsed once into an open-addressed table of entry names,
+// so a lookup neither allocates nor leaves the VM. Stored entries are
+// read straight from the mapping; compressed ones are located here and
+// inflated by libzip.
+class ClassPathMappedJar : public CHeapObj<mtClass> {
+ public:
+  class Entry VALUE_OBJ_CLASS_SPEC {
+   public:
+    const u1* _data;     // the entry data in the mapping, NULL if the
+                         // local header is damaged (libzip reports it)
+    u4        _size;     // uncompressed size
+    bool      _stored;   // not compressed
+  };
+
+ private:
+  const char* _path;     // canonical path
+  char*       _base;     // the mapped file
+  size_t      _size;
+  size_t      _loc_base; // offset of the archive in the file
+  size_t      _cen;      // offset of the central directory
+  int         _count;    // number of entries
+  u4*         _table;    // central directory offsets by name hash, 0 if unused
+  int         _table_mask;
+
+  ClassPathMappedJar(const char* path, char* base, size_t size);
+  bool parse_central_directory();
+  const u1* cen_at(size_t offset) const { return (const u1*)_base + offset; }
+
+ public:
+  // Maps the zip file at path, or returns NULL if it cannot be mapped or
+  // uses features this reader leaves to libzip (zip64, encryption, or a
+  // compression method other than deflate).
+  static ClassPathMappedJar* open(const char* path);
+  ~ClassPathMappedJar();
+
+  const char* path() const { return _path; }
+
+  // Returns false if the jar has no entry called name.
+  bool find(const char* name, Entry* entry) const;
+
+  // Calls f with the package name ("java/lang") and its length, 0 for the
+  // unnamed package, of the jar's file entries. Consecutive entries of the
+  // same package are reported once.
+  void packages_do(void f(const char* name, int len, void* context), void* context) const;
+
+  static unsigned int hash(const char* s, int len) {
+    unsigned int h = 0;
+    for (int i = 0; i < len; i++) {
+      h = 31 * h + (unsigned int)(u1)s[i];
+    }
+    return h;
+  }
+};
+
+// A package-to-entry index over all entries of the boot class path, used
+// with -XX:+UseClassPathIndex. Every mapped jar is recorded under each
+// package it has files in; the other entries (directories and jars that
+// could not be mapped) are kept in a separate list and searched for every
+// name. A lookup merges the two lists by class path position, so it tries
+// the same entries as a linear search would, in the same order, but skips
+// the mapped jars that cannot have the class. A miss costs one hash probe
+// when the boot class path is all jars.
+//
+// Entries are added at the tail of their lists under ClassPathIndex_lock
+// and published with release stores, so lookups take no lock.
+class ClassPathIndex : AllStatic {
+ private:
+  static ClassPathPackage** _table;      // mapped jars by package
+  static ClassPathPackage*  _unindexed;  // the other entries
+  static int                _entry_count;
+
+  static const int table_size = 4099;
+
+  static void add_package(const char* name, int len, void* context);
+  static void append(ClassPathPackage** list, ClassPathPackage* node);
+
+ public:
+  static bool is_enabled() { return UseClassPathIndex; }
+
+  // Records the next entry of the boot class path.
+  static void add_entry(ClassPathEntry* entry);
+
+  // Searches the boot class path for file_name. Returns the stream and
+  // sets classpath_index and cpe as the linear search does, or returns NULL.
+  static ClassFileStream* open_stream(const char* file_name, int* classpath_index,
+                                      ClassPathEntry** cpe, TRAPS);
+};
+
+#endif // SHARE_VM_CLASSFILE_CLASSPATHINDEX_HPP
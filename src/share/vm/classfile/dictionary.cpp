@@ -26,6 +26,7 @@
 #include "classfile/dictionary.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "classfile/systemDictionaryShared.hpp"
+#include "memory/gcLocker.hpp"
 #include "memory/iterator.hpp"
 #include "oops/oop.inline.hpp"
 #include "prims/jvmtiRedefineClassesTrace.hpp"
@@ -114,7 +115,10 @@ bool DictionaryEntry::contains_protection_domain(oop protection_domain) const {
     return true;
   }
 
-  for (ProtectionDomainEntry* current = _pd_set;
+  // Readers may not hold SystemDictionary_lock; pairs with the release
+  // store in add_protection_domain().
+  ProtectionDomainEntry* head = (ProtectionDomainEntry*)OrderAccess::load_ptr_acquire(&_pd_set);
+  for (ProtectionDomainEntry* current = head;
                               current != NULL;
                               current = current->next()) {
     if (current->protection_domain() == protection_domain) return true;
@@ -404,6 +408,23 @@ Klass* Dictionary::find_class(int index, unsigned int hash,
 }
 
 
+// Variant of find_class for readers that do not hold SystemDictionary_lock.
+// Entries are linked in with a release store after they are complete and
+// are only unlinked and freed by do_unloading() at a safepoint, so the
+// walk must not reach a safepoint. The caller cannot rely on the class
+// still being absent once this returns NULL; only the locked find_class
+// can be combined with an update of the dictionary or placeholders.
+
+Klass* Dictionary::find_class_lock_free(int index, unsigned int hash,
+                                        Symbol* name, ClassLoaderData* loader_data) {
+  assert (index == index_for(name, loader_data), "incorrect index?");
+  No_Safepoint_Verifier nosafepoint;
+
+  DictionaryEntry* entry = get_entry(index, hash, name, loader_data);
+  return (entry != NULL) ? entry->klass() : (Klass*)NULL;
+}
+
+
 // Variant of find_class for shared classes.  No locking required, as
 // that table is static.
 
@@ -415,6 +436,16 @@ Klass* Dictionary::find_shared_class(int index, unsigned int hash,
   return (entry != NULL) ? entry->klass() : (Klass*)NULL;
 }
 
+// Returns the entry of a class in the shared dictionary (loader_data is
+// NULL), or of a boot class while dumping. Neither table has entries
+// removed concurrently.
+DictionaryEntry* Dictionary::find_shared_entry(Symbol* name, ClassLoaderData* loader_data) {
+  assert(UseSharedSpaces || DumpSharedSpaces, "only for shared classes");
+  unsigned int hash = compute_hash(name, loader_data);
+  int index = hash_to_index(hash);
+  return get_entry(index, hash, name, loader_data);
+}
+
 
 void Dictionary::add_protection_domain(int index, unsigned int hash,
                                        instanceKlassHandle klass,
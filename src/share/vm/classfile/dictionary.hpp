@@ -85,6 +85,7 @@ public:
                       Symbol* name, ClassLoaderData* loader_data);
 
   Klass* find_shared_class(int index, unsigned int hash, Symbol* name);
+  DictionaryEntry* find_shared_entry(Symbol* name, ClassLoaderData* loader_data);
 
   // Compiler support
   Klass* try_get_next_class();
@@ -115,6 +116,11 @@ public:
   // Unload (that is, break root links to) all unmarked classes and loaders.
   void do_unloading();
 
+  // Lookup of a loaded class without SystemDictionary_lock, ignoring
+  // protection domains. See find_class_lock_free() for the rules.
+  Klass* find_class_lock_free(int index, unsigned int hash, Symbol* name,
+                              ClassLoaderData* loader_data);
+
   // Protection domains
   Klass* find(int index, unsigned int hash, Symbol* name,
                 ClassLoaderData* loader_data, Handle protection_domain, TRAPS);
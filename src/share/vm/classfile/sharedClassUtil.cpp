@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoader.hpp"
+#include "classfile/classLoaderData.inline.hpp"
+#include "classfile/classLoaderExt.hpp"
+#include "classfile/sharedClassUtil.hpp"
+#include "memory/metadataFactory.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/arguments.hpp"
+
+void FileMapHeaderExt::populate(FileMapInfo* mapinfo, size_t alignment) {
+  FileMapInfo::FileMapHeader::populate(mapinfo, alignment);
+
+  _app_paths_start_index = ClassLoaderExt::app_paths_start_index();
+  _verify_local = BytecodeVerificationLocal;
+  _verify_remote = BytecodeVerificationRemote;
+  _has_app_classes = ClassLoaderExt::has_app_classes();
+}
+
+bool FileMapHeaderExt::validate() {
+  if (!FileMapInfo::FileMapHeader::validate()) {
+    return false;
+  }
+
+  // The archived app classes were verified, if at all, with the settings
+  // used while dumping. Archives without app classes are accepted as
+  // before.
+  if (UseAppCDS && _has_app_classes &&
+      ((!_verify_local && BytecodeVerificationLocal) ||
+       (!_verify_remote && BytecodeVerificationRemote))) {
+    FileMapInfo::fail_continue("The shared archive file was created with less restrictive "
+                               "verification setting than the current setting.");
+    return false;
+  }
+
+  ClassLoaderExt::_app_paths_start_index = _app_paths_start_index;
+  return true;
+}
+
+bool SharedPathsMiscInfoExt::check(jint type, const char* path) {
+  switch (type) {
+  case APP:
+    {
+      if (!UseAppCDS) {
+        // The app class path is recorded last. The archived app classes
+        // are not used, so the rest of it need not match.
+        _cur_ptr = _end_ptr;
+        return true;
+      }
+      size_t len = strlen(path);
+      const char* appcp = Arguments::get_appclasspath();
+      if (strncmp(appcp, path, len) != 0 ||
+          (appcp[len] != '\0' && appcp[len] != os::path_separator()[0])) {
+        return fail("[APP classpath mismatch, actual: -Djava.class.path=", appcp);
+      }
+    }
+    break;
+  default:
+    return SharedPathsMiscInfo::check(type, path);
+  }
+
+  return true;
+}
+
+void SharedClassUtil::update_shared_classpath(ClassPathEntry *cpe,
+                                              SharedClassPathEntry* ent,
+                                              time_t timestamp,
+                                              long filesize, TRAPS) {
+  ent->_timestamp = timestamp;
+  ent->_filesize  = filesize;
+
+  SharedClassPathEntryExt* ext = (SharedClassPathEntryExt*)ent;
+  ext->_manifest = NULL;
+  ext->_is_signed = false;
+
+  int index = (int)(((address)ent - (address)FileMapInfo::shared_classpath(0)) /
+                    shared_class_path_entry_size());
+  if (index < ClassLoaderExt::app_paths_start_index()) {
+    return;
+  }
+
+  ResourceMark rm(THREAD);
+  jint manifest_size;
+  u1* manifest;
+  const char* manifest_name = "META-INF/MANIFEST.MF";
+  if (cpe->is_lazy()) {
+    manifest = ((LazyClassPathEntry*)cpe)->open_entry(manifest_name, &manifest_size, true, CHECK);
+  } else {
+    manifest = ((ClassPathZipEntry*)cpe)->open_entry(manifest_name, &manifest_size, true, CHECK);
+  }
+  if (manifest == NULL) {
+    return;
+  }
+
+  // Signed jars have digest attributes in their manifest.
+  if (strstr((const char*)manifest, "-Digest") != NULL) {
+    ext->_is_signed = true;
+    return;
+  }
+
+  ClassLoaderData* loader_data = ClassLoaderData::the_null_class_loader_data();
+  Array<u1>* buf = MetadataFactory::new_array<u1>(loader_data, manifest_size + 1, CHECK);
+  memcpy(buf->adr_at(0), manifest, manifest_size + 1);
+  ext->_manifest = buf;
+}
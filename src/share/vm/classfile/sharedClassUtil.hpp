@@ -25,44 +25,117 @@
 #ifndef SHARE_VM_CLASSFILE_SHAREDCLASSUTIL_HPP
 #define SHARE_VM_CLASSFILE_SHAREDCLASSUTIL_HPP
 
+#include "classfile/classLoaderExt.hpp"
 #include "classfile/sharedPathsMiscInfo.hpp"
 #include "memory/filemap.hpp"
 
+// The archive header also records where the app class path starts in the
+// shared path table, and the verification settings the app classes were
+// verified with.
+class FileMapHeaderExt: public FileMapInfo::FileMapHeader {
+public:
+  jshort _app_paths_start_index;    // Index of the first app class path entry
+  bool   _verify_local;             // BytecodeVerificationLocal setting
+  bool   _verify_remote;            // BytecodeVerificationRemote setting
+  bool   _has_app_classes;          // Were any app classes archived?
+
+  FileMapHeaderExt() {
+    _has_app_classes = false;
+  }
+  virtual void populate(FileMapInfo* mapinfo, size_t alignment);
+  virtual bool validate();
+};
+
+// With UseAppCDS the app class path used while dumping is recorded after
+// the boot class path information. At run time it must be a prefix of
+// -Djava.class.path.
+class SharedPathsMiscInfoExt : public SharedPathsMiscInfo {
+public:
+  enum {
+    APP = 4
+  };
+
+  SharedPathsMiscInfoExt() : SharedPathsMiscInfo() {}
+  SharedPathsMiscInfoExt(char* buf, int size) : SharedPathsMiscInfo(buf, size) {}
+
+  virtual const char* type_name(int type) {
+    switch (type) {
+    case APP: return "APP";
+    default:  return SharedPathsMiscInfo::type_name(type);
+    }
+  }
+
+  virtual void print_path(outputStream* out, int type, const char* path) {
+    switch (type) {
+    case APP:
+      out->print("Expecting -Djava.class.path to start with %s", path);
+      break;
+    default:
+      SharedPathsMiscInfo::print_path(out, type, path);
+    }
+  }
+
+  void add_app_classpath(const char* path) {
+    add_path(path, APP);
+  }
+
+protected:
+  virtual bool check(jint type, const char* path);
+};
+
+class SharedClassPathEntryExt: public SharedClassPathEntry {
+public:
+  // META-INF/MANIFEST.MF of an app class path jar, NUL terminated, or NULL.
+  // It is used to define the packages of the archived app classes.
+  Array<u1>* _manifest;
+  bool       _is_signed;
+};
+
 class SharedClassUtil : AllStatic {
 public:
 
   static SharedPathsMiscInfo* allocate_shared_paths_misc_info() {
-    return new SharedPathsMiscInfo();
+    return new SharedPathsMiscInfoExt();
   }
 
   static SharedPathsMiscInfo* allocate_shared_paths_misc_info(char* buf, int size) {
-    return new SharedPathsMiscInfo(buf, size);
+    return new SharedPathsMiscInfoExt(buf, size);
   }
 
   static FileMapInfo::FileMapHeader* allocate_file_map_header() {
-    return new FileMapInfo::FileMapHeader();
+    return new FileMapHeaderExt();
   }
 
   static size_t file_map_header_size() {
-    return sizeof(FileMapInfo::FileMapHeader);
+    return sizeof(FileMapHeaderExt);
   }
 
   static size_t shared_class_path_entry_size() {
-    return sizeof(SharedClassPathEntry);
+    return sizeof(SharedClassPathEntryExt);
   }
 
   static void update_shared_classpath(ClassPathEntry *cpe,
                                       SharedClassPathEntry* ent,
                                       time_t timestamp,
-                                      long filesize, TRAPS) {
-    ent->_timestamp = timestamp;
-    ent->_filesize  = filesize;
-  }
+                                      long filesize, TRAPS);
 
   static void initialize(TRAPS) {}
 
   inline static bool is_shared_boot_class(Klass* klass) {
-    return (klass->_shared_class_path_index >= 0);
+    return (klass->_shared_class_path_index >= 0 &&
+            klass->_shared_class_path_index < ClassLoaderExt::app_paths_start_index());
+  }
+
+  inline static bool is_shared_app_class(Klass* klass) {
+    return klass->_shared_class_path_index >= ClassLoaderExt::app_paths_start_index();
+  }
+
+  static SharedClassPathEntryExt* shared_classpath(int index) {
+    return (SharedClassPathEntryExt*)FileMapInfo::shared_classpath(index);
+  }
+
+  static bool is_classpath_entry_signed(int classpath_index) {
+    return shared_classpath(classpath_index)->_is_signed;
   }
 };
 
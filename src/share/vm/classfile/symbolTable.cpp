@@ -33,11 +33,17 @@
 #include "memory/gcLocker.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/oop.inline2.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/interfaceSupport.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "utilities/copy.hpp"
+#include "utilities/growableArray.hpp"
 #include "utilities/hashtable.inline.hpp"
 #if INCLUDE_ALL_GCS
 #include "gc_implementation/g1/g1SATBCardTableModRefBS.hpp"
 #include "gc_implementation/g1/g1StringDedup.hpp"
+#include "gc_implementation/g1/heapRegionBounds.inline.hpp"
 #endif
 
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
@@ -47,10 +53,51 @@ PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 // the number of buckets a thread claims
 const int ClaimChunkSize = 32;
 
+// the number of buckets the service thread resizes or cleans before it
+// releases the table lock and checks for a safepoint
+const int ConcurrentChunkSize = 1024;
+
+// Concurrent changes by the service thread are bracketed by an odd
+// epoch. A lock-free lookup that failed while the epoch was odd, or
+// that raced with a change, may have missed an entry that was being
+// moved and has to be retried under the table lock.
+static void begin_concurrent_change(volatile jint* epoch) {
+  Atomic::inc(epoch);
+  OrderAccess::fence();
+}
+
+static void end_concurrent_change(volatile jint* epoch) {
+  OrderAccess::fence();
+  Atomic::inc(epoch);
+}
+
+static bool may_have_missed_entry(volatile jint* epoch, jint seen) {
+  if (SafepointSynchronize::is_at_safepoint()) {
+    // The service thread is stopped between chunks.
+    return false;
+  }
+  OrderAccess::loadload();
+  return (seen & 1) != 0 || *epoch != seen;
+}
+
+static void request_concurrent_work(volatile bool* has_work) {
+  if (!*has_work) {
+    MutexLockerEx ml(Service_lock, Mutex::_no_safepoint_check_flag);
+    *has_work = true;
+    Service_lock->notify_all();
+  }
+}
+
 SymbolTable* SymbolTable::_the_table = NULL;
 // Static arena for symbols that are not deallocated
 Arena* SymbolTable::_arena = NULL;
 bool SymbolTable::_needs_rehashing = false;
+volatile bool SymbolTable::_has_work = false;
+volatile bool SymbolTable::_needs_cleaning = false;
+volatile jint SymbolTable::_concurrent_epoch = 0;
+volatile jint SymbolTable::_deferred_processed = 0;
+volatile jint SymbolTable::_deferred_removed = 0;
+HashtableEntry<Symbol*, mtSymbol>* SymbolTable::_unlinked_entries = NULL;
 
 Symbol* SymbolTable::allocate_symbol(const u1* name, int len, bool c_heap, TRAPS) {
   assert (len <= Symbol::max_length(), "should be checked by caller");
@@ -84,6 +131,9 @@ void SymbolTable::initialize_symbols(int arena_alloc_size) {
 void SymbolTable::symbols_do(SymbolClosure *cl) {
   const int n = the_table()->table_size();
   for (int i = 0; i < n; i++) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     for (HashtableEntry<Symbol*, mtSymbol>* p = the_table()->bucket(i);
          p != NULL;
          p = p->next()) {
@@ -98,6 +148,10 @@ volatile int SymbolTable::_parallel_claimed_idx = 0;
 
 void SymbolTable::buckets_unlink(int start_idx, int end_idx, BucketUnlinkContext* context, size_t* memory_total) {
   for (int i = start_idx; i < end_idx; ++i) {
+    if (the_table()->is_redirect(i)) {
+      // The entries are still in the lower bucket.
+      continue;
+    }
     HashtableEntry<Symbol*, mtSymbol>** p = the_table()->bucket_addr(i);
     HashtableEntry<Symbol*, mtSymbol>* entry = the_table()->bucket(i);
     while (entry != NULL) {
@@ -130,6 +184,14 @@ void SymbolTable::buckets_unlink(int start_idx, int end_idx, BucketUnlinkContext
 // Remove unreferenced symbols from the symbol table
 // This is done late during GC.
 void SymbolTable::unlink(int* processed, int* removed) {
+  if (ConcurrentSymbolTableCleaning) {
+    _needs_cleaning = true;
+    request_concurrent_work(&_has_work);
+    // Report the work of the service thread since the last request.
+    *processed = Atomic::xchg(0, &_deferred_processed);
+    *removed = Atomic::xchg(0, &_deferred_removed);
+    return;
+  }
   size_t memory_total = 0;
   BucketUnlinkContext context;
   buckets_unlink(0, the_table()->table_size(), &context, &memory_total);
@@ -148,6 +210,10 @@ void SymbolTable::unlink(int* processed, int* removed) {
 }
 
 void SymbolTable::possibly_parallel_unlink(int* processed, int* removed) {
+  if (ConcurrentSymbolTableCleaning) {
+    unlink(processed, removed);
+    return;
+  }
   const int limit = the_table()->table_size();
 
   size_t memory_total = 0;
@@ -179,12 +245,138 @@ void SymbolTable::possibly_parallel_unlink(int* processed, int* removed) {
   }
 }
 
+// Unlinks the entries of dead symbols in the buckets [start_idx, end_idx)
+// while lock-free readers may be walking them. The entries keep pointing
+// into the table or to other unlinked entries, whose symbols are all dead,
+// so a reader that is on one of them still terminates.
+int SymbolTable::unlink_dead_entries(int start_idx, int end_idx, int* processed) {
+  assert_locked_or_safepoint(SymbolTable_lock);
+  int removed = 0;
+  for (int i = start_idx; i < end_idx; ++i) {
+    if (is_redirect(i)) {
+      continue;
+    }
+    HashtableEntry<Symbol*, mtSymbol>** p = bucket_addr(i);
+    HashtableEntry<Symbol*, mtSymbol>* entry = bucket(i);
+    while (entry != NULL) {
+      // See buckets_unlink() for shared entries.
+      if (entry->is_shared() && !use_alternate_hashcode()) {
+        break;
+      }
+      Symbol* s = entry->literal();
+      (*processed)++;
+      // Claiming the symbol fails if a lookup has just referenced it again.
+      // Once claimed, no lookup can revive it, see try_increment_refcount().
+      if (s->try_claim_dead()) {
+        *p = entry->next();
+        entry->set_next(_unlinked_entries);
+        _unlinked_entries = entry;
+        removed++;
+      } else {
+        p = entry->next_addr();
+      }
+      entry = (HashtableEntry<Symbol*, mtSymbol>*)HashtableEntry<Symbol*, mtSymbol>::make_ptr(*p);
+    }
+  }
+  return removed;
+}
+
+void SymbolTable::grow(JavaThread* jt) {
+  int old_size;
+  {
+    MutexLocker ml(SymbolTable_lock, jt);
+    if (!the_table()->needs_resize(TableResizeLoadFactor)) {
+      return;
+    }
+    old_size = the_table()->table_size();
+    begin_concurrent_change(&_concurrent_epoch);
+    the_table()->start_resize();
+  }
+  bool more;
+  do {
+    {
+      // Let a pending safepoint proceed
+      ThreadBlockInVM tbivm(jt);
+    }
+    MutexLocker ml(SymbolTable_lock, jt);
+    more = the_table()->resize_step(ConcurrentChunkSize);
+  } while (more);
+  end_concurrent_change(&_concurrent_epoch);
+  if (TraceTableResizing) {
+    tty->print_cr("[SymbolTable resized from %d to %d buckets, %d entries]",
+                  old_size, the_table()->table_size(), the_table()->number_of_entries());
+  }
+}
+
+void SymbolTable::clean(JavaThread* jt) {
+  int processed = 0;
+  int removed = 0;
+  int index = 0;
+  begin_concurrent_change(&_concurrent_epoch);
+  while (true) {
+    {
+      MutexLocker ml(SymbolTable_lock, jt);
+      // The table may have been rehashed at a safepoint since the last chunk.
+      SymbolTable* table = the_table();
+      int limit = table->table_size();
+      if (index >= limit) {
+        break;
+      }
+      int end_idx = MIN2(limit, index + ConcurrentChunkSize);
+      removed += table->unlink_dead_entries(index, end_idx, &processed);
+      index = end_idx;
+    }
+    // Let a pending safepoint proceed
+    ThreadBlockInVM tbivm(jt);
+  }
+  end_concurrent_change(&_concurrent_epoch);
+  Atomic::add(processed, &_deferred_processed);
+  Atomic::add(processed, &_symbols_counted);
+  if (TraceTableResizing) {
+    tty->print_cr("[SymbolTable cleaned, %d of %d symbols unlinked]", removed, processed);
+  }
+}
+
+void SymbolTable::do_concurrent_work(JavaThread* jt) {
+  _has_work = false;
+  // A request made after this point sets _has_work again.
+  OrderAccess::fence();
+  grow(jt);
+  if (_needs_cleaning) {
+    _needs_cleaning = false;
+    clean(jt);
+  }
+}
+
+void SymbolTable::free_deferred() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  SymbolTable* table = the_table();
+  table->free_retired_buckets();
+
+  BucketUnlinkContext context;
+  HashtableEntry<Symbol*, mtSymbol>* entry = _unlinked_entries;
+  _unlinked_entries = NULL;
+  while (entry != NULL) {
+    HashtableEntry<Symbol*, mtSymbol>* next = entry->next();
+    Symbol* s = entry->literal();
+    assert(s->is_dead(), "only claimed symbols are unlinked");
+    delete s;
+    context.free_entry(entry);
+    entry = next;
+  }
+  table->bulk_free_entries(&context);
+  Atomic::add(context._num_removed, &_deferred_removed);
+  Atomic::add(context._num_removed, &_symbols_removed);
+}
+
 // Create a new table and using alternate hash code, populate the new table
 // with the existing strings.   Set flag to use the alternate hash code afterwards.
 void SymbolTable::rehash_table() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
   // This should never happen with -Xshare:dump but it might in testing mode.
   if (DumpSharedSpaces) return;
+  // Retried at a later safepoint once the service thread has finished.
+  if (the_table()->is_resizing()) return;
   // Create a new symbol table
   SymbolTable* new_table = new SymbolTable();
 
@@ -208,9 +400,14 @@ Symbol* SymbolTable::lookup(int index, const char* name,
     if (e->hash() == hash) {
       Symbol* sym = e->literal();
       if (sym->equals(name, len)) {
-        // something is referencing this symbol now.
-        sym->increment_refcount();
-        return sym;
+        // something is referencing this symbol now. A symbol with a zero
+        // count may be unlinked concurrently and cannot be revived.
+        if (!ConcurrentSymbolTableCleaning) {
+          sym->increment_refcount();
+          return sym;
+        } else if (sym->try_increment_refcount()) {
+          return sym;
+        }
       }
     }
   }
@@ -294,9 +491,15 @@ Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
 Symbol* SymbolTable::lookup_only(const char* name, int len,
                                    unsigned int& hash) {
   hash = hash_symbol(name, len);
+  jint epoch = OrderAccess::load_acquire(&_concurrent_epoch);
   int index = the_table()->hash_to_index(hash);
 
   Symbol* s = the_table()->lookup(index, name, len, hash);
+  if (s == NULL && may_have_missed_entry(&_concurrent_epoch, epoch)) {
+    MutexLocker ml(SymbolTable_lock);
+    index = the_table()->hash_to_index(hash);
+    s = the_table()->lookup(index, name, len, hash);
+  }
   return s;
 }
 
@@ -402,16 +605,15 @@ Symbol* SymbolTable::basic_add(int index_arg, u1 *name, int len,
   No_Safepoint_Verifier nsv;
 
   // Check if the symbol table has been rehashed, if so, need to recalculate
-  // the hash value and index.
+  // the hash value and index. The index also changes if the table has been
+  // resized since the caller's lookup.
   unsigned int hashValue;
-  int index;
   if (use_alternate_hashcode()) {
     hashValue = hash_symbol((const char*)name, len);
-    index = hash_to_index(hashValue);
   } else {
     hashValue = hashValue_arg;
-    index = index_arg;
   }
+  int index = hash_to_index(hashValue);
 
   // Since look-up was done lock-free, we need to check if another
   // thread beat us in the race to insert the symbol.
@@ -427,7 +629,11 @@ Symbol* SymbolTable::basic_add(int index_arg, u1 *name, int len,
   assert(sym->equals((char*)name, len), "symbol must be properly initialized");
 
   HashtableEntry<Symbol*, mtSymbol>* entry = new_entry(hashValue, sym);
+  prepare_add(index);
   add_entry(index, entry);
+  if (needs_resize(TableResizeLoadFactor)) {
+    request_concurrent_work(&_has_work);
+  }
   return sym;
 }
 
@@ -475,23 +681,30 @@ bool SymbolTable::basic_add(ClassLoaderData* loader_data, constantPoolHandle cp,
       Symbol* sym = allocate_symbol((const u1*)names[i], lengths[i], c_heap, CHECK_(false));
       assert(sym->equals(names[i], lengths[i]), "symbol must be properly initialized");  // why wouldn't it be???
       HashtableEntry<Symbol*, mtSymbol>* entry = new_entry(hashValue, sym);
+      prepare_add(index);
       add_entry(index, entry);
       cp->symbol_at_put(cp_indices[i], sym);
     }
   }
+  if (needs_resize(TableResizeLoadFactor)) {
+    request_concurrent_work(&_has_work);
+  }
   return true;
 }
 
 
 void SymbolTable::verify() {
   for (int i = 0; i < the_table()->table_size(); ++i) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     HashtableEntry<Symbol*, mtSymbol>* p = the_table()->bucket(i);
     for ( ; p != NULL; p = p->next()) {
       Symbol* s = (Symbol*)(p->literal());
       guarantee(s != NULL, "symbol is NULL");
       unsigned int h = hash_symbol((char*)s->bytes(), s->utf8_length());
       guarantee(p->hash() == h, "broken hash in symbol table entry");
-      guarantee(the_table()->hash_to_index(h) == i,
+      guarantee(the_table()->chain_index(h) == i,
                 "wrong index in symbol table");
     }
   }
@@ -524,6 +737,9 @@ void SymbolTable::print_histogram() {
   int memory_total = 0;
   int count = 0;
   for (i = 0; i < the_table()->table_size(); i++) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     HashtableEntry<Symbol*, mtSymbol>* p = the_table()->bucket(i);
     for ( ; p != NULL; p = p->next()) {
       memory_total += p->literal()->size();
@@ -585,6 +801,9 @@ void SymbolTable::print_histogram() {
 
 void SymbolTable::print() {
   for (int i = 0; i < the_table()->table_size(); ++i) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     HashtableEntry<Symbol*, mtSymbol>** p = the_table()->bucket_addr(i);
     HashtableEntry<Symbol*, mtSymbol>* entry = the_table()->bucket(i);
     if (entry != NULL) {
@@ -648,6 +867,14 @@ bool StringTable::_needs_rehashing = false;
 
 volatile int StringTable::_parallel_claimed_idx = 0;
 
+volatile bool StringTable::_has_work = false;
+volatile jint StringTable::_concurrent_epoch = 0;
+
+u4*  StringTable::_shared_buckets = NULL;
+u4*  StringTable::_shared_entries = NULL;
+int  StringTable::_shared_bucket_count = 0;
+bool StringTable::_shared_strings_mapped = false;
+
 // Pick hashing algorithm
 unsigned int StringTable::hash_string(const jchar* s, int len) {
   return use_alternate_hashcode() ? AltHashing::murmur3_32(seed(), s, len) :
@@ -682,16 +909,15 @@ oop StringTable::basic_add(int index_arg, Handle string, jchar* name,
   No_Safepoint_Verifier nsv;
 
   // Check if the symbol table has been rehashed, if so, need to recalculate
-  // the hash value and index before second lookup.
+  // the hash value and index before second lookup. The index also changes
+  // if the table has been resized since the caller's lookup.
   unsigned int hashValue;
-  int index;
   if (use_alternate_hashcode()) {
     hashValue = hash_string(name, len);
-    index = hash_to_index(hashValue);
   } else {
     hashValue = hashValue_arg;
-    index = index_arg;
   }
+  int index = hash_to_index(hashValue);
 
   // Since look-up was done lock-free, we need to check if another
   // thread beat us in the race to insert the symbol.
@@ -703,11 +929,34 @@ oop StringTable::basic_add(int index_arg, Handle string, jchar* name,
   }
 
   HashtableEntry<oop, mtSymbol>* entry = new_entry(hashValue, string());
+  prepare_add(index);
   add_entry(index, entry);
+  if (needs_resize(TableResizeLoadFactor)) {
+    request_concurrent_work(&_has_work);
+  }
   return string();
 }
 
 
+// The shared strings are always live, so unlike the strings of the
+// table proper they need not be reported to the GC.
+oop StringTable::lookup_shared(jchar* name, int len) {
+  if (!_shared_strings_mapped) {
+    return NULL;
+  }
+  unsigned int hash = java_lang_String::hash_code(name, len);
+  unsigned int index = hash % (unsigned int)_shared_bucket_count;
+  for (u4 i = _shared_buckets[index]; i < _shared_buckets[index + 1]; i++) {
+    if (_shared_entries[2 * i] == hash) {
+      oop string = oopDesc::decode_heap_oop_not_null((narrowOop)_shared_entries[2 * i + 1]);
+      if (java_lang_String::equals(string, name, len)) {
+        return string;
+      }
+    }
+  }
+  return NULL;
+}
+
 oop StringTable::lookup(Symbol* symbol) {
   ResourceMark rm;
   int length;
@@ -728,9 +977,20 @@ static void ensure_string_alive(oop string) {
 }
 
 oop StringTable::lookup(jchar* name, int len) {
+  oop shared = lookup_shared(name, len);
+  if (shared != NULL) {
+    return shared;
+  }
+
   unsigned int hash = hash_string(name, len);
+  jint epoch = OrderAccess::load_acquire(&_concurrent_epoch);
   int index = the_table()->hash_to_index(hash);
   oop string = the_table()->lookup(index, name, len, hash);
+  if (string == NULL && may_have_missed_entry(&_concurrent_epoch, epoch)) {
+    MutexLocker ml(StringTable_lock);
+    index = the_table()->hash_to_index(hash);
+    string = the_table()->lookup(index, name, len, hash);
+  }
 
   ensure_string_alive(string);
 
@@ -740,6 +1000,11 @@ oop StringTable::lookup(jchar* name, int len) {
 
 oop StringTable::intern(Handle string_or_null, jchar* name,
                         int len, TRAPS) {
+  oop shared = lookup_shared(name, len);
+  if (shared != NULL) {
+    return shared;
+  }
+
   unsigned int hashValue = hash_string(name, len);
   int index = the_table()->hash_to_index(hashValue);
   oop found_string = the_table()->lookup(index, name, len, hashValue);
@@ -863,6 +1128,10 @@ void StringTable::buckets_oops_do(OopClosure* f, int start_idx, int end_idx) {
                  start_idx, end_idx));
 
   for (int i = start_idx; i < end_idx; i += 1) {
+    if (the_table()->is_redirect(i)) {
+      // The entries are still in the lower bucket.
+      continue;
+    }
     HashtableEntry<oop, mtSymbol>* entry = the_table()->bucket(i);
     while (entry != NULL) {
       assert(!entry->is_shared(), "CDS not used for the StringTable");
@@ -886,6 +1155,9 @@ void StringTable::buckets_unlink_or_oops_do(BoolObjectClosure* is_alive, OopClos
                  start_idx, end_idx));
 
   for (int i = start_idx; i < end_idx; ++i) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     HashtableEntry<oop, mtSymbol>** p = the_table()->bucket_addr(i);
     HashtableEntry<oop, mtSymbol>* entry = the_table()->bucket(i);
     while (entry != NULL) {
@@ -910,6 +1182,44 @@ void StringTable::oops_do(OopClosure* f) {
   buckets_oops_do(f, 0, the_table()->table_size());
 }
 
+void StringTable::grow(JavaThread* jt) {
+  int old_size;
+  {
+    MutexLocker ml(StringTable_lock, jt);
+    if (!the_table()->needs_resize(TableResizeLoadFactor)) {
+      return;
+    }
+    old_size = the_table()->table_size();
+    begin_concurrent_change(&_concurrent_epoch);
+    the_table()->start_resize();
+  }
+  bool more;
+  do {
+    {
+      // Let a pending safepoint proceed
+      ThreadBlockInVM tbivm(jt);
+    }
+    MutexLocker ml(StringTable_lock, jt);
+    more = the_table()->resize_step(ConcurrentChunkSize);
+  } while (more);
+  end_concurrent_change(&_concurrent_epoch);
+  if (TraceTableResizing) {
+    tty->print_cr("[StringTable resized from %d to %d buckets, %d entries]",
+                  old_size, the_table()->table_size(), the_table()->number_of_entries());
+  }
+}
+
+void StringTable::do_concurrent_work(JavaThread* jt) {
+  _has_work = false;
+  OrderAccess::fence();
+  grow(jt);
+}
+
+void StringTable::free_deferred() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  the_table()->free_retired_buckets();
+}
+
 void StringTable::possibly_parallel_oops_do(OopClosure* f) {
   const int limit = the_table()->table_size();
 
@@ -930,13 +1240,16 @@ void StringTable::possibly_parallel_oops_do(OopClosure* f) {
 // See StringTable::verify_and_compare() below for exhaustive verification.
 void StringTable::verify() {
   for (int i = 0; i < the_table()->table_size(); ++i) {
+    if (the_table()->is_redirect(i)) {
+      continue;
+    }
     HashtableEntry<oop, mtSymbol>* p = the_table()->bucket(i);
     for ( ; p != NULL; p = p->next()) {
       oop s = p->literal();
       guarantee(s != NULL, "interned string is NULL");
       unsigned int h = java_lang_String::hash_string(s);
       guarantee(p->hash() == h, "broken hash in string table entry");
-      guarantee(the_table()->hash_to_index(h) == i,
+      guarantee(the_table()->chain_index(h) == i,
                 "wrong index in string table");
     }
   }
@@ -946,6 +1259,170 @@ void StringTable::dump(outputStream* st) {
   the_table()->dump_table(st, "StringTable");
 }
 
+#if INCLUDE_ALL_GCS
+// Write an int[] that covers [mem, mem + words) of the string region
+// image. The image is not in the heap, so the header is written by hand.
+static void write_shared_filler(HeapWord* mem, size_t words) {
+  assert(words >= CollectedHeap::min_fill_size(), "too small for a filler");
+  *(markOop*)mem = markOopDesc::prototype();
+  *(narrowKlass*)((char*)mem + oopDesc::klass_offset_in_bytes()) =
+    Klass::encode_klass_not_null(Universe::intArrayKlassObj());
+  *(jint*)((char*)mem + arrayOopDesc::length_offset_in_bytes()) =
+    (jint)((words * HeapWordSize - arrayOopDesc::base_offset_in_bytes(T_INT)) / sizeof(jint));
+}
+
+// Fill a gap with fillers that are not humongous in any region size.
+static void fill_shared_gap(HeapWord* mem, size_t words, size_t max_words) {
+  const size_t min_words = CollectedHeap::min_fill_size();
+  while (words > max_words) {
+    const size_t cur = (words - max_words) >= min_words ? max_words : max_words - min_words;
+    write_shared_filler(mem, cur);
+    mem += cur;
+    words -= cur;
+  }
+  if (words > 0) {
+    write_shared_filler(mem, words);
+  }
+}
+#endif // INCLUDE_ALL_GCS
+
+char* StringTable::copy_shared_strings(char** top, char* end, MemRegion* range) {
+  assert(DumpSharedSpaces, "dump time only");
+  assert(SafepointSynchronize::is_at_safepoint(), "the strings must not move");
+  ResourceMark rm;
+  *range = MemRegion();
+  char* image = NULL;
+  GrowableArray<oop> strings;
+  GrowableArray<size_t> offsets;
+
+#if INCLUDE_ALL_GCS
+  if (UseCompressedOops && UseCompressedClassPointers) {
+    // The image is laid out in chunks of the smallest G1 region size, so
+    // that no object crosses a region boundary whatever the region size
+    // at run time. A string and its value array are kept in the same
+    // chunk, and strings that might be humongous are left out.
+    const size_t chunk_words = HeapRegionBounds::min_size() / HeapWordSize;
+    const size_t max_words = chunk_words / 2;
+    const size_t min_fill = CollectedHeap::min_fill_size();
+    size_t pos = 0;
+    size_t chunk_end = chunk_words;
+    for (int i = 0; i < the_table()->table_size(); ++i) {
+      if (the_table()->is_redirect(i)) {
+        continue;
+      }
+      for (HashtableEntry<oop, mtSymbol>* p = the_table()->bucket(i); p != NULL; p = p->next()) {
+        oop s = p->literal();
+        typeArrayOop value = java_lang_String::value(s);
+        if (value == NULL) {
+          continue;
+        }
+        size_t words = s->size() + value->size();
+        if (words > max_words) {
+          continue;
+        }
+        size_t remaining = chunk_end - pos;
+        if (words != remaining && words + min_fill > remaining) {
+          // The rest of the chunk is left to a filler.
+          pos = chunk_end;
+          chunk_end += chunk_words;
+        }
+        strings.append(s);
+        offsets.append(pos);
+        pos += words;
+      }
+    }
+
+    size_t image_words = chunk_end;
+    MemRegion heap = Universe::heap()->reserved_region();
+    HeapWord* range_end = (HeapWord*)align_size_down((intptr_t)heap.end(),
+                                                     (intptr_t)HeapRegionBounds::min_size());
+    if (strings.length() > 0 && image_words < pointer_delta(range_end, heap.start())) {
+      *range = MemRegion(range_end - image_words, image_words);
+      image = NEW_C_HEAP_ARRAY(char, image_words * HeapWordSize, mtClassShared);
+      memset(image, 0, image_words * HeapWordSize);
+
+      HeapWord* base = (HeapWord*)image;
+      pos = 0;
+      for (int i = 0; i < strings.length(); i++) {
+        oop s = strings.at(i);
+        typeArrayOop value = java_lang_String::value(s);
+        size_t offset = offsets.at(i);
+        fill_shared_gap(base + pos, offset - pos, max_words);
+
+        HeapWord* s_copy = base + offset;
+        HeapWord* value_copy = s_copy + s->size();
+        Copy::aligned_disjoint_words((HeapWord*)s, s_copy, s->size());
+        Copy::aligned_disjoint_words((HeapWord*)value, value_copy, value->size());
+        *(markOop*)s_copy = markOopDesc::prototype();
+        *(markOop*)value_copy = markOopDesc::prototype();
+        oop value_target = (oop)(range->start() + (value_copy - base));
+        *(narrowOop*)((char*)s_copy + java_lang_String::value_offset_in_bytes()) =
+          oopDesc::encode_heap_oop_not_null(value_target);
+        if (java_lang_String::has_hash_field()) {
+          *(jint*)((char*)s_copy + java_lang_String::hash_offset_in_bytes()) =
+            (jint)java_lang_String::hash_code(s);
+        }
+        pos = offset + s->size() + value->size();
+      }
+      fill_shared_gap(base + pos, image_words - pos, max_words);
+    } else {
+      strings.clear();
+    }
+  }
+#endif // INCLUDE_ALL_GCS
+
+  // The table that finds the archived strings. Entries are bucketed by
+  // String.hashCode, which does not change with the table's hash seed.
+  int count = strings.length();
+  int bucket_count = count == 0 ? 0 : count / 2 + 1;
+  size_t len = sizeof(intptr_t);
+  if (bucket_count > 0) {
+    len += (bucket_count + 1 + 2 * count) * sizeof(u4);
+  }
+  len = align_size_up(len, sizeof(intptr_t));
+  if (*top + sizeof(intptr_t) + len > end) {
+    report_out_of_shared_space(SharedMiscData);
+  }
+  *(intptr_t*)(*top) = len;
+  *top += sizeof(intptr_t);
+  *(intptr_t*)(*top) = bucket_count;
+
+  if (bucket_count > 0) {
+    u4* buckets = (u4*)(*top + sizeof(intptr_t));
+    u4* entries = buckets + bucket_count + 1;
+    memset(buckets, 0, (bucket_count + 1) * sizeof(u4));
+    for (int i = 0; i < count; i++) {
+      buckets[java_lang_String::hash_code(strings.at(i)) % (unsigned int)bucket_count + 1]++;
+    }
+    for (int b = 0; b < bucket_count; b++) {
+      buckets[b + 1] += buckets[b];
+    }
+    u4* next = NEW_C_HEAP_ARRAY(u4, bucket_count, mtClassShared);
+    memcpy(next, buckets, bucket_count * sizeof(u4));
+    for (int i = 0; i < count; i++) {
+      unsigned int hash = java_lang_String::hash_code(strings.at(i));
+      u4 e = next[hash % (unsigned int)bucket_count]++;
+      oop target = (oop)(range->start() + offsets.at(i));
+      entries[2 * e] = hash;
+      entries[2 * e + 1] = oopDesc::encode_heap_oop_not_null(target);
+    }
+    FREE_C_HEAP_ARRAY(u4, next, mtClassShared);
+  }
+  *top += len;
+  return image;
+}
+
+char* StringTable::restore_shared_table(char* buffer) {
+  intptr_t len = *(intptr_t*)buffer;
+  buffer += sizeof(intptr_t);
+  _shared_bucket_count = (int)*(intptr_t*)buffer;
+  if (_shared_bucket_count > 0) {
+    _shared_buckets = (u4*)(buffer + sizeof(intptr_t));
+    _shared_entries = _shared_buckets + _shared_bucket_count + 1;
+  }
+  return buffer + len;
+}
+
 StringTable::VerifyRetTypes StringTable::compare_entries(
                                       int bkt1, int e_cnt1,
                                       HashtableEntry<oop, mtSymbol>* e_ptr1,
@@ -1007,11 +1484,11 @@ StringTable::VerifyRetTypes StringTable::verify_entry(int bkt, int e_cnt,
     ret = _verify_fail_continue;
   }
 
-  if (the_table()->hash_to_index(h) != bkt) {
+  if (the_table()->chain_index(h) != bkt) {
     if (mesg_mode == _verify_with_mesgs) {
       tty->print_cr("ERROR: wrong index value for entry @ bucket[%d][%d], "
                     "str_hash=%d, hash_to_index=%d", bkt, e_cnt, h,
-                    the_table()->hash_to_index(h));
+                    the_table()->chain_index(h));
     }
     ret = _verify_fail_continue;
   }
@@ -1041,6 +1518,9 @@ int StringTable::verify_and_compare_entries() {
 
   // first, verify all the entries individually:
   for (int bkt = 0; bkt < the_table()->table_size(); bkt++) {
+    if (the_table()->is_redirect(bkt)) {
+      continue;
+    }
     HashtableEntry<oop, mtSymbol>* e_ptr = the_table()->bucket(bkt);
     for (int e_cnt = 0; e_ptr != NULL; e_ptr = e_ptr->next(), e_cnt++) {
       VerifyRetTypes ret = verify_entry(bkt, e_cnt, e_ptr, _verify_with_mesgs);
@@ -1061,6 +1541,9 @@ int StringTable::verify_and_compare_entries() {
 
   // second, verify all entries relative to each other:
   for (int bkt1 = 0; bkt1 < the_table()->table_size(); bkt1++) {
+    if (the_table()->is_redirect(bkt1)) {
+      continue;
+    }
     HashtableEntry<oop, mtSymbol>* e_ptr1 = the_table()->bucket(bkt1);
     for (int e_cnt1 = 0; e_ptr1 != NULL; e_ptr1 = e_ptr1->next(), e_cnt1++) {
       if (need_entry_verify) {
@@ -1073,6 +1556,9 @@ int StringTable::verify_and_compare_entries() {
       }
 
       for (int bkt2 = bkt1; bkt2 < the_table()->table_size(); bkt2++) {
+        if (the_table()->is_redirect(bkt2)) {
+          continue;
+        }
         HashtableEntry<oop, mtSymbol>* e_ptr2 = the_table()->bucket(bkt2);
         int e_cnt2;
         for (e_cnt2 = 0; e_ptr2 != NULL; e_ptr2 = e_ptr2->next(), e_cnt2++) {
@@ -1109,6 +1595,8 @@ void StringTable::rehash_table() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
   // This should never happen with -Xshare:dump but it might in testing mode.
   if (DumpSharedSpaces) return;
+  // Retried at a later safepoint once the service thread has finished.
+  if (the_table()->is_resizing()) return;
   StringTable* new_table = new StringTable();
 
   // Rehash the table
@@ -40,6 +40,7 @@
 //  - symbolTableEntrys are allocated in blocks to reduce the space overhead.
 
 class BoolObjectClosure;
+class MemRegion;
 class outputStream;
 
 
@@ -89,6 +90,24 @@ private:
   static int _symbols_removed;
   static int _symbols_counted;
 
+  // Resizing and cleaning by the service thread. While either is in
+  // progress the epoch is odd, and a lock-free lookup that fails during
+  // or across such a change is retried under the SymbolTable_lock.
+  static volatile bool _has_work;
+  static volatile bool _needs_cleaning;
+  static volatile jint _concurrent_epoch;
+  // Entries of dead symbols unlinked by the service thread. Lock-free
+  // readers may still be looking at them until the next safepoint.
+  static HashtableEntry<Symbol*, mtSymbol>* _unlinked_entries;
+  // Symbols scanned and freed by the service thread and not yet reported
+  // to a GC by unlink().
+  static volatile jint _deferred_processed;
+  static volatile jint _deferred_removed;
+
+  static void grow(JavaThread* jt);
+  static void clean(JavaThread* jt);
+  int unlink_dead_entries(int start_idx, int end_idx, int* processed);
+
   Symbol* allocate_symbol(const u1* name, int len, bool c_heap, TRAPS); // Assumes no characters larger than 0x7F
 
   // Adding elements
@@ -194,6 +213,12 @@ public:
   // Release any dead symbols, possibly parallel version
   static void possibly_parallel_unlink(int* processed, int* removed);
 
+  // Concurrent resizing and cleaning, done by the service thread
+  static bool has_work()                { return _has_work; }
+  static void do_concurrent_work(JavaThread* jt);
+  // Frees what the concurrent work has unlinked. Called at a safepoint.
+  static void free_deferred();
+
   // iterate over symbols
   static void symbols_do(SymbolClosure *cl);
 
@@ -268,6 +293,23 @@ private:
   // Claimed high water mark for parallel chunked scanning
   static volatile int _parallel_claimed_idx;
 
+  // Resizing by the service thread, see SymbolTable
+  static volatile bool _has_work;
+  static volatile jint _concurrent_epoch;
+
+  // Read-only table of the strings mapped from the CDS archive. It is
+  // laid out in the misc data region: _shared_buckets[i] is the index of
+  // the first entry of bucket i, and each entry is a pair of the
+  // String.hashCode value and the compressed oop of the string.
+  static u4*  _shared_buckets;
+  static u4*  _shared_entries;
+  static int  _shared_bucket_count;
+  static bool _shared_strings_mapped;
+
+  static oop lookup_shared(jchar* name, int len);
+
+  static void grow(JavaThread* jt);
+
   static oop intern(Handle string_or_null, jchar* chars, int length, TRAPS);
   oop basic_add(int index, Handle string_or_null, jchar* name, int len,
                 unsigned int hashValue, TRAPS);
@@ -329,6 +371,13 @@ public:
   }
   static void possibly_parallel_oops_do(OopClosure* f);
 
+  // Concurrent resizing, done by the service thread. Dead entries are
+  // only removed by the GC, which decides whether the strings are alive.
+  static bool has_work()                { return _has_work; }
+  static void do_concurrent_work(JavaThread* jt);
+  // Frees the bucket array replaced by a resize. Called at a safepoint.
+  static void free_deferred();
+
   // Hashing algorithm, used as the hash value used by the
   //     StringTable for bucket selection and comparison (stored in the
   //     HashtableEntry structures).  This is used in the String.intern() method.
@@ -381,6 +430,16 @@ public:
     the_table()->Hashtable<oop, mtSymbol>::reverse();
   }
 
+  // Copy the interned strings into a heap image for the CDS string
+  // region and write the table that finds them at *top. The image is
+  // laid out to be mapped at the top of the heap; returns it, or NULL if
+  // no string was archived. range is set to where it is to be mapped.
+  static char* copy_shared_strings(char** top, char* end, MemRegion* range);
+  static char* restore_shared_table(char* buffer);
+  // The shared table is only used once the string region is mapped.
+  static void set_shared_strings_mapped() { _shared_strings_mapped = true; }
+  static bool shared_strings_mapped()     { return _shared_strings_mapped; }
+
   // Rehash the symbol table if it gets out of balance
   static void rehash_table();
   static bool needs_rehashing() { return _needs_rehashing; }
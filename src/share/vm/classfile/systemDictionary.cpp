@@ -471,6 +471,17 @@ void SystemDictionary::validate_protection_domain(instanceKlassHandle klass,
     unsigned int d_hash = dictionary()->compute_hash(kn, loader_data);
     int d_index = dictionary()->hash_to_index(d_hash);
 
+    // Another thread may have validated the same protection domain
+    // while we were in java; the pd_set can be read without the lock.
+    {
+      No_Safepoint_Verifier nosafepoint;
+      if (dictionary()->is_valid_protection_domain(d_index, d_hash, kn,
+                                                   loader_data,
+                                                   protection_domain)) {
+        return;
+      }
+    }
+
     MutexLocker mu(SystemDictionary_lock, THREAD);
     {
       // Note that we have an entry, and entries can be deleted only during GC,
@@ -649,6 +660,18 @@ Klass* SystemDictionary::resolve_instance_class_or_null(Symbol* name,
                                       protection_domain, THREAD);
   if (probe != NULL) return probe;
 
+  // The class may be loaded already, but not yet checked against this
+  // protection domain. That needs neither the loader lock nor
+  // SystemDictionary_lock, only the package access check.
+  probe = dictionary()->find_class_lock_free(d_index, d_hash, name, loader_data);
+  if (probe != NULL) {
+    instanceKlassHandle k(THREAD, probe);
+    if (protection_domain() != NULL) {
+      validate_protection_domain(k, class_loader, protection_domain, CHECK_NULL);
+    }
+    return k();
+  }
+
 
   // Non-bootstrap class loaders will call out to class loader and
   // define via jvm/jni_DefineClass which will acquire the
@@ -897,7 +920,6 @@ Klass* SystemDictionary::resolve_instance_class_or_null(Symbol* name,
 
   // Check the protection domain has the right access
   {
-    MutexLocker mu(SystemDictionary_lock, THREAD);
     // Note that we have an entry, and entries can be deleted only during GC,
     // so we cannot allow GC to occur while we're holding this entry.
     // We're using a No_Safepoint_Verifier to catch any place where we
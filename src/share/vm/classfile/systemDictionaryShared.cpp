@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.inline.hpp"
+#include "classfile/classLoaderExt.hpp"
+#include "classfile/javaClasses.hpp"
+#include "classfile/sharedClassUtil.hpp"
+#include "classfile/systemDictionaryShared.hpp"
+#include "classfile/vmSymbols.hpp"
+#include "memory/filemap.hpp"
+#include "memory/metadataFactory.hpp"
+#include "memory/oopFactory.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/objArrayOop.hpp"
+#include "oops/typeArrayOop.hpp"
+#include "runtime/javaCalls.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/synchronizer.hpp"
+
+objArrayOop SystemDictionaryShared::_shared_protection_domains = NULL;
+objArrayOop SystemDictionaryShared::_shared_jar_urls           = NULL;
+objArrayOop SystemDictionaryShared::_shared_jar_manifests      = NULL;
+GrowableArray<Klass*>* SystemDictionaryShared::_classes_with_constraints = NULL;
+
+void SystemDictionaryShared::initialize(TRAPS) {
+  if (UseSharedSpaces && UseAppCDS) {
+    int n = FileMapInfo::get_number_of_share_classpaths();
+    _shared_protection_domains =
+      oopFactory::new_objArray(SystemDictionary::ProtectionDomain_klass(), n, CHECK);
+    _shared_jar_urls =
+      oopFactory::new_objArray(SystemDictionary::URL_klass(), n, CHECK);
+    _shared_jar_manifests =
+      oopFactory::new_objArray(SystemDictionary::Jar_Manifest_klass(), n, CHECK);
+  }
+}
+
+void SystemDictionaryShared::roots_oops_do(OopClosure* blk) {
+  blk->do_oop((oop*)&_shared_protection_domains);
+  blk->do_oop((oop*)&_shared_jar_urls);
+  blk->do_oop((oop*)&_shared_jar_manifests);
+}
+
+void SystemDictionaryShared::oops_do(OopClosure* f) {
+  f->do_oop((oop*)&_shared_protection_domains);
+  f->do_oop((oop*)&_shared_jar_urls);
+  f->do_oop((oop*)&_shared_jar_manifests);
+}
+
+// Allocates an instance of k and runs the constructor with the given
+// signature and arguments.
+static Handle new_instance(Klass* k, Symbol* signature, JavaCallArguments* args, TRAPS) {
+  instanceKlassHandle klass(THREAD, k);
+  klass->initialize(CHECK_NH);
+  Handle obj = klass->allocate_instance_handle(CHECK_NH);
+  args->set_receiver(obj);
+  JavaValue result(T_VOID);
+  JavaCalls::call_special(&result, klass, vmSymbols::object_initializer_name(),
+                          signature, args, CHECK_NH);
+  return obj;
+}
+
+// The URL the system class loader uses as the code source of the jar.
+Handle SystemDictionaryShared::get_shared_jar_url(int shared_path_index, TRAPS) {
+  if (_shared_jar_urls->obj_at(shared_path_index) == NULL) {
+    const char* path = FileMapInfo::shared_classpath_name(shared_path_index);
+    Handle path_string = java_lang_String::create_from_str(path, CHECK_NH);
+    JavaCallArguments file_args;
+    file_args.push_oop(path_string);
+    Handle file = new_instance(SystemDictionary::File_klass(),
+                               vmSymbols::string_void_signature(), &file_args, CHECK_NH);
+
+    JavaValue result(T_OBJECT);
+    JavaCalls::call_static(&result,
+                           KlassHandle(THREAD, SystemDictionary::sun_misc_Launcher_klass()),
+                           vmSymbols::getFileURL_name(),
+                           vmSymbols::getFileURL_signature(),
+                           file, CHECK_NH);
+    _shared_jar_urls->obj_at_put(shared_path_index, (oop)result.get_jobject());
+  }
+  return Handle(THREAD, _shared_jar_urls->obj_at(shared_path_index));
+}
+
+// The archived manifest of the jar as a java.util.jar.Manifest, or a
+// null handle if the jar has none.
+Handle SystemDictionaryShared::get_shared_jar_manifest(int shared_path_index, TRAPS) {
+  if (_shared_jar_manifests->obj_at(shared_path_index) == NULL) {
+    Array<u1>* src = SharedClassUtil::shared_classpath(shared_path_index)->_manifest;
+    if (src == NULL) {
+      return Handle();
+    }
+    int size = src->length() - 1; // without the trailing NUL
+    typeArrayOop buf = oopFactory::new_byteArray(size, CHECK_NH);
+    typeArrayHandle bufhandle(THREAD, buf);
+    if (size > 0) {
+      memcpy(bufhandle->byte_at_addr(0), src->adr_at(0), size);
+    }
+
+    JavaCallArguments bais_args;
+    bais_args.push_oop(bufhandle);
+    Handle bais = new_instance(SystemDictionary::ByteArrayInputStream_klass(),
+                               vmSymbols::byte_array_void_signature(), &bais_args, CHECK_NH);
+
+    JavaCallArguments manifest_args;
+    manifest_args.push_oop(bais);
+    Handle manifest = new_instance(SystemDictionary::Jar_Manifest_klass(),
+                                   vmSymbols::input_stream_void_signature(), &manifest_args, CHECK_NH);
+    _shared_jar_manifests->obj_at_put(shared_path_index, manifest());
+  }
+  return Handle(THREAD, _shared_jar_manifests->obj_at(shared_path_index));
+}
+
+// The same protection domain SecureClassLoader.defineClass() would use
+// for a class of the jar.
+Handle SystemDictionaryShared::get_shared_protection_domain(Handle class_loader,
+                                                            int shared_path_index,
+                                                            Handle url, TRAPS) {
+  if (_shared_protection_domains->obj_at(shared_path_index) == NULL) {
+    // The classes of signed jars are not archived.
+    JavaCallArguments cs_args;
+    cs_args.push_oop(url);
+    cs_args.push_oop(Handle());
+    Handle cs = new_instance(SystemDictionary::CodeSource_klass(),
+                             vmSymbols::url_code_signer_array_void_signature(), &cs_args, CHECK_NH);
+
+    JavaValue result(T_OBJECT);
+    JavaCalls::call_special(&result, class_loader,
+                            KlassHandle(THREAD, SystemDictionary::SecureClassLoader_klass()),
+                            vmSymbols::getProtectionDomain_name(),
+                            vmSymbols::getProtectionDomain_signature(),
+                            cs, CHECK_NH);
+    _shared_protection_domains->obj_at_put(shared_path_index, (oop)result.get_jobject());
+  }
+  return Handle(THREAD, _shared_protection_domains->obj_at(shared_path_index));
+}
+
+// Defines the package of the class like URLClassLoader.defineClass()
+// does, including the sealing check.
+void SystemDictionaryShared::define_shared_package(Symbol* class_name,
+                                                   Handle class_loader,
+                                                   Handle manifest,
+                                                   Handle url, TRAPS) {
+  ResourceMark rm(THREAD);
+  const char* name = class_name->as_klass_external_name();
+  const char* last = strrchr(name, '.');
+  if (last == NULL) {
+    // Unnamed package
+    return;
+  }
+  int len = (int)(last - name);
+  char* pkgname = NEW_RESOURCE_ARRAY(char, len + 1);
+  strncpy(pkgname, name, len);
+  pkgname[len] = '\0';
+  Handle pkgname_string = java_lang_String::create_from_str(pkgname, CHECK);
+
+  JavaCallArguments args(class_loader);
+  args.push_oop(pkgname_string);
+  args.push_oop(manifest);
+  args.push_oop(url);
+  JavaValue result(T_VOID);
+  JavaCalls::call_special(&result,
+                          KlassHandle(THREAD, SystemDictionary::URLClassLoader_klass()),
+                          vmSymbols::definePackageInternal_name(),
+                          vmSymbols::definePackageInternal_signature(),
+                          &args, CHECK);
+}
+
+instanceKlassHandle SystemDictionaryShared::find_or_load_shared_class(
+                 Symbol* class_name, Handle class_loader, TRAPS) {
+  instanceKlassHandle nh = instanceKlassHandle(); // null Handle
+  if (!UseSharedSpaces || !UseAppCDS || !is_app_class_loader(class_loader)) {
+    return nh;
+  }
+
+  instanceKlassHandle ik(THREAD, find_shared_class(class_name));
+  if (ik.is_null() || !SharedClassUtil::is_shared_app_class(ik())) {
+    return nh;
+  }
+
+  ClassLoaderData* loader_data = register_loader(class_loader, CHECK_(nh));
+  unsigned int d_hash = dictionary()->compute_hash(class_name, loader_data);
+  int d_index = dictionary()->hash_to_index(d_hash);
+
+  // The system class loader is parallel capable. ClassLoader.loadClass()
+  // calls findLoadedClass() while holding the lock for the class name,
+  // which keeps other threads from loading the class meanwhile.
+  Handle lockObject = compute_loader_lock_object(class_loader, THREAD);
+  check_loader_lock_contention(lockObject, THREAD);
+  ObjectLocker ol(lockObject, THREAD, !is_parallelCapable(class_loader));
+
+  {
+    MutexLocker mu(SystemDictionary_lock, THREAD);
+    Klass* check = find_class(d_index, d_hash, class_name, loader_data);
+    if (check != NULL) {
+      return instanceKlassHandle(THREAD, check);
+    }
+    if (ik->class_loader_data() != NULL) {
+      // An earlier attempt restored the class but failed to define it.
+      // The loader reads the class from the jar instead.
+      return nh;
+    }
+  }
+
+  int index = ik->shared_classpath_index();
+  Handle url = get_shared_jar_url(index, CHECK_(nh));
+  Handle manifest = get_shared_jar_manifest(index, CHECK_(nh));
+  Handle protection_domain = get_shared_protection_domain(class_loader, index, url, CHECK_(nh));
+  define_shared_package(class_name, class_loader, manifest, url, CHECK_(nh));
+
+  ik = load_shared_class(ik, class_loader, protection_domain, CHECK_(nh));
+  if (ik.not_null()) {
+    ik = find_or_define_instance_class(class_name, class_loader, ik, CHECK_(nh));
+  }
+  return ik;
+}
+
+SharedDictionaryEntry* SystemDictionaryShared::find_shared_entry(Klass* k) {
+  if (DumpSharedSpaces) {
+    // The archived classes are all loaded by the boot loader while dumping.
+    return (SharedDictionaryEntry*)dictionary()->find_shared_entry(
+             k->name(), ClassLoaderData::the_null_class_loader_data());
+  } else {
+    return (SharedDictionaryEntry*)shared_dictionary()->find_shared_entry(k->name(), NULL);
+  }
+}
+
+void SystemDictionaryShared::add_verification_dependency(Klass* k, Symbol* accessor_clsname,
+                                                         Symbol* target_clsname) {
+  assert(DumpSharedSpaces, "called only while dumping");
+  if (!SharedClassUtil::is_shared_app_class(k)) {
+    return;
+  }
+
+  SharedDictionaryEntry* entry = find_shared_entry(k);
+  assert(entry != NULL && entry->klass() == k, "class being verified must be defined");
+  GrowableArray<Symbol*>* constraints = entry->_dump_time_constraints;
+  if (constraints == NULL) {
+    constraints = new (ResourceObj::C_HEAP, mtClass) GrowableArray<Symbol*>(4, true, mtClass);
+    entry->_dump_time_constraints = constraints;
+    if (_classes_with_constraints == NULL) {
+      _classes_with_constraints = new (ResourceObj::C_HEAP, mtClass) GrowableArray<Klass*>(100, true, mtClass);
+    }
+    _classes_with_constraints->append(k);
+  }
+
+  for (int i = 0; i < constraints->length(); i += 2) {
+    if (constraints->at(i) == accessor_clsname && constraints->at(i + 1) == target_clsname) {
+      return;
+    }
+  }
+  accessor_clsname->increment_refcount();
+  target_clsname->increment_refcount();
+  constraints->append(accessor_clsname);
+  constraints->append(target_clsname);
+}
+
+void SystemDictionaryShared::finalize_verification_dependencies() {
+  if (_classes_with_constraints == NULL) {
+    return;
+  }
+
+  EXCEPTION_MARK; // The allocation should never fail, but would exit VM on error.
+  ClassLoaderData* loader_data = ClassLoaderData::the_null_class_loader_data();
+  for (int i = 0; i < _classes_with_constraints->length(); i++) {
+    Klass* k = _classes_with_constraints->at(i);
+    SharedDictionaryEntry* entry = find_shared_entry(k);
+    if (entry == NULL || entry->klass() != k) {
+      // Removed because it failed verification
+      continue;
+    }
+    GrowableArray<Symbol*>* constraints = entry->_dump_time_constraints;
+    Array<Symbol*>* archived = MetadataFactory::new_array<Symbol*>(loader_data, constraints->length(), THREAD);
+    for (int j = 0; j < constraints->length(); j++) {
+      archived->at_put(j, constraints->at(j));
+    }
+    entry->_verifier_constraints = archived;
+    entry->_dump_time_constraints = NULL;
+    delete constraints;
+  }
+}
+
+bool SystemDictionaryShared::check_verification_dependencies(Klass* k, Handle class_loader,
+                                                             Handle protection_domain,
+                                                             char** message_buffer, TRAPS) {
+  if (!SharedClassUtil::is_shared_app_class(k)) {
+    return true;
+  }
+
+  SharedDictionaryEntry* entry = find_shared_entry(k);
+  assert(entry != NULL && entry->klass() == k, "archived class must be in the shared dictionary");
+  Array<Symbol*>* constraints = entry->_verifier_constraints;
+  if (constraints == NULL) {
+    return true;
+  }
+
+  for (int i = 0; i < constraints->length(); i += 2) {
+    Klass* accessor = SystemDictionary::resolve_or_fail(constraints->at(i),
+                        class_loader, protection_domain, true, CHECK_false);
+    Klass* target = SystemDictionary::resolve_or_fail(constraints->at(i + 1),
+                        class_loader, protection_domain, true, CHECK_false);
+    // The verifier treats interfaces as java.lang.Object.
+    if (!target->is_interface() && !accessor->is_subclass_of(target)) {
+      const char* fmt = "Bad type on operand stack in %s: %s is not assignable to %s";
+      size_t len = strlen(fmt) + strlen(k->external_name()) +
+                   strlen(accessor->external_name()) + strlen(target->external_name());
+      *message_buffer = NEW_RESOURCE_ARRAY(char, len);
+      jio_snprintf(*message_buffer, len, fmt, k->external_name(),
+                   accessor->external_name(), target->external_name());
+      return false;
+    }
+  }
+  return true;
+}
@@ -28,37 +28,88 @@
 
 #include "classfile/dictionary.hpp"
 #include "classfile/systemDictionary.hpp"
+#include "utilities/growableArray.hpp"
+
+// The entries of the shared dictionary also hold the verification
+// constraints of the archived app classes: pairs of class names
+// (accessor, target) where the verifier needed accessor to be a subclass
+// of target.
+class SharedDictionaryEntry : public DictionaryEntry {
+  friend class SystemDictionaryShared;
+ private:
+  // Collected while dumping; moved to _verifier_constraints before the
+  // dictionary is archived.
+  GrowableArray<Symbol*>* _dump_time_constraints;
+  Array<Symbol*>*         _verifier_constraints;
+
+ public:
+  void init() {
+    _dump_time_constraints = NULL;
+    _verifier_constraints = NULL;
+  }
+};
 
 class SystemDictionaryShared: public SystemDictionary {
+private:
+#if INCLUDE_CDS
+  // Java objects of the app class path jars, indexed by shared path index.
+  static objArrayOop _shared_protection_domains;
+  static objArrayOop _shared_jar_urls;
+  static objArrayOop _shared_jar_manifests;
+
+  // Classes that got verification constraints while dumping.
+  static GrowableArray<Klass*>* _classes_with_constraints;
+
+  static bool is_app_class_loader(Handle class_loader) {
+    return class_loader.not_null() &&
+           class_loader->klass() == SystemDictionary::sun_misc_Launcher_AppClassLoader_klass();
+  }
+
+  static Handle get_shared_jar_url(int shared_path_index, TRAPS);
+  static Handle get_shared_jar_manifest(int shared_path_index, TRAPS);
+  static Handle get_shared_protection_domain(Handle class_loader,
+                                             int shared_path_index,
+                                             Handle url, TRAPS);
+  static void define_shared_package(Symbol* class_name, Handle class_loader,
+                                    Handle manifest, Handle url, TRAPS);
+  static SharedDictionaryEntry* find_shared_entry(Klass* k);
+#endif
+
 public:
-  static void initialize(TRAPS) {}
+  static void initialize(TRAPS) NOT_CDS_RETURN;
+
+  // Loads an archived app class for the system class loader, called when
+  // the class is not yet in the loader's dictionary.
   static instanceKlassHandle find_or_load_shared_class(Symbol* class_name,
                                                        Handle class_loader,
-                                                       TRAPS) {
-    return instanceKlassHandle();
-  }
-  static void roots_oops_do(OopClosure* blk) {}
-  static void oops_do(OopClosure* f) {}
+                                                       TRAPS) NOT_CDS_RETURN_(instanceKlassHandle());
+  static void roots_oops_do(OopClosure* blk) NOT_CDS_RETURN;
+  static void oops_do(OopClosure* f) NOT_CDS_RETURN;
   static bool is_sharing_possible(ClassLoaderData* loader_data) {
     oop class_loader = loader_data->class_loader();
-    return (class_loader == NULL);
+    return (class_loader == NULL ||
+            (UseAppCDS &&
+             class_loader->klass() == SystemDictionary::sun_misc_Launcher_AppClassLoader_klass()));
   }
 
   static size_t dictionary_entry_size() {
-    return sizeof(DictionaryEntry);
+    return sizeof(SharedDictionaryEntry);
+  }
+  static void init_shared_dictionary_entry(Klass* k, DictionaryEntry* entry) {
+    ((SharedDictionaryEntry*)entry)->init();
   }
-  static void init_shared_dictionary_entry(Klass* k, DictionaryEntry* entry) {}
 
-  // The (non-application) CDS implementation supports only classes in the boot
-  // class loader, which ensures that the verification dependencies are the same
-  // during archive creation time and runtime. Thus we can do the dependency checks
-  // entirely during archive creation time.
+  // The boot class path is the same during archive creation time and
+  // runtime, so the verification dependencies of boot classes are checked
+  // entirely during archive creation time. The app classes are resolved by
+  // the system class loader at run time, so their dependencies are
+  // recorded and checked again when they are linked.
   static void add_verification_dependency(Klass* k, Symbol* accessor_clsname,
-                                          Symbol* target_clsname) {}
-  static void finalize_verification_dependencies() {}
+                                          Symbol* target_clsname) NOT_CDS_RETURN;
+  static void finalize_verification_dependencies() NOT_CDS_RETURN;
   static bool check_verification_dependencies(Klass* k, Handle class_loader,
                                               Handle protection_domain,
-                                              char** message_buffer, TRAPS) {return true;}
+                                              char** message_buffer, TRAPS) NOT_CDS_RETURN_(true);
 };
 
 #endif // SHARE_VM_CLASSFILE_SYSTEMDICTIONARYSHARED_HPP
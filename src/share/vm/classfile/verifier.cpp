@@ -94,6 +94,11 @@ static void* verify_byte_codes_fn() {
 // Methods in Verifier
 
 bool Verifier::should_verify_for(oop class_loader, bool should_verify_class) {
+  if (DumpSharedSpaces && class_loader == NULL && should_verify_class) {
+    // Classes of the app class path are loaded by the boot loader while
+    // dumping, but are verified as the system class loader would.
+    return BytecodeVerificationRemote;
+  }
   return (class_loader == NULL JVMCI_ONLY(|| SystemDictionary::in_jvmci_loader_hierarchy(class_loader)) || !should_verify_class) ?
     BytecodeVerificationLocal : BytecodeVerificationRemote;
 }
@@ -42,9 +42,11 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/arguments.hpp"
 #include "runtime/deoptimization.hpp"
+#include "runtime/globals_extension.hpp"
 #include "runtime/icache.hpp"
 #include "runtime/java.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/sweeper.hpp"
 #include "services/memoryService.hpp"
 #include "trace/tracing.hpp"
 #include "utilities/xmlstream.hpp"
@@ -116,9 +118,19 @@ class CodeBlob_sizes {
   }
 };
 
+// Iteration over CodeHeaps and over the CodeBlobs of each CodeHeap in turn
+
+#define FOR_ALL_HEAPS(heap)              for (GrowableArrayIterator<CodeHeap*> heap = _heaps->begin(); heap != _heaps->end(); ++heap)
+#define FOR_ALL_NMETHOD_HEAPS(heap)      FOR_ALL_HEAPS(heap) if (heap_accepts_nmethods(*heap))
+#define FOR_ALL_BLOBS(var)               FOR_ALL_HEAPS(heap) for (CodeBlob *var = first_blob(*heap); var != NULL; var = next_blob(*heap, var))
+#define FOR_ALL_ALIVE_BLOBS(var)         FOR_ALL_HEAPS(heap) for (CodeBlob *var = alive(*heap, first_blob(*heap)); var != NULL; var = alive(*heap, next_blob(*heap, var)))
+#define FOR_ALL_ALIVE_NMETHODS(var)      FOR_ALL_NMETHOD_HEAPS(heap) for (nmethod *var = alive_nmethod(*heap, first_blob(*heap)); var != NULL; var = alive_nmethod(*heap, next_blob(*heap, var)))
+
 // CodeCache implementation
 
-CodeHeap * CodeCache::_heap = new CodeHeap();
+GrowableArray<CodeHeap*>* CodeCache::_heaps = new(ResourceObj::C_HEAP, mtCode) GrowableArray<CodeHeap*>(CodeBlobType::All, true, mtCode);
+address CodeCache::_low_bound = NULL;
+address CodeCache::_high_bound = NULL;
 int CodeCache::_number_of_blobs = 0;
 int CodeCache::_number_of_adapters = 0;
 int CodeCache::_number_of_nmethods = 0;
@@ -128,15 +140,66 @@ nmethod* CodeCache::_scavenge_root_nmethods = NULL;
 
 int CodeCache::_codemem_full_count = 0;
 
+CodeHeap* CodeCache::get_code_heap(const CodeBlob* cb) {
+  CodeHeap* heap = get_code_heap_containing((void*)cb);
+  assert(heap != NULL, "CodeBlob must be in a code heap");
+  return heap;
+}
+
+CodeHeap* CodeCache::get_code_heap(int code_blob_type) {
+  FOR_ALL_HEAPS(heap) {
+    if (heap_accepts(*heap, code_blob_type)) {
+      return *heap;
+    }
+  }
+  return NULL;
+}
+
+CodeBlob* CodeCache::first_blob(CodeHeap* heap) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  return (CodeBlob*)heap->first();
+}
+
+CodeBlob* CodeCache::next_blob(CodeHeap* heap, CodeBlob* cb) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  return (CodeBlob*)heap->next(cb);
+}
+
+CodeBlob* CodeCache::alive(CodeHeap* heap, CodeBlob* cb) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  while (cb != NULL && !cb->is_alive()) cb = next_blob(heap, cb);
+  return cb;
+}
+
+nmethod* CodeCache::alive_nmethod(CodeHeap* heap, CodeBlob* cb) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next_blob(heap, cb);
+  return (nmethod*)cb;
+}
+
+// Iteration over all CodeBlobs, one code heap after the other
+
 CodeBlob* CodeCache::first() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->first();
+  FOR_ALL_HEAPS(heap) {
+    CodeBlob* cb = first_blob(*heap);
+    if (cb != NULL) {
+      return cb;
+    }
+  }
+  return NULL;
 }
 
 
 CodeBlob* CodeCache::next(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->next(cb);
+  CodeHeap* heap = get_code_heap(cb);
+  CodeBlob* next = next_blob(heap, cb);
+  // Continue with the first blob of the following code heaps
+  for (int i = _heaps->find(heap) + 1; next == NULL && i < _heaps->length(); i++) {
+    next = first_blob(_heaps->at(i));
+  }
+  return next;
 }
 
 
@@ -153,27 +216,43 @@ nmethod* CodeCache::alive_nmethod(CodeBlob* cb) {
   return (nmethod*)cb;
 }
 
+// Returns cb if it is an nmethod, or else the first nmethod after cb in the
+// code heap at heap_index or in the following code heaps. Code heaps that
+// hold no nmethods are skipped, so the sweeper never walks the stubs.
+nmethod* CodeCache::nmethod_from(int heap_index, CodeBlob* cb) {
+  while (heap_index < _heaps->length()) {
+    CodeHeap* heap = _heaps->at(heap_index);
+    if (heap_accepts_nmethods(heap)) {
+      while (cb != NULL && !cb->is_nmethod()) {
+        cb = next_blob(heap, cb);
+      }
+      if (cb != NULL) {
+        return (nmethod*)cb;
+      }
+    }
+    heap_index++;
+    if (heap_index < _heaps->length()) {
+      cb = first_blob(_heaps->at(heap_index));
+    }
+  }
+  return NULL;
+}
+
 nmethod* CodeCache::first_nmethod() {
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = first();
-  while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+  if (_heaps->is_empty()) {
+    return NULL;
   }
-  return (nmethod*)cb;
+  return nmethod_from(0, first_blob(_heaps->at(0)));
 }
 
 nmethod* CodeCache::next_nmethod (CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  cb = next(cb);
-  while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
-  }
-  return (nmethod*)cb;
+  CodeHeap* heap = get_code_heap(cb);
+  return nmethod_from(_heaps->find(heap), next_blob(heap, cb));
 }
 
-static size_t maxCodeCacheUsed = 0;
-
-CodeBlob* CodeCache::allocate(int size, bool is_critical) {
+CodeBlob* CodeCache::allocate(int size, int code_blob_type, bool is_critical, int orig_code_blob_type) {
   // Do not seize the CodeCache lock here--if the caller has not
   // already done so, we are going to lose bigtime, since the code
   // cache will contain a garbage CodeBlob until the caller can
@@ -182,23 +261,53 @@ CodeBlob* CodeCache::allocate(int size, bool is_critical) {
   guarantee(size >= 0, "allocation request must be reasonable");
   assert_locked_or_safepoint(CodeCache_lock);
   CodeBlob* cb = NULL;
-  _number_of_blobs++;
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  assert(heap != NULL, "no code heap for the CodeBlobType");
   while (true) {
-    cb = (CodeBlob*)_heap->allocate(size, is_critical);
+    cb = (CodeBlob*)heap->allocate(size, is_critical);
     if (cb != NULL) break;
-    if (!_heap->expand_by(CodeCacheExpansionSize)) {
+    if (!heap->expand_by(CodeCacheExpansionSize)) {
       // Expansion failed
+      if (SegmentedCodeCache) {
+        // Fall back to another code heap before giving up:
+        // NonNMethod -> MethodNonProfiled -> MethodProfiled (-> MethodNonProfiled)
+        int type = code_blob_type;
+        switch (code_blob_type) {
+        case CodeBlobType::NonNMethod:
+          type = CodeBlobType::MethodNonProfiled;
+          break;
+        case CodeBlobType::MethodNonProfiled:
+          type = CodeBlobType::MethodProfiled;
+          break;
+        case CodeBlobType::MethodProfiled:
+          // Only go back if the profiled code heap was tried first
+          if (orig_code_blob_type == CodeBlobType::MethodProfiled) {
+            type = CodeBlobType::MethodNonProfiled;
+          }
+          break;
+        }
+        if (type != code_blob_type && type != orig_code_blob_type && heap_available(type)) {
+          if (PrintCodeCacheExtension) {
+            tty->print_cr("%s is full, allocating in %s", heap->name(), get_code_heap(type)->name());
+          }
+          return allocate(size, type, is_critical, orig_code_blob_type);
+        }
+      }
       return NULL;
     }
     if (PrintCodeCacheExtension) {
       ResourceMark rm;
-      tty->print_cr("code cache extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
-                    (intptr_t)_heap->low_boundary(), (intptr_t)_heap->high(),
-                    (address)_heap->high() - (address)_heap->low_boundary());
+      tty->print_cr("%s extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
+                    SegmentedCodeCache ? heap->name() : "code cache",
+                    (intptr_t)heap->low_boundary(), (intptr_t)heap->high(),
+                    (address)heap->high() - (address)heap->low_boundary());
     }
   }
-  maxCodeCacheUsed = MAX2(maxCodeCacheUsed, ((address)_heap->high_boundary() -
-                          (address)_heap->low_boundary()) - unallocated_capacity());
+  _number_of_blobs++;
+  if (heap_accepts_nmethods(heap)) {
+    // Possibly wakes up the sweeper thread
+    NMethodSweeper::notify(heap->code_blob_type());
+  }
   verify_if_often();
   print_trace("allocation", cb, size);
   return cb;
@@ -220,7 +329,7 @@ void CodeCache::free(CodeBlob* cb) {
   }
   _number_of_blobs--;
 
-  _heap->deallocate(cb);
+  get_code_heap(cb)->deallocate(cb);
 
   verify_if_often();
   assert(_number_of_blobs >= 0, "sanity check");
@@ -251,16 +360,9 @@ void CodeCache::flush() {
 }
 
 
-// Iteration over CodeBlobs
-
-#define FOR_ALL_BLOBS(var)       for (CodeBlob *var =       first() ; var != NULL; var =       next(var) )
-#define FOR_ALL_ALIVE_BLOBS(var) for (CodeBlob *var = alive(first()); var != NULL; var = alive(next(var)))
-#define FOR_ALL_ALIVE_NMETHODS(var) for (nmethod *var = alive_nmethod(first()); var != NULL; var = alive_nmethod(next(var)))
-
-
 bool CodeCache::contains(void *p) {
   // It should be ok to call contains without holding a lock
-  return _heap->contains(p);
+  return get_code_heap_containing(p) != NULL;
 }
 
 
@@ -292,8 +394,8 @@ void CodeCache::blobs_do(void f(CodeBlob* nm)) {
 
 void CodeCache::nmethods_do(void f(nmethod* nm)) {
   assert_locked_or_safepoint(CodeCache_lock);
-  FOR_ALL_BLOBS(nm) {
-    if (nm->is_nmethod()) f((nmethod*)nm);
+  for (nmethod* nm = first_nmethod(); nm != NULL; nm = next_nmethod(nm)) {
+    f(nm);
   }
 }
 
@@ -305,12 +407,12 @@ void CodeCache::alive_nmethods_do(void f(nmethod* nm)) {
 }
 
 int CodeCache::alignment_unit() {
-  return (int)_heap->alignment_unit();
+  return (int)_heaps->first()->alignment_unit();
 }
 
 
 int CodeCache::alignment_offset() {
-  return (int)_heap->alignment_offset();
+  return (int)_heaps->first()->alignment_offset();
 }
 
 
@@ -578,25 +680,190 @@ void CodeCache::verify_oops() {
 
 address CodeCache::first_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->low_boundary();
+  return _low_bound;
 }
 
 
 address CodeCache::last_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->high();
+  address last = _low_bound;
+  FOR_ALL_HEAPS(heap) {
+    last = MAX2(last, (address)(*heap)->high());
+  }
+  return last;
+}
+
+size_t CodeCache::capacity() {
+  size_t cap = 0;
+  FOR_ALL_HEAPS(heap) {
+    cap += (*heap)->capacity();
+  }
+  return cap;
+}
+
+size_t CodeCache::max_capacity() {
+  size_t max_cap = 0;
+  FOR_ALL_HEAPS(heap) {
+    max_cap += (*heap)->max_capacity();
+  }
+  return max_cap;
+}
+
+size_t CodeCache::unallocated_capacity() {
+  size_t unallocated_cap = 0;
+  FOR_ALL_HEAPS(heap) {
+    unallocated_cap += (*heap)->unallocated_capacity();
+  }
+  return unallocated_cap;
+}
+
+size_t CodeCache::unallocated_capacity(int code_blob_type) {
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  return (heap != NULL) ? heap->unallocated_capacity() : 0;
 }
 
 /**
- * Returns the reverse free ratio. E.g., if 25% (1/4) of the code cache
- * is free, reverse_free_ratio() returns 4.
+ * Returns the reverse free ratio of the code heap for the given type.
+ * E.g., if 25% (1/4) of the code heap is free, reverse_free_ratio()
+ * returns 4.
  */
-double CodeCache::reverse_free_ratio() {
-  double unallocated_capacity = (double)(CodeCache::unallocated_capacity() - CodeCacheMinimumFreeSpace);
-  double max_capacity = (double)CodeCache::max_capacity();
+double CodeCache::reverse_free_ratio(int code_blob_type) {
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  if (heap == NULL) {
+    return 0;
+  }
+  // Avoid a division by zero or a negative ratio when the heap is full
+  double unallocated_capacity = MAX2((double)heap->unallocated_capacity() - CodeCacheMinimumFreeSpace, 1.0);
+  double max_capacity = (double)heap->max_capacity();
   return max_capacity / unallocated_capacity;
 }
 
+bool CodeCache::is_full(int* code_blob_type) {
+  FOR_ALL_NMETHOD_HEAPS(heap) {
+    if ((*heap)->unallocated_capacity() < CodeCacheMinimumFreeSpace) {
+      *code_blob_type = (*heap)->code_blob_type();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CodeCache::heap_available(int code_blob_type) {
+  if (!SegmentedCodeCache) {
+    // No segmentation: use a single code heap
+    return (code_blob_type == CodeBlobType::All);
+  } else if (TieredCompilation && (TieredStopAtLevel > CompLevel_simple)) {
+    // Tiered compilation: use all code heaps
+    return (code_blob_type < CodeBlobType::All);
+  } else {
+    // No profiled code: we only need the non-nmethod and non-profiled code heap
+    return (code_blob_type == CodeBlobType::NonNMethod) ||
+           (code_blob_type == CodeBlobType::MethodNonProfiled);
+  }
+}
+
+ReservedCodeSpace CodeCache::reserve_heap_memory(size_t size) {
+  size_t page_size = os::vm_page_size();
+  if (os::can_execute_large_page_memory()) {
+    page_size = os::page_size_for_region_unaligned(size, 8);
+  }
+
+  const size_t granularity = os::vm_allocation_granularity();
+  const size_t r_align = MAX2(page_size, granularity);
+  const size_t r_size = align_size_up(size, r_align);
+
+  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
+    MAX2(page_size, granularity);
+  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
+  if (!rs.is_reserved()) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+  os::trace_page_sizes("code cache", InitialCodeCacheSize, size, page_size,
+                       rs.base(), rs.size());
+
+  _low_bound = (address)rs.base();
+  _high_bound = _low_bound + rs.size();
+  return rs;
+}
+
+void CodeCache::add_heap(ReservedSpace rs, const char* name, int code_blob_type) {
+  assert(heap_available(code_blob_type), "code heap is not used");
+  CodeHeap* heap = new CodeHeap(name, code_blob_type);
+  _heaps->append(heap);
+
+  size_t size_initial = MIN2((size_t)InitialCodeCacheSize, rs.size());
+  if (!heap->reserve(rs, size_initial, CodeCacheSegmentSize)) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+
+  // The memory pool of the single code heap keeps its traditional name
+  MemoryService::add_code_heap_memory_pool(heap, SegmentedCodeCache ? name : "Code Cache");
+}
+
+void CodeCache::initialize_heaps() {
+  const bool profiled = heap_available(CodeBlobType::MethodProfiled);
+  const size_t cache_size = ReservedCodeCacheSize;
+
+  // Sizes of 0 for the method code heaps stand for a share of the rest of
+  // the code cache: the profiled and the non-profiled heap get half each.
+  size_t non_nmethod_size = NonNMethodCodeHeapSize;
+  size_t profiled_size = 0;
+  size_t non_profiled_size = 0;
+  if (non_nmethod_size < cache_size) {
+    size_t method_size = cache_size - non_nmethod_size;
+    if (profiled) {
+      if (ProfiledCodeHeapSize != 0) {
+        profiled_size = ProfiledCodeHeapSize;
+      } else if (NonProfiledCodeHeapSize != 0) {
+        profiled_size = method_size - MIN2((size_t)NonProfiledCodeHeapSize, method_size);
+      } else {
+        profiled_size = method_size / 2;
+      }
+    }
+    non_profiled_size = (NonProfiledCodeHeapSize != 0) ? (size_t)NonProfiledCodeHeapSize :
+                        method_size - MIN2(profiled_size, method_size);
+  }
+
+  // The interpreter and the stubs of the VM go to the non-nmethod code heap
+  const size_t min_non_nmethod_size = (CodeCacheMinimumUseSpace DEBUG_ONLY(* 3)) + CodeCacheMinimumFreeSpace;
+  if (non_nmethod_size + profiled_size + non_profiled_size != cache_size ||
+      non_nmethod_size < min_non_nmethod_size || non_profiled_size == 0 ||
+      (profiled && profiled_size == 0)) {
+    vm_exit_during_initialization(err_msg("Invalid code heap sizes: NonNMethodCodeHeapSize (" SIZE_FORMAT "K, at least "
+                                          SIZE_FORMAT "K) + ProfiledCodeHeapSize (" SIZE_FORMAT "K) + "
+                                          "NonProfiledCodeHeapSize (" SIZE_FORMAT "K) must be equal to "
+                                          "ReservedCodeCacheSize (" SIZE_FORMAT "K)",
+                                          non_nmethod_size/K, min_non_nmethod_size/K, profiled_size/K,
+                                          non_profiled_size/K, cache_size/K));
+  }
+  FLAG_SET_ERGO(uintx, ProfiledCodeHeapSize, profiled_size);
+  FLAG_SET_ERGO(uintx, NonProfiledCodeHeapSize, non_profiled_size);
+
+  // Carve the code heaps out of one reservation, with the non-nmethod code
+  // heap in the middle, close to the callers of its stubs:
+  // ---------- high -----------
+  //    Non-profiled nmethods
+  //         Non-nmethods
+  //      Profiled nmethods
+  // ---------- low ------------
+  ReservedCodeSpace rs = reserve_heap_memory(cache_size);
+  const size_t alignment = MAX2(rs.alignment(), (size_t)os::vm_allocation_granularity());
+  profiled_size = align_size_up(profiled_size, alignment);
+  non_nmethod_size = align_size_up(non_nmethod_size, alignment);
+  assert(profiled_size + non_nmethod_size < rs.size(), "no space left for non-profiled code");
+
+  ReservedSpace rest = rs;
+  if (profiled) {
+    ReservedSpace profiled_space = rest.first_part(profiled_size);
+    rest = rest.last_part(profiled_size);
+    add_heap(profiled_space, "CodeHeap 'profiled nmethods'", CodeBlobType::MethodProfiled);
+  }
+  ReservedSpace non_nmethod_space = rest.first_part(non_nmethod_size);
+  ReservedSpace non_profiled_space = rest.last_part(non_nmethod_size);
+  add_heap(non_nmethod_space, "CodeHeap 'non-nmethods'", CodeBlobType::NonNMethod);
+  add_heap(non_profiled_space, "CodeHeap 'non-profiled nmethods'", CodeBlobType::MethodNonProfiled);
+}
+
 void icache_init();
 
 void CodeCache::initialize() {
@@ -611,12 +878,15 @@ void CodeCache::initialize() {
   CodeCacheExpansionSize = round_to(CodeCacheExpansionSize, os::vm_page_size());
   InitialCodeCacheSize = round_to(InitialCodeCacheSize, os::vm_page_size());
   ReservedCodeCacheSize = round_to(ReservedCodeCacheSize, os::vm_page_size());
-  if (!_heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
-    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  if (SegmentedCodeCache) {
+    // Use one code heap per type of code
+    initialize_heaps();
+  } else {
+    // Use a single code heap
+    ReservedCodeSpace rs = reserve_heap_memory(ReservedCodeCacheSize);
+    add_heap(rs, "CodeCache", CodeBlobType::All);
   }
 
-  MemoryService::add_code_heap_memory_pool(_heap);
-
   // Initialize ICache flush mechanism
   // This service is needed for os::register_code_area
   icache_init();
@@ -624,7 +894,7 @@ void CodeCache::initialize() {
   // Give OS a chance to register generated code area.
   // This is used on Windows 64 bit platforms to register
   // Structured Exception Handlers for our generated code.
-  os::register_code_area(_heap->low_boundary(), _heap->high_boundary());
+  os::register_code_area((char*)_low_bound, (char*)_high_bound);
 }
 
 
@@ -769,23 +1039,27 @@ void CodeCache::make_marked_nmethods_not_entrant() {
 }
 
 void CodeCache::verify() {
-  _heap->verify();
+  FOR_ALL_HEAPS(heap) {
+    (*heap)->verify();
+  }
   FOR_ALL_ALIVE_BLOBS(p) {
     p->verify();
   }
 }
 
-void CodeCache::report_codemem_full() {
+void CodeCache::report_codemem_full(int code_blob_type) {
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  assert(heap != NULL, "no code heap for the CodeBlobType");
   _codemem_full_count++;
   EventCodeCacheFull event;
   if (event.should_commit()) {
-    event.set_startAddress((u8)low_bound());
-    event.set_commitedTopAddress((u8)high());
-    event.set_reservedTopAddress((u8)high_bound());
+    event.set_startAddress((u8)heap->low_boundary());
+    event.set_commitedTopAddress((u8)heap->high());
+    event.set_reservedTopAddress((u8)heap->high_boundary());
     event.set_entryCount(nof_blobs());
     event.set_methodCount(nof_nmethods());
     event.set_adaptorCount(nof_adapters());
-    event.set_unallocatedCapacity(unallocated_capacity()/K);
+    event.set_unallocatedCapacity(heap->unallocated_capacity()/K);
     event.set_fullCount(_codemem_full_count);
     event.commit();
   }
@@ -798,7 +1072,9 @@ void CodeCache::report_codemem_full() {
 
 void CodeCache::verify_if_often() {
   if (VerifyCodeCacheOften) {
-    _heap->verify();
+    FOR_ALL_HEAPS(heap) {
+      (*heap)->verify();
+    }
   }
 }
 
@@ -970,17 +1246,23 @@ void CodeCache::print() {
 }
 
 void CodeCache::print_summary(outputStream* st, bool detailed) {
-  size_t total = (_heap->high_boundary() - _heap->low_boundary());
-  st->print_cr("CodeCache: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT
-               "Kb max_used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb",
-               total/K, (total - unallocated_capacity())/K,
-               maxCodeCacheUsed/K, unallocated_capacity()/K);
+  FOR_ALL_HEAPS(heap_iterator) {
+    CodeHeap* heap = (*heap_iterator);
+    size_t total = (heap->high_boundary() - heap->low_boundary());
+    st->print_cr("%s: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT
+                 "Kb max_used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb",
+                 heap->name(), total/K, (total - heap->unallocated_capacity())/K,
+                 heap->max_allocated_capacity()/K, heap->unallocated_capacity()/K);
+
+    if (detailed) {
+      st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
+                   p2i(heap->low_boundary()),
+                   p2i(heap->high()),
+                   p2i(heap->high_boundary()));
+    }
+  }
 
   if (detailed) {
-    st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
-                 p2i(_heap->low_boundary()),
-                 p2i(_heap->high()),
-                 p2i(_heap->high_boundary()));
     st->print_cr(" total_blobs=" UINT32_FORMAT " nmethods=" UINT32_FORMAT
                  " adapters=" UINT32_FORMAT,
                  nof_blobs(), nof_nmethods(), nof_adapters());
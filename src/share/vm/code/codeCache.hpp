@@ -30,6 +30,7 @@
 #include "memory/heap.hpp"
 #include "oops/instanceKlass.hpp"
 #include "oops/oopsHierarchy.hpp"
+#include "utilities/growableArray.hpp"
 
 // The CodeCache implements the code cache for various pieces of generated
 // code, e.g., compiled java methods, runtime stubs, transition frames, etc.
@@ -39,6 +40,15 @@
 //   - Each CodeBlob occupies one chunk of memory.
 //   - Like the offset table in oldspace the zone has at table for
 //     locating a method given a addess of an instruction.
+//
+// With -XX:+SegmentedCodeCache the code cache is divided into code heaps
+// for the different types of code (see CodeBlobType):
+//   - Non-nmethods: stubs, adapters and buffers of the VM and the compilers
+//   - Profiled nmethods: methods compiled at tier 2 and 3 (C1 with profiling)
+//   - Non-profiled nmethods: methods compiled at tier 1 and 4, and native wrappers
+// The heaps are carved out of one contiguous reservation, so that low_bound()
+// and high_bound() still delimit all generated code. Without segmentation
+// a single code heap holds all types of code.
 
 class OopClosure;
 class DepChange;
@@ -46,11 +56,14 @@ class DepChange;
 class CodeCache : AllStatic {
   friend class VMStructs;
  private:
-  // CodeHeap is malloc()'ed at startup and never deleted during shutdown,
+  // CodeHeaps are malloc()'ed at startup and never deleted during shutdown,
   // so that the generated assembly code is always there when it's needed.
   // This may cause memory leak, but is necessary, for now. See 4423824,
   // 4422213 or 4436291 for details.
-  static CodeHeap * _heap;
+  static GrowableArray<CodeHeap*>* _heaps;
+
+  static address _low_bound;                     // Lower bound of CodeHeap addresses
+  static address _high_bound;                    // Upper bound of CodeHeap addresses
   static int _number_of_blobs;
   static int _number_of_adapters;
   static int _number_of_nmethods;
@@ -69,15 +82,50 @@ class CodeCache : AllStatic {
   static void prune_scavenge_root_nmethods();
   static void unlink_scavenge_root_nmethod(nmethod* nm, nmethod* prev);
 
+  // CodeHeap management
+  static void initialize_heaps();                             // Initializes the CodeHeaps of the segmented code cache
+  static ReservedCodeSpace reserve_heap_memory(size_t size);  // Reserves one contiguous chunk of memory for the CodeHeaps
+  static void add_heap(ReservedSpace rs, const char* name, int code_blob_type);
+  static bool heap_accepts(CodeHeap* heap, int code_blob_type) {
+    return heap->code_blob_type() == CodeBlobType::All || heap->code_blob_type() == code_blob_type;
+  }
+  static bool heap_accepts_nmethods(CodeHeap* heap) {
+    return heap->code_blob_type() != CodeBlobType::NonNMethod;
+  }
+  static CodeHeap* get_code_heap(const CodeBlob* cb);         // Returns the CodeHeap containing the given CodeBlob
+  static CodeHeap* get_code_heap(int code_blob_type);         // Returns the CodeHeap for the given CodeBlobType
+
+  // Returns the CodeHeap containing the given address, or NULL
+  static CodeHeap* get_code_heap_containing(void* p) {
+    for (int i = 0; i < _heaps->length(); i++) {
+      CodeHeap* heap = _heaps->at(i);
+      if (heap->contains(p)) {
+        return heap;
+      }
+    }
+    return NULL;
+  }
+
+  // Iteration within a single CodeHeap
+  static CodeBlob* first_blob(CodeHeap* heap);
+  static CodeBlob* next_blob(CodeHeap* heap, CodeBlob* cb);
+  static CodeBlob* alive(CodeHeap* heap, CodeBlob* cb);
+  static nmethod* alive_nmethod(CodeHeap* heap, CodeBlob* cb);
+  static nmethod* nmethod_from(int heap_index, CodeBlob* cb);
+
+  static CodeBlob* allocate(int size, int code_blob_type, bool is_critical, int orig_code_blob_type);
+
  public:
 
   // Initialization
   static void initialize();
 
-  static void report_codemem_full();
+  static void report_codemem_full(int code_blob_type);
 
   // Allocation/administration
-  static CodeBlob* allocate(int size, bool is_critical = false); // allocates a new CodeBlob
+  static CodeBlob* allocate(int size, int code_blob_type, bool is_critical = false) { // allocates a new CodeBlob
+    return allocate(size, code_blob_type, is_critical, code_blob_type);
+  }
   static void commit(CodeBlob* cb);                 // called when the allocated CodeBlob has been filled
   static int alignment_unit();                      // guaranteed alignment of all CodeBlobs
   static int alignment_offset();                    // guaranteed offset of first CodeBlob byte within alignment unit (i.e., allocation header)
@@ -89,6 +137,29 @@ class CodeCache : AllStatic {
   static void nmethods_do(void f(nmethod* nm));     // iterates over all nmethods
   static void alive_nmethods_do(void f(nmethod* nm)); // iterates over all alive nmethods
 
+  // CodeHeaps
+  static GrowableArray<CodeHeap*>* heaps()       { return _heaps; }
+  static bool heap_available(int code_blob_type);   // returns whether a CodeHeap for the CodeBlobType is used
+
+  // Returns the CodeBlobType of the code heap that compiled code of the given level goes to
+  static int get_code_blob_type(int comp_level) {
+    if (comp_level == CompLevel_limited_profile ||
+        comp_level == CompLevel_full_profile) {
+      // Profiled methods
+      return CodeBlobType::MethodProfiled;
+    }
+    assert(comp_level == CompLevel_none ||
+           comp_level == CompLevel_simple ||
+           comp_level == CompLevel_full_optimization, "unknown compilation level");
+    // Non-profiled methods and native wrappers
+    return CodeBlobType::MethodNonProfiled;
+  }
+
+  // Returns the CodeBlobType of the code heap holding the given CodeBlob
+  static int get_code_blob_type(const CodeBlob* cb) {
+    return get_code_heap(cb)->code_blob_type();
+  }
+
   // Lookup
   static CodeBlob* find_blob(void* start);
   static nmethod*  find_nmethod(void* start);
@@ -97,9 +168,10 @@ class CodeCache : AllStatic {
   // what you are doing)
   static CodeBlob* find_blob_unsafe(void* start) {
     // NMT can walk the stack before code cache is created
-    if (_heap == NULL) return NULL;
+    CodeHeap* heap = get_code_heap_containing(start);
+    if (heap == NULL) return NULL;
 
-    CodeBlob* result = (CodeBlob*)_heap->find_start(start);
+    CodeBlob* result = (CodeBlob*)heap->find_start(start);
     // this assert is too strong because the heap code will return the
     // heapblock containing start. That block can often be larger than
     // the codeBlob itself. If you look up an address that is within
@@ -160,17 +232,20 @@ class CodeCache : AllStatic {
   static void log_state(outputStream* st);
 
   // The full limits of the codeCache
-  static address  low_bound()                    { return (address) _heap->low_boundary(); }
-  static address  high_bound()                   { return (address) _heap->high_boundary(); }
-  static address  high()                         { return (address) _heap->high(); }
+  static address  low_bound()                    { return _low_bound; }
+  static address  high_bound()                   { return _high_bound; }
 
   // Profiling
   static address first_address();                // first address used for CodeBlobs
   static address last_address();                 // last  address used for CodeBlobs
-  static size_t  capacity()                      { return _heap->capacity(); }
-  static size_t  max_capacity()                  { return _heap->max_capacity(); }
-  static size_t  unallocated_capacity()          { return _heap->unallocated_capacity(); }
-  static double  reverse_free_ratio();
+  static size_t  capacity();
+  static size_t  max_capacity();
+  static size_t  unallocated_capacity();
+  static size_t  unallocated_capacity(int code_blob_type);
+  static double  reverse_free_ratio(int code_blob_type);
+  // Returns true and sets code_blob_type if the code heap for one of the
+  // types of compiled methods has less than CodeCacheMinimumFreeSpace left
+  static bool    is_full(int* code_blob_type);
 
   static bool needs_cache_clean()                { return _needs_cache_clean; }
   static void set_needs_cache_clean(bool v)      { _needs_cache_clean = v;    }
@@ -572,6 +572,7 @@ void nmethod::init_defaults() {
   _marked_for_deoptimization  = 0;
   _lock_count                 = 0;
   _stack_traversal_mark       = 0;
+  _compile_time_us            = 0;
   _unload_reported            = false;           // jvmti state
 
 #ifdef ASSERT
@@ -614,11 +615,11 @@ nmethod* nmethod::new_native_nmethod(methodHandle method,
     CodeOffsets offsets;
     offsets.set_value(CodeOffsets::Verified_Entry, vep_offset);
     offsets.set_value(CodeOffsets::Frame_Complete, frame_complete);
-    nm = new (native_nmethod_size) nmethod(method(), native_nmethod_size,
-                                            compile_id, &offsets,
-                                            code_buffer, frame_size,
-                                            basic_lock_owner_sp_offset,
-                                            basic_lock_sp_offset, oop_maps);
+    nm = new (native_nmethod_size, CompLevel_none) nmethod(method(), native_nmethod_size,
+                                                            compile_id, &offsets,
+                                                            code_buffer, frame_size,
+                                                            basic_lock_owner_sp_offset,
+                                                            basic_lock_sp_offset, oop_maps);
     if (nm != NULL)  note_native_wrapper_nmethod(nm);
     if (PrintAssembly && nm != NULL) {
       Disassembler::decode(nm);
@@ -652,8 +653,8 @@ nmethod* nmethod::new_dtrace_nmethod(methodHandle method,
     offsets.set_value(CodeOffsets::Dtrace_trap, trap_offset);
     offsets.set_value(CodeOffsets::Frame_Complete, frame_complete);
 
-    nm = new (nmethod_size) nmethod(method(), nmethod_size,
-                                    &offsets, code_buffer, frame_size);
+    nm = new (nmethod_size, CompLevel_none) nmethod(method(), nmethod_size,
+                                                    &offsets, code_buffer, frame_size);
 
     if (nm != NULL)  note_java_nmethod(nm);
     if (PrintAssembly && nm != NULL) {
@@ -714,7 +715,7 @@ nmethod* nmethod::new_nmethod(methodHandle method,
 #endif
       + round_to(debug_info->data_size()       , oopSize);
 
-    nm = new (nmethod_size)
+    nm = new (nmethod_size, comp_level)
     nmethod(method(), nmethod_size, compile_id, entry_bci, offsets,
             orig_pc_offset, debug_info, dependencies, code_buffer, frame_size,
             oop_maps,
@@ -951,9 +952,9 @@ nmethod::nmethod(
 }
 #endif // def HAVE_DTRACE_H
 
-void* nmethod::operator new(size_t size, int nmethod_size) throw() {
+void* nmethod::operator new(size_t size, int nmethod_size, int comp_level) throw() {
   // Not critical, may return null if there is too little continuous memory
-  return CodeCache::allocate(nmethod_size);
+  return CodeCache::allocate(nmethod_size, CodeCache::get_code_blob_type(comp_level));
 }
 
 nmethod::nmethod(
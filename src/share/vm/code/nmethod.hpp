@@ -255,6 +255,10 @@ class nmethod : public CodeBlob {
   // counter is decreased (by 1) while sweeping.
   int _hotness_counter;
 
+  // Time it took to compile this nmethod in microseconds, 0 if unknown.
+  // Used by -XX:+UseCostAwareCodeCacheFlushing.
+  int _compile_time_us;
+
   ExceptionCache * volatile _exception_cache;
   PcDescCache     _pc_desc_cache;
 
@@ -319,7 +323,7 @@ class nmethod : public CodeBlob {
           );
 
   // helper methods
-  void* operator new(size_t size, int nmethod_size) throw();
+  void* operator new(size_t size, int nmethod_size, int comp_level) throw();
 
   const char* reloc_string_for(u_char* begin, u_char* end);
   // Returns true if this thread changed the state of the nmethod or
@@ -461,6 +465,9 @@ class nmethod : public CodeBlob {
   void set_hotness_counter(int val) { _hotness_counter = val; }
   int  hotness_counter() const      { return _hotness_counter; }
 
+  void set_compile_time_us(int us)  { _compile_time_us = us; }
+  int  compile_time_us() const      { return _compile_time_us; }
+
   // Containment
   bool consts_contains       (address addr) const { return consts_begin       () <= addr && addr < consts_end       (); }
   bool insts_contains        (address addr) const { return insts_begin        () <= addr && addr < insts_end        (); }
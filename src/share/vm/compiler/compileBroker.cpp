@@ -1122,9 +1122,9 @@ void CompileBroker::compilation_init(TRAPS) {
 }
 
 
-CompilerThread* CompileBroker::make_compiler_thread(const char* name, CompileQueue* queue, CompilerCounters* counters,
-                                                    AbstractCompiler* comp, TRAPS) {
-  CompilerThread* compiler_thread = NULL;
+JavaThread* CompileBroker::make_thread(const char* name, CompileQueue* queue, CompilerCounters* counters,
+                                       AbstractCompiler* comp, bool compiler_thread, TRAPS) {
+  JavaThread* thread = NULL;
 
   Klass* k =
     SystemDictionary::resolve_or_fail(vmSymbols::java_lang_Thread(),
@@ -1146,7 +1146,11 @@ CompilerThread* CompileBroker::make_compiler_thread(const char* name, CompileQue
 
   {
     MutexLocker mu(Threads_lock, THREAD);
-    compiler_thread = new CompilerThread(queue, counters);
+    if (compiler_thread) {
+      thread = new CompilerThread(queue, counters);
+    } else {
+      thread = new CodeCacheSweeperThread();
+    }
     // At this point the new CompilerThread data-races with this startup
     // thread (which I believe is the primoridal thread and NOT the VM
     // thread).  This means Java bytecodes being executed at startup can
@@ -1159,12 +1163,12 @@ CompilerThread* CompileBroker::make_compiler_thread(const char* name, CompileQue
     // in that case. However, since this must work and we do not allow
     // exceptions anyway, check and abort if this fails.
 
-    if (compiler_thread == NULL || compiler_thread->osthread() == NULL){
+    if (thread == NULL || thread->osthread() == NULL) {
       vm_exit_during_initialization("java.lang.OutOfMemoryError",
                                     "unable to create new native thread");
     }
 
-    java_lang_Thread::set_thread(thread_oop(), compiler_thread);
+    java_lang_Thread::set_thread(thread_oop(), thread);
 
     // Note that this only sets the JavaThread _priority field, which by
     // definition is limited to Java priorities and not OS priorities.
@@ -1185,20 +1189,22 @@ CompilerThread* CompileBroker::make_compiler_thread(const char* name, CompileQue
         native_prio = os::java_to_os_priority[NearMaxPriority];
       }
     }
-    os::set_native_priority(compiler_thread, native_prio);
+    os::set_native_priority(thread, native_prio);
 
     java_lang_Thread::set_daemon(thread_oop());
 
-    compiler_thread->set_threadObj(thread_oop());
-    compiler_thread->set_compiler(comp);
-    Threads::add(compiler_thread);
-    Thread::start(compiler_thread);
+    thread->set_threadObj(thread_oop());
+    if (compiler_thread) {
+      thread->as_CompilerThread()->set_compiler(comp);
+    }
+    Threads::add(thread);
+    Thread::start(thread);
   }
 
   // Let go of Threads_lock before yielding
   os::yield(); // make sure that the compiler thread is started early (especially helpful on SOLARIS)
 
-  return compiler_thread;
+  return thread;
 }
 
 
@@ -1228,8 +1234,8 @@ void CompileBroker::init_compiler_threads(int c1_compiler_count, int c2_compiler
     sprintf(name_buffer, "%s CompilerThread%d", _compilers[1]->name(), i);
     CompilerCounters* counters = new CompilerCounters("compilerThread", i, CHECK);
     // Shark and C2
-    CompilerThread* new_thread = make_compiler_thread(name_buffer, _c2_compile_queue, counters, _compilers[1], CHECK);
-    _compiler_threads->append(new_thread);
+    JavaThread* new_thread = make_thread(name_buffer, _c2_compile_queue, counters, _compilers[1], true, CHECK);
+    _compiler_threads->append(new_thread->as_CompilerThread());
   }
 
   for (int i = c2_compiler_count; i < compiler_count; i++) {
@@ -1237,8 +1243,13 @@ void CompileBroker::init_compiler_threads(int c1_compiler_count, int c2_compiler
     sprintf(name_buffer, "C1 CompilerThread%d", i);
     CompilerCounters* counters = new CompilerCounters("compilerThread", i, CHECK);
     // C1
-    CompilerThread* new_thread = make_compiler_thread(name_buffer, _c1_compile_queue, counters, _compilers[0], CHECK);
-    _compiler_threads->append(new_thread);
+    JavaThread* new_thread = make_thread(name_buffer, _c1_compile_queue, counters, _compilers[0], true, CHECK);
+    _compiler_threads->append(new_thread->as_CompilerThread());
+  }
+
+  if (MethodFlushing && UseCodeCacheSweeperThread) {
+    // Initialize the sweeper thread
+    make_thread("Sweeper thread", NULL, NULL, NULL, false, CHECK);
   }
 
   if (UsePerfData) {
@@ -2000,9 +2011,10 @@ void CompileBroker::compiler_thread_loop() {
     // We need this HandleMark to avoid leaking VM handles.
     HandleMark hm(thread);
 
-    if (CodeCache::unallocated_capacity() < CodeCacheMinimumFreeSpace) {
+    int code_blob_type;
+    if (CodeCache::is_full(&code_blob_type)) {
       // the code cache is really full
-      handle_full_code_cache();
+      handle_full_code_cache(code_blob_type);
     }
 
     CompileTask* task = queue->get();
@@ -2371,10 +2383,11 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
 }
 
 /**
- * The CodeCache is full.  Print out warning and disable compilation
- * or try code cache cleaning so compilation can continue later.
+ * The code heap for the given CodeBlobType is full.  Print out warning and
+ * disable compilation or try code cache cleaning so compilation can continue
+ * later.
  */
-void CompileBroker::handle_full_code_cache() {
+void CompileBroker::handle_full_code_cache(int code_blob_type) {
   UseInterpreter = true;
   if (UseCompiler || AlwaysCompileLoopMethods ) {
     if (xtty != NULL) {
@@ -2391,7 +2404,7 @@ void CompileBroker::handle_full_code_cache() {
       xtty->end_elem();
     }
 
-    CodeCache::report_codemem_full();
+    CodeCache::report_codemem_full(code_blob_type);
 
 #ifndef PRODUCT
     if (CompileTheWorld || ExitOnFullCodeCache) {
@@ -2406,10 +2419,16 @@ void CompileBroker::handle_full_code_cache() {
       if (CompileBroker::set_should_compile_new_jobs(CompileBroker::stop_compilation)) {
         NMethodSweeper::log_sweep("disable_compiler");
       }
-      // Switch to 'vm_state'. This ensures that possibly_sweep() can be called
-      // without having to consider the state in which the current thread is.
-      ThreadInVMfromUnknown in_vm;
-      NMethodSweeper::possibly_sweep();
+      if (UseCodeCacheSweeperThread) {
+        // Wake up the sweeper thread, it frees the space
+        MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+        NMethodSweeper::notify(code_blob_type);
+      } else {
+        // Switch to 'vm_state'. This ensures that possibly_sweep() can be called
+        // without having to consider the state in which the current thread is.
+        ThreadInVMfromUnknown in_vm;
+        NMethodSweeper::possibly_sweep();
+      }
     } else {
       disable_compilation_forever();
     }
@@ -2566,6 +2585,9 @@ void CompileBroker::collect_statistics(CompilerThread* thread, elapsedTimer time
     _t_total_compilation.add(time);
     _peak_compilation_time = time.milliseconds() > _peak_compilation_time ? time.milliseconds() : _peak_compilation_time;
 
+    // Remember the cost of the compilation for the code cache sweeper
+    code->set_compile_time_us((int)MIN2(time.seconds() * 1000000, (double)max_jint));
+
     if (CITime) {
       int bytes_compiled = method->code_size() + task->num_inlined_bytecodes();
       JVMCI_ONLY(CompilerStatistics* stats = compiler(task->comp_level())->stats();)
@@ -88,6 +88,8 @@ CMSAdaptiveSizePolicy::CMSAdaptiveSizePolicy(size_t init_eden_size,
   _avg_cms_free         = new AdaptiveWeightedAverage(AdaptiveTimeWeight);
   _avg_cms_free_at_sweep = new AdaptiveWeightedAverage(AdaptiveTimeWeight);
   _avg_cms_promo        = new AdaptiveWeightedAverage(AdaptiveTimeWeight);
+  _avg_cms_fragmentation = new AdaptiveWeightedAverage(AdaptiveTimeWeight);
+  _defragmenting_sweeps = 0;
 
   // Mark-sweep-compact
   _avg_msc_pause        = new AdaptiveWeightedAverage(AdaptiveTimeWeight);
@@ -152,6 +152,12 @@ class CMSAdaptiveSizePolicy : public AdaptiveSizePolicy {
   AdaptiveWeightedAverage* _avg_cms_free;
   // Average of the bytes promoted between cms collections.
   AdaptiveWeightedAverage* _avg_cms_promo;
+  // Average of the fragmentation (in percent, see
+  // CompactibleFreeListSpace::flsFrag()) at the start of the sweep.
+  AdaptiveWeightedAverage* _avg_cms_fragmentation;
+  // Number of sweeps that coalesced aggressively because the
+  // fragmentation exceeded CMSFragmentationTarget.
+  size_t _defragmenting_sweeps;
 
   // stop-the-world (STW) mark-sweep-compact
   // Average of the pause time in seconds for STW mark-sweep-compact
@@ -233,6 +239,13 @@ class CMSAdaptiveSizePolicy : public AdaptiveSizePolicy {
     return _avg_cms_free_at_sweep;
   }
 
+  AdaptiveWeightedAverage* avg_cms_fragmentation() const {
+    return _avg_cms_fragmentation;
+  }
+
+  size_t defragmenting_sweeps() const { return _defragmenting_sweeps; }
+  void increment_defragmenting_sweeps() { _defragmenting_sweeps++; }
+
   AdaptiveWeightedAverage* avg_msc_pause() const {
     return _avg_msc_pause;
   }
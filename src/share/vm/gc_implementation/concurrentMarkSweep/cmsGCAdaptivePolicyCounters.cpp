@@ -113,6 +113,20 @@ CMSGCAdaptivePolicyCounters::CMSGCAdaptivePolicyCounters(const char* name_arg,
         (jlong) cms_size_policy()->avg_cms_free_at_sweep()->average(),
         CHECK);
 
+    cname = PerfDataManager::counter_name(name_space(), "avgCMSFragmentation");
+    _avg_cms_fragmentation_counter = PerfDataManager::create_variable(SUN_GC,
+        cname,
+        PerfData::U_None,
+        (jlong) cms_size_policy()->avg_cms_fragmentation()->average(),
+        CHECK);
+
+    cname = PerfDataManager::counter_name(name_space(), "cmsDefragmentingSweeps");
+    _cms_defragmenting_sweeps_counter = PerfDataManager::create_variable(SUN_GC,
+        cname,
+        PerfData::U_Events,
+        (jlong) cms_size_policy()->defragmenting_sweeps(),
+        CHECK);
+
     cname = PerfDataManager::counter_name(name_space(), "avgCMSFree");
     _avg_cms_free_counter = PerfDataManager::create_variable(SUN_GC,
         cname,
@@ -270,6 +284,8 @@ void CMSGCAdaptivePolicyCounters::update_counters_from_policy() {
 
     update_avg_cms_free_counter();
     update_avg_cms_free_at_sweep_counter();
+    update_avg_cms_fragmentation_counter();
+    update_cms_defragmenting_sweeps_counter();
     update_avg_cms_promo_counter();
 
     update_avg_msc_pause_counter();
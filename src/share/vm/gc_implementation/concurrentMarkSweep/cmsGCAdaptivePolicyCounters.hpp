@@ -79,6 +79,12 @@ class CMSGCAdaptivePolicyCounters : public GCAdaptivePolicyCounters {
   // Average of the free space in the tenured generation at the
   // start of the sweep of the tenured generation.
   PerfVariable* _avg_cms_free_at_sweep_counter;
+  // Average of the fragmentation of the free space in the tenured
+  // generation at the start of the sweep, in percent.
+  PerfVariable* _avg_cms_fragmentation_counter;
+  // Number of sweeps that coalesced free blocks aggressively
+  // to bring the fragmentation down to CMSFragmentationTarget.
+  PerfVariable* _cms_defragmenting_sweeps_counter;
   // Average of the free space in the tenured generation at the
   // after any resizing of the tenured generation at the end
   // of a collection of the tenured generation.
@@ -193,6 +199,16 @@ class CMSGCAdaptivePolicyCounters : public GCAdaptivePolicyCounters {
       (jlong) cms_size_policy()->avg_cms_free_at_sweep()->average());
   }
 
+  inline void update_avg_cms_fragmentation_counter() {
+    _avg_cms_fragmentation_counter->set_value(
+      (jlong) cms_size_policy()->avg_cms_fragmentation()->average());
+  }
+
+  inline void update_cms_defragmenting_sweeps_counter() {
+    _cms_defragmenting_sweeps_counter->set_value(
+      (jlong) cms_size_policy()->defragmenting_sweeps());
+  }
+
   inline void update_avg_cms_promo_counter() {
     _avg_cms_promo_counter->set_value(
       (jlong) cms_size_policy()->avg_cms_promo()->average());
@@ -2599,9 +2599,18 @@ AdaptiveWeightedAverage CFLS_LAB::_blocks_to_claim[]    =
   VECTOR_257(AdaptiveWeightedAverage(OldPLABWeight, (float)CMSParPromoteBlocksToClaim));
 size_t CFLS_LAB::_global_num_blocks[]  = VECTOR_257(0);
 uint   CFLS_LAB::_global_num_workers[] = VECTOR_257(0);
+size_t CFLS_LAB::_global_num_refills[]         = VECTOR_257(0);
+size_t CFLS_LAB::_global_num_reserve_refills[] = VECTOR_257(0);
+size_t CFLS_LAB::_global_num_dict_refills[]    = VECTOR_257(0);
+size_t CFLS_LAB::_global_num_reserve_allocs = 0;
+size_t CFLS_LAB::_global_num_dict_allocs    = 0;
+size_t CFLS_LAB::_global_num_reserves       = 0;
 
 CFLS_LAB::CFLS_LAB(CompactibleFreeListSpace* cfls) :
-  _cfls(cfls)
+  _cfls(cfls),
+  _reserve(NULL),
+  _num_reserve_allocs(0),
+  _num_dict_allocs(0)
 {
   assert(CompactibleFreeListSpace::IndexSetSize == 257, "Modify VECTOR_257() macro above");
   for (size_t i = CompactibleFreeListSpace::IndexSetStart;
@@ -2609,6 +2618,9 @@ CFLS_LAB::CFLS_LAB(CompactibleFreeListSpace* cfls) :
        i += CompactibleFreeListSpace::IndexSetStride) {
     _indexedFreeList[i].set_size(i);
     _num_blocks[i] = 0;
+    _num_refills[i] = 0;
+    _num_reserve_refills[i] = 0;
+    _num_dict_refills[i] = 0;
   }
 }
 
@@ -2628,11 +2640,19 @@ HeapWord* CFLS_LAB::alloc(size_t word_sz) {
   FreeChunk* res;
   assert(word_sz == _cfls->adjustObjectSize(word_sz), "Error");
   if (word_sz >=  CompactibleFreeListSpace::IndexSetSize) {
-    // This locking manages sync with other large object allocations.
-    MutexLockerEx x(_cfls->parDictionaryAllocLock(),
-                    Mutex::_no_safepoint_check_flag);
-    res = _cfls->getChunkFromDictionaryExact(word_sz);
-    if (res == NULL) return NULL;
+    // Medium sized blocks are split off this worker's reserve, which
+    // does not need the dictionary lock.
+    res = use_reserve_for(word_sz) ? get_from_reserve(word_sz) : NULL;
+    if (res != NULL) {
+      _num_reserve_allocs++;
+    } else {
+      // This locking manages sync with other large object allocations.
+      MutexLockerEx x(_cfls->parDictionaryAllocLock(),
+                      Mutex::_no_safepoint_check_flag);
+      res = _cfls->getChunkFromDictionaryExact(word_sz);
+      if (res == NULL) return NULL;
+      _num_dict_allocs++;
+    }
   } else {
     AdaptiveFreeList<FreeChunk>* fl = &_indexedFreeList[word_sz];
     if (fl->count() == 0) {
@@ -2679,18 +2699,119 @@ void CFLS_LAB::get_from_global_pool(size_t word_sz, AdaptiveFreeList<FreeChunk>*
     n_blks = MIN2(n_blks, CMSOldPLABMax);
   }
   assert(n_blks > 0, "Error");
-  _cfls->par_get_chunk_of_blocks(word_sz, n_blks, fl);
+  assert(fl->count() == 0, "Precondition.");
+  _num_refills[word_sz]++;
+  if (!_cfls->par_get_chunk_of_blocks_IFL(word_sz, n_blks, fl)) {
+    // The indexed free lists could not satisfy the request. Rather than
+    // splitting a chunk from the dictionary under the dictionary lock,
+    // try this worker's reserve first.
+    if (use_reserve_for(word_sz) && get_blocks_from_reserve(word_sz, n_blks, fl)) {
+      _num_reserve_refills[word_sz]++;
+    } else {
+      _cfls->par_get_chunk_of_blocks_dictionary(word_sz, n_blks, fl);
+      _num_dict_refills[word_sz]++;
+    }
+  }
   // Update stats table entry for this block size
   _num_blocks[word_sz] += fl->count();
 }
 
+FreeChunk* CFLS_LAB::get_from_reserve(size_t word_sz) {
+  if (_reserve != NULL) {
+    size_t reserve_sz = _reserve->size();
+    if (reserve_sz == word_sz) {
+      FreeChunk* res = _reserve;
+      _reserve = NULL;
+      return res;
+    }
+    if (reserve_sz >= word_sz + MinChunkSize) {
+      FreeChunk* res = _reserve;
+      _reserve = _cfls->par_split_chunk_prefix(res, word_sz);
+      return res;
+    }
+  }
+  if (!refill_reserve(word_sz + MinChunkSize)) {
+    return NULL;
+  }
+  FreeChunk* res = _reserve;
+  _reserve = _cfls->par_split_chunk_prefix(res, word_sz);
+  return res;
+}
+
+bool CFLS_LAB::get_blocks_from_reserve(size_t word_sz, size_t n,
+                                       AdaptiveFreeList<FreeChunk>* fl) {
+  if (_reserve == NULL || _reserve->size() < word_sz) {
+    if (!refill_reserve(n * word_sz + MinChunkSize)) {
+      return false;
+    }
+  }
+  size_t reserve_sz = _reserve->size();
+  n = MIN2(n, reserve_sz / word_sz);
+  // Leave either nothing or a viable free chunk behind.
+  size_t rem = reserve_sz - n * word_sz;
+  if (rem > 0 && rem < MinChunkSize) {
+    n--;
+    rem += word_sz;
+  }
+  if (n == 0) {
+    return false;
+  }
+  FreeChunk* fc = _reserve;
+  if (rem == 0) {
+    _reserve = NULL;
+  } else {
+    _reserve = _cfls->par_split_chunk_prefix(fc, n * word_sz);
+  }
+  _cfls->par_split_chunk_into_blocks(fc, word_sz, fl);
+  return true;
+}
+
+bool CFLS_LAB::refill_reserve(size_t min_word_sz) {
+  release_reserve();
+  size_t word_sz = _cfls->adjustObjectSize(MAX2((size_t)CMSParPromoteReserveSize, min_word_sz));
+  MutexLockerEx x(_cfls->parDictionaryAllocLock(),
+                  Mutex::_no_safepoint_check_flag);
+  _reserve = _cfls->getChunkFromDictionaryExact(word_sz);
+  if (_reserve == NULL) {
+    return false;
+  }
+  assert(_reserve->is_free(), "the reserve must look like a free block");
+  _global_num_reserves++;
+  return true;
+}
+
+void CFLS_LAB::release_reserve() {
+  if (_reserve != NULL) {
+    _cfls->par_return_split_chunk(_reserve);
+    _reserve = NULL;
+  }
+}
+
 void CFLS_LAB::compute_desired_plab_size() {
+  if (PrintOldPLAB && (_global_num_reserves > 0 || _global_num_dict_allocs > 0)) {
+    gclog_or_tty->print_cr("reserves: " SIZE_FORMAT ", large blocks from reserve: " SIZE_FORMAT
+                           ", from dictionary: " SIZE_FORMAT,
+                           _global_num_reserves, _global_num_reserve_allocs, _global_num_dict_allocs);
+  }
+  _global_num_reserves = 0;
+  _global_num_reserve_allocs = 0;
+  _global_num_dict_allocs = 0;
   for (size_t i =  CompactibleFreeListSpace::IndexSetStart;
        i < CompactibleFreeListSpace::IndexSetSize;
        i += CompactibleFreeListSpace::IndexSetStride) {
     assert((_global_num_workers[i] == 0) == (_global_num_blocks[i] == 0),
            "Counter inconsistency");
     if (_global_num_workers[i] > 0) {
+      if (PrintOldPLAB) {
+        size_t ifl_refills = _global_num_refills[i] - _global_num_reserve_refills[i] - _global_num_dict_refills[i];
+        gclog_or_tty->print_cr("[" SIZE_FORMAT "]: refills " SIZE_FORMAT " (indexed " SIZE_FORMAT
+                               ", reserve " SIZE_FORMAT ", dictionary " SIZE_FORMAT "), blocks " SIZE_FORMAT,
+                               i, _global_num_refills[i], ifl_refills, _global_num_reserve_refills[i],
+                               _global_num_dict_refills[i], _global_num_blocks[i]);
+      }
+      _global_num_refills[i] = 0;
+      _global_num_reserve_refills[i] = 0;
+      _global_num_dict_refills[i] = 0;
       // Need to smooth wrt historical average
       if (ResizeOldPLAB) {
         _blocks_to_claim[i].sample(
@@ -2717,6 +2838,11 @@ void CFLS_LAB::retire(int tid) {
   // so no need for locks and such.
   NOT_PRODUCT(Thread* t = Thread::current();)
   assert(Thread::current()->is_VM_thread(), "Error");
+  release_reserve();
+  _global_num_reserve_allocs += _num_reserve_allocs;
+  _global_num_dict_allocs += _num_dict_allocs;
+  _num_reserve_allocs = 0;
+  _num_dict_allocs = 0;
   for (size_t i =  CompactibleFreeListSpace::IndexSetStart;
        i < CompactibleFreeListSpace::IndexSetSize;
        i += CompactibleFreeListSpace::IndexSetStride) {
@@ -2732,6 +2858,9 @@ void CFLS_LAB::retire(int tid) {
         // Update globals stats for num_blocks used
         _global_num_blocks[i] += (_num_blocks[i] - num_retire);
         _global_num_workers[i]++;
+        _global_num_refills[i] += _num_refills[i];
+        _global_num_reserve_refills[i] += _num_reserve_refills[i];
+        _global_num_dict_refills[i] += _num_dict_refills[i];
         assert(_global_num_workers[i] <= ParallelGCThreads, "Too big");
         if (num_retire > 0) {
           _cfls->_indexedFreeList[i].prepend(&_indexedFreeList[i]);
@@ -2747,6 +2876,9 @@ void CFLS_LAB::retire(int tid) {
       // Reset stats for next round
       _num_blocks[i]         = 0;
     }
+    _num_refills[i]         = 0;
+    _num_reserve_refills[i] = 0;
+    _num_dict_refills[i]    = 0;
   }
 }
 
@@ -2937,6 +3069,11 @@ void CompactibleFreeListSpace:: par_get_chunk_of_blocks_dictionary(size_t word_s
     return;
   }
 
+  par_split_chunk_into_blocks(fc, word_sz, fl);
+}
+
+void CompactibleFreeListSpace::par_split_chunk_into_blocks(FreeChunk* fc, size_t word_sz,
+                                                           AdaptiveFreeList<FreeChunk>* fl) {
   size_t n = fc->size() / word_sz;
 
   assert((ssize_t)n > 0, "Consistency");
@@ -2987,6 +3124,41 @@ void CompactibleFreeListSpace:: par_get_chunk_of_blocks_dictionary(size_t word_s
   assert(fl->tail()->next() == NULL, "List invariant.");
 }
 
+FreeChunk* CompactibleFreeListSpace::par_split_chunk_prefix(FreeChunk* fc, size_t prefix_size) {
+  size_t size = fc->size();
+  assert(fc->is_free(), "Error: should be a free block");
+  assert(size >= prefix_size + MinChunkSize, "remainder too small");
+  size_t rem = size - prefix_size;
+  FreeChunk* rem_fc = (FreeChunk*)((HeapWord*)fc + prefix_size);
+  rem_fc->set_size(rem);
+  rem_fc->link_prev(NULL); // Mark as a free block for other (parallel) GC threads.
+  rem_fc->link_next(NULL);
+  // Above must occur before BOT is updated below.
+  OrderAccess::storestore();
+  _bt.split_block((HeapWord*)fc, size, prefix_size);
+  fc->set_size(prefix_size);
+  _bt.verify_single_block((HeapWord*)fc, prefix_size);
+  _bt.verify_single_block((HeapWord*)rem_fc, rem);
+  return rem_fc;
+}
+
+void CompactibleFreeListSpace::par_return_split_chunk(FreeChunk* fc) {
+  size_t size = fc->size();
+  assert(fc->is_free(), "Error: should be a free block");
+  _bt.verify_not_unallocated((HeapWord*)fc, size);
+  if (size >= IndexSetSize) {
+    MutexLockerEx x(parDictionaryAllocLock(),
+                    Mutex::_no_safepoint_check_flag);
+    returnChunkToDictionary(fc);
+    dictionary()->dict_census_update(size, true /*split*/, true /*birth*/);
+  } else {
+    MutexLockerEx x(_indexedFreeListParLocks[size],
+                    Mutex::_no_safepoint_check_flag);
+    _indexedFreeList[size].return_chunk_at_head(fc);
+    smallSplitBirth(size);
+  }
+}
+
 void CompactibleFreeListSpace:: par_get_chunk_of_blocks(size_t word_sz, size_t n, AdaptiveFreeList<FreeChunk>* fl) {
   assert(fl->count() == 0, "Precondition.");
   assert(word_sz < CompactibleFreeListSpace::IndexSetSize,
@@ -189,6 +189,21 @@ class CompactibleFreeListSpace: public CompactibleSpace {
   // dictionary.
   void par_get_chunk_of_blocks_dictionary(size_t word_sz, size_t n, AdaptiveFreeList<FreeChunk>* fl);
 
+  // Splits the free chunk "fc", whose size must be a multiple of "word_sz",
+  // into blocks of size "word_sz" and adds them to "fl". The chunk must not
+  // be on any free list.
+  void par_split_chunk_into_blocks(FreeChunk* fc, size_t word_sz, AdaptiveFreeList<FreeChunk>* fl);
+
+  // Splits off a prefix of "prefix_size" words of the free chunk "fc",
+  // which must not be on any free list, and returns the remainder, which
+  // is marked free and is not put on any free list either. The remainder
+  // must be at least MinChunkSize large.
+  FreeChunk* par_split_chunk_prefix(FreeChunk* fc, size_t prefix_size);
+
+  // Returns a free chunk split off during parallel promotion to the
+  // indexed free lists or the dictionary, taking the appropriate lock.
+  void par_return_split_chunk(FreeChunk* fc);
+
   // Allocation helper functions
   // Allocate using a strategy that takes from the indexed free lists
   // first.  This allocation strategy assumes a companion sweeping
@@ -660,9 +675,54 @@ class CFLS_LAB : public CHeapObj<mtGC> {
   static uint   _global_num_workers[CompactibleFreeListSpace::IndexSetSize];
   size_t        _num_blocks        [CompactibleFreeListSpace::IndexSetSize];
 
+  // Per size class refill statistics, accumulated over all workers by
+  // retire() and reported by compute_desired_plab_size().
+  static size_t _global_num_refills      [CompactibleFreeListSpace::IndexSetSize];
+  static size_t _global_num_reserve_refills[CompactibleFreeListSpace::IndexSetSize];
+  static size_t _global_num_dict_refills [CompactibleFreeListSpace::IndexSetSize];
+  size_t        _num_refills             [CompactibleFreeListSpace::IndexSetSize];
+  size_t        _num_reserve_refills     [CompactibleFreeListSpace::IndexSetSize];
+  size_t        _num_dict_refills        [CompactibleFreeListSpace::IndexSetSize];
+
+  // A range of the space reserved by this worker (see
+  // CMSParPromoteReserveSize). It is a single free chunk that is on no
+  // free list; blocks are split off its start without taking the
+  // dictionary lock. NULL if there is no reserved range.
+  FreeChunk*    _reserve;
+
+  // Allocations of blocks too large for the indexed free lists, from
+  // the reserve and from the dictionary.
+  size_t        _num_reserve_allocs;
+  size_t        _num_dict_allocs;
+  static size_t _global_num_reserve_allocs;
+  static size_t _global_num_dict_allocs;
+  static size_t _global_num_reserves;
+
   // Internal work method
   void get_from_global_pool(size_t word_sz, AdaptiveFreeList<FreeChunk>* fl);
 
+  // Whether blocks of the given size may be taken from the reserve.
+  static bool use_reserve_for(size_t word_sz) {
+    return CMSParPromoteReserveSize > 0 &&
+           word_sz <= CMSParPromoteReserveSize / 4;
+  }
+
+  // Split a block of exactly "word_sz" words off the reserve, replacing
+  // the reserve with a fresh range from the dictionary if needed.
+  // Returns NULL if that fails.
+  FreeChunk* get_from_reserve(size_t word_sz);
+
+  // Take up to "n" blocks of size "word_sz" from the reserve and add them
+  // to "fl". Returns false if no block could be taken.
+  bool get_blocks_from_reserve(size_t word_sz, size_t n, AdaptiveFreeList<FreeChunk>* fl);
+
+  // Replace the reserve with a fresh range of at least "min_word_sz"
+  // words from the dictionary.
+  bool refill_reserve(size_t min_word_sz);
+
+  // Return the reserve to the free lists of the space.
+  void release_reserve();
+
 public:
   CFLS_LAB(CompactibleFreeListSpace* cfls);
 
@@ -672,7 +732,8 @@ public:
   // Return any unused portions of the buffer to the global pool.
   void retire(int tid);
 
-  // Dynamic OldPLABSize sizing
+  // Dynamic OldPLABSize sizing; also prints the refill statistics
+  // of the last scavenge with PrintOldPLAB.
   static void compute_desired_plab_size();
   // When the settings are modified from default static initialization
   static void modify_initialization(size_t n, unsigned wt);
@@ -60,9 +60,11 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/java.hpp"
 #include "runtime/orderAccess.inline.hpp"
+#include "runtime/thread.inline.hpp"
 #include "runtime/vmThread.hpp"
 #include "services/memoryService.hpp"
 #include "services/runtimeService.hpp"
+#include "utilities/quickSort.hpp"
 #if INCLUDE_JVMCI
 #include "jvmci/jvmci.hpp"
 #endif
@@ -575,10 +577,10 @@ CMSCollector::CMSCollector(ConcurrentMarkSweepGeneration* cmsGen,
   _restart_addr(NULL),
   _overflow_list(NULL),
   _stats(cmsGen),
-  _eden_chunk_lock(new Mutex(Mutex::leaf + 1, "CMS_eden_chunk_lock", true)),
   _eden_chunk_array(NULL),     // may be set in ctor body
   _eden_chunk_capacity(0),     // -- ditto --
   _eden_chunk_index(0),        // -- ditto --
+  _eden_chunk_last_sample(NULL),
   _survivor_plab_array(NULL),  // -- ditto --
   _survivor_chunk_array(NULL), // -- ditto --
   _survivor_chunk_capacity(0), // -- ditto --
@@ -2847,6 +2849,7 @@ void CMSCollector::gc_epilogue(bool full) {
   }
   // reset _eden_chunk_array so sampling starts afresh
   _eden_chunk_index = 0;
+  _eden_chunk_last_sample = NULL;
 
   size_t cms_used   = _cmsGen->cmsSpace()->used();
   _cmsGen->cmsSpace()->recalculate_used_stable();
@@ -3742,10 +3745,6 @@ void CMSCollector::checkpointRootsInitialWork(bool asynch) {
   // the klasses. The claimed marks need to be cleared before marking starts.
   ClassLoaderDataGraph::clear_claimed_marks();
 
-  if (CMSPrintEdenSurvivorChunks) {
-    print_eden_and_survivor_chunk_arrays();
-  }
-
   {
 #if defined(COMPILER2) || INCLUDE_JVMCI
     DerivedPointerTableDeactivate dpt_deact;
@@ -5136,10 +5135,6 @@ void CMSCollector::checkpointRootsFinalWork(bool asynch,
     // Update the saved marks which may affect the root scans.
     gch->save_marks();
 
-    if (CMSPrintEdenSurvivorChunks) {
-      print_eden_and_survivor_chunk_arrays();
-    }
-
     {
 #if defined(COMPILER2) || INCLUDE_JVMCI
       DerivedPointerTableDeactivate dpt_deact;
@@ -5711,24 +5706,89 @@ CMSParRemarkTask::do_work_steal(int i, Par_MarkRefsIntoAndScanClosure* cl,
 // CMSEdenChunksRecordAlways is false, we use the other asynchronous
 // sampling in sample_eden() that activates during the part of the
 // preclean phase.
+//
+// The samples are recorded without locking so that none are lost
+// when many threads refill their TLABs at the same time, as happens
+// during allocation bursts. A thread claims a sample by advancing
+// _eden_chunk_last_sample by at least CMSSamplingGrain; this bounds
+// the number of samples by _eden_chunk_capacity. Since the slots may
+// be written out of address order, the array is sorted by
+// finalize_eden_chunk_array() before it is used.
 void CMSCollector::sample_eden_chunk() {
   if (CMSEdenChunksRecordAlways && _eden_chunk_array != NULL) {
-    if (_eden_chunk_lock->try_lock()) {
-      // Record a sample. This is the critical section. The contents
-      // of the _eden_chunk_array have to be non-decreasing in the
-      // address order.
-      _eden_chunk_array[_eden_chunk_index] = *_top_addr;
-      assert(_eden_chunk_array[_eden_chunk_index] <= *_end_addr,
-             "Unexpected state of Eden");
-      if (_eden_chunk_index == 0 ||
-          ((_eden_chunk_array[_eden_chunk_index] > _eden_chunk_array[_eden_chunk_index-1]) &&
-           (pointer_delta(_eden_chunk_array[_eden_chunk_index],
-                          _eden_chunk_array[_eden_chunk_index-1]) >= CMSSamplingGrain))) {
-        _eden_chunk_index++;  // commit sample
+    HeapWord* last = _eden_chunk_last_sample;
+    HeapWord* cur  = *_top_addr;
+    assert(cur <= *_end_addr, "Unexpected state of Eden");
+    if (last != NULL &&
+        (cur <= last || pointer_delta(cur, last) < CMSSamplingGrain)) {
+      return;
+    }
+    if (Atomic::cmpxchg_ptr(cur, &_eden_chunk_last_sample, last) != last) {
+      // Another thread recorded a sample at about the same address.
+      return;
+    }
+    size_t index = (size_t)Atomic::add_ptr(1, (volatile intptr_t*)&_eden_chunk_index) - 1;
+    if (index < _eden_chunk_capacity) {
+      _eden_chunk_array[index] = cur;   // commit sample
+    }
+  }
+}
+
+static int compare_eden_chunks(HeapWord** a, HeapWord** b) {
+  if (*a < *b) {
+    return -1;
+  } else if (*a > *b) {
+    return 1;
+  }
+  return 0;
+}
+
+// Turn the eden samples into strictly increasing chunk boundaries
+// within the used part of eden. The start of the current TLAB of
+// each thread is an exact object boundary as well; adding them puts
+// boundaries into the most recently allocated part of eden, which
+// the samples may not have covered yet.
+void CMSCollector::finalize_eden_chunk_array(EdenSpace* eden) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Eden must be stable");
+  if (_eden_chunk_array == NULL) {
+    return;
+  }
+  size_t n = MIN2((size_t)_eden_chunk_index, _eden_chunk_capacity);
+  if (CMSEdenChunksRecordAlways && UseTLAB) {
+    for (JavaThread* thread = Threads::first();
+         thread != NULL && n < _eden_chunk_capacity;
+         thread = thread->next()) {
+      HeapWord* start = thread->tlab().start();
+      if (start != NULL && eden->used_region().contains(start)) {
+        _eden_chunk_array[n++] = start;
+      }
+      start = thread->medium_tlab().start();
+      if (start != NULL && n < _eden_chunk_capacity &&
+          eden->used_region().contains(start)) {
+        _eden_chunk_array[n++] = start;
       }
-      _eden_chunk_lock->unlock();
     }
   }
+  QuickSort::sort<HeapWord*>(_eden_chunk_array, (int)n, compare_eden_chunks, false);
+  HeapWord* bottom = eden->bottom();
+  HeapWord* top    = eden->top();
+  HeapWord* prev   = bottom;
+  size_t    index  = 0;
+  for (size_t i = 0; i < n; i++) {
+    HeapWord* cur = _eden_chunk_array[i];
+    if (cur >= top) {
+      break;
+    }
+    if (cur > prev &&
+        (index == 0 || pointer_delta(cur, prev) >= CMSSamplingGrain)) {
+      _eden_chunk_array[index++] = cur;
+      prev = cur;
+    }
+  }
+  _eden_chunk_index = index;
+  if (PrintCMSStatistics > 0) {
+    gclog_or_tty->print(" (Eden:" SIZE_FORMAT "chunks) ", index);
+  }
 }
 
 // Return a thread-local PLAB recording array, as appropriate.
@@ -5833,6 +5893,7 @@ initialize_sequential_subtasks_for_young_gen_rescan(int n_threads) {
 
   // Eden space
   if (!dng->eden()->is_empty()) {
+    finalize_eden_chunk_array(dng->eden());
     SequentialSubTasksDone* pst = dng->eden()->par_seq_tasks();
     assert(!pst->valid(), "Clobbering existing data?");
     // Each valid entry in [0, _eden_chunk_index) represents a task.
@@ -5874,6 +5935,11 @@ initialize_sequential_subtasks_for_young_gen_rescan(int n_threads) {
     pst->set_n_tasks((int)n_tasks);
     assert(pst->valid(), "Error");
   }
+
+  // Print the chunk arrays once they are final
+  if (CMSPrintEdenSurvivorChunks) {
+    print_eden_and_survivor_chunk_arrays();
+  }
 }
 
 // Parallel version of remark
@@ -6563,9 +6629,24 @@ void CMSCollector::sweepWork(ConcurrentMarkSweepGeneration* gen,
                                       _intra_sweep_estimate.padded_average());
   gen->setNearLargestChunk();
 
+  // Fragmentation builds up when the census keeps small blocks apart
+  // for a demand that does not materialize, and eventually makes
+  // promotion fail. Above CMSFragmentationTarget, this sweep
+  // coalesces runs of free small blocks into larger ones.
+  double frag = gen->cmsSpace()->flsFrag() * 100.0;
+  bool defragment = CMSFragmentationTarget > 0 && frag > (double)CMSFragmentationTarget;
+  size_policy()->avg_cms_fragmentation()->sample((float)frag);
+  if (defragment) {
+    size_policy()->increment_defragmenting_sweeps();
+  }
+  if (PrintFLSStatistics != 0) {
+    gclog_or_tty->print_cr("CMS: fragmentation at sweep %1.2f%%%s", frag,
+                           defragment ? ", defragmenting" : "");
+  }
+
   {
     SweepClosure sweepClosure(this, gen, &_markBitMap,
-                            CMSYield && asynch);
+                            CMSYield && asynch, defragment);
     gen->cmsSpace()->blk_iterate_careful(&sweepClosure);
     // We need to free-up/coalesce garbage/blocks from a
     // co-terminal free run. This is done in the SweepClosure
@@ -8187,7 +8268,8 @@ void MarkFromDirtyCardsClosure::do_MemRegion(MemRegion mr) {
 
 SweepClosure::SweepClosure(CMSCollector* collector,
                            ConcurrentMarkSweepGeneration* g,
-                           CMSBitMap* bitMap, bool should_yield) :
+                           CMSBitMap* bitMap, bool should_yield,
+                           bool defragment) :
   _collector(collector),
   _g(g),
   _sp(g->cmsSpace()),
@@ -8195,6 +8277,7 @@ SweepClosure::SweepClosure(CMSCollector* collector,
   _freelistLock(_sp->freelistLock()),
   _bitMap(bitMap),
   _yield(should_yield),
+  _defragment(defragment),
   _inFreeRange(false),           // No free range at beginning of sweep
   _freeRangeInFreeLists(false),  // No free range at beginning of sweep
   _lastFreeRangeCoalesced(false),
@@ -8683,6 +8766,13 @@ void SweepClosure::do_post_free_or_garbage_chunk(FreeChunk* fc,
     default:
      ShouldNotReachHere();
   }
+  // In a defragmenting sweep, also coalesce whenever either side is
+  // a small block, leaving the census to decide only between large
+  // blocks.
+  if (!coalesce && _defragment) {
+    coalesce = left  < CompactibleFreeListSpace::SmallForDictionary ||
+               right < CompactibleFreeListSpace::SmallForDictionary;
+  }
 
   // Should the current free range be coalesced?
   // If the chunk is in a free range and either we decided to coalesce above
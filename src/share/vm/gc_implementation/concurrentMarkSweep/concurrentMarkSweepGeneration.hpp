@@ -752,10 +752,12 @@ class CMSCollector: public CHeapObj<mtGC> {
   Generation* _young_gen;  // the younger gen
   HeapWord** _top_addr;    // ... Top of Eden
   HeapWord** _end_addr;    // ... End of Eden
-  Mutex*     _eden_chunk_lock;
   HeapWord** _eden_chunk_array; // ... Eden partitioning array
-  size_t     _eden_chunk_index; // ... top (exclusive) of array
+  volatile size_t _eden_chunk_index; // ... top (exclusive) of array
   size_t     _eden_chunk_capacity;  // ... max entries in array
+  // The last sample claimed by sample_eden_chunk(); samples are
+  // recorded without locking by the allocating threads.
+  HeapWord* volatile _eden_chunk_last_sample;
 
   // Support for parallelizing survivor space rescan
   HeapWord** _survivor_chunk_array;
@@ -813,6 +815,9 @@ class CMSCollector: public CHeapObj<mtGC> {
   void initialize_sequential_subtasks_for_young_gen_rescan(int i);
   // Helper function for above; merge-sorts the per-thread plab samples
   void merge_survivor_plab_arrays(ContiguousSpace* surv, int no_of_gc_threads);
+  // Helper function for above; adds the TLAB boundaries of all threads
+  // to the eden samples and sorts them into the eden chunk boundaries
+  void finalize_eden_chunk_array(EdenSpace* eden);
   // Resets (i.e. clears) the per-thread plab sample vectors
   void reset_survivor_plab_arrays();
 
@@ -1767,6 +1772,13 @@ class SweepClosure: public BlkClosureCareful {
                                         // done with yields. For instance
                                         // when done by the foreground
                                         // collector we shouldn't yield.
+  bool                           _defragment;
+                                        // Whether free ranges containing
+                                        // small blocks should be coalesced
+                                        // regardless of the free list
+                                        // census, because the space is
+                                        // more fragmented than
+                                        // CMSFragmentationTarget.
   HeapWord*                      _freeFinger;   // When _inFreeRange is set, the
                                                 // pointer to the "left hand
                                                 // chunk"
@@ -1824,7 +1836,7 @@ class SweepClosure: public BlkClosureCareful {
 
  public:
   SweepClosure(CMSCollector* collector, ConcurrentMarkSweepGeneration* g,
-               CMSBitMap* bitMap, bool should_yield);
+               CMSBitMap* bitMap, bool should_yield, bool defragment);
   ~SweepClosure() PRODUCT_RETURN;
 
   size_t       do_blk_careful(HeapWord* addr);
@@ -104,12 +104,13 @@ public:
 
   // Determine whether to add the given region to the CSet chooser or
   // not. Currently, we skip humongous regions (we never add them to
-  // the CSet, we only reclaim them during cleanup) and regions whose
-  // live bytes are over the threshold.
+  // the CSet, we only reclaim them during cleanup), archive regions
+  // and regions whose live bytes are over the threshold.
   bool should_add(HeapRegion* hr) {
     assert(hr->is_marked(), "pre-condition");
     assert(!hr->is_young(), "should never consider young regions");
     return !hr->isHumongous() &&
+            !hr->is_archive() &&
             hr->live_bytes() < _region_live_threshold_bytes;
   }
 
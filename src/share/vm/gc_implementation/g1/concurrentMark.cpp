@@ -1874,7 +1874,8 @@ public:
     hr->note_end_of_marking();
     _max_live_bytes += hr->max_live_bytes();
 
-    if (hr->used() > 0 && hr->max_live_bytes() == 0 && !hr->is_young()) {
+    if (hr->used() > 0 && hr->max_live_bytes() == 0 &&
+        !hr->is_young() && !hr->is_archive()) {
       _freed_bytes += hr->used();
       hr->set_containing_set(NULL);
       if (hr->isHumongous()) {
@@ -53,11 +53,17 @@ public:
    virtual void release_gc_alloc_regions(uint no_of_gc_workers, EvacuationInfo& evacuation_info) = 0;
    virtual void abandon_gc_alloc_regions() = 0;
 
+   // Returns the mutator alloc region for the NUMA node of the current thread.
    virtual MutatorAllocRegion*    mutator_alloc_region(AllocationContext_t context) = 0;
-   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context) = 0;
+   virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index) = 0;
+   // The number of regions used by all survivor GC alloc regions.
+   virtual uint                   survivor_gc_alloc_regions_count(AllocationContext_t context) = 0;
    virtual OldGCAllocRegion*      old_gc_alloc_region(AllocationContext_t context) = 0;
    virtual size_t                 used() = 0;
    virtual bool                   is_retained_old_region(HeapRegion* hr) = 0;
+   // The largest TLAB, up to max_tlab bytes, that fits into the mutator alloc
+   // region of any NUMA node.
+   virtual size_t                 unsafe_max_tlab_alloc(size_t max_tlab) = 0;
 
    void                           reuse_retained_old_region(EvacuationInfo& evacuation_info,
                                                             OldGCAllocRegion* old,
@@ -90,14 +96,20 @@ public:
 };
 
 // The default allocator for G1.
+//
+// Mutator and survivor alloc regions are kept per NUMA node (see G1NUMA),
+// so that threads allocate into regions placed on the node they run on.
 class G1DefaultAllocator : public G1Allocator {
 protected:
-  // Alloc region used to satisfy mutator allocation requests.
-  MutatorAllocRegion _mutator_alloc_region;
+  // The number of mutator and survivor alloc regions, one per NUMA node.
+  uint _num_alloc_regions;
 
-  // Alloc region used to satisfy allocation requests by the GC for
+  // Alloc regions used to satisfy mutator allocation requests.
+  MutatorAllocRegion* _mutator_alloc_regions;
+
+  // Alloc regions used to satisfy allocation requests by the GC for
   // survivor objects.
-  SurvivorGCAllocRegion _survivor_gc_alloc_region;
+  SurvivorGCAllocRegion* _survivor_gc_alloc_regions;
 
   // Alloc region used to satisfy allocation requests by the GC for
   // old objects.
@@ -105,7 +117,7 @@ protected:
 
   HeapRegion* _retained_old_gc_alloc_region;
 public:
-  G1DefaultAllocator(G1CollectedHeap* heap) : G1Allocator(heap), _retained_old_gc_alloc_region(NULL) { }
+  G1DefaultAllocator(G1CollectedHeap* heap);
 
   virtual void init_mutator_alloc_region();
   virtual void release_mutator_alloc_region();
@@ -118,12 +130,22 @@ public:
     return _retained_old_gc_alloc_region == hr;
   }
 
-  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context) {
-    return &_mutator_alloc_region;
+  virtual MutatorAllocRegion* mutator_alloc_region(AllocationContext_t context);
+  virtual size_t unsafe_max_tlab_alloc(size_t max_tlab);
+
+  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context, uint node_index) {
+    if (node_index >= _num_alloc_regions) {
+      node_index = 0;
+    }
+    return &_survivor_gc_alloc_regions[node_index];
   }
 
-  virtual SurvivorGCAllocRegion* survivor_gc_alloc_region(AllocationContext_t context) {
-    return &_survivor_gc_alloc_region;
+  virtual uint survivor_gc_alloc_regions_count(AllocationContext_t context) {
+    uint count = 0;
+    for (uint i = 0; i < _num_alloc_regions; i++) {
+      count += _survivor_gc_alloc_regions[i].count();
+    }
+    return count;
   }
 
   virtual OldGCAllocRegion* old_gc_alloc_region(AllocationContext_t context) {
@@ -135,10 +157,12 @@ public:
            "Should be owned on this thread's behalf.");
     size_t result = _summary_bytes_used;
 
-    // Read only once in case it is set to NULL concurrently
-    HeapRegion* hr = mutator_alloc_region(AllocationContext::current())->get();
-    if (hr != NULL) {
-      result += hr->used();
+    for (uint i = 0; i < _num_alloc_regions; i++) {
+      // Read only once in case it is set to NULL concurrently
+      HeapRegion* hr = _mutator_alloc_regions[i].get();
+      if (hr != NULL) {
+        result += hr->used();
+      }
     }
     return result;
   }
@@ -217,6 +241,7 @@ public:
   // Allocate word_sz words in dest, either directly into the regions or by
   // allocating a new PLAB. Returns the address of the allocated memory, NULL if
   // not successful.
+  // Survivor space is taken from the NUMA node the current thread runs on.
   HeapWord* allocate_direct_or_new_plab(InCSetState dest,
                                         size_t word_sz,
                                         AllocationContext_t context);
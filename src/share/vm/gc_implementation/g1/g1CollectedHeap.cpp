@@ -509,7 +509,7 @@ G1CollectedHeap* G1CollectedHeap::_g1h;
 // Private methods.
 
 HeapRegion*
-G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
+G1CollectedHeap::new_region_try_secondary_free_list(bool is_old, uint node_index) {
   MutexLockerEx x(SecondaryFreeList_lock, Mutex::_no_safepoint_check_flag);
   while (!_secondary_free_list.is_empty() || free_regions_coming()) {
     if (!_secondary_free_list.is_empty()) {
@@ -525,7 +525,7 @@ G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
 
       assert(_hrm.num_free_regions() > 0, "if the secondary_free_list was not "
              "empty we should have moved at least one entry to the free_list");
-      HeapRegion* res = _hrm.allocate_free_region(is_old);
+      HeapRegion* res = _hrm.allocate_free_region(is_old, node_index);
       if (G1ConcRegionFreeingVerbose) {
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "allocated " HR_FORMAT " from secondary_free_list",
@@ -547,7 +547,8 @@ G1CollectedHeap::new_region_try_secondary_free_list(bool is_old) {
   return NULL;
 }
 
-HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand) {
+HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_expand,
+                                        uint node_index) {
   assert(!isHumongous(word_size) || word_size <= HeapRegion::GrainWords,
          "the only time we use this to allocate a humongous region is "
          "when we are allocating a single humongous region");
@@ -559,21 +560,21 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "forced to look at the secondary_free_list");
       }
-      res = new_region_try_secondary_free_list(is_old);
+      res = new_region_try_secondary_free_list(is_old, node_index);
       if (res != NULL) {
         return res;
       }
     }
   }
 
-  res = _hrm.allocate_free_region(is_old);
+  res = _hrm.allocate_free_region(is_old, node_index);
 
   if (res == NULL) {
     if (G1ConcRegionFreeingVerbose) {
       gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                              "res == NULL, trying the secondary_free_list");
     }
-    res = new_region_try_secondary_free_list(is_old);
+    res = new_region_try_secondary_free_list(is_old, node_index);
   }
   if (res == NULL && do_expand && _expand_heap_after_alloc_failure) {
     // Currently, only attempts to allocate GC alloc regions set
@@ -592,7 +593,7 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool is_old, bool do_e
       // always expand the heap by an amount aligned to the heap
       // region size, the free list should in theory not be empty.
       // In either case allocate_free_region() will check for NULL.
-      res = _hrm.allocate_free_region(is_old);
+      res = _hrm.allocate_free_region(is_old, node_index);
     } else {
       _expand_heap_after_alloc_failure = false;
     }
@@ -913,22 +914,23 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
 
     {
       MutexLockerEx x(Heap_lock);
-      result = _allocator->mutator_alloc_region(context)->attempt_allocation_locked(word_size,
-                                                                                    false /* bot_updates */);
+      // Select the region of the thread's NUMA node once, so that all
+      // steps below work on the same region even if the thread moves.
+      MutatorAllocRegion* alloc_region = _allocator->mutator_alloc_region(context);
+      result = alloc_region->attempt_allocation_locked(word_size, false /* bot_updates */);
       if (result != NULL) {
         return result;
       }
 
       // If we reach here, attempt_allocation_locked() above failed to
       // allocate a new region. So the mutator alloc region should be NULL.
-      assert(_allocator->mutator_alloc_region(context)->get() == NULL, "only way to get here");
+      assert(alloc_region->get() == NULL, "only way to get here");
 
       if (GC_locker::is_active_and_needs_gc()) {
         if (g1_policy()->can_expand_young_list()) {
           // No need for an ergo verbose message here,
           // can_expand_young_list() does this when it returns true.
-          result = _allocator->mutator_alloc_region(context)->attempt_allocation_force(word_size,
-                                                                                       false /* bot_updates */);
+          result = alloc_region->attempt_allocation_force(word_size, false /* bot_updates */);
           if (result != NULL) {
             return result;
           }
@@ -1234,7 +1236,7 @@ public:
       }
     } else if (hr->continuesHumongous()) {
       _hr_printer->post_compaction(hr, G1HRPrinter::ContinuesHumongous);
-    } else if (hr->is_old()) {
+    } else if (hr->is_old() || hr->is_archive()) {
       _hr_printer->post_compaction(hr, G1HRPrinter::Old);
     } else {
       ShouldNotReachHere();
@@ -1749,6 +1751,96 @@ HeapWord* G1CollectedHeap::expand_and_allocate(size_t word_size, AllocationConte
   return NULL;
 }
 
+bool G1CollectedHeap::alloc_archive_regions(MemRegion range) {
+  assert(range.start() < range.end(), "empty range");
+  assert(is_in_reserved(range.start()) && is_in_reserved(range.last()),
+         "range must be in the heap");
+  MutexLockerEx x(Heap_lock);
+
+  size_t commits = 0;
+  if (!_hrm.allocate_containing_regions(range, &commits)) {
+    return false;
+  }
+  if (commits != 0) {
+    ergo_verbose1(ErgoHeapSizing,
+                  "attempt heap expansion",
+                  ergo_format_reason("allocate archive regions")
+                  ergo_format_byte("total size"),
+                  HeapRegion::GrainWords * HeapWordSize * commits);
+    g1_policy()->record_new_heap_size(num_regions());
+  }
+
+  HeapRegion* curr_region = heap_region_containing(range.start());
+  HeapRegion* last_region = heap_region_containing(range.last());
+  while (true) {
+    HeapWord* top = curr_region == last_region ? range.end() : curr_region->end();
+    curr_region->set_allocation_context(AllocationContext::system());
+    curr_region->set_archive();
+    curr_region->set_top(top);
+    _old_set.add(curr_region);
+    _allocator->increase_used(curr_region->used());
+    if (_hr_printer.is_active()) {
+      _hr_printer.alloc(G1HRPrinter::Old, curr_region, top);
+    }
+    if (curr_region == last_region) {
+      break;
+    }
+    curr_region = _hrm.next_region_in_heap(curr_region);
+  }
+  return true;
+}
+
+// Fill [start, start + words) with dummy objects small enough not to be
+// taken for humongous objects, which the verification does not expect
+// in a live part of a non-humongous region.
+static void fill_with_non_humongous_objects(HeapWord* start, size_t words) {
+  const size_t max = HeapRegion::GrainWords / 2;
+  const size_t min = CollectedHeap::min_fill_size();
+  while (words > max) {
+    const size_t cur = (words - max) >= min ? max : max - min;
+    CollectedHeap::fill_with_object(start, cur);
+    start += cur;
+    words -= cur;
+  }
+  CollectedHeap::fill_with_object(start, words);
+}
+
+void G1CollectedHeap::fill_archive_regions(MemRegion range, bool fill_range) {
+  MutexLockerEx x(Heap_lock);
+
+  HeapRegion* curr_region = heap_region_containing(range.start());
+  HeapRegion* last_region = heap_region_containing(range.last());
+  if (fill_range) {
+    fill_with_non_humongous_objects(range.start(), range.word_size());
+  }
+
+  // The range starts at a 1M boundary, which need not be a region
+  // boundary. The space below it was counted as used when the region
+  // was allocated.
+  if (range.start() > curr_region->bottom()) {
+    fill_with_non_humongous_objects(curr_region->bottom(),
+                                    pointer_delta(range.start(), curr_region->bottom()));
+  }
+
+  // The archived objects were not allocated through the regions, so
+  // record them in the block offset tables.
+  while (true) {
+    HeapWord* p = curr_region->bottom();
+    while (p < curr_region->top()) {
+      size_t size = oop(p)->size();
+      curr_region->alloc_block_in_bot(p, p + size);
+      p += size;
+    }
+    guarantee(p == curr_region->top(), "archived objects must not cross regions");
+    if (curr_region == last_region) {
+      break;
+    }
+    curr_region = _hrm.next_region_in_heap(curr_region);
+  }
+
+  MarkSweep::set_archive_range(range);
+}
+
 bool G1CollectedHeap::expand(size_t expand_bytes) {
   size_t aligned_expand_bytes = ReservedSpace::page_align_size_up(expand_bytes);
   aligned_expand_bytes = align_size_up(aligned_expand_bytes,
@@ -1884,6 +1976,8 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
 
   _g1h = this;
 
+  // The allocator sets up its alloc regions per NUMA node.
+  _numa = G1NUMA::create();
   _allocator = G1Allocator::create_allocator(_g1h);
   _humongous_object_threshold_in_words = HeapRegion::GrainWords / 2;
 
@@ -2907,20 +3001,14 @@ size_t G1CollectedHeap::max_tlab_size() const {
 }
 
 size_t G1CollectedHeap::unsafe_max_tlab_alloc(Thread* ignored) const {
-  // Return the remaining space in the cur alloc region, but not less than
-  // the min TLAB size.
+  // Return the remaining space in the largest alloc region of all NUMA
+  // nodes, but not less than the min TLAB size.
 
   // Also, this value can be at most the humongous object threshold,
   // since we can't allow tlabs to grow big enough to accommodate
   // humongous objects.
 
-  HeapRegion* hr = _allocator->mutator_alloc_region(AllocationContext::current())->get();
-  size_t max_tlab = max_tlab_size() * wordSize;
-  if (hr == NULL) {
-    return max_tlab;
-  } else {
-    return MIN2(MAX2(hr->free(), (size_t) MinTLABSize), max_tlab);
-  }
+  return _allocator->unsafe_max_tlab_alloc(max_tlab_size() * wordSize);
 }
 
 size_t G1CollectedHeap::max_capacity() const {
@@ -3231,7 +3319,9 @@ public:
       } else {
         VerifyObjsInRegionClosure not_dead_yet_cl(r, _vo);
         r->object_iterate(&not_dead_yet_cl);
-        if (_vo != VerifyOption_G1UseNextMarking) {
+        if (_vo != VerifyOption_G1UseNextMarking && !r->is_archive()) {
+          // Archived objects are live without being marked, so the
+          // marking based live bytes do not account for them.
           if (r->max_live_bytes() < not_dead_yet_cl.live_bytes()) {
             gclog_or_tty->print_cr("[" PTR_FORMAT "," PTR_FORMAT "] "
                                    "max_live_bytes " SIZE_FORMAT " "
@@ -3432,7 +3522,7 @@ bool G1CollectedHeap::is_obj_dead_cond(const oop obj,
   switch (vo) {
   case VerifyOption_G1UsePrevMarking: return is_obj_dead(obj, hr);
   case VerifyOption_G1UseNextMarking: return is_obj_ill(obj, hr);
-  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked();
+  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked() && !hr->is_archive();
   default:                            ShouldNotReachHere();
   }
   return false; // keep some compilers happy
@@ -3443,7 +3533,8 @@ bool G1CollectedHeap::is_obj_dead_cond(const oop obj,
   switch (vo) {
   case VerifyOption_G1UsePrevMarking: return is_obj_dead(obj);
   case VerifyOption_G1UseNextMarking: return is_obj_ill(obj);
-  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked();
+  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked() &&
+                                             !heap_region_containing(obj)->is_archive();
   default:                            ShouldNotReachHere();
   }
   return false; // keep some compilers happy
@@ -3466,6 +3557,9 @@ void G1CollectedHeap::print_on(outputStream* st) const {
   st->print("%u survivors (" SIZE_FORMAT "K)", survivor_regions,
             (size_t) survivor_regions * HeapRegion::GrainBytes / K);
   st->cr();
+  if (_numa->is_enabled()) {
+    _numa->print_on(st);
+  }
   MetaspaceAux::print_on(st);
 }
 
@@ -6600,7 +6694,7 @@ public:
   TearDownRegionSetsClosure(HeapRegionSet* old_set) : _old_set(old_set) { }
 
   bool doHeapRegion(HeapRegion* r) {
-    if (r->is_old()) {
+    if (r->is_old() || r->is_archive()) {
       _old_set->remove(r);
     } else {
       // We ignore free regions, we'll empty the free list afterwards.
@@ -6666,6 +6760,9 @@ public:
 
       if (r->isHumongous()) {
         // We ignore humongous regions, we left the humongous set unchanged
+      } else if (r->is_archive()) {
+        // Archive regions keep their type and go back to the old set.
+        _old_set->add(r);
       } else {
         // Objects that were compacted would have ended up on regions
         // that were previously old or free.
@@ -6716,7 +6813,8 @@ bool G1CollectedHeap::is_in_closed_subset(const void* p) const {
 // Methods for the mutator alloc region
 
 HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
-                                                      bool force) {
+                                                      bool force,
+                                                      uint node_index) {
   assert_heap_locked_or_at_safepoint(true /* should_be_vm_thread */);
   assert(!force || g1_policy()->can_expand_young_list(),
          "if force is true we should be able to expand the young list");
@@ -6724,7 +6822,8 @@ HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
   if (force || !young_list_full) {
     HeapRegion* new_alloc_region = new_region(word_size,
                                               false /* is_old */,
-                                              false /* do_expand */);
+                                              false /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       set_region_short_lived_locked(new_alloc_region);
       _hr_printer.alloc(new_alloc_region, G1HRPrinter::Eden, young_list_full);
@@ -6769,14 +6868,16 @@ void G1CollectedHeap::set_par_threads() {
 
 HeapRegion* G1CollectedHeap::new_gc_alloc_region(size_t word_size,
                                                  uint count,
-                                                 InCSetState dest) {
+                                                 InCSetState dest,
+                                                 uint node_index) {
   assert(FreeList_lock->owned_by_self(), "pre-condition");
 
   if (count < g1_policy()->max_regions(dest)) {
     const bool is_survivor = (dest.is_young());
     HeapRegion* new_alloc_region = new_region(word_size,
                                               !is_survivor,
-                                              true /* do_expand */);
+                                              true /* do_expand */,
+                                              node_index);
     if (new_alloc_region != NULL) {
       // We really only need to do this for old regions given that we
       // should never scan survivors. But it doesn't hurt to do it
@@ -6845,7 +6946,7 @@ public:
     } else if (hr->is_empty()) {
       assert(_hrm->is_free(hr), err_msg("Heap region %u is empty but not on the free list.", hr->hrm_index()));
       _free_count.increment(1u, hr->capacity());
-    } else if (hr->is_old()) {
+    } else if (hr->is_old() || hr->is_archive()) {
       assert(hr->containing_set() == _old_set, err_msg("Heap region %u is old but not in the old set.", hr->hrm_index()));
       _old_count.increment(1u, hr->capacity());
     } else {
@@ -232,6 +232,10 @@ void G1MarkSweep::mark_sweep_phase2() {
 class G1AdjustPointersClosure: public HeapRegionClosure {
  public:
   bool doHeapRegion(HeapRegion* r) {
+    if (r->is_archive()) {
+      // Archived objects only refer to each other and never move.
+      return false;
+    }
     if (r->isHumongous()) {
       if (r->startsHumongous()) {
         // We must adjust the pointers on the single H object.
@@ -287,6 +291,9 @@ public:
   G1SpaceCompactClosure() {}
 
   bool doHeapRegion(HeapRegion* hr) {
+    if (hr->is_archive()) {
+      return false;
+    }
     if (hr->isHumongous()) {
       if (hr->startsHumongous()) {
         oop obj = oop(hr->bottom());
@@ -369,6 +376,10 @@ void G1PrepareCompactClosure::update_sets() {
 }
 
 bool G1PrepareCompactClosure::doHeapRegion(HeapRegion* hr) {
+  if (hr->is_archive()) {
+    // Archive regions are neither compacted nor compacted into.
+    return false;
+  }
   if (hr->isHumongous()) {
     if (hr->startsHumongous()) {
       oop obj = oop(hr->bottom());
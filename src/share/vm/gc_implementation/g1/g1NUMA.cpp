@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
+#include "gc_implementation/g1/heapRegion.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "runtime/osThread.hpp"
+#include "runtime/thread.inline.hpp"
+
+G1NUMA::G1NUMA() :
+  _node_ids(NULL), _num_active_nodes(0), _is_simulated(false),
+  _page_size(0), _local_region_allocs(NULL), _remote_region_allocs(NULL) {
+}
+
+G1NUMA* G1NUMA::create() {
+  G1NUMA* numa = new G1NUMA();
+
+  if (G1NUMASimulatedNodes > 1) {
+    numa->initialize_simulated((uint)G1NUMASimulatedNodes);
+  } else if (UseNUMA) {
+    numa->initialize_from_os();
+  } else {
+    numa->initialize_without_numa();
+  }
+
+  numa->_page_size = UseLargePages ? os::large_page_size() : os::vm_page_size();
+
+  uint n = numa->_num_active_nodes;
+  numa->_local_region_allocs = NEW_C_HEAP_ARRAY(size_t, n, mtGC);
+  numa->_remote_region_allocs = NEW_C_HEAP_ARRAY(size_t, n, mtGC);
+  for (uint i = 0; i < n; i++) {
+    numa->_local_region_allocs[i] = 0;
+    numa->_remote_region_allocs[i] = 0;
+  }
+  return numa;
+}
+
+G1NUMA::~G1NUMA() {
+  FREE_C_HEAP_ARRAY(int, _node_ids, mtGC);
+  FREE_C_HEAP_ARRAY(size_t, _local_region_allocs, mtGC);
+  FREE_C_HEAP_ARRAY(size_t, _remote_region_allocs, mtGC);
+}
+
+void G1NUMA::initialize_without_numa() {
+  _num_active_nodes = 1;
+  _node_ids = NEW_C_HEAP_ARRAY(int, 1, mtGC);
+  _node_ids[0] = 0;
+}
+
+void G1NUMA::initialize_simulated(uint num_nodes) {
+  _is_simulated = true;
+  _num_active_nodes = num_nodes;
+  _node_ids = NEW_C_HEAP_ARRAY(int, num_nodes, mtGC);
+  for (uint i = 0; i < num_nodes; i++) {
+    _node_ids[i] = (int)i;
+  }
+}
+
+void G1NUMA::initialize_from_os() {
+  size_t max_node_ids = os::numa_get_groups_num();
+  if (max_node_ids <= 1) {
+    initialize_without_numa();
+    return;
+  }
+  _node_ids = NEW_C_HEAP_ARRAY(int, max_node_ids, mtGC);
+  _num_active_nodes = (uint)os::numa_get_leaf_groups(_node_ids, max_node_ids);
+  if (_num_active_nodes == 0) {
+    FREE_C_HEAP_ARRAY(int, _node_ids, mtGC);
+    initialize_without_numa();
+  }
+}
+
+int G1NUMA::node_id(uint node_index) const {
+  assert(node_index < _num_active_nodes,
+         err_msg("Node index %u out of bounds (%u)", node_index, _num_active_nodes));
+  return _node_ids[node_index];
+}
+
+uint G1NUMA::index_of_node_id(int node_id) const {
+  for (uint i = 0; i < _num_active_nodes; i++) {
+    if (_node_ids[i] == node_id) {
+      return i;
+    }
+  }
+  return UnknownNodeIndex;
+}
+
+uint G1NUMA::index_of_current_thread() const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  if (_is_simulated) {
+    // Spread threads over the simulated nodes by their OS thread id, which
+    // stays the same for the lifetime of the thread.
+    Thread* thread = Thread::current();
+    OSThread* osthread = thread->osthread();
+    if (osthread == NULL) {
+      return 0;
+    }
+    return (uint)((uintx)osthread->thread_id() % _num_active_nodes);
+  }
+  return index_of_node_id(os::numa_get_group_id());
+}
+
+uint G1NUMA::preferred_node_index_for_index(uint region_index) const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  size_t regions_per_page = MAX2(_page_size / HeapRegion::GrainBytes, (size_t)1);
+  return (uint)((region_index / regions_per_page) % _num_active_nodes);
+}
+
+void G1NUMA::request_memory_on_node(HeapWord* bottom, size_t word_size, uint region_index) {
+  if (!is_enabled() || _is_simulated) {
+    return;
+  }
+  // If the region is smaller than a page, the whole page is bound. All
+  // regions in that page have the same preferred node, so binding it
+  // several times is harmless.
+  char* start = (char*)align_ptr_down(bottom, _page_size);
+  char* end = (char*)align_ptr_up(bottom + word_size, _page_size);
+  int lgrp_id = node_id(preferred_node_index_for_index(region_index));
+  // Memory that has already been touched (e.g. with AlwaysPreTouch) is
+  // not migrated by this.
+  os::numa_make_local(start, pointer_delta(end, start, sizeof(char)), lgrp_id);
+}
+
+void G1NUMA::record_region_allocation(uint requested_node_index, HeapRegion* hr) {
+  if (!is_enabled() || requested_node_index >= _num_active_nodes) {
+    return;
+  }
+  if (hr->node_index() == requested_node_index) {
+    _local_region_allocs[requested_node_index]++;
+  } else {
+    _remote_region_allocs[requested_node_index]++;
+  }
+}
+
+void G1NUMA::print_on(outputStream* st) const {
+  st->print("  NUMA nodes %u%s", _num_active_nodes, _is_simulated ? " (simulated)" : "");
+  if (is_enabled()) {
+    st->print(", region allocations local/remote:");
+    for (uint i = 0; i < _num_active_nodes; i++) {
+      st->print(" %d: " SIZE_FORMAT "/" SIZE_FORMAT,
+                _node_ids[i], _local_region_allocs[i], _remote_region_allocs[i]);
+    }
+  }
+  st->cr();
+}
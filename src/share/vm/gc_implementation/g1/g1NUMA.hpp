@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class HeapRegion;
+
+// Keeps track of the NUMA nodes G1 allocates on.
+//
+// Nodes are referred to by a dense "node index" in [0, num_active_nodes()),
+// which is what HeapRegions and the allocators store. The mapping from
+// node index to the OS node id is kept here.
+//
+// Every committed region is assigned a preferred node in a round-robin
+// fashion (taking into account that several regions may share one page)
+// and, on real NUMA hardware, its memory is bound to that node right after
+// commit. Mutator and survivor allocation then try to use regions whose
+// node matches the node of the allocating thread.
+//
+// With G1NUMASimulatedNodes set, the node of a region and of a thread are
+// computed as if the machine had that many nodes, but no memory binding
+// is done. This allows testing the node-aware allocation paths on
+// single-node machines.
+class G1NUMA: public CHeapObj<mtGC> {
+  // Mapping of node index to OS node id.
+  int* _node_ids;
+  uint _num_active_nodes;
+  bool _is_simulated;
+
+  // The page size used for the heap. Regions smaller than a page share
+  // the node of the page they are in.
+  size_t _page_size;
+
+  // Per-node statistics of region allocation requests: how often the
+  // request could be satisfied with a region on the requested node.
+  // Updated with either the Heap_lock or the FreeList_lock held.
+  size_t* _local_region_allocs;
+  size_t* _remote_region_allocs;
+
+  G1NUMA();
+
+  void initialize_without_numa();
+  void initialize_simulated(uint num_nodes);
+  void initialize_from_os();
+
+  uint index_of_node_id(int node_id) const;
+
+public:
+  static const uint UnknownNodeIndex = UINT_MAX;
+
+  static G1NUMA* create();
+  ~G1NUMA();
+
+  // Whether node-aware allocation is in effect.
+  bool is_enabled() const { return _num_active_nodes > 1; }
+  bool is_simulated() const { return _is_simulated; }
+
+  uint num_active_nodes() const { return _num_active_nodes; }
+
+  // The OS node id for the given node index.
+  int node_id(uint node_index) const;
+
+  // Returns the node index of the node the current thread runs on.
+  uint index_of_current_thread() const;
+
+  // Returns the node index the memory of the region with the given index
+  // should be placed on.
+  uint preferred_node_index_for_index(uint region_index) const;
+
+  // Called after the memory for the given regions has been committed.
+  // Binds the memory of the regions to their preferred node.
+  void request_memory_on_node(HeapWord* bottom, size_t word_size, uint region_index);
+
+  // Record whether a region allocation for the given node index could be
+  // satisfied with a region on that node.
+  void record_region_allocation(uint requested_node_index, HeapRegion* hr);
+
+  void print_on(outputStream* st) const;
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1NUMA_HPP
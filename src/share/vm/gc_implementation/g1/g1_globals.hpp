@@ -327,6 +327,11 @@
   diagnostic(bool, G1VerifyHeapRegionCodeRoots, false,                      \
           "Verify the code root lists attached to each heap region.")       \
                                                                             \
+  diagnostic(uintx, G1NUMASimulatedNodes, 0,                                \
+          "If greater than one, G1 assigns regions and threads to this "    \
+          "many simulated NUMA nodes instead of the nodes of the machine. " \
+          "Memory is not bound to nodes in this mode.")                     \
+                                                                            \
   develop(bool, G1VerifyBitmaps, false,                                     \
           "Verifies the consistency of the marking bitmaps")
 
@@ -27,6 +27,7 @@
 
 #include "gc_implementation/g1/g1AllocationContext.hpp"
 #include "gc_implementation/g1/g1BlockOffsetTable.hpp"
+#include "gc_implementation/g1/g1NUMA.hpp"
 #include "gc_implementation/g1/g1_specialized_oop_closures.hpp"
 #include "gc_implementation/g1/heapRegionType.hpp"
 #include "gc_implementation/g1/survRateGroup.hpp"
@@ -189,6 +190,12 @@ class G1OffsetTableContigSpace: public CompactibleSpace {
   virtual HeapWord* initialize_threshold();
   virtual HeapWord* cross_threshold(HeapWord* start, HeapWord* end);
 
+  // Record a block that was placed without going through allocate(),
+  // such as an object of a mapped archive region.
+  void alloc_block_in_bot(HeapWord* start, HeapWord* end) {
+    _offsets.alloc_block(start, end);
+  }
+
   virtual void print() const;
 
   void reset_bot() {
@@ -215,6 +222,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // The index of this region in the heap region sequence.
   uint  _hrm_index;
 
+  // The index of the NUMA node this region's memory is placed on.
+  uint  _node_index;
+
   AllocationContext_t _allocation_context;
 
   HeapRegionType _type;
@@ -358,6 +368,10 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // sequence, otherwise -1.
   uint hrm_index() const { return _hrm_index; }
 
+  // The NUMA node index of this region, see G1NUMA.
+  uint node_index() const { return _node_index; }
+  void set_node_index(uint node_index) { _node_index = node_index; }
+
   // The number of bytes marked live in the region in the last marking phase.
   size_t marked_bytes()    { return _prev_marked_bytes; }
   size_t live_bytes() {
@@ -418,6 +432,10 @@ class HeapRegion: public G1OffsetTableContigSpace {
 
   bool is_old() const { return _type.is_old(); }
 
+  // An archive region holds objects mapped from the CDS archive. It is
+  // never collected and all its objects are considered live.
+  bool is_archive() const { return _type.is_archive(); }
+
   // For a humongous region, region in which it starts.
   HeapRegion* humongous_start_region() const {
     return _humongous_start_region;
@@ -675,6 +693,8 @@ class HeapRegion: public G1OffsetTableContigSpace {
 
   void set_old() { _type.set_old(); }
 
+  void set_archive() { _type.set_archive(); }
+
   // Determine if an object has been allocated since the last
   // mark performed by the collector. This returns true iff the object
   // is within the unmarked area of the region.
@@ -140,11 +140,35 @@ void HeapRegionManager::make_regions_available(uint start, uint num_regions) {
     HeapWord* bottom = G1CollectedHeap::heap()->bottom_addr_for_region(i);
     MemRegion mr(bottom, bottom + HeapRegion::GrainWords);
 
+    // Place the memory on its node before initialize() touches it.
+    G1NUMA* numa = G1CollectedHeap::heap()->numa();
+    numa->request_memory_on_node(bottom, HeapRegion::GrainWords, i);
+    hr->set_node_index(numa->preferred_node_index_for_index(i));
+
     hr->initialize(mr);
     insert_into_free_list(at(i));
   }
 }
 
+HeapRegion* HeapRegionManager::allocate_free_region(bool is_old, uint requested_node_index) {
+  HeapRegion* hr = NULL;
+  G1NUMA* numa = G1CollectedHeap::heap()->numa();
+
+  if (numa->is_enabled() && requested_node_index != G1NUMA::UnknownNodeIndex) {
+    hr = _free_list.remove_region_with_node_index(is_old, requested_node_index);
+  }
+  if (hr == NULL) {
+    hr = _free_list.remove_region(is_old);
+  }
+
+  if (hr != NULL) {
+    assert(hr->next() == NULL, "Single region should not have next");
+    assert(is_available(hr->hrm_index()), "Must be committed");
+    numa->record_region_allocation(requested_node_index, hr);
+  }
+  return hr;
+}
+
 MemoryUsage HeapRegionManager::get_auxiliary_data_memory_usage() const {
   size_t used_sz =
     _prev_bitmap_mapper->committed_size() +
@@ -190,6 +214,30 @@ uint HeapRegionManager::expand_at(uint start, uint num_regions) {
   return expanded;
 }
 
+bool HeapRegionManager::allocate_containing_regions(MemRegion range, size_t* commit_count) {
+  size_t commits = 0;
+  uint start_index = (uint)(pointer_delta(range.start(), heap_bottom()) >> HeapRegion::LogOfHRGrainWords);
+  uint last_index = (uint)(pointer_delta(range.last(), heap_bottom()) >> HeapRegion::LogOfHRGrainWords);
+
+  // Uncommitted regions are free once committed, so only committed
+  // regions need checking before anything is changed.
+  for (uint curr_index = start_index; curr_index <= last_index; curr_index++) {
+    if (is_available(curr_index) && !at(curr_index)->is_free()) {
+      return false;
+    }
+  }
+  for (uint curr_index = start_index; curr_index <= last_index; curr_index++) {
+    if (!is_available(curr_index)) {
+      commits++;
+      expand_at(curr_index, 1);
+    }
+  }
+
+  allocate_free_regions_starting_at(start_index, (last_index - start_index) + 1);
+  *commit_count = commits;
+  return true;
+}
+
 uint HeapRegionManager::find_contiguous(size_t num, bool empty_only) {
   uint found = 0;
   size_t length_found = 0;
@@ -163,15 +163,10 @@ public:
     _free_list.add_ordered(list);
   }
 
-  HeapRegion* allocate_free_region(bool is_old) {
-    HeapRegion* hr = _free_list.remove_region(is_old);
-
-    if (hr != NULL) {
-      assert(hr->next() == NULL, "Single region should not have next");
-      assert(is_available(hr->hrm_index()), "Must be committed");
-    }
-    return hr;
-  }
+  // Allocate a free region. If NUMA-aware allocation is enabled, a region on
+  // the given node is preferred; if there is none, any free region is used.
+  HeapRegion* allocate_free_region(bool is_old,
+                                   uint requested_node_index = G1NUMA::UnknownNodeIndex);
 
   inline void allocate_free_regions_starting_at(uint first, uint num_regions);
 
@@ -213,6 +208,13 @@ public:
   // this.
   uint expand_at(uint start, uint num_regions);
 
+  // Commit as needed and remove from the free list all regions that
+  // contain part of the given range, which must lie within the reserved
+  // heap. Returns false, without changing any region, if one of them is
+  // committed but not free. The number of regions committed is returned
+  // in commit_count.
+  bool allocate_containing_regions(MemRegion range, size_t* commit_count);
+
   // Find a contiguous set of empty regions of length num. Returns the start index of
   // that set, or G1_NO_HRM_INDEX.
   uint find_contiguous_only_empty(size_t num) { return find_contiguous(num, true); }
@@ -148,5 +148,43 @@ inline HeapRegion* FreeRegionList::remove_region(bool from_head) {
   return hr;
 }
 
+inline HeapRegion* FreeRegionList::remove_region_with_node_index(bool from_head,
+                                                                 uint requested_node_index) {
+  check_mt_safety();
+  verify_optional();
+
+  HeapRegion* hr = from_head ? _head : _tail;
+  while (hr != NULL && hr->node_index() != requested_node_index) {
+    hr = from_head ? hr->next() : hr->prev();
+  }
+  if (hr == NULL) {
+    return NULL;
+  }
+
+  // Unlink the region, which may be anywhere in the list.
+  HeapRegion* prev = hr->prev();
+  HeapRegion* next = hr->next();
+  if (prev == NULL) {
+    _head = next;
+  } else {
+    prev->set_next(next);
+  }
+  if (next == NULL) {
+    _tail = prev;
+  } else {
+    next->set_prev(prev);
+  }
+  hr->set_prev(NULL);
+  hr->set_next(NULL);
+
+  if (_last == hr) {
+    _last = NULL;
+  }
+
+  // remove() will verify the region and check mt safety.
+  remove(hr);
+  return hr;
+}
+
 #endif // SHARE_VM_GC_IMPLEMENTATION_G1_HEAPREGIONSET_INLINE_HPP
 
@@ -35,6 +35,7 @@
 PRAGMA_FORMAT_MUTE_WARNINGS_FOR_GCC
 
 uint                    MarkSweep::_total_invocations = 0;
+uint                    MarkSweep::_adjust_tasks_per_space = 0;
 
 Stack<oop, mtGC>              MarkSweep::_marking_stack;
 Stack<ObjArrayTask, mtGC>     MarkSweep::_objarray_stack;
@@ -45,6 +46,7 @@ size_t                  MarkSweep::_preserved_count = 0;
 size_t                  MarkSweep::_preserved_count_max = 0;
 PreservedMark*          MarkSweep::_preserved_marks = NULL;
 ReferenceProcessor*     MarkSweep::_ref_processor   = NULL;
+MemRegion               MarkSweep::_archive_range;
 STWGCTimer*             MarkSweep::_gc_timer        = NULL;
 SerialOldTracer*        MarkSweep::_gc_tracer       = NULL;
 
@@ -145,7 +147,9 @@ void MarkSweep::restore_marks() {
 
 MarkSweep::IsAliveClosure   MarkSweep::is_alive;
 
-bool MarkSweep::IsAliveClosure::do_object_b(oop p) { return p->is_gc_marked(); }
+bool MarkSweep::IsAliveClosure::do_object_b(oop p) {
+  return p->is_gc_marked() || is_archive_object(p);
+}
 
 MarkSweep::KeepAliveClosure MarkSweep::keep_alive;
 
@@ -26,6 +26,7 @@
 #define SHARE_VM_GC_IMPLEMENTATION_SHARED_MARKSWEEP_HPP
 
 #include "gc_interface/collectedHeap.hpp"
+#include "memory/memRegion.hpp"
 #include "memory/universe.hpp"
 #include "oops/markOop.hpp"
 #include "oops/oop.hpp"
@@ -105,6 +106,10 @@ class MarkSweep : AllStatic {
   // Total invocations of a MarkSweep collection
   static uint _total_invocations;
 
+  // Number of tasks each compactible space should be divided into for
+  // a parallel phase3, or 0 if phase3 is serial.
+  static uint _adjust_tasks_per_space;
+
   // Traversal stacks used during phase1
   static Stack<oop, mtGC>                      _marking_stack;
   static Stack<ObjArrayTask, mtGC>             _objarray_stack;
@@ -119,6 +124,10 @@ class MarkSweep : AllStatic {
   // Reference processing (used in ...follow_contents)
   static ReferenceProcessor*             _ref_processor;
 
+  // Heap range of the mapped CDS string region, if any. Its objects
+  // are always live and are neither marked nor moved.
+  static MemRegion                       _archive_range;
+
   static STWGCTimer*                     _gc_timer;
   static SerialOldTracer*                _gc_tracer;
 
@@ -140,6 +149,7 @@ class MarkSweep : AllStatic {
 
   // Accessors
   static uint total_invocations() { return _total_invocations; }
+  static uint adjust_tasks_per_space() { return _adjust_tasks_per_space; }
 
   // Reference Processing
   static ReferenceProcessor* const ref_processor() { return _ref_processor; }
@@ -147,6 +157,12 @@ class MarkSweep : AllStatic {
   static STWGCTimer* gc_timer() { return _gc_timer; }
   static SerialOldTracer* gc_tracer() { return _gc_tracer; }
 
+  // Archived objects
+  static void set_archive_range(MemRegion range) { _archive_range = range; }
+  static bool is_archive_object(oop obj) {
+    return _archive_range.contains((void*)obj);
+  }
+
   // Call backs for marking
   static void mark_object(oop obj);
   // Mark pointer and follow contents.  Empty marking stack afterwards.
@@ -267,14 +267,45 @@ HeapWord* CollectedHeap::allocate_from_tlab_slow(KlassHandle klass, Thread* thre
   // the amount free in the tlab is too large to discard.
   if (thread->tlab().free() > thread->tlab().refill_waste_limit()) {
     thread->tlab().record_slow_allocation(size);
+    if (UseMediumTLAB) {
+      return allocate_from_medium_tlab(klass, thread, size);
+    }
     return NULL;
   }
 
+  // Let the tlab catch up with the allocation rate of the thread
+  // instead of waiting for the next GC to resize it.
+  if (ResizeTLAB && ResizeTLABOnRefill) {
+    thread->tlab().resize_on_refill();
+  }
+
+  return refill_tlab(klass, thread->tlab(), size);
+}
+
+// Objects that do not fit in a tlab too full to discard go to a second
+// per-thread buffer rather than to the shared space, as long as they are
+// small enough not to waste most of such a buffer.
+HeapWord* CollectedHeap::allocate_from_medium_tlab(KlassHandle klass, Thread* thread, size_t size) {
+  ThreadLocalAllocBuffer& medium = thread->medium_tlab();
+  HeapWord* obj = medium.allocate(size);
+  if (obj != NULL) {
+    return obj;
+  }
+
+  size_t desired_size = thread->tlab().desired_size();
+  if (align_object_size(size) > desired_size / 2) {
+    return NULL;
+  }
+  medium.set_desired_size(desired_size);
+  return refill_tlab(klass, medium, size);
+}
+
+HeapWord* CollectedHeap::refill_tlab(KlassHandle klass, ThreadLocalAllocBuffer& tlab, size_t size) {
   // Discard tlab and allocate a new one.
   // To minimize fragmentation, the last TLAB may be smaller than the rest.
-  size_t new_tlab_size = thread->tlab().compute_size(size);
+  size_t new_tlab_size = tlab.compute_size(size);
 
-  thread->tlab().clear_before_allocation();
+  tlab.clear_before_allocation();
 
   if (new_tlab_size == 0) {
     return NULL;
@@ -301,7 +332,7 @@ HeapWord* CollectedHeap::allocate_from_tlab_slow(KlassHandle klass, Thread* thre
     Copy::fill_to_words(obj + hdr_size, new_tlab_size - hdr_size, badHeapWordVal);
 #endif // ASSERT
   }
-  thread->tlab().fill(obj, obj + size, new_tlab_size);
+  tlab.fill(obj, obj + size, new_tlab_size);
   return obj;
 }
 
@@ -523,7 +554,10 @@ void CollectedHeap::ensure_parsability(bool retire_tlabs) {
          "Attempt to fill tlabs before main thread has been added"
          " to threads list is doomed to failure!");
   for (JavaThread *thread = Threads::first(); thread; thread = thread->next()) {
-     if (use_tlab) thread->tlab().make_parsable(retire_tlabs);
+     if (use_tlab) {
+       thread->tlab().make_parsable(retire_tlabs);
+       thread->medium_tlab().make_parsable(retire_tlabs);
+     }
 #if defined(COMPILER2) || INCLUDE_JVMCI
      // The deferred store barriers must all have been flushed to the
      // card-table (or other remembered set structure) before GC starts
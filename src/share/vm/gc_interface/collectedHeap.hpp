@@ -42,12 +42,14 @@
 class AdaptiveSizePolicy;
 class BarrierSet;
 class CollectorPolicy;
+class FlexibleWorkGang;
 class GCHeapSummary;
 class GCTimer;
 class GCTracer;
 class MetaspaceSummary;
 class Thread;
 class ThreadClosure;
+class ThreadLocalAllocBuffer;
 class VirtualSpaceSummary;
 class nmethod;
 
@@ -138,6 +140,8 @@ class CollectedHeap : public CHeapObj<mtInternal> {
   // Allocate from the current thread's TLAB, with broken-out slow path.
   inline static HeapWord* allocate_from_tlab(KlassHandle klass, Thread* thread, size_t size);
   static HeapWord* allocate_from_tlab_slow(KlassHandle klass, Thread* thread, size_t size);
+  static HeapWord* allocate_from_medium_tlab(KlassHandle klass, Thread* thread, size_t size);
+  static HeapWord* refill_tlab(KlassHandle klass, ThreadLocalAllocBuffer& tlab, size_t size);
 
   // Allocate an uninitialized block of the given size, or returns NULL if
   // this is impossible.
@@ -592,6 +596,10 @@ class CollectedHeap : public CHeapObj<mtInternal> {
   // Iterator for all GC threads (other than VM thread)
   virtual void gc_threads_do(ThreadClosure* tc) const = 0;
 
+  // Returns the work gang that may be used by the VM thread to perform
+  // the clean up tasks of a safepoint, or NULL if there is none.
+  virtual FlexibleWorkGang* get_safepoint_workers() { return NULL; }
+
   // Print any relevant tracing info that flags imply.
   // Default implementation does nothing.
   virtual void print_tracing_info() const = 0;
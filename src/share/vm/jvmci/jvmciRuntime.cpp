@@ -1562,7 +1562,7 @@ JVMCI::CodeInstallResult JVMCIRuntime::register_method(JVMCIEnv* JVMCIENV,
         {
           MutexUnlocker ml(Compile_lock);
           MutexUnlocker locker(MethodCompileQueue_lock);
-          CompileBroker::handle_full_code_cache();
+          CompileBroker::handle_full_code_cache(CodeCache::get_code_blob_type(comp_level));
         }
       } else {
         nm->set_has_unsafe_access(has_unsafe_access);
@@ -117,6 +117,8 @@
   nonstatic_field(JavaThread,                  _jvmci_counters,                        jlong*)                                       \
   nonstatic_field(JavaThread,                  _should_post_on_exceptions_flag,        int)                                          \
   nonstatic_field(JavaThread,                  _jni_environment,                       JNIEnv)                                       \
+  nonstatic_field(JavaThread,                  _lock_stack,                            LockStack)                                    \
+  nonstatic_field(LockStack,                   _top,                                   uint32_t)                                     \
   nonstatic_field(MethodData,                  _jvmci_ir_size,                         int)                                          \
   nonstatic_field(ConstantPool,                _flags,                                 int)                                          \
   nonstatic_field(Annotations,                 _fields_annotations,                    Array<AnnotationArray*>*)                     \
@@ -127,6 +129,7 @@
   declare_toplevel_type(CompilerToVM::Data)                                   \
   declare_toplevel_type(ObjectWaiter)                                         \
   declare_toplevel_type(JVMCICompileState)                                    \
+  declare_toplevel_type(LockStack)                                          \
   declare_toplevel_type(Annotations)                                          \
   declare_toplevel_type(Array<AnnotationArray*>*)                             \
   declare_toplevel_type(JNIEnv)
@@ -189,6 +192,7 @@
   declare_constant(CodeInstaller::CARD_TABLE_ADDRESS)                                             \
   declare_constant(CodeInstaller::INVOKE_INVALID)                                                 \
                                                                                                   \
+  declare_constant(LockStack::CAPACITY)                                                           \
   declare_constant(Method::invalid_vtable_index)                                                  \
 
 #define VM_ADDRESSES_JVMCI(declare_address, declare_preprocessor_address, declare_function) \
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.inline.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "classfile/systemDictionaryShared.hpp"
+#include "memory/dynamicArchive.hpp"
+#include "memory/iterator.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/arguments.hpp"
+#include "runtime/globals_extension.hpp"
+#include "runtime/interfaceSupport.hpp"
+#include "runtime/os.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+
+// Collects the names of the loaded instance classes of a class loader.
+// Anonymous classes are not looked up by name, so they cannot be listed.
+class ArchivableClassesClosure : public KlassClosure {
+  GrowableArray<Symbol*>* _names;
+ public:
+  ArchivableClassesClosure(GrowableArray<Symbol*>* names) : _names(names) {}
+
+  void do_klass(Klass* k) {
+    if (k->oop_is_instance() && !InstanceKlass::cast(k)->is_anonymous()) {
+      _names->append(k->name());
+    }
+  }
+};
+
+int DynamicArchive::write_class_list(const char* path, TRAPS) {
+  GrowableArray<Symbol*>* names = new GrowableArray<Symbol*>(1000);
+  ArchivableClassesClosure collect(names);
+  ClassLoaderData::the_null_class_loader_data()->loaded_classes_do(&collect);
+  oop system_loader = SystemDictionary::java_system_loader();
+  if (system_loader != NULL) {
+    ClassLoaderData* loader_data = ClassLoaderData::class_loader_data_or_null(system_loader);
+    if (loader_data != NULL && SystemDictionaryShared::is_sharing_possible(loader_data)) {
+      loader_data->loaded_classes_do(&collect);
+    }
+  }
+
+  // The classes stay loaded, and their names with them, since this thread
+  // does not stop at a safepoint before the list is written.
+  fileStream list(path, "w");
+  if (!list.is_open()) {
+    return -1;
+  }
+  for (int i = 0; i < names->length(); i++) {
+    list.print_cr("%s", names->at(i)->as_C_string());
+  }
+  return names->length();
+}
+
+// Appends an argument to a command line run by os::fork_and_exec(),
+// quoted for its shell.
+static void print_argument(outputStream* st, const char* arg) {
+#ifdef _WINDOWS
+  st->print(" \"%s\"", arg);
+#else
+  st->print(" '");
+  for (const char* p = arg; *p != '\0'; p++) {
+    if (*p == '\'') {
+      st->print("'\\''");
+    } else {
+      st->put(*p);
+    }
+  }
+  st->put('\'');
+#endif
+}
+
+static void print_flag(outputStream* st, const char* name, const char* value) {
+  stringStream arg;
+  arg.print("-XX:%s=%s", name, value);
+  print_argument(st, arg.as_string());
+}
+
+static void print_size_flag(outputStream* st, const char* name, uintx value) {
+  stringStream arg;
+  arg.print("-XX:%s=" UINTX_FORMAT, name, value);
+  print_argument(st, arg.as_string());
+}
+
+bool DynamicArchive::run_dump(const char* class_list_path, TRAPS) {
+  const char* sep = os::file_separator();
+  stringStream cmd;
+
+  // The launcher of this run, with the VM library of this run, so that
+  // the archive is accepted by the same VM.
+  stringStream java;
+  java.print("%s%sbin%sjava", Arguments::get_java_home(), sep, sep);
+  print_argument(&cmd, java.as_string());
+  char jvm_dir[JVM_MAXPATHLEN];
+  os::jvm_path(jvm_dir, sizeof(jvm_dir));
+  char* end = strrchr(jvm_dir, *sep);
+  if (end != NULL) {
+    *end = '\0';
+  }
+  stringStream altjvm;
+  altjvm.print("-XXaltjvm=%s", jvm_dir);
+  print_argument(&cmd, altjvm.as_string());
+
+  // The class paths and the flags that the archive is checked against.
+  stringStream bootclasspath;
+  bootclasspath.print("-Xbootclasspath:%s", Arguments::get_sysclasspath());
+  print_argument(&cmd, bootclasspath.as_string());
+  if (UseAppCDS) {
+    print_argument(&cmd, "-XX:+UseAppCDS");
+    print_argument(&cmd, "-cp");
+    print_argument(&cmd, Arguments::get_appclasspath());
+  }
+  print_size_flag(&cmd, "ObjectAlignmentInBytes", (uintx)ObjectAlignmentInBytes);
+  if (!FLAG_IS_DEFAULT(SharedBaseAddress)) {
+    print_size_flag(&cmd, "SharedBaseAddress", SharedBaseAddress);
+  }
+  if (!FLAG_IS_DEFAULT(SharedReadWriteSize)) {
+    print_size_flag(&cmd, "SharedReadWriteSize", SharedReadWriteSize);
+  }
+  if (!FLAG_IS_DEFAULT(SharedReadOnlySize)) {
+    print_size_flag(&cmd, "SharedReadOnlySize", SharedReadOnlySize);
+  }
+  if (!FLAG_IS_DEFAULT(SharedMiscDataSize)) {
+    print_size_flag(&cmd, "SharedMiscDataSize", SharedMiscDataSize);
+  }
+  if (!FLAG_IS_DEFAULT(SharedMiscCodeSize)) {
+    print_size_flag(&cmd, "SharedMiscCodeSize", SharedMiscCodeSize);
+  }
+
+  print_argument(&cmd, "-XX:+UnlockDiagnosticVMOptions");
+  print_flag(&cmd, "SharedArchiveFile", ArchiveClassesAtExit);
+  if (SharedClassListFile != NULL) {
+    print_flag(&cmd, "SharedClassListFile", SharedClassListFile);
+  }
+  print_flag(&cmd, "ExtraSharedClassListFile", class_list_path);
+  print_argument(&cmd, "-Xshare:dump");
+
+  stringStream log;
+  log.print("%s.log", ArchiveClassesAtExit);
+  cmd.print(" >");
+  print_argument(&cmd, log.as_string());
+  cmd.print(" 2>&1");
+
+  if (PrintSharedSpaces) {
+    tty->print_cr("Dumping the CDS archive %s:%s", ArchiveClassesAtExit, cmd.as_string());
+  }
+  int status;
+  {
+    // Dumping takes a while; do not hold up safepoints meanwhile.
+    ThreadToNativeFromVM ttn((JavaThread*)THREAD);
+    status = os::fork_and_exec(cmd.as_string());
+  }
+  if (status != 0) {
+    warning("Unable to dump the CDS archive %s (exit code %d), see %s",
+            ArchiveClassesAtExit, status, log.as_string());
+    return false;
+  }
+  remove(log.as_string());
+  return true;
+}
+
+void DynamicArchive::dump(TRAPS) {
+  assert(ArchiveClassesAtExit != NULL, "only called with ArchiveClassesAtExit");
+  assert(THREAD->is_Java_thread(), "leaves the VM while dumping");
+  ResourceMark rm(THREAD);
+
+  stringStream class_list_path;
+  class_list_path.print("%s.classlist", ArchiveClassesAtExit);
+  int count = write_class_list(class_list_path.as_string(), THREAD);
+  if (count < 0) {
+    warning("Unable to write the class list %s for -XX:ArchiveClassesAtExit",
+            class_list_path.as_string());
+    return;
+  }
+  if (run_dump(class_list_path.as_string(), THREAD)) {
+    remove(class_list_path.as_string());
+    if (PrintSharedSpaces) {
+      tty->print_cr("Dumped the CDS archive %s with the %d classes of this run",
+                    ArchiveClassesAtExit, count);
+    }
+  }
+}
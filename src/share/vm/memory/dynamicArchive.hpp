@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
+#define SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/exceptions.hpp"
+
+// Dumps a CDS archive at the end of a run, for -XX:ArchiveClassesAtExit.
+//
+// The classes of a running VM are spread over its Metaspace and cannot be
+// relocated into an archive, and this VM maps one archive only. So the
+// classes loaded by the boot and system class loaders during the run are
+// written to a class list next to the archive, and the archive is dumped
+// by a child VM with -Xshare:dump, from the default or SharedClassListFile
+// class list plus that one. The child runs the VM library of this run with
+// its boot and app class paths, so the SharedPathsMiscInfo of the archive
+// rejects launches with other class paths. A later launch uses the archive
+// with -XX:SharedArchiveFile, like any other one.
+class DynamicArchive : AllStatic {
+ private:
+  static int write_class_list(const char* path, TRAPS);
+  static bool run_dump(const char* class_list_path, TRAPS);
+
+ public:
+  // Dumps the archive to ArchiveClassesAtExit. Called by before_exit().
+  static void dump(TRAPS);
+};
+
+#endif // SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
@@ -31,12 +31,17 @@
 #include "memory/filemap.hpp"
 #include "memory/metadataFactory.hpp"
 #include "memory/oopFactory.hpp"
+#include "memory/universe.hpp"
 #include "oops/objArrayOop.hpp"
+#include "prims/jvmtiExport.hpp"
 #include "runtime/arguments.hpp"
 #include "runtime/java.hpp"
 #include "runtime/os.hpp"
 #include "services/memTracker.hpp"
 #include "utilities/defaultStream.hpp"
+#if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1CollectedHeap.hpp"
+#endif
 
 # include <sys/stat.h>
 # include <errno.h>
@@ -164,6 +169,10 @@ void FileMapInfo::FileMapHeader::populate(FileMapInfo* mapinfo, size_t alignment
   _version = _current_version;
   _alignment = alignment;
   _obj_alignment = ObjectAlignmentInBytes;
+  _narrow_oop_base = Universe::narrow_oop_base();
+  _narrow_oop_shift = Universe::narrow_oop_shift();
+  _narrow_klass_base = Universe::narrow_klass_base();
+  _narrow_klass_shift = Universe::narrow_klass_shift();
   _classpath_entry_table_size = mapinfo->_classpath_entry_table_size;
   _classpath_entry_table = mapinfo->_classpath_entry_table;
   _classpath_entry_size = mapinfo->_classpath_entry_size;
@@ -250,6 +259,10 @@ bool FileMapInfo::validate_classpath_entry_table() {
   _validating_classpath_entry_table = true;
 
   int count = _header->_classpath_entry_table_size;
+  if (!UseAppCDS) {
+    // Only the archived app classes come from the app class path entries.
+    count = MIN2(count, (int)ClassLoaderExt::app_paths_start_index());
+  }
 
   _classpath_entry_table = _header->_classpath_entry_table;
   _classpath_entry_size = _header->_classpath_entry_size;
@@ -330,11 +343,15 @@ bool FileMapInfo::init_from_file(int fd) {
   }
 
   size_t len = lseek(fd, 0, SEEK_END);
-  struct FileMapInfo::FileMapHeader::space_info* si =
-    &_header->_space[MetaspaceShared::mc];
-  if (si->_file_offset >= len || len - si->_file_offset < si->_used) {
-    fail_continue("The shared archive file has been truncated.");
-    return false;
+  for (int i = 0; i < MetaspaceShared::n_all_regions; i++) {
+    struct FileMapInfo::FileMapHeader::space_info* si = &_header->_space[i];
+    if (si->_used == 0) {
+      continue;
+    }
+    if (si->_file_offset >= len || len - si->_file_offset < si->_used) {
+      fail_continue("The shared archive file has been truncated.");
+      return false;
+    }
   }
 
   _file_offset += (long)n;
@@ -442,6 +459,15 @@ void FileMapInfo::write_region(int region, char* base, size_t size,
 }
 
 
+// Dump the archived strings. They are laid out in a C heap buffer but
+// are recorded at the heap address they will be mapped at.
+
+void FileMapInfo::write_string_region(char* buffer, char* requested_base, size_t size) {
+  write_region(MetaspaceShared::st, buffer, size, size, false, false);
+  _header->_space[MetaspaceShared::st]._base = requested_base;
+}
+
+
 // Dump bytes to file -- at the current file position.
 
 void FileMapInfo::write_bytes(const void* buffer, int nbytes) {
@@ -552,7 +578,7 @@ ReservedSpace FileMapInfo::reserve_shared_memory() {
 }
 
 // Memory map a region in the address space.
-static const char* shared_region_name[] = { "ReadOnly", "ReadWrite", "MiscData", "MiscCode"};
+static const char* shared_region_name[] = { "ReadOnly", "ReadWrite", "MiscData", "MiscCode", "String"};
 
 char* FileMapInfo::map_region(int i) {
   struct FileMapInfo::FileMapHeader::space_info* si = &_header->_space[i];
@@ -577,6 +603,77 @@ char* FileMapInfo::map_region(int i) {
   return base;
 }
 
+// Map the archived strings into the Java heap. Only G1 supports this: the
+// regions that receive them become archive regions, which are never
+// collected. Returns false, leaving the heap as it was, if the strings
+// cannot be used with this heap.
+bool FileMapInfo::map_string_region() {
+#if INCLUDE_ALL_GCS
+  struct FileMapInfo::FileMapHeader::space_info* si = &_header->_space[MetaspaceShared::st];
+  if (si->_used == 0) {
+    return false;
+  }
+
+  const char* reason = NULL;
+  MemRegion range((HeapWord*)si->_base, si->_used / HeapWordSize);
+  if (!UseG1GC) {
+    reason = "G1 is not used";
+  } else if (!UseCompressedOops || !UseCompressedClassPointers) {
+    reason = "compressed oops and class pointers are not used";
+  } else if (_header->_narrow_oop_base != Universe::narrow_oop_base() ||
+             _header->_narrow_oop_shift != Universe::narrow_oop_shift() ||
+             _header->_narrow_klass_base != Universe::narrow_klass_base() ||
+             _header->_narrow_klass_shift != Universe::narrow_klass_shift()) {
+    reason = "the pointer encoding differs";
+  } else if (JvmtiExport::should_post_class_file_load_hook()) {
+    // A hook may replace java.lang.String, which the strings refer to.
+    reason = "the class file load hook is enabled";
+  } else if (!Universe::heap()->reserved_region().contains(range)) {
+    reason = "the heap does not contain the string region";
+  } else if (!G1CollectedHeap::heap()->alloc_archive_regions(range)) {
+    reason = "the heap regions are in use";
+  }
+  if (reason != NULL) {
+    if (PrintSharedSpaces) {
+      tty->print_cr("Shared strings are not used: %s.", reason);
+    }
+    return false;
+  }
+
+  // The regions are committed, so the string region is mapped over them.
+  // Large pages cannot be partly replaced by a file mapping, nor can NMT
+  // record a mapping inside the heap reservation; the strings are read
+  // into place then.
+  char* requested_addr = si->_base;
+  char* base = NULL;
+  if (!UseLargePages && MemTracker::tracking_level() < NMT_summary) {
+    base = os::map_memory(_fd, _full_path, si->_file_offset,
+                          requested_addr, si->_used, false, false);
+  }
+  bool ok = base == requested_addr;
+  if (!ok) {
+    ok = os::seek_to_file_offset(_fd, si->_file_offset) >= 0 &&
+         os::read(_fd, requested_addr, (unsigned int)si->_used) == si->_used;
+  }
+  if (ok && VerifySharedSpaces) {
+    ok = ClassLoader::crc32(0, requested_addr, (jint)si->_used) == si->_crc;
+  }
+  if (!ok && PrintSharedSpaces) {
+    tty->print_cr("Shared strings are not used: the string region could not be read.");
+  }
+  // If the contents are not usable the regions, which cannot be given
+  // back, are filled with dummy objects instead.
+  G1CollectedHeap::heap()->fill_archive_regions(range, !ok /* fill_range */);
+  if (ok && PrintSharedSpaces) {
+    tty->print_cr("Shared strings mapped at " INTPTR_FORMAT "-" INTPTR_FORMAT,
+                  p2i(range.start()), p2i(range.end()));
+  }
+  return ok;
+#else
+  return false;
+#endif // INCLUDE_ALL_GCS
+}
+
 bool FileMapInfo::verify_region_checksum(int i) {
   if (!VerifySharedSpaces) {
     return true;
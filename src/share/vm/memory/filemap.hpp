@@ -56,7 +56,7 @@ private:
   friend class ManifestStream;
   enum {
     _invalid_version = -1,
-    _current_version = 2
+    _current_version = 4
   };
 
   bool  _file_open;
@@ -100,7 +100,13 @@ public:
       size_t _used;          // for setting space top on read
       bool   _read_only;     // read only space?
       bool   _allow_exec;    // executable code in space?
-    } _space[MetaspaceShared::n_regions];
+    } _space[MetaspaceShared::n_all_regions];
+
+    // The encoding of the heap and klass pointers in the string region.
+    address _narrow_oop_base;
+    int     _narrow_oop_shift;
+    address _narrow_klass_base;
+    int     _narrow_klass_shift;
 
     // The following fields are all sanity checks for whether this archive
     // will function correctly with this JVM and the bootclasspath it's
@@ -182,9 +188,11 @@ public:
   void  write_space(int i, Metaspace* space, bool read_only);
   void  write_region(int region, char* base, size_t size,
                      size_t capacity, bool read_only, bool allow_exec);
+  void  write_string_region(char* buffer, char* requested_base, size_t size);
   void  write_bytes(const void* buffer, int count);
   void  write_bytes_aligned(const void* buffer, int count);
   char* map_region(int i);
+  bool  map_string_region();
   void  unmap_region(int i);
   bool  verify_region_checksum(int i);
   void  close();
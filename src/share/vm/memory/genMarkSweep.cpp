@@ -40,10 +40,12 @@
 #include "memory/generation.inline.hpp"
 #include "memory/modRefBarrierSet.hpp"
 #include "memory/referencePolicy.hpp"
+#include "memory/resourceArea.hpp"
 #include "memory/space.hpp"
 #include "oops/instanceRefKlass.hpp"
 #include "oops/oop.inline.hpp"
 #include "prims/jvmtiExport.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/fprofiler.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/synchronizer.hpp"
@@ -51,6 +53,8 @@
 #include "runtime/vmThread.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/events.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/workgroup.hpp"
 #if INCLUDE_JVMCI
 #include "jvmci/jvmci.hpp"
 #endif
@@ -274,9 +278,25 @@ void GenMarkSweep::mark_sweep_phase2() {
   GCTraceTime tm("phase 2", PrintGC && Verbose, true, _gc_timer, _gc_tracer->gc_id());
   trace("2");
 
+  // Have the spaces record the task boundaries for a parallel phase3
+  // while they compute the new addresses.
+  FlexibleWorkGang* workers = adjust_workers();
+  _adjust_tasks_per_space = workers != NULL ? workers->active_workers() * AdjustTasksPerWorker : 0;
+
   gch->prepare_for_compaction();
 }
 
+FlexibleWorkGang* GenMarkSweep::adjust_workers() {
+  if (!GenMarkSweepParallelAdjustEnabled) {
+    return NULL;
+  }
+  FlexibleWorkGang* workers = GenCollectedHeap::heap()->workers();
+  if (workers == NULL || workers->active_workers() <= 1) {
+    return NULL;
+  }
+  return workers;
+}
+
 class GenAdjustPointersClosure: public GenCollectedHeap::GenClosure {
 public:
   void do_generation(Generation* gen) {
@@ -284,6 +304,79 @@ public:
   }
 };
 
+// Collects the compaction spaces of the generations, which have been
+// divided into tasks by prepare_for_compaction().
+class GenCollectCompactionSpacesClosure: public GenCollectedHeap::GenClosure {
+  GrowableArray<CompactibleSpace*>* _spaces;
+public:
+  GenCollectCompactionSpacesClosure(GrowableArray<CompactibleSpace*>* spaces) :
+    _spaces(spaces) { }
+  void do_generation(Generation* gen) {
+    for (CompactibleSpace* sp = gen->first_compaction_space();
+         sp != NULL;
+         sp = sp->next_compaction_space()) {
+      _spaces->append(sp);
+    }
+  }
+};
+
+// Adjusts the spaces that are not compaction spaces (and so have no
+// tasks), e.g. an empty to-space.
+class GenAdjustOtherSpacesClosure: public SpaceClosure {
+  GrowableArray<CompactibleSpace*>* _spaces;
+public:
+  GenAdjustOtherSpacesClosure(GrowableArray<CompactibleSpace*>* spaces) :
+    _spaces(spaces) { }
+  void do_space(Space* sp) {
+    if (!_spaces->contains((CompactibleSpace*)sp)) {
+      sp->adjust_pointers();
+    }
+  }
+};
+
+class GenAdjustOtherSpacesGenClosure: public GenCollectedHeap::GenClosure {
+  GenAdjustOtherSpacesClosure _blk;
+public:
+  GenAdjustOtherSpacesGenClosure(GrowableArray<CompactibleSpace*>* spaces) :
+    _blk(spaces) { }
+  void do_generation(Generation* gen) {
+    gen->space_iterate(&_blk, true);
+  }
+};
+
+// Adjusts the pointers in the heap in parallel. The workers claim the
+// tasks of all compaction spaces in turn; pointer adjustment only
+// reads the forwarding pointers installed in phase2 and writes the
+// fields of the object being adjusted, so the tasks are independent.
+class GenAdjustPointersTask: public AbstractGangTask {
+  GrowableArray<CompactibleSpace*>* _spaces;
+  uint          _num_tasks;
+  volatile jint _claimed;
+public:
+  GenAdjustPointersTask(GrowableArray<CompactibleSpace*>* spaces) :
+    AbstractGangTask("GenMarkSweep adjust pointers"),
+    _spaces(spaces), _num_tasks(0), _claimed(0) {
+    for (int i = 0; i < _spaces->length(); i++) {
+      _num_tasks += _spaces->at(i)->num_adjust_tasks();
+    }
+  }
+
+  void work(uint worker_id) {
+    while (true) {
+      uint task = (uint)(Atomic::add(1, &_claimed) - 1);
+      if (task >= _num_tasks) {
+        return;
+      }
+      int i = 0;
+      while (task >= _spaces->at(i)->num_adjust_tasks()) {
+        task -= _spaces->at(i)->num_adjust_tasks();
+        i++;
+      }
+      _spaces->at(i)->adjust_pointers_in_task(task);
+    }
+  }
+};
+
 void GenMarkSweep::mark_sweep_phase3(int level) {
   GenCollectedHeap* gch = GenCollectedHeap::heap();
 
@@ -312,8 +405,22 @@ void GenMarkSweep::mark_sweep_phase3(int level) {
   gch->gen_process_weak_roots(&adjust_pointer_closure);
 
   adjust_marks();
-  GenAdjustPointersClosure blk;
-  gch->generation_iterate(&blk, true);
+
+  FlexibleWorkGang* workers = adjust_workers();
+  if (workers != NULL && _adjust_tasks_per_space > 0) {
+    ResourceMark rm;
+    GrowableArray<CompactibleSpace*> spaces;
+    GenCollectCompactionSpacesClosure collect_blk(&spaces);
+    gch->generation_iterate(&collect_blk, true);
+    GenAdjustPointersTask tsk(&spaces);
+    workers->run_task(&tsk);
+    GenAdjustOtherSpacesGenClosure other_blk(&spaces);
+    gch->generation_iterate(&other_blk, true);
+  } else {
+    GenAdjustPointersClosure blk;
+    gch->generation_iterate(&blk, true);
+  }
+  _adjust_tasks_per_space = 0;
 }
 
 class GenCompactClosure: public GenCollectedHeap::GenClosure {
@@ -27,6 +27,8 @@
 
 #include "gc_implementation/shared/markSweep.hpp"
 
+class FlexibleWorkGang;
+
 class GenMarkSweep : public MarkSweep {
   friend class VM_MarkSweep;
   friend class G1MarkSweep;
@@ -40,8 +42,13 @@ class GenMarkSweep : public MarkSweep {
   static void mark_sweep_phase1(int level, bool clear_all_softrefs);
   // Calculate new addresses
   static void mark_sweep_phase2();
+  // Number of phase3 tasks per space and worker, for load balancing
+  static const uint AdjustTasksPerWorker = 4;
+
   // Update pointers
   static void mark_sweep_phase3(int level);
+  // The work gang for a parallel phase3, or NULL if it is to be serial
+  static FlexibleWorkGang* adjust_workers();
   // Move objects to new positions
   static void mark_sweep_phase4();
 
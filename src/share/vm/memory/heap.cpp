@@ -27,6 +27,7 @@
 #include "oops/oop.inline.hpp"
 #include "runtime/os.hpp"
 #include "services/memTracker.hpp"
+#include "utilities/bitMap.inline.hpp"
 
 size_t CodeHeap::header_size() {
   return sizeof(HeapBlock);
@@ -35,14 +36,15 @@ size_t CodeHeap::header_size() {
 
 // Implementation of Heap
 
-CodeHeap::CodeHeap() {
+CodeHeap::CodeHeap(const char* name, const int code_blob_type)
+  : _free_bins(_free_bins_map, free_list_bins), _name(name), _code_blob_type(code_blob_type) {
   _number_of_committed_segments = 0;
   _number_of_reserved_segments  = 0;
   _segment_size                 = 0;
   _log2_segment_size            = 0;
   _next_segment                 = 0;
-  _freelist                     = NULL;
-  _freelist_segments            = 0;
+  clear_freelist();
+  _max_allocated_capacity       = 0;
 }
 
 
@@ -57,6 +59,21 @@ void CodeHeap::mark_segmap_as_free(size_t beg, size_t end) {
 }
 
 
+void CodeHeap::mark_segmap_as_merged(size_t beg, size_t seg, size_t end) {
+  assert(beg <  seg && seg <  end && end <= _next_segment, "interval out of bounds");
+  // Rewrite the entries of the appended block as if beg..end had been marked
+  // as used in one go. Hop chains then stay as short as in a used block, no
+  // matter how many blocks were merged into a free block.
+  address p = (address)_segmap.low() + seg;
+  address q = (address)_segmap.low() + end;
+  int i = (int)((seg - beg - 1) % 0xFE) + 1;
+  while (p < q) {
+    *p++ = i++;
+    if (i == 0xFF) i = 1;
+  }
+}
+
+
 void CodeHeap::mark_segmap_as_used(size_t beg, size_t end) {
   assert(0   <= beg && beg <  _number_of_committed_segments, "interval begin out of bounds");
   assert(beg <  end && end <= _number_of_committed_segments, "interval end   out of bounds");
@@ -87,30 +104,25 @@ void CodeHeap::on_code_mapping(char* base, size_t size) {
 }
 
 
-bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
+bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size,
                        size_t segment_size) {
-  assert(reserved_size >= committed_size, "reserved < committed");
+  assert(rs.size() >= committed_size, "reserved < committed");
   assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
   assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
 
   _segment_size      = segment_size;
   _log2_segment_size = exact_log2(segment_size);
 
-  // Reserve and initialize space for _memory.
+  // Initialize space for _memory in the given reservation.
   size_t page_size = os::vm_page_size();
   if (os::can_execute_large_page_memory()) {
-    page_size = os::page_size_for_region_unaligned(reserved_size, 8);
+    page_size = os::page_size_for_region_unaligned(rs.size(), 8);
   }
 
   const size_t granularity = os::vm_allocation_granularity();
-  const size_t r_align = MAX2(page_size, granularity);
-  const size_t r_size = align_size_up(reserved_size, r_align);
   const size_t c_size = align_size_up(committed_size, page_size);
 
-  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
-    MAX2(page_size, granularity);
-  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
-  os::trace_page_sizes("code heap", committed_size, reserved_size, page_size,
+  os::trace_page_sizes(_name, committed_size, rs.size(), page_size,
                        rs.base(), rs.size());
   if (!_memory.initialize(rs, c_size)) {
     return false;
@@ -177,6 +189,7 @@ void CodeHeap::shrink_by(size_t size) {
 
 void CodeHeap::clear() {
   _next_segment = 0;
+  clear_freelist();
   mark_segmap_as_free(0, _number_of_committed_segments);
 }
 
@@ -195,6 +208,7 @@ void* CodeHeap::allocate(size_t instance_size, bool is_critical) {
 #ifdef ASSERT
     memset((void *)block->allocated_space(), badCodeHeapNewVal, instance_size);
 #endif
+    _max_allocated_capacity = MAX2(_max_allocated_capacity, allocated_capacity());
     return block->allocated_space();
   }
 
@@ -220,6 +234,7 @@ void* CodeHeap::allocate(size_t instance_size, bool is_critical) {
 #ifdef ASSERT
     memset((void *)b->allocated_space(), badCodeHeapNewVal, instance_size);
 #endif
+    _max_allocated_capacity = MAX2(_max_allocated_capacity, allocated_capacity());
     return b->allocated_space();
   } else {
     return NULL;
@@ -327,107 +342,157 @@ size_t CodeHeap::heap_unallocated_capacity() const {
 
 // Free list management
 
+void CodeHeap::clear_freelist() {
+  for (size_t bin = 0; bin < free_list_bins; bin++) {
+    _freelists[bin] = NULL;
+  }
+  _free_bins.clear();
+  _freelist_segments = 0;
+  _freelist_length   = 0;
+}
+
 FreeBlock *CodeHeap::following_block(FreeBlock *b) {
   return (FreeBlock*)(((address)b) + _segment_size * b->length());
 }
 
-// Inserts block b after a
-void CodeHeap::insert_after(FreeBlock* a, FreeBlock* b) {
-  assert(a != NULL && b != NULL, "must be real pointers");
-
-  // Link b into the list after a
-  b->set_link(a->link());
-  a->set_link(b);
-
-  // See if we can merge blocks
-  merge_right(b); // Try to make b bigger
-  merge_right(a); // Try to make a include b
+// Returns the block that ends where b starts, or NULL if b is the first
+// block. The segment map leads to its start in a few hops.
+FreeBlock* CodeHeap::preceding_block(FreeBlock* b) {
+  size_t i = segment_for(b);
+  if (i == 0) {
+    return NULL;
+  }
+  address map = (address)_segmap.low();
+  i--;
+  assert(map[i] != 0xFF, "block in front of b must be in the heap");
+  while (map[i] > 0) i -= (int)map[i];
+  return (FreeBlock*)block_at(i);
 }
 
-// Try to merge this block with the following block
-void CodeHeap::merge_right(FreeBlock *a) {
-  assert(a->free(), "must be a free block");
-  if (following_block(a) == a->link()) {
-    assert(a->link() != NULL && a->link()->free(), "must be free too");
-    // Update block a to include the following block
-    a->set_length(a->length() + a->link()->length());
-    a->set_link(a->link()->link());
-    // Update find_start map
-    size_t beg = segment_for(a);
-    mark_segmap_as_used(beg, beg + a->length());
+// Non critical allocations are not allowed to use the last part of the
+// code heap. They are carved from the front of a block that crosses into
+// it (see split_block), so only the front part has to stay clear of it.
+bool CodeHeap::fits(FreeBlock* b, size_t length, bool is_critical) const {
+  if (b->length() < length) {
+    return false;
   }
+  return is_critical ||
+         ((size_t)b + segments_to_size(length)) <= ((size_t)high_boundary() - CodeCacheMinimumFreeSpace);
 }
 
-void CodeHeap::add_to_freelist(HeapBlock *a) {
-  FreeBlock* b = (FreeBlock*)a;
-  assert(b != _freelist, "cannot be removed twice");
-
-  // Mark as free and update free space count
-  _freelist_segments += b->length();
+void CodeHeap::insert_into_freelist(FreeBlock* b) {
+  size_t bin = free_list_bin(b->length());
   b->set_free();
-
-  // First element in list?
-  if (_freelist == NULL) {
-    _freelist = b;
-    b->set_link(NULL);
-    return;
+  b->set_prev(NULL);
+  b->set_link(_freelists[bin]);
+  if (_freelists[bin] != NULL) {
+    _freelists[bin]->set_prev(b);
+  } else {
+    _free_bins.set_bit(bin);
   }
+  _freelists[bin] = b;
+  _freelist_segments += b->length();
+  _freelist_length++;
+}
 
-  // Scan for right place to put into list. List
-  // is sorted by increasing addresseses
-  FreeBlock* prev = NULL;
-  FreeBlock* cur  = _freelist;
-  while(cur != NULL && cur < b) {
-    assert(prev == NULL || prev < cur, "must be ordered");
-    prev = cur;
-    cur  = cur->link();
+void CodeHeap::remove_from_freelist(FreeBlock* b) {
+  assert(b->free(), "must be a free block");
+  size_t bin = free_list_bin(b->length());
+  if (b->prev() != NULL) {
+    b->prev()->set_link(b->link());
+  } else {
+    assert(_freelists[bin] == b, "must be first in its size class");
+    _freelists[bin] = b->link();
+    if (_freelists[bin] == NULL) {
+      _free_bins.clear_bit(bin);
+    }
   }
+  if (b->link() != NULL) {
+    b->link()->set_prev(b->prev());
+  }
+  _freelist_segments -= b->length();
+  _freelist_length--;
+}
 
-  assert( (prev == NULL && b < _freelist) ||
-          (prev < b && (cur == NULL || b < cur)), "list must be ordered");
-
-  if (prev == NULL) {
-    // Insert first in list
-    b->set_link(_freelist);
-    _freelist = b;
-    merge_right(_freelist);
+// Takes length segments out of b, which is off the free list, and returns
+// the rest of b to the free list. The allocation comes from the end of b,
+// so only its own segment map entries are rewritten, unless a non critical
+// allocation would cross into the last part of the code heap.
+FreeBlock* CodeHeap::split_block(FreeBlock* b, size_t length, bool is_critical) {
+  size_t remainder = b->length() - length;
+  // Don't leave anything on the freelist smaller than CodeCacheMinBlockLength.
+  if (remainder < CodeCacheMinBlockLength) {
+    return b;
+  }
+  FreeBlock* rest;
+  if (is_critical ||
+      (size_t)following_block(b) <= ((size_t)high_boundary() - CodeCacheMinimumFreeSpace)) {
+    // Truncate block and return a pointer to the following block
+    rest = b;
+    rest->set_length(remainder);
+    b = following_block(rest);
+    b->set_length(length);
+    size_t beg = segment_for(b);
+    mark_segmap_as_used(beg, beg + length);
   } else {
-    insert_after(prev, b);
+    // Keep the front of the block and return the following block
+    b->set_length(length);
+    rest = following_block(b);
+    rest->set_length(remainder);
+    size_t beg = segment_for(rest);
+    mark_segmap_as_used(beg, beg + remainder);
   }
+  insert_into_freelist(rest);
+  return b;
 }
 
-// Search freelist for an entry on the list with the best fit
+void CodeHeap::add_to_freelist(HeapBlock *a) {
+  FreeBlock* b = (FreeBlock*)a;
+  assert(!b->free(), "cannot be removed twice");
+  size_t length = b->length();
+
+  // Merge with the free blocks on both sides.
+  FreeBlock* next = following_block(b);
+  if (segment_for(next) < _next_segment && next->free()) {
+    remove_from_freelist(next);
+    size_t beg = segment_for(b);
+    mark_segmap_as_merged(beg, beg + length, beg + length + next->length());
+    length += next->length();
+  }
+  FreeBlock* prev = preceding_block(b);
+  if (prev != NULL && prev->free()) {
+    remove_from_freelist(prev);
+    size_t beg = segment_for(prev);
+    mark_segmap_as_merged(beg, beg + prev->length(), beg + prev->length() + length);
+    length += prev->length();
+    b = prev;
+  }
+
+  b->set_length(length);
+  insert_into_freelist(b);
+}
+
+// Search the size classes for the block with the best fit. Every block of a
+// class above the one of length is large enough, so the search ends in the
+// first non-empty class that has a block that fits.
 // Return NULL if no one was found
 FreeBlock* CodeHeap::search_freelist(size_t length, bool is_critical) {
-  FreeBlock *best_block = NULL;
-  FreeBlock *best_prev  = NULL;
-  size_t best_length = 0;
-
-  // Search for smallest block which is bigger than length
-  FreeBlock *prev = NULL;
-  FreeBlock *cur = _freelist;
-  while(cur != NULL) {
-    size_t l = cur->length();
-    if (l >= length && (best_block == NULL || best_length > l)) {
-
-      // Non critical allocations are not allowed to use the last part of the code heap.
-      if (!is_critical) {
-        // Make sure the end of the allocation doesn't cross into the last part of the code heap
-        if (((size_t)cur + length) > ((size_t)high_boundary() - CodeCacheMinimumFreeSpace)) {
-          // the freelist is sorted by address - if one fails, all consecutive will also fail.
+  FreeBlock* best_block = NULL;
+
+  for (size_t bin = _free_bins.get_next_one_offset(free_list_bin(length), free_list_bins);
+       bin < free_list_bins && best_block == NULL;
+       bin = _free_bins.get_next_one_offset(bin + 1, free_list_bins)) {
+    assert(_freelists[bin] != NULL, "size class must have free blocks");
+    for (FreeBlock* cur = _freelists[bin]; cur != NULL; cur = cur->link()) {
+      if (fits(cur, length, is_critical) &&
+          (best_block == NULL || cur->length() < best_block->length())) {
+        best_block = cur;
+        if (bin < free_list_exact_bins || cur->length() == length) {
+          // All blocks of an exact size class have the same length
           break;
         }
       }
-
-      // Remember best block, its previous element, and its length
-      best_block = cur;
-      best_prev  = prev;
-      best_length = best_block->length();
     }
-
-    // Next element in list
-    prev = cur;
-    cur  = cur->link();
   }
 
   if (best_block == NULL) {
@@ -435,32 +500,9 @@ FreeBlock* CodeHeap::search_freelist(size_t length, bool is_critical) {
     return NULL;
   }
 
-  assert((best_prev == NULL && _freelist == best_block ) ||
-         (best_prev != NULL && best_prev->link() == best_block), "sanity check");
-
-  // Exact (or at least good enough) fit. Remove from list.
-  // Don't leave anything on the freelist smaller than CodeCacheMinBlockLength.
-  if (best_length < length + CodeCacheMinBlockLength) {
-    length = best_length;
-    if (best_prev == NULL) {
-      assert(_freelist == best_block, "sanity check");
-      _freelist = _freelist->link();
-    } else {
-      // Unmap element
-      best_prev->set_link(best_block->link());
-    }
-  } else {
-    // Truncate block and return a pointer to the following block
-    best_block->set_length(best_length - length);
-    best_block = following_block(best_block);
-    // Set used bit and length on new block
-    size_t beg = segment_for(best_block);
-    mark_segmap_as_used(beg, beg + length);
-    best_block->set_length(length);
-  }
-
+  remove_from_freelist(best_block);
+  best_block = split_block(best_block, length, is_critical);
   best_block->set_used();
-  _freelist_segments -= length;
   return best_block;
 }
 
@@ -473,33 +515,106 @@ void CodeHeap::print() {
   tty->print_cr("The Heap");
 }
 
+void CodeHeap::test() {
+  const size_t heap_size = 4 * M;
+  ReservedSpace rs(heap_size);
+  assert(rs.is_reserved(), "should reserve the test heap");
+  CodeHeap heap("TestCodeHeap", 0);
+  bool reserved = heap.reserve(rs, heap_size, CodeCacheSegmentSize);
+  assert(reserved, "should initialize the test heap");
+
+  // Blocks of increasing length, each one segment longer than the last.
+  // Some are longer than the exact size classes.
+  const size_t n = 300;
+  const size_t min_length = CodeCacheMinBlockLength;
+  void* blocks[n];
+  for (size_t i = 0; i < n; i++) {
+    blocks[i] = heap.allocate(heap.segments_to_size(min_length + i) - sizeof(HeapBlock), true);
+    assert(blocks[i] != NULL, "should allocate from the top of the heap");
+  }
+  const size_t total = heap._next_segment;
+
+  // Free every other block; none of them can be merged.
+  size_t freed = 0;
+  for (size_t i = 1; i < n; i += 2) {
+    heap.deallocate(blocks[i]);
+    freed += min_length + i;
+  }
+  heap.verify();
+  assert(heap._freelist_length == n / 2, "free blocks should not have been merged");
+  assert(heap._freelist_segments == freed, "wrong free segments");
+
+  // Best fits are exact fits, from the exact and the power-of-two classes.
+  void* p = heap.allocate(heap.segments_to_size(min_length + 5) - sizeof(HeapBlock), true);
+  assert(p == blocks[5], "should be the exact fit");
+  p = heap.allocate(heap.segments_to_size(min_length + 285) - sizeof(HeapBlock), true);
+  assert(p == blocks[285], "should be the exact fit");
+  heap.verify();
+
+  // Freeing a block between two free blocks merges all three.
+  heap.deallocate(blocks[8]);
+  heap.verify();
+  assert(heap._freelist_length == n / 2 - 2 - 1, "should have merged with both neighbours");
+  p = heap.allocate(heap.segments_to_size(3 * min_length + 7 + 8 + 9) - sizeof(HeapBlock), true);
+  assert(p == blocks[7], "should be the merged block");
+
+  // A smaller request is split off the end of the best fit.
+  p = heap.allocate(heap.segments_to_size(11) - sizeof(HeapBlock), true);
+  assert(p == (address)blocks[11] + heap.segments_to_size(min_length),
+         "should be split off the end of the best fit");
+  heap.verify();
+
+  // Freeing everything leaves a single free block.
+  while ((p = heap.first()) != NULL) {
+    heap.deallocate(p);
+  }
+  heap.verify();
+  assert(heap._freelist_length == 1, "all blocks should have been merged");
+  assert(heap._freelist_segments == total, "the whole heap should be free");
+  assert(heap.allocated_capacity() == 0, "nothing should be allocated");
+
+  os::release_memory(heap._segmap.low_boundary(), heap._segmap.reserved_size());
+  rs.release();
+}
+
 #endif
 
 void CodeHeap::verify() {
   // Count the number of blocks on the freelist, and the amount of space
   // represented.
-  int count = 0;
+  size_t count = 0;
   size_t len = 0;
-  for(FreeBlock* b = _freelist; b != NULL; b = b->link()) {
-    len += b->length();
-    count++;
+  for (size_t bin = 0; bin < free_list_bins; bin++) {
+    guarantee(_free_bins.at(bin) == (_freelists[bin] != NULL), "wrong size class map");
+    for (FreeBlock* b = _freelists[bin]; b != NULL; b = b->link()) {
+      guarantee(b->free(), "must be a free block");
+      guarantee(free_list_bin(b->length()) == bin, "wrong size class");
+      guarantee(b->link() == NULL || b->link()->prev() == b, "broken freelist links");
+      len += b->length();
+      count++;
+    }
   }
 
   // Verify that freelist contains the right amount of free space
-  //  guarantee(len == _freelist_segments, "wrong freelist");
+  guarantee(len == _freelist_segments, "wrong freelist");
+  guarantee(count == _freelist_length, "wrong freelist length");
 
   // Verify that the number of free blocks is not out of hand.
-  static int free_block_threshold = 10000;
+  static size_t free_block_threshold = 10000;
   if (count > free_block_threshold) {
-    warning("CodeHeap: # of free blocks > %d", free_block_threshold);
+    warning("CodeHeap: # of free blocks > " SIZE_FORMAT, free_block_threshold);
     // Double the warning limit
     free_block_threshold *= 2;
   }
 
   // Verify that the freelist contains the same number of free blocks that is
-  // found on the full list.
+  // found on the full list, and that no two free blocks are adjacent.
   for(HeapBlock *h = first_block(); h != NULL; h = next_block(h)) {
-    if (h->free()) count--;
+    if (h->free()) {
+      count--;
+      HeapBlock* next = next_block(h);
+      guarantee(next == NULL || !next->free(), "free blocks must be merged");
+    }
   }
-  //  guarantee(count == 0, "missing free blocks");
+  guarantee(count == 0, "missing free blocks");
 }
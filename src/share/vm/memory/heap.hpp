@@ -27,6 +27,7 @@
 
 #include "memory/allocation.hpp"
 #include "runtime/virtualspace.hpp"
+#include "utilities/bitMap.hpp"
 
 // Blocks
 
@@ -60,14 +61,18 @@ class HeapBlock VALUE_OBJ_CLASS_SPEC {
   bool free()                                    { return !_header._used; }
 };
 
+// A free block is linked into the free list of its size class in both
+// directions, so it can be taken off the list when it is merged with a
+// block freed next to it.
 class FreeBlock: public HeapBlock {
   friend class VMStructs;
  protected:
   FreeBlock* _link;
+  FreeBlock* _prev;
 
  public:
   // Initialization
-  void initialize(size_t length)             { HeapBlock::initialize(length); _link= NULL; }
+  void initialize(size_t length)             { HeapBlock::initialize(length); _link = NULL; _prev = NULL; }
 
   // Merging
   void set_length(size_t l)                  { _header._length = l; }
@@ -75,8 +80,18 @@ class FreeBlock: public HeapBlock {
   // Accessors
   FreeBlock* link() const                    { return _link; }
   void set_link(FreeBlock* link)             { _link = link; }
+  FreeBlock* prev() const                    { return _prev; }
+  void set_prev(FreeBlock* prev)             { _prev = prev; }
 };
 
+// The free blocks of a CodeHeap are kept in size classes: one exact class
+// per length below free_list_exact_bins segments, which covers most
+// nmethods and stubs, and one class per power of two above. A bitmap of
+// the non-empty classes finds the smallest class that can satisfy a request
+// with a few word scans. Any block of a larger class fits, so a best fit
+// needs at most a scan of the power-of-two class the request falls in and
+// of the first non-empty class after it. Free neighbours are found through
+// the segment map and merged on deallocation.
 class CodeHeap : public CHeapObj<mtCode> {
   friend class VMStructs;
  private:
@@ -90,8 +105,21 @@ class CodeHeap : public CHeapObj<mtCode> {
 
   size_t       _next_segment;
 
-  FreeBlock*   _freelist;
+  enum {
+    log2_free_list_exact_bins = 8,
+    free_list_exact_bins      = 1 << log2_free_list_exact_bins,
+    free_list_bins            = free_list_exact_bins + BitsPerWord - log2_free_list_exact_bins
+  };
+
+  FreeBlock*   _freelists[free_list_bins];       // Free blocks by size class
+  BitMap::bm_word_t _free_bins_map[(free_list_bins + BitsPerWord - 1) / BitsPerWord];
+  BitMap       _free_bins;                       // Size classes with free blocks
   size_t       _freelist_segments;               // No. of segments in freelist
+  size_t       _freelist_length;                 // No. of blocks in freelist
+
+  const char*  _name;                            // Name of the CodeHeap
+  const int    _code_blob_type;                  // CodeBlobType it contains
+  size_t       _max_allocated_capacity;          // Peak capacity that was allocated during lifetime of the heap
 
   // Helper functions
   size_t   size_to_segments(size_t size) const { return (size + _segment_size - 1) >> _log2_segment_size; }
@@ -102,11 +130,20 @@ class CodeHeap : public CHeapObj<mtCode> {
 
   void  mark_segmap_as_free(size_t beg, size_t end);
   void  mark_segmap_as_used(size_t beg, size_t end);
+  void  mark_segmap_as_merged(size_t beg, size_t seg, size_t end);
 
   // Freelist management helpers
+  static size_t free_list_bin(size_t length) {
+    return length < free_list_exact_bins ? length :
+      free_list_exact_bins + log2_intptr((uintptr_t)length) - log2_free_list_exact_bins;
+  }
+  void clear_freelist();
   FreeBlock* following_block(FreeBlock *b);
-  void insert_after(FreeBlock* a, FreeBlock* b);
-  void merge_right (FreeBlock* a);
+  FreeBlock* preceding_block(FreeBlock *b);
+  bool fits(FreeBlock* b, size_t length, bool is_critical) const;
+  void insert_into_freelist(FreeBlock* b);
+  void remove_from_freelist(FreeBlock* b);
+  FreeBlock* split_block(FreeBlock* b, size_t length, bool is_critical);
 
   // Toplevel freelist management
   void add_to_freelist(HeapBlock *b);
@@ -122,10 +159,10 @@ class CodeHeap : public CHeapObj<mtCode> {
   void on_code_mapping(char* base, size_t size);
 
  public:
-  CodeHeap();
+  CodeHeap(const char* name, const int code_blob_type);
 
   // Heap extents
-  bool  reserve(size_t reserved_size, size_t committed_size, size_t segment_size);
+  bool  reserve(ReservedSpace rs, size_t committed_size, size_t segment_size);
   void  release();                               // releases all allocated memory
   bool  expand_by(size_t size);                  // expands commited memory by size
   void  shrink_by(size_t size);                  // shrinks commited memory by size
@@ -158,6 +195,10 @@ class CodeHeap : public CHeapObj<mtCode> {
   size_t max_capacity() const;
   size_t allocated_capacity() const;
   size_t unallocated_capacity() const            { return max_capacity() - allocated_capacity(); }
+  size_t max_allocated_capacity() const          { return _max_allocated_capacity; }
+
+  const char* name() const                       { return _name; }
+  int code_blob_type() const                     { return _code_blob_type; }
 
 private:
   size_t heap_unallocated_capacity() const;
@@ -166,6 +207,8 @@ public:
   // Debugging
   void verify();
   void print()  PRODUCT_RETURN;
+
+  NOT_PRODUCT(static void test();)
 };
 
 #endif // SHARE_VM_MEMORY_HEAP_HPP
@@ -55,6 +55,7 @@ Metachunk::Metachunk(size_t word_size,
                      VirtualSpaceNode* container)
     : Metabase<Metachunk>(word_size),
     _top(NULL),
+    _is_uncommitted(false),
     _container(container)
 {
   _top = initial_top();
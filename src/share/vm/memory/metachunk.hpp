@@ -102,6 +102,9 @@ class Metachunk : public Metabase<Metachunk> {
   // Current allocation top.
   MetaWord* _top;
 
+  // Set while the chunk is free and its payload has been uncommitted.
+  bool _is_uncommitted;
+
   DEBUG_ONLY(bool _is_tagged_free;)
 
   MetaWord* initial_top() const { return (MetaWord*)this + overhead(); }
@@ -138,6 +141,9 @@ class Metachunk : public Metabase<Metachunk> {
   size_t used_word_size() const;
   size_t free_word_size() const;
 
+  bool is_uncommitted() const     { return _is_uncommitted; }
+  void set_is_uncommitted(bool v) { _is_uncommitted = v; }
+
 #ifdef ASSERT
   bool is_tagged_free() { return _is_tagged_free; }
   void set_is_tagged_free(bool v) { _is_tagged_free = v; }
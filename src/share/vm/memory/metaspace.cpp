@@ -45,6 +45,7 @@
 #include "runtime/orderAccess.inline.hpp"
 #include "services/memTracker.hpp"
 #include "services/memoryService.hpp"
+#include "utilities/bitMap.inline.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/debug.hpp"
 
@@ -112,6 +113,10 @@ class ChunkManager : public CHeapObj<mtInternal> {
   size_t _free_chunks_total;
   size_t _free_chunks_count;
 
+  // Set when a medium or humongous chunk is freed, cleared when the
+  // free chunks have been uncommitted.
+  bool _has_uncommittable_chunks;
+
   void dec_free_chunks_total(size_t v) {
     assert(_free_chunks_count > 0 &&
              _free_chunks_total > 0,
@@ -140,10 +145,19 @@ class ChunkManager : public CHeapObj<mtInternal> {
   }
   void verify_free_chunks_count();
 
+  // Merges the free chunks of the target_index sized region around chunk
+  // into one chunk. Returns false if the region holds a chunk in use or is
+  // not made of whole chunks.
+  bool coalesce_around(Metachunk* chunk, ChunkIndex target_index);
+
+  // Splits a free chunk of a larger size into chunks of the size of
+  // target_index and smaller. Returns false if there is none to split.
+  bool split_larger_chunk(ChunkIndex target_index);
+
  public:
 
   ChunkManager(size_t specialized_size, size_t small_size, size_t medium_size)
-      : _free_chunks_total(0), _free_chunks_count(0) {
+      : _free_chunks_total(0), _free_chunks_count(0), _has_uncommittable_chunks(false) {
     _free_chunks[SpecializedIndex].set_size(specialized_size);
     _free_chunks[SmallIndex].set_size(small_size);
     _free_chunks[MediumIndex].set_size(medium_size);
@@ -164,6 +178,17 @@ class ChunkManager : public CHeapObj<mtInternal> {
   // of type index.
   void return_chunks(ChunkIndex index, Metachunk* chunks);
 
+  // Return a chunk that was in use to the freelist of type index and
+  // merge it with its free neighbours.
+  void return_single_chunk(ChunkIndex index, Metachunk* chunk);
+
+  // Add a chunk that has never been in use, such as the remainder of a
+  // split, to its freelist.
+  void add_free_chunk(Metachunk* chunk);
+
+  bool has_uncommittable_chunks() const { return _has_uncommittable_chunks; }
+  void clear_has_uncommittable_chunks() { _has_uncommittable_chunks = false; }
+
   // Total of the space in the free chunks list
   size_t free_chunks_total_words();
   size_t free_chunks_total_bytes();
@@ -281,6 +306,77 @@ class BlockFreelist VALUE_OBJ_CLASS_SPEC {
   void print_on(outputStream* st) const;
 };
 
+// Records, for each smallest chunk sized unit of a VirtualSpaceNode,
+// whether a chunk starts there and whether that chunk is in use. Chunks
+// are aligned to their size within the node, so the free neighbours of a
+// chunk can be found and merged without walking the node.
+class OccupancyMap : public CHeapObj<mtClass> {
+  const MetaWord* const _reference_address;
+  const size_t          _smallest_chunk_word_size;
+  const size_t          _map_size_in_words;
+  BitMap::bm_word_t*    _chunk_starts_map;
+  BitMap::bm_word_t*    _in_use_map;
+  BitMap                _chunk_starts;
+  BitMap                _in_use;
+
+  BitMap::idx_t index_for(const MetaWord* p) const {
+    assert(p >= _reference_address, "Address below the map");
+    size_t delta = pointer_delta(p, _reference_address, sizeof(MetaWord));
+    assert(delta % _smallest_chunk_word_size == 0, "Address not chunk aligned");
+    return delta / _smallest_chunk_word_size;
+  }
+
+ public:
+  OccupancyMap(const MetaWord* reference_address, size_t word_size,
+               size_t smallest_chunk_word_size);
+  ~OccupancyMap();
+
+  bool chunk_starts_at(const MetaWord* p) const {
+    return _chunk_starts.at(index_for(p));
+  }
+  void set_chunk_starts_at(const MetaWord* p, bool v) {
+    _chunk_starts.at_put(index_for(p), v);
+  }
+  // Clears the chunk start bits of [p, p + word_size).
+  void clear_chunk_starts(const MetaWord* p, size_t word_size) {
+    _chunk_starts.clear_range(index_for(p), index_for(p + word_size));
+  }
+
+  bool is_in_use(const MetaWord* p) const {
+    return _in_use.at(index_for(p));
+  }
+  void set_in_use(const MetaWord* p, bool v) {
+    _in_use.at_put(index_for(p), v);
+  }
+  // Returns true if a chunk in use starts in [p, p + word_size).
+  bool is_region_in_use(const MetaWord* p, size_t word_size) const {
+    BitMap::idx_t end = index_for(p + word_size);
+    return _in_use.get_next_one_offset(index_for(p), end) < end;
+  }
+};
+
+OccupancyMap::OccupancyMap(const MetaWord* reference_address, size_t word_size,
+                           size_t smallest_chunk_word_size) :
+    _reference_address(reference_address),
+    _smallest_chunk_word_size(smallest_chunk_word_size),
+    _map_size_in_words(align_size_up(word_size / smallest_chunk_word_size, BitsPerWord) / BitsPerWord) {
+  assert(word_size % smallest_chunk_word_size == 0, "Size not chunk aligned");
+  BitMap::idx_t size_in_bits = word_size / smallest_chunk_word_size;
+  _chunk_starts_map = NEW_C_HEAP_ARRAY(BitMap::bm_word_t, _map_size_in_words, mtClass);
+  _in_use_map = NEW_C_HEAP_ARRAY(BitMap::bm_word_t, _map_size_in_words, mtClass);
+  _chunk_starts.set_map(_chunk_starts_map);
+  _chunk_starts.set_size(size_in_bits);
+  _in_use.set_map(_in_use_map);
+  _in_use.set_size(size_in_bits);
+  _chunk_starts.clear();
+  _in_use.clear();
+}
+
+OccupancyMap::~OccupancyMap() {
+  FREE_C_HEAP_ARRAY(BitMap::bm_word_t, _chunk_starts_map, mtClass);
+  FREE_C_HEAP_ARRAY(BitMap::bm_word_t, _in_use_map, mtClass);
+}
+
 // A VirtualSpaceList node.
 class VirtualSpaceNode : public CHeapObj<mtClass> {
   friend class VirtualSpaceList;
@@ -288,6 +384,9 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   // Link to next VirtualSpaceNode
   VirtualSpaceNode* _next;
 
+  // Is this node part of the compressed class space
+  const bool _is_class;
+
   // total in the VirtualSpace
   MemRegion _reserved;
   ReservedSpace _rs;
@@ -296,6 +395,12 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   // count of chunks contained in this VirtualSpace
   uintx _container_count;
 
+  // Chunk starts and chunks in use
+  OccupancyMap* _occupancy_map;
+
+  // Committed memory of free chunks given back to the OS
+  size_t _uncommitted_words;
+
   // Convenience functions to access the _virtual_space
   char* low()  const { return virtual_space()->low(); }
   char* high() const { return virtual_space()->high(); }
@@ -306,12 +411,24 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
 
   // Committed but unused space in the virtual space
   size_t free_words_in_vs() const;
+
+  // The payload of a free chunk that can be uncommitted: the commit
+  // granules past the chunk header and its free list links.
+  void uncommittable_region(Metachunk* chunk, char** start, char** end) const;
+
+  // Carve the space up to target_top into free chunks, so that the next
+  // chunk taken starts at target_top.
+  void allocate_padding_chunks_until_top_is_at(MetaWord* target_top);
  public:
 
-  VirtualSpaceNode(size_t byte_size);
-  VirtualSpaceNode(ReservedSpace rs) : _top(NULL), _next(NULL), _rs(rs), _container_count(0) {}
+  VirtualSpaceNode(bool is_class, size_t byte_size);
+  VirtualSpaceNode(bool is_class, ReservedSpace rs) :
+    _is_class(is_class), _top(NULL), _next(NULL), _rs(rs), _container_count(0),
+    _occupancy_map(NULL), _uncommitted_words(0) {}
   ~VirtualSpaceNode();
 
+  bool is_class() const { return _is_class; }
+
   // Convenience functions for logical bottom and end
   MetaWord* bottom() const { return (MetaWord*) _virtual_space.low(); }
   MetaWord* end() const { return (MetaWord*) _virtual_space.high(); }
@@ -319,7 +436,10 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   bool contains(const void* ptr) { return ptr >= low() && ptr < high(); }
 
   size_t reserved_words() const  { return _virtual_space.reserved_size() / BytesPerWord; }
-  size_t committed_words() const { return _virtual_space.actual_committed_size() / BytesPerWord; }
+  size_t committed_words() const {
+    return _virtual_space.actual_committed_size() / BytesPerWord - _uncommitted_words;
+  }
+  size_t uncommitted_words() const { return _uncommitted_words; }
 
   bool is_pre_committed() const { return _virtual_space.special(); }
 
@@ -341,6 +461,16 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   MetaWord* top() const { return _top; }
   void inc_top(size_t word_size) { _top += word_size; }
 
+  OccupancyMap* occupancy_map() const { return _occupancy_map; }
+
+  // Chunks are aligned to their size within the node so that free
+  // neighbours can be merged; humongous chunks to the smallest chunk size.
+  size_t chunk_alignment(size_t chunk_word_size) const;
+
+  // The largest non-humongous chunk size that is aligned at p and not
+  // larger than max_word_size.
+  size_t largest_chunk_size_at(const MetaWord* p, size_t max_word_size) const;
+
   uintx container_count() { return _container_count; }
   void inc_container_count();
   void dec_container_count();
@@ -361,6 +491,14 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   // Allocate a chunk from the virtual space and return it.
   Metachunk* get_chunk_vs(size_t chunk_word_size);
 
+  // Give the payload of free medium and humongous chunks back to the
+  // OS. Returns the number of words uncommitted.
+  size_t uncommit_free_chunks();
+
+  // Commit the payload of a free chunk again before it is handed out.
+  // Returns false if the Metaspace may not grow by that much.
+  bool recommit_chunk(Metachunk* chunk);
+
   // Expands/shrinks the committed space in a virtual space.  Delegates
   // to Virtualspace
   bool expand_by(size_t min_words, size_t preferred_words);
@@ -410,7 +548,9 @@ static bool should_commit_large_pages_when_reserving(size_t bytes) {
 }
 
   // byte_size is the size of the associated virtualspace.
-VirtualSpaceNode::VirtualSpaceNode(size_t bytes) : _top(NULL), _next(NULL), _rs(), _container_count(0) {
+VirtualSpaceNode::VirtualSpaceNode(bool is_class, size_t bytes) :
+    _is_class(is_class), _top(NULL), _next(NULL), _rs(), _container_count(0),
+    _occupancy_map(NULL), _uncommitted_words(0) {
   assert_is_size_aligned(bytes, Metaspace::reserve_alignment());
 
 #if INCLUDE_CDS
@@ -566,6 +706,11 @@ class VirtualSpaceList : public CHeapObj<mtClass> {
   // Unlink empty VirtualSpaceNodes and free it.
   void purge(ChunkManager* chunk_manager);
 
+  // Give the payload of free medium and humongous chunks back to the OS.
+  void uncommit_free_chunks();
+
+  size_t uncommitted_words();
+
   void print_on(outputStream* st) const;
 
   class VirtualSpaceListIterator : public StackObj {
@@ -888,6 +1033,9 @@ void BlockFreelist::print_on(outputStream* st) const {
 
 VirtualSpaceNode::~VirtualSpaceNode() {
   _rs.release();
+  if (_occupancy_map != NULL) {
+    delete _occupancy_map;
+  }
 #ifdef ASSERT
   size_t word_size = sizeof(*this) / BytesPerWord;
   Copy::fill_to_words((HeapWord*) this, word_size, 0xf1f1f1f1);
@@ -907,13 +1055,55 @@ size_t VirtualSpaceNode::free_words_in_vs() const {
   return pointer_delta(end(), top(), sizeof(MetaWord));
 }
 
+size_t VirtualSpaceNode::chunk_alignment(size_t chunk_word_size) const {
+  if (chunk_word_size == SpaceManager::specialized_chunk_size(is_class()) ||
+      chunk_word_size == SpaceManager::small_chunk_size(is_class()) ||
+      chunk_word_size == SpaceManager::medium_chunk_size(is_class())) {
+    return chunk_word_size;
+  }
+  return SpaceManager::smallest_chunk_size(is_class());
+}
+
+size_t VirtualSpaceNode::largest_chunk_size_at(const MetaWord* p, size_t max_word_size) const {
+  size_t offset = pointer_delta(p, bottom(), sizeof(MetaWord));
+  size_t chunk_sizes[] = {
+    SpaceManager::medium_chunk_size(is_class()),
+    SpaceManager::small_chunk_size(is_class()),
+    SpaceManager::specialized_chunk_size(is_class())
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+    if (chunk_sizes[i] <= max_word_size && offset % chunk_sizes[i] == 0) {
+      return chunk_sizes[i];
+    }
+  }
+  ShouldNotReachHere();
+  return 0;
+}
+
+void VirtualSpaceNode::allocate_padding_chunks_until_top_is_at(MetaWord* target_top) {
+  ChunkManager* chunk_manager = Metaspace::get_chunk_manager(
+    is_class() ? Metaspace::ClassType : Metaspace::NonClassType);
+  while (top() < target_top) {
+    size_t chunk_word_size =
+      largest_chunk_size_at(top(), pointer_delta(target_top, top(), sizeof(MetaWord)));
+    Metachunk* padding = ::new (top()) Metachunk(chunk_word_size, this);
+    occupancy_map()->set_chunk_starts_at(top(), true);
+    inc_top(chunk_word_size);
+    chunk_manager->add_free_chunk(padding);
+  }
+  assert(top() == target_top, "Padding overshot");
+}
+
 // Allocates the chunk from the virtual space only.
 // This interface is also used internally for debugging.  Not all
 // chunks removed here are necessarily used for allocation.
 Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size) {
-  // Bottom of the new chunk
+  // Bottom of the new chunk, aligned to the chunk size within the node.
+  // The space skipped for the alignment is added to the free lists.
   MetaWord* chunk_limit = top();
   assert(chunk_limit != NULL, "Not safe to call this method");
+  size_t offset = pointer_delta(chunk_limit, bottom(), sizeof(MetaWord));
+  size_t padding_words = align_size_up(offset, chunk_alignment(chunk_word_size)) - offset;
 
   // The virtual spaces are always expanded by the
   // commit granularity to enforce the following condition.
@@ -921,7 +1111,7 @@ Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size) {
   assert(_virtual_space.committed_size() == _virtual_space.actual_committed_size(),
       "The committed memory doesn't match the expanded memory.");
 
-  if (!is_available(chunk_word_size)) {
+  if (!is_available(padding_words + chunk_word_size)) {
     if (TraceMetadataChunkAllocation) {
       gclog_or_tty->print("VirtualSpaceNode::take_from_committed() not available %d words ", chunk_word_size);
       // Dump some information about the virtual space that is nearly full
@@ -930,11 +1120,17 @@ Metachunk* VirtualSpaceNode::take_from_committed(size_t chunk_word_size) {
     return NULL;
   }
 
+  if (padding_words > 0) {
+    allocate_padding_chunks_until_top_is_at(chunk_limit + padding_words);
+    chunk_limit = top();
+  }
+
   // Take the space  (bump top on the current virtual space).
   inc_top(chunk_word_size);
 
   // Initialize the chunk
   Metachunk* result = ::new (chunk_limit) Metachunk(chunk_word_size, this);
+  occupancy_map()->set_chunk_starts_at(chunk_limit, true);
   return result;
 }
 
@@ -962,11 +1158,72 @@ Metachunk* VirtualSpaceNode::get_chunk_vs(size_t chunk_word_size) {
   assert_lock_strong(SpaceManager::expand_lock());
   Metachunk* result = take_from_committed(chunk_word_size);
   if (result != NULL) {
+    occupancy_map()->set_in_use(result->bottom(), true);
     inc_container_count();
   }
   return result;
 }
 
+void VirtualSpaceNode::uncommittable_region(Metachunk* chunk, char** start, char** end) const {
+  size_t header_bytes = MAX2(sizeof(TreeChunk<Metachunk, FreeList<Metachunk> >),
+                             Metachunk::overhead() * BytesPerWord);
+  *start = (char*)align_ptr_up((char*)chunk + header_bytes, Metaspace::commit_alignment());
+  *end = (char*)align_ptr_down((char*)chunk->end(), Metaspace::commit_alignment());
+}
+
+size_t VirtualSpaceNode::uncommit_free_chunks() {
+  assert_lock_strong(SpaceManager::expand_lock());
+  if (is_pre_committed()) {
+    return 0;
+  }
+
+  size_t uncommitted = 0;
+  size_t medium_size = SpaceManager::medium_chunk_size(is_class());
+  Metachunk* chunk = first_chunk();
+  Metachunk* invalid_chunk = (Metachunk*) top();
+  while (chunk < invalid_chunk) {
+    MetaWord* next = ((MetaWord*)chunk) + chunk->word_size();
+    if (chunk->word_size() >= medium_size &&
+        !chunk->is_uncommitted() &&
+        !occupancy_map()->is_in_use(chunk->bottom())) {
+      assert(chunk->is_tagged_free(), "Should be tagged free");
+      char* start;
+      char* end;
+      uncommittable_region(chunk, &start, &end);
+      if (start < end && os::uncommit_memory(start, end - start)) {
+        chunk->set_is_uncommitted(true);
+        uncommitted += (end - start) / BytesPerWord;
+      }
+    }
+    chunk = (Metachunk*) next;
+  }
+  _uncommitted_words += uncommitted;
+  return uncommitted;
+}
+
+bool VirtualSpaceNode::recommit_chunk(Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(chunk->is_uncommitted(), "Chunk is committed");
+  char* start;
+  char* end;
+  uncommittable_region(chunk, &start, &end);
+  size_t words = (end - start) / BytesPerWord;
+
+  if (!MetaspaceGC::can_expand(words, is_class()) ||
+      MetaspaceGC::allowed_expansion() < words) {
+    return false;
+  }
+  if (!os::commit_memory(start, end - start, Metaspace::commit_alignment(), false)) {
+    return false;
+  }
+
+  chunk->set_is_uncommitted(false);
+  _uncommitted_words -= words;
+  Metaspace::get_space_list(is_class() ? Metaspace::ClassType : Metaspace::NonClassType)
+    ->inc_committed_words(words);
+  return true;
+}
+
 bool VirtualSpaceNode::initialize() {
 
   if (!_rs.is_reserved()) {
@@ -993,6 +1250,8 @@ bool VirtualSpaceNode::initialize() {
     set_top((MetaWord*)virtual_space()->low());
     set_reserved(MemRegion((HeapWord*)_rs.base(),
                  (HeapWord*)(_rs.base() + _rs.size())));
+    _occupancy_map = new OccupancyMap(bottom(), reserved_words(),
+                                      SpaceManager::smallest_chunk_size(is_class()));
 
     assert(reserved()->start() == (HeapWord*) _rs.base(),
       err_msg("Reserved start was not set properly " PTR_FORMAT
@@ -1136,6 +1395,31 @@ void VirtualSpaceList::purge(ChunkManager* chunk_manager) {
 }
 
 
+void VirtualSpaceList::uncommit_free_chunks() {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t uncommitted = 0;
+  VirtualSpaceListIterator iter(virtual_space_list());
+  while (iter.repeat()) {
+    VirtualSpaceNode* vsn = iter.get_next();
+    uncommitted += vsn->uncommit_free_chunks();
+  }
+  dec_committed_words(uncommitted);
+  if (TraceMetadataChunkAllocation) {
+    gclog_or_tty->print_cr("VirtualSpaceList::uncommit_free_chunks: uncommitted "
+                           SIZE_FORMAT "K of free %s chunks",
+                           uncommitted * BytesPerWord / K, is_class() ? "class" : "data");
+  }
+}
+
+size_t VirtualSpaceList::uncommitted_words() {
+  size_t uncommitted = 0;
+  VirtualSpaceListIterator iter(virtual_space_list());
+  while (iter.repeat()) {
+    uncommitted += iter.get_next()->uncommitted_words();
+  }
+  return uncommitted;
+}
+
 // This function looks at the mmap regions in the metaspace without locking.
 // The chunks are added with store ordering and not deleted except for at
 // unloading time during a safepoint.
@@ -1164,19 +1448,18 @@ void VirtualSpaceList::retire_current_virtual_space() {
 }
 
 void VirtualSpaceNode::retire(ChunkManager* chunk_manager) {
-  for (int i = (int)MediumIndex; i >= (int)ZeroIndex; --i) {
-    ChunkIndex index = (ChunkIndex)i;
-    size_t chunk_size = chunk_manager->free_chunks(index)->size();
-
-    while (free_words_in_vs() >= chunk_size) {
-      DEBUG_ONLY(verify_container_count();)
-      Metachunk* chunk = get_chunk_vs(chunk_size);
-      assert(chunk != NULL, "allocation should have been successful");
-
-      chunk_manager->return_chunks(index, chunk);
-      chunk_manager->inc_free_chunks_total(chunk_size);
-      DEBUG_ONLY(verify_container_count();)
-    }
+  // Take the largest chunk that is aligned at the current top each time,
+  // so that no padding is needed.
+  size_t smallest_size = chunk_manager->free_chunks(SpecializedIndex)->size();
+  while (free_words_in_vs() >= smallest_size) {
+    DEBUG_ONLY(verify_container_count();)
+    size_t chunk_size = largest_chunk_size_at(top(), free_words_in_vs());
+    Metachunk* chunk = get_chunk_vs(chunk_size);
+    assert(chunk != NULL, "allocation should have been successful");
+
+    chunk_manager->inc_free_chunks_total(chunk_size);
+    chunk_manager->return_chunks(chunk_manager->list_index(chunk_size), chunk);
+    DEBUG_ONLY(verify_container_count();)
   }
   assert(free_words_in_vs() == 0, "should be empty now");
 }
@@ -1202,7 +1485,7 @@ VirtualSpaceList::VirtualSpaceList(ReservedSpace rs) :
                                    _virtual_space_count(0) {
   MutexLockerEx cl(SpaceManager::expand_lock(),
                    Mutex::_no_safepoint_check_flag);
-  VirtualSpaceNode* class_entry = new VirtualSpaceNode(rs);
+  VirtualSpaceNode* class_entry = new VirtualSpaceNode(true, rs);
   bool succeeded = class_entry->initialize();
   if (succeeded) {
     link_vs(class_entry);
@@ -1234,7 +1517,7 @@ bool VirtualSpaceList::create_new_virtual_space(size_t vs_word_size) {
   assert_is_size_aligned(vs_byte_size, Metaspace::reserve_alignment());
 
   // Allocate the meta virtual space and initialize it.
-  VirtualSpaceNode* new_entry = new VirtualSpaceNode(vs_byte_size);
+  VirtualSpaceNode* new_entry = new VirtualSpaceNode(false, vs_byte_size);
   if (!new_entry->initialize()) {
     delete new_entry;
     return false;
@@ -1340,8 +1623,12 @@ Metachunk* VirtualSpaceList::get_new_chunk(size_t chunk_word_size, size_t sugges
 
   // The expand amount is currently only determined by the requested sizes
   // and not how much committed memory is left in the current virtual space.
+  // Leave room for the padding that aligns the chunk in the node.
 
-  size_t min_word_size       = align_size_up(chunk_word_size,              Metaspace::commit_alignment_words());
+  size_t max_padding_words   = current_virtual_space()->chunk_alignment(chunk_word_size) -
+                               SpaceManager::smallest_chunk_size(is_class());
+  size_t min_word_size       = align_size_up(chunk_word_size + max_padding_words,
+                                             Metaspace::commit_alignment_words());
   size_t preferred_word_size = align_size_up(suggested_commit_granularity, Metaspace::commit_alignment_words());
   if (min_word_size >= preferred_word_size) {
     // Can happen when humongous chunks are allocated.
@@ -1823,16 +2110,25 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
   slow_locked_verify();
 
   Metachunk* chunk = NULL;
-  if (list_index(word_size) != HumongousIndex) {
+  ChunkIndex index = list_index(word_size);
+  if (index != HumongousIndex) {
     ChunkList* free_list = find_free_chunks_list(word_size);
     assert(free_list != NULL, "Sanity check");
 
     chunk = free_list->head();
 
+    if (chunk == NULL && split_larger_chunk(index)) {
+      chunk = free_list->head();
+    }
+
     if (chunk == NULL) {
       return NULL;
     }
 
+    if (chunk->is_uncommitted() && !chunk->container()->recommit_chunk(chunk)) {
+      return NULL;
+    }
+
     // Remove the chunk as the head of the list.
     free_list->remove_chunk(chunk);
 
@@ -1850,6 +2146,11 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
       return NULL;
     }
 
+    if (chunk->is_uncommitted() && !chunk->container()->recommit_chunk(chunk)) {
+      humongous_dictionary()->return_chunk(chunk);
+      return NULL;
+    }
+
     if (TraceMetadataHumongousAllocation) {
       size_t waste = chunk->word_size() - word_size;
       gclog_or_tty->print_cr("Free list allocate humongous chunk size "
@@ -1870,12 +2171,108 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
   // work.
   chunk->set_is_tagged_free(false);
 #endif
+  chunk->container()->occupancy_map()->set_in_use(chunk->bottom(), true);
   chunk->container()->inc_container_count();
 
   slow_locked_verify();
   return chunk;
 }
 
+bool ChunkManager::split_larger_chunk(ChunkIndex target_index) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t target_size = free_chunks(target_index)->size();
+  for (ChunkIndex i = next_chunk_index(target_index); i < HumongousIndex; i = next_chunk_index(i)) {
+    Metachunk* larger = free_chunks(i)->head();
+    if (larger == NULL) {
+      continue;
+    }
+    VirtualSpaceNode* vsn = larger->container();
+    if (larger->is_uncommitted() && !vsn->recommit_chunk(larger)) {
+      return false;
+    }
+    remove_chunk(larger);
+
+    // The first piece has the target size, the rest are the largest
+    // chunks aligned at their start, like padding at the top of a node.
+    MetaWord* p = larger->bottom();
+    MetaWord* end = p + larger->word_size();
+    size_t chunk_word_size = target_size;
+    while (p < end) {
+      Metachunk* piece = ::new (p) Metachunk(chunk_word_size, vsn);
+      vsn->occupancy_map()->set_chunk_starts_at(p, true);
+      add_free_chunk(piece);
+      p += chunk_word_size;
+      if (p < end) {
+        chunk_word_size = vsn->largest_chunk_size_at(p, pointer_delta(end, p, sizeof(MetaWord)));
+      }
+    }
+
+    if (TraceMetadataChunkAllocation && Verbose) {
+      gclog_or_tty->print_cr("ChunkManager::split_larger_chunk: split " SIZE_FORMAT
+                             " words for a chunk of " SIZE_FORMAT " words",
+                             pointer_delta(end, (MetaWord*)larger, sizeof(MetaWord)), target_size);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool ChunkManager::coalesce_around(Metachunk* chunk, ChunkIndex target_index) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t target_size = free_chunks(target_index)->size();
+  assert(chunk->word_size() < target_size, "Nothing to merge");
+
+  VirtualSpaceNode* vsn = chunk->container();
+  OccupancyMap* ocmap = vsn->occupancy_map();
+  size_t offset = pointer_delta(chunk->bottom(), vsn->bottom(), sizeof(MetaWord));
+  MetaWord* region_start = vsn->bottom() + align_size_down(offset, target_size);
+  MetaWord* region_end = region_start + target_size;
+
+  // The region must be made of whole chunks, none of them in use. A
+  // humongous chunk reaching into the region owns its start or end.
+  if (region_end > vsn->top() ||
+      !ocmap->chunk_starts_at(region_start) ||
+      (region_end < vsn->top() && !ocmap->chunk_starts_at(region_end)) ||
+      ocmap->is_region_in_use(region_start, target_size)) {
+    return false;
+  }
+
+  MetaWord* p = region_start;
+  while (p < region_end) {
+    Metachunk* c = (Metachunk*)p;
+    p += c->word_size();
+    assert(c->is_tagged_free(), "Should be tagged free");
+    remove_chunk(c);
+  }
+  assert(p == region_end, "Chunk crosses the region end");
+
+  ocmap->clear_chunk_starts(region_start, target_size);
+  ocmap->set_chunk_starts_at(region_start, true);
+  Metachunk* merged = ::new (region_start) Metachunk(target_size, vsn);
+  add_free_chunk(merged);
+
+  if (TraceMetadataChunkAllocation && Verbose) {
+    gclog_or_tty->print_cr("ChunkManager::coalesce_around: merged chunk " PTR_FORMAT
+                           " size " SIZE_FORMAT, merged, target_size);
+  }
+  return true;
+}
+
+void ChunkManager::add_free_chunk(Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  DEBUG_ONLY(chunk->set_is_tagged_free(true);)
+  ChunkIndex index = list_index(chunk->word_size());
+  if (index != HumongousIndex) {
+    free_chunks(index)->return_chunk_at_head(chunk);
+  } else {
+    humongous_dictionary()->return_chunk(chunk);
+  }
+  if (index >= MediumIndex) {
+    _has_uncommittable_chunks = true;
+  }
+  inc_free_chunks_total(chunk->word_size());
+}
+
 Metachunk* ChunkManager::chunk_freelist_allocate(size_t word_size) {
   assert_lock_strong(SpaceManager::expand_lock());
   slow_locked_verify();
@@ -2251,27 +2648,48 @@ void ChunkManager::return_chunks(ChunkIndex index, Metachunk* chunks) {
   if (chunks == NULL) {
     return;
   }
-  ChunkList* list = free_chunks(index);
-  assert(list->size() == chunks->word_size(), "Mismatch in chunk sizes");
+  assert(free_chunks(index)->size() == chunks->word_size(), "Mismatch in chunk sizes");
   assert_lock_strong(SpaceManager::expand_lock());
   Metachunk* cur = chunks;
 
-  // This returns chunks one at a time.  If a new
-  // class List can be created that is a base class
-  // of FreeList then something like FreeList::prepend()
-  // can be used in place of this loop
+  // This returns chunks one at a time so that each can be
+  // merged with its free neighbours.
   while (cur != NULL) {
     assert(cur->container() != NULL, "Container should have been set");
-    cur->container()->dec_container_count();
     // Capture the next link before it is changed
-    // by the call to return_chunk_at_head();
+    // by the call to return_single_chunk();
     Metachunk* next = cur->next();
-    DEBUG_ONLY(cur->set_is_tagged_free(true);)
-    list->return_chunk_at_head(cur);
+    return_single_chunk(index, cur);
     cur = next;
   }
 }
 
+void ChunkManager::return_single_chunk(ChunkIndex index, Metachunk* chunk) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  VirtualSpaceNode* vsn = chunk->container();
+  vsn->dec_container_count();
+  vsn->occupancy_map()->set_in_use(chunk->bottom(), false);
+  DEBUG_ONLY(chunk->set_is_tagged_free(true);)
+
+  if (index == HumongousIndex) {
+    humongous_dictionary()->return_chunk(chunk);
+    _has_uncommittable_chunks = true;
+    return;
+  }
+
+  free_chunks(index)->return_chunk_at_head(chunk);
+  if (index == MediumIndex) {
+    _has_uncommittable_chunks = true;
+    return;
+  }
+
+  // Merge into a medium chunk if the neighbours are free, else into a
+  // small one.
+  if (!coalesce_around(chunk, MediumIndex) && index == SpecializedIndex) {
+    coalesce_around(chunk, SmallIndex);
+  }
+}
+
 SpaceManager::~SpaceManager() {
   // This call this->_lock which can't be done while holding expand_lock()
   assert(sum_capacity_in_chunks_in_use() == allocated_chunks_words(),
@@ -2337,9 +2755,6 @@ SpaceManager::~SpaceManager() {
   Metachunk* humongous_chunks = chunks_in_use(HumongousIndex);
 
   while (humongous_chunks != NULL) {
-#ifdef ASSERT
-    humongous_chunks->set_is_tagged_free(true);
-#endif
     if (TraceMetadataChunkAllocation && Verbose) {
       gclog_or_tty->print(PTR_FORMAT " (" SIZE_FORMAT ") ",
                           humongous_chunks,
@@ -2352,8 +2767,7 @@ SpaceManager::~SpaceManager() {
                    " granularity %d",
                    humongous_chunks->word_size(), smallest_chunk_size()));
     Metachunk* next_humongous_chunks = humongous_chunks->next();
-    humongous_chunks->container()->dec_container_count();
-    chunk_manager()->humongous_dictionary()->return_chunk(humongous_chunks);
+    chunk_manager()->return_single_chunk(HumongousIndex, humongous_chunks);
     humongous_chunks = next_humongous_chunks;
   }
   if (TraceMetadataChunkAllocation && Verbose) {
@@ -2911,6 +3325,58 @@ void MetaspaceAux::print_waste(outputStream* out) {
   }
 }
 
+// Printed by the VM.metaspace diagnostic command.
+void MetaspaceAux::print_report(outputStream* out) {
+  MutexLockerEx cl(SpaceManager::expand_lock(),
+                   Mutex::_no_safepoint_check_flag);
+  print_report(out, Metaspace::NonClassType);
+  if (Metaspace::using_class_space()) {
+    print_report(out, Metaspace::ClassType);
+  }
+}
+
+void MetaspaceAux::print_report(outputStream* out, Metaspace::MetadataType mdtype) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  VirtualSpaceList* list = Metaspace::get_space_list(mdtype);
+  ChunkManager* cm = Metaspace::get_chunk_manager(mdtype);
+  if (list == NULL || cm == NULL) {
+    return;
+  }
+
+  size_t capacity = capacity_bytes(mdtype);
+  size_t used = used_bytes(mdtype);
+  out->print_cr("%s:", mdtype == Metaspace::ClassType ? "Class space" : "Non-class space");
+  out->print_cr("  reserved " SIZE_FORMAT "K, committed " SIZE_FORMAT "K, "
+                "capacity " SIZE_FORMAT "K, used " SIZE_FORMAT "K, "
+                "free in chunks in use " SIZE_FORMAT "K",
+                list->reserved_bytes() / K, list->committed_bytes() / K,
+                capacity / K, used / K, (capacity - MIN2(used, capacity)) / K);
+
+  out->print("  free chunks:");
+  size_t free_total = 0;
+  size_t free_below_medium = 0;
+  for (ChunkIndex i = ZeroIndex; i < NumberOfInUseLists; i = next_chunk_index(i)) {
+    size_t bytes = cm->size_free_chunks_in_bytes(i);
+    out->print(" %s " SIZE_FORMAT " (" SIZE_FORMAT "K)",
+               i == SpecializedIndex ? "specialized" :
+               i == SmallIndex       ? "small" :
+               i == MediumIndex      ? "medium" : "humongous",
+               cm->num_free_chunks(i), bytes / K);
+    free_total += bytes;
+    if (i < MediumIndex) {
+      free_below_medium += bytes;
+    }
+  }
+  out->cr();
+
+  // Free memory in chunks smaller than a medium chunk can only serve
+  // small requests until its neighbours are freed and it is merged.
+  out->print_cr("  free chunks total " SIZE_FORMAT "K, uncommitted " SIZE_FORMAT "K, "
+                "fragmentation " SIZE_FORMAT "%%",
+                free_total / K, list->uncommitted_words() * BytesPerWord / K,
+                free_total == 0 ? 0 : free_below_medium * 100 / free_total);
+}
+
 // Dump global metaspace things from the end of ClassLoaderDataGraph
 void MetaspaceAux::dump(outputStream* out) {
   out->print_cr("All Metaspace:");
@@ -3737,6 +4203,10 @@ void Metaspace::iterate(Metaspace::AllocRecordClosure *closure) {
 
 void Metaspace::purge(MetadataType mdtype) {
   get_space_list(mdtype)->purge(get_chunk_manager(mdtype));
+  if (MetaspaceUncommitFreeChunks && get_chunk_manager(mdtype)->has_uncommittable_chunks()) {
+    get_space_list(mdtype)->uncommit_free_chunks();
+    get_chunk_manager(mdtype)->clear_has_uncommittable_chunks();
+  }
 }
 
 void Metaspace::purge() {
@@ -3877,7 +4347,7 @@ class TestVirtualSpaceNodeTest {
 
     { // No committed memory in VSN
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.retire(&cm);
       assert(cm.sum_free_chunks_count() == 0, "did not commit any memory in the VSN");
@@ -3885,7 +4355,7 @@ class TestVirtualSpaceNodeTest {
 
     { // All of VSN is committed, half is used by chunks
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.expand_by(vsn_test_size_words, vsn_test_size_words);
       vsn.get_chunk_vs(MediumChunk);
@@ -3897,7 +4367,7 @@ class TestVirtualSpaceNodeTest {
 
     { // 4 pages of VSN is committed, some is used by chunks
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       const size_t page_chunks = 4 * (size_t)os::vm_page_size() / BytesPerWord;
       assert(page_chunks < MediumChunk, "Test expects medium chunks to be at least 4*page_size");
       vsn.initialize();
@@ -3919,7 +4389,7 @@ class TestVirtualSpaceNodeTest {
 
     { // Half of VSN is committed, a humongous chunk is used
       ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
-      VirtualSpaceNode vsn(vsn_test_size_bytes);
+      VirtualSpaceNode vsn(false, vsn_test_size_bytes);
       vsn.initialize();
       vsn.expand_by(MediumChunk * 2, MediumChunk * 2);
       vsn.get_chunk_vs(MediumChunk + SpecializedChunk); // Humongous chunks will be aligned up to MediumChunk + SpecializedChunk
@@ -3950,7 +4420,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_positive() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -3968,7 +4438,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_negative() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -3983,7 +4453,7 @@ class TestVirtualSpaceNodeTest {
 
   static void test_is_available_overflow() {
     // Reserve some memory.
-    VirtualSpaceNode vsn(os::vm_allocation_granularity());
+    VirtualSpaceNode vsn(false, os::vm_allocation_granularity());
     assert(vsn.initialize(), "Failed to setup VirtualSpaceNode");
 
     // Commit some memory.
@@ -4064,6 +4534,67 @@ void SpaceManager_test_adjust_initial_chunk_size() {
 
 // The following test is placed here instead of a gtest / unittest file
 // because the ChunkManager class is only available in this file.
+void ChunkManager_test_coalesce_and_split() {
+  MutexLockerEx ml(SpaceManager::expand_lock(), Mutex::_no_safepoint_check_flag);
+  const size_t vsn_test_size_words = MediumChunk * 4;
+  const size_t specialized_per_medium = MediumChunk / SpecializedChunk;
+
+  ChunkManager cm(SpecializedChunk, SmallChunk, MediumChunk);
+  VirtualSpaceNode vsn(false, vsn_test_size_words * BytesPerWord);
+  vsn.initialize();
+  vsn.expand_by(vsn_test_size_words, vsn_test_size_words);
+
+  // Fill the first medium sized region with specialized chunks.
+  Metachunk* chunks[MediumChunk / SpecializedChunk];
+  for (size_t i = 0; i < specialized_per_medium; i++) {
+    chunks[i] = vsn.get_chunk_vs(SpecializedChunk);
+    assert(chunks[i] != NULL, "should have been memory for the chunk");
+  }
+
+  // The last specialized chunk of each small region merges the region.
+  for (size_t i = 0; i < specialized_per_medium - 1; i++) {
+    cm.inc_free_chunks_total(SpecializedChunk);
+    cm.return_chunks(SpecializedIndex, chunks[i]);
+  }
+  assert(cm.num_free_chunks(SmallIndex) == specialized_per_medium * SpecializedChunk / SmallChunk - 1,
+         err_msg("Small chunks: " SIZE_FORMAT, cm.num_free_chunks(SmallIndex)));
+  assert(cm.num_free_chunks(SpecializedIndex) == SmallChunk / SpecializedChunk - 1,
+         err_msg("Specialized chunks: " SIZE_FORMAT, cm.num_free_chunks(SpecializedIndex)));
+  assert(cm.num_free_chunks(MediumIndex) == 0, "no medium chunk yet");
+
+  // Returning the last chunk frees the whole region.
+  cm.inc_free_chunks_total(SpecializedChunk);
+  cm.return_chunks(SpecializedIndex, chunks[specialized_per_medium - 1]);
+  assert(cm.num_free_chunks(MediumIndex) == 1, "should have merged into a medium chunk");
+  assert(cm.sum_free_chunks_count() == 1, "nothing else should be left");
+  assert(cm.sum_free_chunks() == MediumChunk, "sizes should add up");
+  assert(vsn.container_count() == 0, "no chunk in use");
+
+  // A specialized chunk is split off the medium chunk.
+  Metachunk* chunk = cm.free_chunks_get(SpecializedChunk);
+  assert((MetaWord*)chunk < vsn.bottom() + SmallChunk, "should have been split off the medium chunk");
+  assert(cm.num_free_chunks(MediumIndex) == 0, "the medium chunk was split");
+  assert(cm.num_free_chunks(SpecializedIndex) == SmallChunk / SpecializedChunk - 1,
+         err_msg("Specialized chunks: " SIZE_FORMAT, cm.num_free_chunks(SpecializedIndex)));
+  assert(cm.num_free_chunks(SmallIndex) == MediumChunk / SmallChunk - 1,
+         err_msg("Small chunks: " SIZE_FORMAT, cm.num_free_chunks(SmallIndex)));
+  assert(cm.sum_free_chunks() == MediumChunk - SpecializedChunk, "sizes should add up");
+
+  // A medium chunk taken next is aligned past the free space.
+  Metachunk* medium = vsn.get_chunk_vs(MediumChunk);
+  assert((MetaWord*)medium == vsn.bottom() + MediumChunk, "medium chunk not aligned");
+
+  // And the split chunk merges back.
+  cm.inc_free_chunks_total(SpecializedChunk);
+  cm.return_chunks(SpecializedIndex, chunk);
+  assert(cm.num_free_chunks(MediumIndex) == 1, "should have merged into a medium chunk");
+  assert(cm.sum_free_chunks() == MediumChunk, "sizes should add up");
+
+  cm.inc_free_chunks_total(MediumChunk);
+  cm.return_chunks(MediumIndex, medium);
+  assert(cm.num_free_chunks(MediumIndex) == 2, "medium chunks are not merged");
+}
+
 void ChunkManager_test_list_index() {
   ChunkManager manager(ClassSpecializedChunk, ClassSmallChunk, ClassMediumChunk);
 
@@ -379,6 +379,9 @@ class MetaspaceAux : AllStatic {
 
   static void print_class_waste(outputStream* out);
   static void print_waste(outputStream* out);
+  // Committed and used memory and the free chunk lists, for VM.metaspace
+  static void print_report(outputStream* out);
+  static void print_report(outputStream* out, Metaspace::MetadataType mdtype);
   static void dump(outputStream* out);
   static void verify_free_chunks();
   // Checks that the values returned by allocated_capacity_bytes() and
@@ -539,6 +539,12 @@ void VM_PopulateDumpSharedSpace::doit() {
 
   ClassLoaderExt::copy_lookup_cache_to_archive(&md_top, md_end);
 
+  // Copy the interned strings into an image of the string region, which
+  // is mapped into the heap at run time, and the table that finds them
+  // into md.
+  MemRegion string_range;
+  char* string_image = StringTable::copy_shared_strings(&md_top, md_end, &string_range);
+
   // Write the other data to the output array.
   WriteClosure wc(md_top, md_end);
   MetaspaceShared::serialize(&wc);
@@ -583,6 +589,8 @@ void VM_PopulateDumpSharedSpace::doit() {
   tty->print_cr(fmt_space, "mc", mc_bytes, mc_t_perc, mc_alloced, mc_u_perc, mc_low);
   tty->print_cr("total   : %9d [100.0%% of total] out of %9d bytes [%4.1f%% used]",
                  total_bytes, total_alloced, total_u_perc);
+  tty->print_cr("st space: " SIZE_FORMAT_W(9) " bytes of interned strings for the heap at " PTR_FORMAT,
+                string_range.byte_size(), p2i(string_range.start()));
 
   // Update the vtable pointers in all of the Klass objects in the
   // heap. They should point to newly generated vtable.
@@ -610,6 +618,8 @@ void VM_PopulateDumpSharedSpace::doit() {
                         pointer_delta(mc_top, _mc_vs.low(), sizeof(char)),
                         SharedMiscCodeSize,
                         true, true);
+  mapinfo->write_string_region(string_image, (char*)string_range.start(),
+                               string_range.byte_size());
 
   // Pass 2 - write data.
   mapinfo->open_for_write();
@@ -625,8 +635,14 @@ void VM_PopulateDumpSharedSpace::doit() {
                         pointer_delta(mc_top, _mc_vs.low(), sizeof(char)),
                         SharedMiscCodeSize,
                         true, true);
+  mapinfo->write_string_region(string_image, (char*)string_range.start(),
+                               string_range.byte_size());
   mapinfo->close();
 
+  if (string_image != NULL) {
+    FREE_C_HEAP_ARRAY(char, string_image, mtClassShared);
+  }
+
   memmove(vtbl_list, saved_vtbl, vtbl_list_size * sizeof(void*));
 
   if (PrintSharedSpaces) {
@@ -652,6 +668,19 @@ void MetaspaceShared::link_one_shared_class(Klass* obj, TRAPS) {
   }
 }
 
+// Intern the string literals of the shared classes, so that they are
+// archived with the other interned strings.
+static void intern_string_literals(Klass* k, TRAPS) {
+  if (k->oop_is_instance()) {
+    ConstantPool* cp = InstanceKlass::cast(k)->constants();
+    for (int i = 1; i < cp->length(); i++) {
+      if (cp->tag_at(i).is_string() && !cp->is_pseudo_string_at(i)) {
+        StringTable::intern(cp->unresolved_string_at(i), CHECK);
+      }
+    }
+  }
+}
+
 void MetaspaceShared::check_one_shared_class(Klass* k) {
   if (k->oop_is_instance() && InstanceKlass::cast(k)->check_sharing_error_state()) {
     _check_classes_made_progress = true;
@@ -771,6 +800,12 @@ void MetaspaceShared::preload_and_dump(TRAPS) {
   link_and_cleanup_shared_classes(CATCH);
   tty->print_cr("Rewriting and linking classes: done");
 
+  // The strings can only be mapped at run time with compressed oops and
+  // class pointers.
+  if (UseCompressedOops && UseCompressedClassPointers) {
+    SystemDictionary::classes_do(intern_string_literals, CATCH);
+  }
+
   // Create and dump the shared spaces.   Everything so far is loaded
   // with the null class loader.
   ClassLoaderData* loader_data = ClassLoaderData::the_null_class_loader_data();
@@ -1069,11 +1104,19 @@ void MetaspaceShared::initialize_shared_spaces() {
   buffer += len;
 
   buffer = ClassLoaderExt::restore_lookup_cache_from_archive(buffer);
+  buffer = StringTable::restore_shared_table(buffer);
 
   intptr_t* array = (intptr_t*)buffer;
   ReadClosure rc(&array);
   serialize(&rc);
 
+  // Map the archived strings into the heap. This needs the well-known
+  // klasses set up by serialize(), and must be done before any string
+  // is interned at run time.
+  if (mapinfo->map_string_region()) {
+    StringTable::set_shared_strings_mapped();
+  }
+
   // Close the mapinfo file
   mapinfo->close();
 
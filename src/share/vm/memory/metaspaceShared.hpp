@@ -75,7 +75,9 @@ class MetaspaceShared : AllStatic {
     rw = 1,  // read-write shared space in the heap
     md = 2,  // miscellaneous data for initializing tables, etc.
     mc = 3,  // miscellaneous code - vtable replacement.
-    n_regions = 4
+    n_regions = 4,
+    st = 4,  // interned strings, mapped into the Java heap.
+    n_all_regions = 5
   };
 
   // Accessor functions to save shared space created for metadata, which has
@@ -494,6 +494,77 @@ void CompactibleSpace::adjust_pointers() {
   SCAN_AND_ADJUST_POINTERS(adjust_obj_size);
 }
 
+void CompactibleSpace::initialize_adjust_tasks() {
+  _num_adjust_task_starts = 0;
+  _next_adjust_task_boundary = end();
+  uint n_tasks = MarkSweep::adjust_tasks_per_space();
+  if (n_tasks <= 1) {
+    return;
+  }
+  if (_adjust_task_capacity < n_tasks - 1) {
+    if (_adjust_task_starts != NULL) {
+      FREE_C_HEAP_ARRAY(HeapWord*, _adjust_task_starts, mtGC);
+    }
+    _adjust_task_starts = NEW_C_HEAP_ARRAY(HeapWord*, n_tasks - 1, mtGC);
+    _adjust_task_capacity = n_tasks - 1;
+  }
+  // Don't bother with tasks that are too small to pay for their claiming.
+  const size_t min_task_words = 16 * K;
+  _adjust_task_words = MAX2(pointer_delta(end(), bottom()) / n_tasks, min_task_words);
+  if (_adjust_task_words < pointer_delta(end(), bottom())) {
+    _next_adjust_task_boundary = bottom() + _adjust_task_words;
+  }
+}
+
+void CompactibleSpace::record_adjust_task_start(HeapWord* q) {
+  assert(q >= _next_adjust_task_boundary && q < end(), "not at a task boundary");
+  if (_num_adjust_task_starts < _adjust_task_capacity) {
+    _adjust_task_starts[_num_adjust_task_starts++] = q;
+    size_t next = (pointer_delta(q, bottom()) / _adjust_task_words + 1) * _adjust_task_words;
+    _next_adjust_task_boundary = next < pointer_delta(end(), bottom()) ? bottom() + next : end();
+  } else {
+    _next_adjust_task_boundary = end();
+  }
+}
+
+void CompactibleSpace::adjust_pointers_in_task(uint task) {
+  assert(task < num_adjust_tasks(), "task out of range");
+  assert(_first_dead <= _end_of_live, "Stands to reason, no?");
+  HeapWord* const t = _end_of_live;
+  HeapWord* q       = task == 0 ? bottom() : _adjust_task_starts[task - 1];
+  HeapWord* task_end = task == _num_adjust_task_starts ? t : _adjust_task_starts[task];
+
+  if (q < _first_dead) {
+    // Below _first_dead there are only objects, some of which may not
+    // move and have had their mark word reinitialized already, so walk
+    // them by size (see SCAN_AND_ADJUST_POINTERS).
+    HeapWord* prefix_end = MIN2(task_end, _first_dead);
+    while (q < prefix_end) {
+      q += adjust_object_size_v(oop(q)->adjust_pointers());
+    }
+    if (q < task_end) {
+      assert(q == _first_dead, "just checking");
+      q = (HeapWord*)oop(_first_dead)->mark()->decode_pointer();
+    }
+  }
+
+  debug_only(HeapWord* prev_q = NULL);
+  while (q < task_end) {
+    if (oop(q)->is_gc_marked()) {
+      // q is alive; point all the oops to the new location
+      debug_only(prev_q = q);
+      q += adjust_object_size_v(oop(q)->adjust_pointers());
+    } else {
+      // q is not a live object, so its mark should point at the next
+      // live object
+      debug_only(prev_q = q);
+      q = (HeapWord*)oop(q)->mark()->decode_pointer();
+      assert(q > prev_q, "we should be moving forward through memory");
+    }
+  }
+  assert(q == task_end, "tasks must end at an object start");
+}
+
 void CompactibleSpace::compact() {
   SCAN_AND_COMPACT(obj_size);
 }
@@ -349,7 +349,10 @@ private:
 
 public:
   CompactibleSpace() :
-   _compaction_top(NULL), _next_compaction_space(NULL) {}
+   _compaction_top(NULL), _next_compaction_space(NULL),
+   _adjust_task_starts(NULL), _adjust_task_capacity(0),
+   _num_adjust_task_starts(0), _adjust_task_words(0),
+   _next_adjust_task_boundary(NULL) {}
 
   virtual void initialize(MemRegion mr, bool clear_space, bool mangle_space);
   virtual void clear(bool mangle_space);
@@ -393,6 +396,13 @@ public:
   virtual void prepare_for_compaction(CompactPoint* cp);
   // MarkSweep support phase3
   virtual void adjust_pointers();
+  // MarkSweep support for a parallel phase3: the live part of the space
+  // is divided into num_adjust_tasks() tasks (see
+  // MarkSweep::adjust_tasks_per_space()), which may be adjusted by
+  // different threads. Requires that prepare_for_compaction() has
+  // been called on this space.
+  uint num_adjust_tasks() const { return _num_adjust_task_starts + 1; }
+  void adjust_pointers_in_task(uint task);
   // MarkSweep support phase4
   virtual void compact();
 
@@ -430,6 +440,20 @@ protected:
   HeapWord* _first_dead;
   HeapWord* _end_of_live;
 
+  // Used during compaction for a parallel phase3. Object starts recorded
+  // during prepare_for_compaction(), roughly every _adjust_task_words,
+  // that divide [bottom, _end_of_live) into tasks.
+  HeapWord** _adjust_task_starts;
+  uint       _adjust_task_capacity;
+  uint       _num_adjust_task_starts;
+  size_t     _adjust_task_words;
+  HeapWord*  _next_adjust_task_boundary;
+
+  void initialize_adjust_tasks();
+  // Called by prepare_for_compaction() for the first live object at or
+  // above _next_adjust_task_boundary.
+  void record_adjust_task_start(HeapWord* q);
+
   // Minimum size of a free block.
   virtual size_t minimum_free_block_size() const { return 0; }
 
@@ -81,6 +81,7 @@ inline HeapWord* Space::block_start(const void* p) {
   LiveRange* liveRange  = NULL; /* The current live range, recorded in the   \
                                    first header of preceding free area. */   \
   _first_dead = first_dead;                                                  \
+  initialize_adjust_tasks();                                                 \
                                                                              \
   const intx interval = PrefetchScanIntervalInBytes;                         \
                                                                              \
@@ -92,6 +93,9 @@ inline HeapWord* Space::block_start(const void* p) {
     if (block_is_obj(q) && oop(q)->is_gc_marked()) {                         \
       /* prefetch beyond q */                                                \
       Prefetch::write(q, interval);                                          \
+      if (q >= _next_adjust_task_boundary) {                                 \
+        record_adjust_task_start(q);                                         \
+      }                                                                      \
       size_t size = block_size(q);                                           \
       compact_top = cp->space->forward(oop(q), size, cp, compact_top);       \
       q += size;                                                             \
@@ -111,6 +115,9 @@ inline HeapWord* Space::block_start(const void* p) {
       if (allowed_deadspace > 0 && q == compact_top) {                       \
         size_t sz = pointer_delta(end, q);                                   \
         if (insert_deadspace(allowed_deadspace, q, sz)) {                    \
+          if (q >= _next_adjust_task_boundary) {                             \
+            record_adjust_task_start(q);                                     \
+          }                                                                  \
           compact_top = cp->space->forward(oop(q), sz, cp, compact_top);     \
           q = end;                                                           \
           end_of_live = end;                                                 \
@@ -57,6 +57,8 @@ void ThreadLocalAllocBuffer::accumulate_statistics_before_gc() {
   for (JavaThread *thread = Threads::first(); thread != NULL; thread = thread->next()) {
     thread->tlab().accumulate_statistics();
     thread->tlab().initialize_statistics();
+    thread->medium_tlab().accumulate_statistics();
+    thread->medium_tlab().initialize_statistics();
   }
 
   // Publish new stats if some allocation occurred.
@@ -74,6 +76,20 @@ void ThreadLocalAllocBuffer::accumulate_statistics() {
   size_t used     = Universe::heap()->tlab_used(thread);
 
   _gc_waste += (unsigned)remaining();
+  if (is_medium()) {
+    // The allocation history of the thread is kept by its primary tlab.
+    if (_number_of_refills > 0) {
+      if (PrintTLAB) {
+        print_stats("gc medium");
+      }
+      global_stats()->update_number_of_refills(_number_of_refills);
+      global_stats()->update_allocation(_number_of_refills * desired_size());
+      global_stats()->update_gc_waste(_gc_waste);
+      global_stats()->update_slow_refill_waste(_slow_refill_waste);
+    }
+    return;
+  }
+
   size_t total_allocated = thread->allocated_bytes();
   size_t allocated_since_last_gc = total_allocated - _allocated_before_last_gc;
   _allocated_before_last_gc = total_allocated;
@@ -167,12 +183,51 @@ void ThreadLocalAllocBuffer::resize() {
   set_refill_waste_limit(initial_refill_waste_limit());
 }
 
+void ThreadLocalAllocBuffer::resize_on_refill() {
+  assert(ResizeTLAB && ResizeTLABOnRefill, "Should not call this otherwise");
+  assert(!is_medium(), "medium buffer follows the primary tlab");
+  // Wait for a few refills so that the rate is not dominated by the
+  // first allocations after the gc.
+  if (_number_of_refills < 2) {
+    return;
+  }
+  Thread* thrd = myThread();
+  size_t used = Universe::heap()->tlab_used(thrd);
+  if (used == 0) {
+    return;
+  }
+  // Same estimate as resize(), but from the fraction of eden this thread
+  // has allocated in the current epoch rather than the averaged history.
+  size_t allocated = thrd->allocated_bytes() - _allocated_before_last_gc;
+  double alloc_frac = MIN2(1.0, (double) allocated / used);
+  size_t capacity = Universe::heap()->tlab_capacity(thrd) / HeapWordSize;
+  size_t new_size = (size_t)(alloc_frac * capacity) / _target_refills;
+
+  // Only grow here, and at most by a factor of two per refill; shrinking
+  // is left to resize() at the next gc.
+  new_size = MIN2(new_size, desired_size() * 2);
+  new_size = align_object_size(MIN2(MAX2(new_size, min_size()), max_size()));
+  if (new_size <= desired_size()) {
+    return;
+  }
+
+  if (PrintTLAB && Verbose) {
+    gclog_or_tty->print("TLAB refill resize: thread: " INTPTR_FORMAT " [id: %2d]"
+                        " alloc: %8.6f desired_size: " SIZE_FORMAT " -> " SIZE_FORMAT "\n",
+                        thrd, thrd->osthread()->thread_id(),
+                        alloc_frac, desired_size(), new_size);
+  }
+  _refill_resizes++;
+  set_desired_size(new_size);
+}
+
 void ThreadLocalAllocBuffer::initialize_statistics() {
     _number_of_refills = 0;
     _fast_refill_waste = 0;
     _slow_refill_waste = 0;
     _gc_waste          = 0;
     _slow_allocations  = 0;
+    _refill_resizes    = 0;
 }
 
 void ThreadLocalAllocBuffer::fill(HeapWord* start,
@@ -240,6 +295,7 @@ void ThreadLocalAllocBuffer::startup_initialization() {
   // before the heap is initialized.  So reinitialize it now.
   guarantee(Thread::current()->is_Java_thread(), "tlab initialization thread not Java thread");
   Thread::current()->tlab().initialize();
+  Thread::current()->medium_tlab().initialize();
 
   if (PrintTLAB && Verbose) {
     gclog_or_tty->print("TLAB min: " SIZE_FORMAT " initial: " SIZE_FORMAT " max: " SIZE_FORMAT "\n",
@@ -287,6 +343,33 @@ void ThreadLocalAllocBuffer::print_stats(const char* tag) {
                       _fast_refill_waste * HeapWordSize);
 }
 
+void ThreadLocalAllocBuffer::print_all_on(outputStream* st) {
+  MutexLockerEx ml(Threads_lock);
+  for (JavaThread *thread = Threads::first(); thread != NULL; thread = thread->next()) {
+    ResourceMark rm;
+    st->print_cr("\"%s\" [id: %d]", thread->get_thread_name(), thread->osthread()->thread_id());
+    thread->tlab().print_on(st);
+    if (UseMediumTLAB) {
+      thread->medium_tlab().print_on(st);
+    }
+  }
+}
+
+void ThreadLocalAllocBuffer::print_on(outputStream* st) {
+  size_t waste = _gc_waste + _slow_refill_waste + _fast_refill_waste;
+  size_t alloc = _number_of_refills * _desired_size;
+  double waste_percent = alloc == 0 ? 0.0 : 100.0 * waste / alloc;
+  st->print_cr("  %s: desired_size: " SIZE_FORMAT "KB refills: %u"
+               " refill resizes: %u slow allocs: %u waste %4.1f%%"
+               " gc: " SIZE_FORMAT "B slow: " SIZE_FORMAT "B fast: " SIZE_FORMAT "B",
+               is_medium() ? "medium" : "tlab",
+               _desired_size / (K / HeapWordSize), _number_of_refills,
+               _refill_resizes, _slow_allocations, waste_percent,
+               (size_t)_gc_waste * HeapWordSize,
+               (size_t)_slow_refill_waste * HeapWordSize,
+               (size_t)_fast_refill_waste * HeapWordSize);
+}
+
 void ThreadLocalAllocBuffer::verify() {
   HeapWord* p = start();
   HeapWord* t = top();
@@ -300,9 +383,11 @@ void ThreadLocalAllocBuffer::verify() {
 }
 
 Thread* ThreadLocalAllocBuffer::myThread() {
+  ByteSize thread_offset = is_medium() ? Thread::medium_tlab_start_offset()
+                                       : Thread::tlab_start_offset();
   return (Thread*)(((char *)this) +
                    in_bytes(start_offset()) -
-                   in_bytes(Thread::tlab_start_offset()));
+                   in_bytes(thread_offset));
 }
 
 
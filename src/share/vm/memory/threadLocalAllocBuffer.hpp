@@ -55,6 +55,9 @@ private:
   unsigned  _slow_refill_waste;
   unsigned  _gc_waste;
   unsigned  _slow_allocations;
+  unsigned  _refill_resizes;                     // desired_size increases since the last gc
+
+  bool      _medium;                             // second buffer for objects that miss a retained tlab
 
   AdaptiveWeightedAverage _allocation_fraction;  // fraction of eden allocated in tlabs
 
@@ -65,7 +68,6 @@ private:
   void set_end(HeapWord* end)                    { _end = end; }
   void set_top(HeapWord* top)                    { _top = top; }
   void set_pf_top(HeapWord* pf_top)              { _pf_top = pf_top; }
-  void set_desired_size(size_t desired_size)     { _desired_size = desired_size; }
   void set_refill_waste_limit(size_t waste)      { _refill_waste_limit = waste;  }
 
   size_t initial_refill_waste_limit()            { return desired_size() / TLABRefillWasteFraction; }
@@ -101,10 +103,16 @@ private:
   static GlobalTLABStats* global_stats() { return _global_stats; }
 
 public:
-  ThreadLocalAllocBuffer() : _allocation_fraction(TLABAllocationWeight), _allocated_before_last_gc(0) {
+  ThreadLocalAllocBuffer() : _allocation_fraction(TLABAllocationWeight), _allocated_before_last_gc(0), _medium(false) {
     // do nothing.  tlabs must be inited by initialize() calls
   }
 
+  // The medium-object buffer of a thread is not resized on its own;
+  // it follows the desired size of the thread's primary tlab.
+  bool is_medium() const                         { return _medium; }
+  void set_medium()                              { _medium = true; }
+  void set_desired_size(size_t desired_size)     { _desired_size = desired_size; }
+
   static const size_t min_size()                 { return align_object_size(MinTLABSize / HeapWordSize) + alignment_reserve(); }
   static const size_t max_size()                 { assert(_max_size != 0, "max_size not set up"); return _max_size; }
   static void set_max_size(size_t max_size)      { _max_size = max_size; }
@@ -140,6 +148,10 @@ public:
   // Record slow allocation
   inline void record_slow_allocation(size_t obj_size);
 
+  // Grow desired_size() at refill time from the allocation rate of the
+  // thread since the last gc, without waiting for the next resize().
+  void resize_on_refill();
+
   // Initialization at startup
   static void startup_initialization();
 
@@ -155,6 +167,10 @@ public:
   // Resize tlabs for all threads
   static void resize_all_tlabs();
 
+  // Print per-thread refill and waste statistics since the last gc
+  static void print_all_on(outputStream* st);
+  void print_on(outputStream* st);
+
   void fill(HeapWord* start, HeapWord* top, size_t new_size);
   void initialize();
 
@@ -43,6 +43,11 @@ void markOopDesc::print_on(outputStream* st) const {
       st->print("is_biased");
       JavaThread* jt = biased_locker();
       st->print(" biased_locker=" INTPTR_FORMAT, p2i(jt));
+    } else if (UseLightweightLocking && is_fast_locked()) {
+      st->print("is_fast_locked");
+      if (has_no_hash()) st->print(" no_hash");
+      else st->print(" hash=" INTPTR_FORMAT, hash());
+      st->print(" age=%d", age());
     } else if (has_monitor()) {
       ObjectMonitor* mon = monitor();
       if (mon == NULL)
@@ -224,7 +224,9 @@ class markOopDesc: public oopDesc {
 
   // Special temporary state of the markOop while being inflated.
   // Code that looks at mark outside a lock need to take this into account.
-  bool is_being_inflated() const { return (value() == 0); }
+  // Lightweight locking never inflates through this state, and 0 is a
+  // valid fast-locked header then.
+  bool is_being_inflated() const { return !UseLightweightLocking && (value() == 0); }
 
   // Distinguished markword value - used when inflating over
   // an existing stacklock.  0 indicates the markword is "BUSY".
@@ -271,9 +273,17 @@ class markOopDesc: public oopDesc {
   markOop set_unlocked() const {
     return markOop(value() | unlocked_value);
   }
-  bool has_locker() const {
+  // With UseLightweightLocking, a locked object keeps its header and only
+  // has its lock bits cleared. The owner is found on its lock stack.
+  bool is_fast_locked() const {
     return ((value() & lock_mask_in_place) == locked_value);
   }
+  markOop set_fast_locked() const {
+    return markOop(value() & ~lock_mask_in_place);
+  }
+  bool has_locker() const {
+    return !UseLightweightLocking && ((value() & lock_mask_in_place) == locked_value);
+  }
   BasicLock* locker() const {
     assert(has_locker(), "check");
     return (BasicLock*) value();
@@ -287,6 +297,10 @@ class markOopDesc: public oopDesc {
     return (ObjectMonitor*) (value() ^ monitor_value);
   }
   bool has_displaced_mark_helper() const {
+    if (UseLightweightLocking) {
+      // A fast-locked header is not displaced.
+      return ((value() & lock_mask_in_place) == monitor_value);
+    }
     return ((value() & unlocked_value) == 0);
   }
   markOop displaced_mark_helper() const {
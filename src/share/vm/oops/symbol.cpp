@@ -62,7 +62,7 @@ void* Symbol::operator new(size_t sz, int len, ClassLoaderData* loader_data, TRA
 }
 
 void Symbol::operator delete(void *p) {
-  assert(((Symbol*)p)->refcount() == 0, "should not call this");
+  assert(((Symbol*)p)->refcount() == 0 || ((Symbol*)p)->is_dead(), "should not call this");
   FreeHeap(p);
 }
 
@@ -214,6 +214,8 @@ unsigned int Symbol::new_hash(juint seed) {
 }
 
 void Symbol::increment_refcount() {
+  // A dead symbol is about to be freed and must not be referenced again.
+  assert(!is_dead(), "reviving a dead symbol");
   // Only increment the refcount if positive.  If negative either
   // overflow has occurred or it is a permanent symbol in a read only
   // shared archive.
@@ -223,6 +225,50 @@ void Symbol::increment_refcount() {
   }
 }
 
+volatile jint* Symbol::refcount_word() {
+  // The refcount occupies the most significant 16 bits of an aligned
+  // 32-bit word (see ATOMIC_SHORT_PAIR), so it can be updated with a
+  // 32-bit cmpxchg that leaves the length unchanged.
+#ifdef VM_LITTLE_ENDIAN
+  assert((intx(&_refcount) & 0x03) == 0x02, "wrong alignment");
+  return (volatile jint*)(&_refcount - 1);
+#else
+  assert((intx(&_refcount) & 0x03) == 0x00, "wrong alignment");
+  return (volatile jint*)(&_refcount);
+#endif
+}
+
+bool Symbol::try_increment_refcount() {
+  volatile jint* word = refcount_word();
+  jint old_word = *word;
+  while (true) {
+    short refc = (short)(old_word >> 16);
+    if (refc == dead_refcount || refc == 0) {
+      return false;
+    }
+    if (refc < 0) {
+      // Permanent symbol
+      return true;
+    }
+    jint cur = Atomic::cmpxchg(old_word + 0x10000, word, old_word);
+    if (cur == old_word) {
+      NOT_PRODUCT(Atomic::inc(&_total_count);)
+      return true;
+    }
+    old_word = cur;
+  }
+}
+
+bool Symbol::try_claim_dead() {
+  volatile jint* word = refcount_word();
+  jint old_word = *word;
+  if ((short)(old_word >> 16) != 0) {
+    return false;
+  }
+  jint dead_word = (jint)(((juint)(jushort)dead_refcount << 16) | ((juint)old_word & 0xffff));
+  return Atomic::cmpxchg(dead_word, word, old_word) == old_word;
+}
+
 void Symbol::decrement_refcount() {
   if (_refcount >= 0) {
     Atomic::dec(&_refcount);
@@ -122,9 +122,13 @@ class Symbol : private SymbolBase {
 
   enum {
     // max_symbol_length is constrained by type of _length
-    max_symbol_length = (1 << 16) -1
+    max_symbol_length = (1 << 16) -1,
+    // refcount of a symbol claimed for freeing by the SymbolTable
+    dead_refcount = -(1 << 15)
   };
 
+  volatile jint* refcount_word();
+
   static int size(int length) {
     size_t sz = heap_word_size(sizeof(SymbolBase) + (length > 0 ? length : 0));
     return align_object_size(sz);
@@ -160,6 +164,13 @@ class Symbol : private SymbolBase {
   int refcount() const      { return _refcount; }
   void increment_refcount();
   void decrement_refcount();
+  // Like increment_refcount(), but fails for a symbol whose count has
+  // dropped to zero, which may be unlinked from the SymbolTable concurrently.
+  bool try_increment_refcount();
+  // Atomically moves an unreferenced symbol to the dead state, after which
+  // its count can no longer be incremented.
+  bool try_claim_dead();
+  bool is_dead() const      { return _refcount == dead_refcount; }
 
   int byte_at(int index) const {
     assert(index >=0 && index < _length, "symbol index overflow");
@@ -658,8 +658,8 @@ void PhaseCFG::set_loop_alignment() {
 }
 
 // Make empty basic blocks to be "connector" blocks, Move uncommon blocks
-// to the end.
-void PhaseCFG::remove_empty_blocks() {
+// to the end if requested.
+void PhaseCFG::remove_empty_blocks(bool move_uncommon_blocks) {
   // Move uncommon blocks to the end
   uint last = number_of_blocks();
   assert(get_block(0) == get_root_block(), "");
@@ -681,7 +681,7 @@ void PhaseCFG::remove_empty_blocks() {
     }
 
     // Look for uncommon blocks and move to end.
-    if (!C->do_freq_based_layout()) {
+    if (move_uncommon_blocks) {
       if (is_uncommon(block)) {
         move_to_end(block, i);
         last--;                   // No longer check for being uncommon!
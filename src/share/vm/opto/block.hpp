@@ -587,8 +587,8 @@ class PhaseCFG : public Phase {
   // Set loop alignment
   void set_loop_alignment();
 
-  // Remove empty basic blocks
-  void remove_empty_blocks();
+  // Remove empty basic blocks, and move uncommon blocks to the end
+  void remove_empty_blocks(bool move_uncommon_blocks);
   Block *fixup_trap_based_check(Node *branch, Block *block, int block_pos, Block *bnext);
   void fixup_flow();
 
@@ -524,6 +524,10 @@
   product(bool, BlockLayoutByFrequency, true,                               \
           "Use edge frequencies to drive block ordering")                   \
                                                                             \
+  product(bool, SplitColdCode, false,                                       \
+          "Emit uncommon blocks after all frequently executed blocks of "   \
+          "a method")                                                       \
+                                                                            \
   product(intx, BlockLayoutMinDiamondPercentage, 20,                        \
           "Miniumum %% of a successor (predecessor) for which block layout "\
           "a will allow a fork (join) in a single chain")                   \
@@ -2368,9 +2368,14 @@ void Compile::Code_Gen() {
   // can now safely remove it.
   {
     NOT_PRODUCT( TracePhase t2("blockOrdering", &_t_blockOrdering, TimeCompiler); )
-    cfg.remove_empty_blocks();
+    cfg.remove_empty_blocks(!do_freq_based_layout());
     if (do_freq_based_layout()) {
       PhaseBlockLayout layout(cfg);
+      if (SplitColdCode) {
+        // The layout keeps uncommon blocks in the traces of the frequent
+        // blocks they branch off. Move them behind all frequent blocks.
+        cfg.remove_empty_blocks(true);
+      }
     } else {
       cfg.set_loop_alignment();
     }
@@ -5093,6 +5093,7 @@ _JNI_IMPORT_OR_EXPORT_ jint JNICALL JNI_GetDefaultJavaVMInitArgs(void *args_) {
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
 #endif
 #include "memory/guardedMemory.hpp"
+#include "memory/heap.hpp"
 #include "utilities/quickSort.hpp"
 #include "utilities/ostream.hpp"
 #if INCLUDE_VM_STRUCTS
@@ -5112,6 +5113,7 @@ void TestMetaspaceAux_test();
 void SpaceManager_test_adjust_initial_chunk_size();
 void TestMetachunk_test();
 void TestVirtualSpaceNode_test();
+void ChunkManager_test_coalesce_and_split();
 void TestNewSize_test();
 void TestKlass_test();
 void Test_linked_list();
@@ -5135,6 +5137,8 @@ void execute_internal_vm_tests() {
     run_unit_test(TestMetaspaceAux_test());
     run_unit_test(TestMetachunk_test());
     run_unit_test(TestVirtualSpaceNode_test());
+    run_unit_test(ChunkManager_test_coalesce_and_split());
+    run_unit_test(CodeHeap::test());
     run_unit_test(GlobalDefinitions::test_globals());
     run_unit_test(GlobalDefinitions::test_proper_unit());
     run_unit_test(GCTimerAllTest::all());
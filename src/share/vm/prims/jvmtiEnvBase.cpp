@@ -976,6 +976,9 @@ JvmtiEnvBase::get_object_monitor_usage(JavaThread* calling_thread, jobject objec
 
         if (mark->has_locker()) {
           owner = (address)mark->locker(); // save the address of the Lock word
+        } else if (UseLightweightLocking && mark->is_fast_locked()) {
+          // the owner has the object on its lock stack
+          owner = (address)Threads::owning_thread_from_object(hobj(), !at_safepoint);
         }
         // implied else: no owner
       } else {
@@ -988,7 +991,14 @@ JvmtiEnvBase::get_object_monitor_usage(JavaThread* calling_thread, jobject objec
         // by a non-owning JavaThread, but only the owning JavaThread
         // can change the owner field from the Lock word to the
         // JavaThread * and it may not have done that yet.
-        owner = (address)mon->owner();
+        // With UseLightweightLocking the owner may be anonymous until
+        // the owning JavaThread, which has the object on its lock
+        // stack, takes the monitor over.
+        if (UseLightweightLocking && mon->is_owner_anonymous()) {
+          owner = (address)Threads::owning_thread_from_object(hobj(), !at_safepoint);
+        } else {
+          owner = (address)mon->owner();
+        }
       }
     }
 
@@ -1021,13 +1031,15 @@ JvmtiEnvBase::get_object_monitor_usage(JavaThread* calling_thread, jobject objec
     }
 
     if (owning_thread != NULL) {  // monitor is owned
-      if ((address)owning_thread == owner) {
+      if ((address)owning_thread == owner &&
+          !(UseLightweightLocking && (mon == NULL || mon->is_owner_anonymous()))) {
         // the owner field is the JavaThread *
         assert(mon != NULL,
           "must have heavyweight monitor with JavaThread * owner");
         ret.entry_count = mon->recursions() + 1;
       } else {
-        // The owner field is the Lock word on the JavaThread's stack
+        // The owner field is the Lock word on the JavaThread's stack,
+        // or the object is on the owner's lock stack,
         // so the recursions field is not valid. We have to count the
         // number of recursive monitor entries the hard way. We pass
         // a handle to survive any GCs along the way.
@@ -2326,6 +2326,8 @@ bool Arguments::check_vm_args_consistency() {
   status = status && verify_interval(SymbolTableSize, minimumSymbolTableSize,
     (max_uintx / SymbolTable::bucket_size()), "SymbolTable size");
 
+  status = status && verify_min_value(AsyncDeflationInterval, 0, "AsyncDeflationInterval");
+
   {
     // Using "else if" below to avoid printing two error messages if min > max.
     // This will also prevent us from reporting both min>100 and max>100 at the
@@ -2475,6 +2477,8 @@ bool Arguments::check_vm_args_consistency() {
 
     status = status && verify_interval(FLSCoalescePolicy, 0, 4, "FLSCoalescePolicy");
 
+    status = status && verify_interval(CMSFragmentationTarget, 0, 100, "CMSFragmentationTarget");
+
     status = status && verify_min_value(CMSRescanMultiple, 1, "CMSRescanMultiple");
     status = status && verify_min_value(CMSConcMarkMultiple, 1, "CMSConcMarkMultiple");
 
@@ -2628,6 +2632,7 @@ bool Arguments::check_vm_args_consistency() {
 
   status &= verify_interval(NmethodSweepFraction, 1, ReservedCodeCacheSize/K, "NmethodSweepFraction");
   status &= verify_interval(NmethodSweepActivity, 0, 2000, "NmethodSweepActivity");
+  status &= verify_interval(StartAggressiveSweepingAt, 1, 100, "StartAggressiveSweepingAt");
 
   if (!FLAG_IS_DEFAULT(CICompilerCount) && !FLAG_IS_DEFAULT(CICompilerCountPerCPU) && CICompilerCountPerCPU) {
     warning("The VM option CICompilerCountPerCPU overrides CICompilerCount.");
@@ -4279,6 +4284,46 @@ jint Arguments::apply_ergo() {
     UseBiasedLocking = false;
   }
 
+  // Lightweight locking has fast paths in the x86_64 interpreter and
+  // compilers only.
+#if !defined(AMD64) || defined(CC_INTERP)
+  if (UseLightweightLocking) {
+    warning("Lightweight locking is not supported on this platform"
+            "; ignoring UseLightweightLocking flag." );
+    FLAG_SET_DEFAULT(UseLightweightLocking, false);
+  }
+#endif
+
+#if INCLUDE_JVMCI
+  // The inline locking snippets of JVMCI compilers displace the mark word
+  // to a BasicLock and know nothing about lock stacks.
+  if (UseLightweightLocking && EnableJVMCI && JVMCIUseFastLocking) {
+    warning("Lightweight locking is not supported with JVMCI fast locking"
+            "; ignoring UseLightweightLocking flag." );
+    FLAG_SET_DEFAULT(UseLightweightLocking, false);
+  }
+#endif
+
+  // A fast-locked mark word can not carry a bias, and lightweight locking
+  // makes the uncontended case cheap enough not to need one.
+  if (UseLightweightLocking && UseBiasedLocking) {
+    if (!FLAG_IS_DEFAULT(UseBiasedLocking)) {
+      warning("Biased Locking is not supported with lightweight locking"
+              "; ignoring UseBiasedLocking flag." );
+    }
+    UseBiasedLocking = false;
+  }
+
+  // The ServiceThread finds the monitors to deflate on the per-thread
+  // in-use lists.
+  if (AsyncDeflateIdleMonitors && !MonitorInUseLists) {
+    if (!FLAG_IS_DEFAULT(MonitorInUseLists)) {
+      warning("AsyncDeflateIdleMonitors requires MonitorInUseLists"
+              "; ignoring -XX:-MonitorInUseLists flag." );
+    }
+    FLAG_SET_ERGO(bool, MonitorInUseLists, true);
+  }
+
 #ifdef ZERO
   // Clear flags not supported on zero.
   FLAG_SET_DEFAULT(ProfileInterpreter, false);
@@ -4379,8 +4424,9 @@ jint Arguments::adjust_after_os() {
     // platforms when UseNUMA is set to ON. NUMA-aware collectors
     // such as the parallel collector for Linux and Solaris will
     // interleave old gen and survivor spaces on top of NUMA
-    // allocation policy for the eden space.
-    // Non NUMA-aware collectors such as CMS, G1 and Serial-GC on
+    // allocation policy for the eden space. G1 binds the memory of
+    // each region to a node when the region is committed.
+    // Non NUMA-aware collectors such as CMS and Serial-GC on
     // all platforms and ParallelGC on Windows will interleave all
     // of the heap spaces across NUMA nodes.
     if (FLAG_IS_DEFAULT(UseNUMAInterleaving)) {
@@ -27,6 +27,7 @@
 #include "oops/markOop.hpp"
 #include "runtime/basicLock.hpp"
 #include "runtime/biasedLocking.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/task.hpp"
 #include "runtime/vframe.hpp"
 #include "runtime/vmThread.hpp"
@@ -503,6 +504,48 @@ public:
 };
 
 
+// Revokes the bias of a single object biased toward another thread
+// while only that thread is stopped. The bias may have changed between
+// the decision to revoke it and the handshake, in which case nothing is
+// done and the caller falls back to VM_RevokeBias.
+class RevokeOneBias : public HandshakeClosure {
+  Handle* _obj;
+  JavaThread* _requesting_thread;
+  JavaThread* _biased_locker;
+  BiasedLocking::Condition _status_code;
+  bool _executed;
+
+public:
+  RevokeOneBias(Handle* obj, JavaThread* requesting_thread, JavaThread* biased_locker)
+    : HandshakeClosure("RevokeOneBias")
+    , _obj(obj)
+    , _requesting_thread(requesting_thread)
+    , _biased_locker(biased_locker)
+    , _status_code(BiasedLocking::NOT_BIASED)
+    , _executed(false) {}
+
+  void do_thread(Thread* target) {
+    assert(target == _biased_locker, "wrong thread");
+    oop obj = (*_obj)();
+    markOop mark = obj->mark();
+    if (mark->has_bias_pattern() &&
+        mark->biased_locker() == _biased_locker &&
+        obj->klass()->prototype_header()->bias_epoch() == mark->bias_epoch()) {
+      ResourceMark rm;
+      if (TraceBiasedLocking) {
+        tty->print_cr("Revoking bias with thread-local handshake:");
+      }
+      _status_code = revoke_bias(obj, false, false, _requesting_thread);
+      _biased_locker->set_cached_monitor_info(NULL);
+      _executed = true;
+    }
+  }
+
+  bool executed() const { return _executed; }
+  BiasedLocking::Condition status_code() const { return _status_code; }
+};
+
+
 class VM_BulkRevokeBias : public VM_RevokeBias {
 private:
   bool _bulk_rebias;
@@ -614,6 +657,15 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
       assert(cond == BIAS_REVOKED, "why not?");
       return cond;
     } else {
+      JavaThread* biased_locker = mark->biased_locker();
+      if (ThreadLocalHandshakes && biased_locker != NULL && biased_locker != THREAD) {
+        // Only the thread toward which the object is biased has to be
+        // stopped to walk its stack.
+        RevokeOneBias revoke(&obj, (JavaThread*) THREAD, biased_locker);
+        if (Handshake::execute(&revoke, biased_locker) && revoke.executed()) {
+          return revoke.status_code();
+        }
+      }
       VM_RevokeBias revoke(&obj, (JavaThread*) THREAD);
       VMThread::execute(&revoke);
       return revoke.status_code();
@@ -789,6 +789,14 @@ class CommandLineFlags {
   diagnostic(bool, AbortVMOnSafepointTimeout, false,                        \
           "Abort upon failure to reach safepoint (see SafepointTimeout)")   \
                                                                             \
+  product(bool, ThreadLocalHandshakes, false,                               \
+          "Use handshakes with single threads instead of safepoints to "    \
+          "revoke the bias of objects biased toward other threads")         \
+                                                                            \
+  diagnostic(intx, HandshakeRetryCount, 100,                                \
+          "Number of times the VM thread retries a handshake with a "       \
+          "thread in the VM before it falls back to a safepoint")           \
+                                                                            \
   /* 50 retries * (5 * current_retry_count) millis = ~6.375 seconds */      \
   /* typically, at most a few retries are needed */                         \
   product(intx, SuspendRetryCount, 50,                                      \
@@ -1170,6 +1178,15 @@ class CommandLineFlags {
                                                                             \
   product(bool, MonitorInUseLists, false, "Track Monitors for Deflation")   \
                                                                             \
+  product(bool, AsyncDeflateIdleMonitors, false,                            \
+          "Deflate idle monitors in the ServiceThread instead of at "       \
+          "every safepoint; implies MonitorInUseLists")                     \
+                                                                            \
+  product(intx, AsyncDeflationInterval, 250,                                \
+          "Minimum time in ms between two walks of the ServiceThread "      \
+          "over the monitors in use. 0 means walk only when MonitorBound "  \
+          "is exceeded")                                                    \
+                                                                            \
   product(intx, SyncFlags, 0, "(Unsafe, Unstable) Experimental Sync flags") \
                                                                             \
   product(intx, SyncVerbose, 0, "(Unstable)")                               \
@@ -1267,6 +1284,10 @@ class CommandLineFlags {
   product(bool, LazyBootClassLoader, true,                                  \
           "Enable/disable lazy opening of boot class path entries")         \
                                                                             \
+  product(bool, UseClassPathIndex, false,                                   \
+          "Map the jar files of the boot class path and search them "       \
+          "through an index of their packages")                             \
+                                                                            \
   product(bool, UseXMMForArrayCopy, false,                                  \
           "Use SSE2 MOVQ instruction for Arraycopy")                        \
                                                                             \
@@ -1428,6 +1449,9 @@ class CommandLineFlags {
   product(bool, TraceMonitorInflation, false,                               \
           "Trace monitor inflation in JVM")                                 \
                                                                             \
+  product(bool, TraceHandshakes, false,                                     \
+          "Trace thread-local handshakes")                                  \
+                                                                            \
   /* gc */                                                                  \
                                                                             \
   product(bool, UseSerialGC, false,                                         \
@@ -1612,6 +1636,11 @@ class CommandLineFlags {
           "Number of blocks to attempt to claim when refilling CMS LAB's "  \
           "for parallel GC")                                                \
                                                                             \
+  product(uintx, CMSParPromoteReserveSize, 0,                               \
+          "Size (in words) of the range of the old generation each "        \
+          "worker reserves for promoting blocks too large for its CMS "     \
+          "LAB, avoiding the dictionary lock. 0 disables reservation")      \
+                                                                            \
   product(uintx, OldPLABWeight, 50,                                         \
           "Percentage (0-100) used to weight the current sample when "      \
           "computing exponentially decaying average for resizing "          \
@@ -1695,6 +1724,11 @@ class CommandLineFlags {
           "CMS: aggressiveness level for coalescing, increasing "           \
           "from 0 to 4")                                                    \
                                                                             \
+  product(uintx, CMSFragmentationTarget, 0,                                 \
+          "CMS: fragmentation of the free space (in percent) above which "  \
+          "a sweep coalesces small free blocks regardless of the free "     \
+          "list census. 0 disables such defragmenting sweeps")              \
+                                                                            \
   product(bool, FLSAlwaysCoalesceLarge, false,                              \
           "CMS: larger free blocks are always available for coalescing")    \
                                                                             \
@@ -2086,6 +2120,15 @@ class CommandLineFlags {
           "Provide more detailed and expensive TLAB statistics "            \
           "(with PrintTLAB)")                                               \
                                                                             \
+  product(bool, ResizeTLABOnRefill, false,                                  \
+          "Grow the TLAB of a thread when it is refilled, from the "        \
+          "fraction of eden the thread allocated since the last GC "        \
+          "(with ResizeTLAB)")                                              \
+                                                                            \
+  product(bool, UseMediumTLAB, false,                                       \
+          "Allocate objects that do not fit in a retained TLAB from a "     \
+          "second thread-local buffer instead of the shared eden")          \
+                                                                            \
   product_pd(bool, NeverActAsServerClassMachine,                            \
           "Never act like a server-class machine")                          \
                                                                             \
@@ -2622,6 +2665,10 @@ class CommandLineFlags {
           "Print the break down of clean up tasks performed during "        \
           "safepoint")                                                      \
                                                                             \
+  product(bool, ParallelSafepointCleanup, true,                             \
+          "Perform the clean up tasks of a safepoint in parallel on the "   \
+          "GC worker threads, if the collector has any")                    \
+                                                                            \
   product(bool, Inline, true,                                               \
           "Enable inlining")                                                \
                                                                             \
@@ -2655,6 +2702,10 @@ class CommandLineFlags {
   diagnostic(bool, PrintMethodFlushingStatistics, false,                    \
           "print statistics about method flushing")                         \
                                                                             \
+  diagnostic(bool, PrintCodeCacheEviction, false,                           \
+          "Print the nmethods the sweeper makes not entrant to free code "  \
+          "cache space, with their compile cost")                           \
+                                                                            \
   develop(bool, UseRelocIndex, false,                                       \
           "Use an index to speed random access to relocations")             \
                                                                             \
@@ -2710,6 +2761,11 @@ class CommandLineFlags {
   product(bool, UseHeavyMonitors, false,                                    \
           "use heavyweight instead of lightweight Java monitors")           \
                                                                             \
+  product(bool, UseLightweightLocking, false,                               \
+          "Lock objects by swinging the mark word and recording the "       \
+          "object on a per-thread lock stack instead of displacing the "    \
+          "mark word to a BasicLock; disables biased locking")              \
+                                                                            \
   product(bool, PrintStringTableStatistics, false,                          \
           "print statistics about the StringTable and SymbolTable")         \
                                                                             \
@@ -3034,6 +3090,14 @@ class CommandLineFlags {
   product(intx, SafepointTimeoutDelay, 10000,                               \
           "Delay in milliseconds for option SafepointTimeout")              \
                                                                             \
+  product(bool, ProfileTimeToSafepoint, false,                              \
+          "Record the last threads to reach each safepoint and where "      \
+          "they were executing; see the VM.safepoint_profile "              \
+          "diagnostic command")                                             \
+                                                                            \
+  product(uintx, TimeToSafepointProfileSize, 128,                           \
+          "Number of safepoints kept by the time to safepoint profiler")    \
+                                                                            \
   product(intx, NmethodSweepFraction, 16,                                   \
           "Number of invocations of sweeper to cover all nmethods")         \
                                                                             \
@@ -3044,6 +3108,18 @@ class CommandLineFlags {
           "Removes cold nmethods from code cache if > 0. Higher values "    \
           "result in more aggressive sweeping")                             \
                                                                             \
+  product(bool, UseCostAwareCodeCacheFlushing, false,                       \
+          "Base code cache eviction on how often an nmethod is found on "   \
+          "thread stacks and on the cost of compiling it again")            \
+                                                                            \
+  product(bool, UseCodeCacheSweeperThread, false,                           \
+          "Sweep the code cache in a dedicated thread instead of in the "   \
+          "compiler threads")                                               \
+                                                                            \
+  product(intx, StartAggressiveSweepingAt, 10,                              \
+          "Wake up the sweeper thread when less than this percentage of "   \
+          "a code heap is free")                                            \
+                                                                            \
   notproduct(bool, LogSweeper, false,                                       \
           "Keep a ring buffer of sweeper activity")                         \
                                                                             \
@@ -3299,6 +3375,10 @@ class CommandLineFlags {
   product(uintx, MaxMetaspaceExpansion, ScaleForWordSize(4*M),              \
           "The maximum expansion of Metaspace without full GC (in bytes)")  \
                                                                             \
+  product(bool, MetaspaceUncommitFreeChunks, true,                          \
+          "Uncommit the memory of free medium and humongous Metaspace "     \
+          "chunks after class unloading")                                   \
+                                                                            \
   product(uintx, QueuedAllocationWarningCount, 0,                           \
           "Number of times an allocation that queues behind a GC "          \
           "will retry before printing a warning")                           \
@@ -3332,6 +3412,12 @@ class CommandLineFlags {
           "How often should we fully compact the heap (ignoring the dead "  \
           "space parameters)")                                              \
                                                                             \
+  product(bool, GenMarkSweepParallelAdjustEnabled, false,                   \
+          "Adjust pointers in parallel in the mark-compact full "           \
+          "collections of the serial and CMS collectors, using the "        \
+          "ParNew worker threads. Only the pointer adjustment phase is "    \
+          "parallelized")                                                   \
+                                                                            \
   product(intx, PrintCMSStatistics, 0,                                      \
           "Statistics for CMS")                                             \
                                                                             \
@@ -3422,6 +3508,21 @@ class CommandLineFlags {
   product_pd(uintx, CodeCacheExpansionSize,                                 \
           "Code cache expansion size (in bytes)")                           \
                                                                             \
+  product(bool, SegmentedCodeCache, false,                                  \
+          "Use a segmented code cache with separate code heaps for "        \
+          "non-method, profiled and non-profiled code")                     \
+                                                                            \
+  product(uintx, NonNMethodCodeHeapSize, 8*M,                               \
+          "Size of the code heap with non-method code (in bytes)")          \
+                                                                            \
+  product(uintx, ProfiledCodeHeapSize, 0,                                   \
+          "Size of the code heap with profiled compiled methods (in "       \
+          "bytes), 0 means half of the rest of the code cache")             \
+                                                                            \
+  product(uintx, NonProfiledCodeHeapSize, 0,                                \
+          "Size of the code heap with non-profiled compiled methods (in "   \
+          "bytes), 0 means the rest of the code cache")                     \
+                                                                            \
   develop_pd(uintx, CodeCacheMinBlockLength,                                \
           "Minimum number of segments in a code cache block")               \
                                                                             \
@@ -3956,6 +4057,18 @@ class CommandLineFlags {
   experimental(uintx, SymbolTableSize, defaultSymbolTableSize,              \
           "Number of buckets in the JVM internal Symbol table")             \
                                                                             \
+  product(uintx, TableResizeLoadFactor, 4,                                  \
+          "Double the interned String table and the Symbol table in the "   \
+          "service thread when they hold more than this many entries "      \
+          "per bucket. 0 disables resizing")                                \
+                                                                            \
+  product(bool, ConcurrentSymbolTableCleaning, false,                       \
+          "Unlink unreferenced symbols from the Symbol table in the "       \
+          "service thread instead of during GC pauses")                     \
+                                                                            \
+  product(bool, TraceTableResizing, false,                                  \
+          "Trace resizing and cleaning of the String and Symbol tables")    \
+                                                                            \
   product(bool, UseStringDeduplication, false,                              \
           "Use string deduplication")                                       \
                                                                             \
@@ -4008,6 +4121,15 @@ class CommandLineFlags {
   product(ccstr, ExtraSharedClassListFile, NULL,                            \
           "Extra classlist for building the CDS archive file")              \
                                                                             \
+  product(bool, UseAppCDS, false,                                           \
+          "Archive classes from the application class path in the CDS "     \
+          "archive and load them from it for the system class loader")      \
+                                                                            \
+  product(ccstr, ArchiveClassesAtExit, NULL,                                \
+          "Dump a CDS archive to this file at exit, with the classes of "   \
+          "the default or SharedClassListFile class list and the ones "     \
+          "loaded by this run")                                             \
+                                                                            \
   experimental(uintx, ArrayAllocatorMallocLimit,                            \
           SOLARIS_ONLY(64*K) NOT_SOLARIS(max_uintx),                        \
           "Allocation less than this value will be allocated "              \
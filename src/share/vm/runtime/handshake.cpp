@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/handshake.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/vmThread.hpp"
+#include "runtime/vm_operations.hpp"
+
+// Arms the handshake in the target. Called by the VM thread with the
+// Threads_lock held.
+static void arm(JavaThread* target, HandshakeClosure* cl) {
+  assert(target->handshake_state() == Handshake::_not_armed, "already armed");
+  target->set_handshake_operation(cl);
+  OrderAccess::release_store(target->handshake_state_addr(), (jint)Handshake::_armed);
+  // Setting the flag is a full fence, so the store of the state cannot
+  // float below the read of the target's thread state in try_process().
+  target->set_has_handshake();
+}
+
+// Completes a claimed handshake.
+static void disarm(JavaThread* target) {
+  assert(Handshake::is_processing(target), "must be claimed");
+  target->set_handshake_operation(NULL);
+  target->clear_has_handshake();
+  OrderAccess::release_store(target->handshake_state_addr(), (jint)Handshake::_not_armed);
+}
+
+// Threads in these states do not touch their Java frames until they
+// have performed a state transition, which checks for an armed handshake.
+static bool is_safe_for_handshake(JavaThread* target, JavaThreadState state) {
+  return state == _thread_new || SafepointSynchronize::safepoint_safe(target, state);
+}
+
+// Tries to execute an armed handshake for the target on the VM thread.
+// Returns true if the handshake is no longer armed, i.e. it has been
+// executed either by us or by the target itself.
+static bool try_process(JavaThread* target, HandshakeClosure* cl) {
+  jint state = target->handshake_state();
+  if (state == Handshake::_not_armed) {
+    return true;
+  }
+  if (state == Handshake::_processing) {
+    // The target is executing the closure itself.
+    return false;
+  }
+  if (!is_safe_for_handshake(target, target->thread_state())) {
+    return false;
+  }
+  if (Atomic::cmpxchg((jint)Handshake::_processing, target->handshake_state_addr(),
+                      (jint)Handshake::_armed) != Handshake::_armed) {
+    // The target claimed the handshake in a concurrent transition.
+    return false;
+  }
+  cl->do_thread(target);
+  disarm(target);
+  return true;
+}
+
+// Disarms a handshake that could not be executed. Returns true if the
+// closure was executed after all because the target claimed it first.
+static bool cancel(JavaThread* target) {
+  if (Atomic::cmpxchg((jint)Handshake::_not_armed, target->handshake_state_addr(),
+                      (jint)Handshake::_armed) == Handshake::_armed) {
+    target->set_handshake_operation(NULL);
+    target->clear_has_handshake();
+    return false;
+  }
+  while (target->handshake_state() != Handshake::_not_armed) {
+    SpinPause();
+  }
+  return true;
+}
+
+static void serialize_thread_states() {
+  if (os::is_MP()) {
+    if (UseMembar) {
+      OrderAccess::fence();
+    } else {
+      // Threads that write their state through the serialization page
+      // need it to be seen before we look at their state.
+      os::serialize_thread_states();
+    }
+  }
+}
+
+class VM_Handshake : public VM_Operation {
+  HandshakeClosure* _cl;
+  JavaThread*       _target;
+  bool              _executed;
+ public:
+  VM_Handshake(HandshakeClosure* cl, JavaThread* target) :
+    _cl(cl), _target(target), _executed(false) {}
+
+  VMOp_Type type() const { return VMOp_Handshake; }
+  Mode evaluation_mode() const { return _no_safepoint; }
+  bool allow_nested_vm_operations() const { return true; }
+  bool executed() const { return _executed; }
+
+  void doit() {
+    MutexLockerEx ml(Threads_lock);
+    JavaThread* thr = Threads::first();
+    while (thr != NULL && thr != _target) {
+      thr = thr->next();
+    }
+    if (thr == NULL) {
+      // The target has exited.
+      return;
+    }
+    arm(_target, _cl);
+    serialize_thread_states();
+
+    for (intx attempt = 0; ; attempt++) {
+      if (try_process(_target, _cl)) {
+        _executed = true;
+        break;
+      }
+      // A thread running Java code only polls the global safepoint page
+      // and does not come by a transition that would process the
+      // handshake, so waiting for it is more expensive than the safepoint
+      // the caller falls back to.
+      if (_target->thread_state() == _thread_in_Java || attempt >= HandshakeRetryCount) {
+        _executed = cancel(_target);
+        break;
+      }
+      os::yield();
+      serialize_thread_states();
+    }
+
+    if (TraceHandshakes && !_executed) {
+      tty->print_cr("[Handshake %s: thread not reached]", _cl->name());
+    }
+  }
+};
+
+bool Handshake::execute(HandshakeClosure* cl, JavaThread* target) {
+  VM_Handshake op(cl, target);
+  VMThread::execute(&op);
+  return op.executed();
+}
+
+void Handshake::process_by_self(JavaThread* thread) {
+  assert(thread == Thread::current(), "must be the target");
+  while (true) {
+    jint state = thread->handshake_state();
+    if (state == _not_armed) {
+      return;
+    }
+    if (state == _armed &&
+        Atomic::cmpxchg((jint)_processing, thread->handshake_state_addr(), (jint)_armed) == _armed) {
+      HandshakeClosure* cl = thread->handshake_operation();
+      {
+        ResourceMark rm(thread);
+        HandleMark hm(thread);
+        cl->do_thread(thread);
+      }
+      disarm(thread);
+      return;
+    }
+    // The VM thread is executing the closure for us.
+    SpinPause();
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_RUNTIME_HANDSHAKE_HPP
+#define SHARE_VM_RUNTIME_HANDSHAKE_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/thread.hpp"
+
+// A handshake executes a closure for a single JavaThread while that
+// thread is stopped, without bringing the other threads to a safepoint.
+//
+// The VM thread arms the handshake in the target thread and then
+// executes the closure itself if the target is in a safepoint-safe
+// state (blocked or in native with a walkable stack). A target that
+// leaves such a state while the handshake is armed notices this in its
+// thread state transition and either executes the closure itself or
+// waits until the VM thread is done with it. Exactly one of the two
+// claims the handshake, using a CAS on the per-thread handshake state.
+//
+// Compiled and interpreted code only poll the global safepoint page, so
+// a thread that keeps running Java code cannot be reached. A handshake
+// with such a thread is disarmed right away, and one with a thread in
+// the VM is disarmed after HandshakeRetryCount attempts; the operation
+// then has to be done at a safepoint instead. Operations on all threads
+// would nearly always end up at a safepoint this way, so they do not
+// use handshakes.
+//
+// A closure may be executed by the VM thread or by the target thread,
+// possibly while the target holds VM locks, so it must not acquire
+// locks or block. The Threads_lock is held by the VM thread for the
+// whole handshake, so the target cannot exit while it is processed.
+class HandshakeClosure : public ThreadClosure {
+  const char* _name;
+ public:
+  HandshakeClosure(const char* name) : _name(name) {}
+  const char* name() const { return _name; }
+};
+
+class Handshake : public AllStatic {
+ public:
+  enum State {
+    _not_armed  = 0,   // no handshake
+    _armed      = 1,   // armed, not yet claimed
+    _processing = 2    // claimed by the VM thread or by the target
+  };
+
+  // Executes the closure for the target thread. Returns false if the
+  // target could not be reached within the retry limit or is no longer
+  // alive; the closure has then not been executed and the caller has
+  // to fall back to a safepoint operation.
+  static bool execute(HandshakeClosure* cl, JavaThread* target);
+
+  // Called by a thread that finds a handshake armed during a thread state
+  // transition. Executes the closure or waits until the VM thread has done so.
+  static void process_by_self(JavaThread* thread);
+
+  static bool is_processing(JavaThread* thread) {
+    return thread->handshake_state() == _processing;
+  }
+};
+
+#endif // SHARE_VM_RUNTIME_HANDSHAKE_HPP
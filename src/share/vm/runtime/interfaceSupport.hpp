@@ -27,6 +27,7 @@
 
 #include "memory/gcLocker.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/os.hpp"
@@ -152,6 +153,9 @@ class ThreadStateTransition : public StackObj {
     if (SafepointSynchronize::do_call_back()) {
       SafepointSynchronize::block(thread);
     }
+    if (thread->has_handshake()) {
+      Handshake::process_by_self(thread);
+    }
     thread->set_thread_state(to);
 
     CHECK_UNHANDLED_OOPS_ONLY(thread->clear_unhandled_oops();)
@@ -183,6 +187,9 @@ class ThreadStateTransition : public StackObj {
     if (SafepointSynchronize::do_call_back()) {
       SafepointSynchronize::block(thread);
     }
+    if (thread->has_handshake()) {
+      Handshake::process_by_self(thread);
+    }
     thread->set_thread_state(to);
 
     CHECK_UNHANDLED_OOPS_ONLY(thread->clear_unhandled_oops();)
@@ -216,7 +223,8 @@ class ThreadStateTransition : public StackObj {
     // We never install asynchronous exceptions when coming (back) in
     // to the runtime from native code because the runtime is not set
     // up to handle exceptions floating around at arbitrary points.
-    if (SafepointSynchronize::do_call_back() || thread->is_suspend_after_native()) {
+    if (SafepointSynchronize::do_call_back() || thread->is_suspend_after_native() ||
+        thread->has_handshake()) {
       JavaThread::check_safepoint_and_suspend_for_native_trans(thread);
 
       // Clear unhandled oops anywhere where we could block, even if we don't.
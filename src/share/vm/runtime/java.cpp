@@ -33,6 +33,7 @@
 #if INCLUDE_JVMCI
 #include "jvmci/jvmci.hpp"
 #endif
+#include "memory/dynamicArchive.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/oopFactory.hpp"
 #include "memory/universe.hpp"
@@ -504,6 +505,13 @@ void before_exit(JavaThread * thread) {
     current = next;
   }
 
+#if INCLUDE_CDS
+  // Dump a CDS archive with the classes loaded so far.
+  if (ArchiveClassesAtExit != NULL) {
+    DynamicArchive::dump(thread);
+  }
+#endif
+
   // Hang forever on exit if we're reporting an error.
   if (ShowMessageBoxOnError && is_error_reported()) {
     os::infinite_sleep();
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "memory/iterator.hpp"
+#include "runtime/lockStack.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/ostream.hpp"
+
+LockStack::LockStack() :
+  _top(start_offset()), _bad_oop_sentinel(badOopVal) {
+  for (int i = 0; i < CAPACITY; i++) {
+    _base[i] = NULL;
+  }
+}
+
+uint32_t LockStack::start_offset() {
+  return in_bytes(JavaThread::lock_stack_base_offset());
+}
+
+uint32_t LockStack::end_offset() {
+  return start_offset() + CAPACITY * oopSize;
+}
+
+int LockStack::to_index(uint32_t offset) {
+  assert(offset >= start_offset() && offset <= end_offset(),
+         err_msg("lock stack offset out of range: %u", offset));
+  return (offset - start_offset()) / oopSize;
+}
+
+#ifndef PRODUCT
+void LockStack::verify(const char* msg) const {
+  assert(UseLightweightLocking, err_msg("%s: lock stack used without lightweight locking", msg));
+  assert(_bad_oop_sentinel == (uintptr_t)badOopVal, err_msg("%s: lock stack sentinel overwritten", msg));
+  int top = to_index(_top);
+  for (int i = 0; i < top; i++) {
+    assert(_base[i] != NULL, err_msg("%s: NULL entry in lock stack", msg));
+    for (int j = i + 1; j < top; j++) {
+      assert(_base[i] != _base[j], err_msg("%s: object locked twice on the lock stack", msg));
+    }
+  }
+}
+#endif
+
+void LockStack::push(oop o) {
+  verify("pre-push");
+  assert(!contains(o), "object is already fast-locked by this thread");
+  assert(can_push(), "lock stack is full");
+  _base[to_index(_top)] = o;
+  _top += oopSize;
+  verify("post-push");
+}
+
+bool LockStack::contains(oop o) const {
+  // Only the owner modifies the lock stack, so a concurrent reader may
+  // see a stale top. That is fine for the diagnostic uses by other threads.
+  int top = MIN2(to_index(_top), (int)CAPACITY);
+  for (int i = top - 1; i >= 0; i--) {
+    if (_base[i] == o) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int LockStack::remove(oop o) {
+  verify("pre-remove");
+  int top = to_index(_top);
+  int inserted = 0;
+  for (int i = 0; i < top; i++) {
+    if (_base[i] != o) {
+      _base[inserted++] = _base[i];
+    }
+  }
+  for (int i = inserted; i < top; i++) {
+    _base[i] = NULL;
+  }
+  int removed = top - inserted;
+  _top -= removed * oopSize;
+  verify("post-remove");
+  return removed;
+}
+
+void LockStack::oops_do(OopClosure* cl) {
+  int top = to_index(_top);
+  for (int i = 0; i < top; i++) {
+    cl->do_oop(&_base[i]);
+  }
+}
+
+void LockStack::print_on(outputStream* st) const {
+  int top = to_index(_top);
+  for (int i = top - 1; i >= 0; i--) {
+    st->print_cr("LockStack[%d]: " INTPTR_FORMAT, i, p2i((oopDesc*)_base[i]));
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_RUNTIME_LOCKSTACK_HPP
+#define SHARE_VM_RUNTIME_LOCKSTACK_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oop.hpp"
+#include "utilities/sizes.hpp"
+
+class OopClosure;
+class outputStream;
+
+// With UseLightweightLocking, an object is locked by clearing the lock
+// bits of its mark word with a CAS and pushing it onto the lock stack of
+// the owning JavaThread. The mark word keeps the object's hash and age,
+// so nothing is displaced, and the owner of a fast-locked object is the
+// thread that has it on its lock stack.
+//
+// Recursive locking, contention, wait/notify and a full lock stack all
+// inflate the object into an ObjectMonitor. A monitor that is inflated
+// by another thread than the owner is owned by ANONYMOUS_OWNER until the
+// owner finds the object on its lock stack and takes it over.
+//
+// The lock stack is embedded in the JavaThread and only modified by its
+// owner; other threads only read it at safepoints or for diagnostics.
+class LockStack VALUE_OBJ_CLASS_SPEC {
+  friend class VMStructs;
+ public:
+  enum { CAPACITY = 8 };
+
+ private:
+  // The offset of the next free slot in bytes, relative to the owning
+  // JavaThread rather than to _base, so that generated code can address
+  // the top of the stack directly from the thread register.
+  uint32_t  _top;
+  // Sits just below _base, so that generated code can compare the top
+  // of an empty lock stack with an oop without special-casing it.
+  uintptr_t _bad_oop_sentinel;
+  oop       _base[CAPACITY];
+
+  static int to_index(uint32_t offset);
+  void verify(const char* msg) const PRODUCT_RETURN;
+
+ public:
+  LockStack();
+
+  static ByteSize top_offset()  { return byte_offset_of(LockStack, _top); }
+  static ByteSize base_offset() { return byte_offset_of(LockStack, _base); }
+
+  // The range of _top, relative to the owning JavaThread.
+  static uint32_t start_offset();
+  static uint32_t end_offset();
+
+  bool can_push() const { return to_index(_top) < CAPACITY; }
+  bool is_empty() const { return to_index(_top) == 0; }
+  void push(oop o);
+  bool contains(oop o) const;
+  // Removes all occurrences of o and returns how many there were.
+  int remove(oop o);
+
+  void oops_do(OopClosure* cl);
+  void print_on(outputStream* st) const;
+};
+
+#endif // SHARE_VM_RUNTIME_LOCKSTACK_HPP
@@ -296,6 +296,14 @@ static volatile int InitDone       = 0 ;
 // -----------------------------------------------------------------------------
 // Enter support
 
+// Records when Self acquired the monitor under contention so that exit()
+// can report how long contended monitors are held.
+inline void ObjectMonitor::StampContendedAcquire () {
+  if (ObjectMonitor::_sync_ContendedHoldTicks != NULL) {
+    _acquire_time = os::elapsed_counter() ;
+  }
+}
+
 bool ObjectMonitor::try_enter(Thread* THREAD) {
   if (THREAD != _owner) {
     if (THREAD->is_lock_owned ((address)_owner)) {
@@ -315,7 +323,7 @@ bool ObjectMonitor::try_enter(Thread* THREAD) {
   }
 }
 
-void ATTR ObjectMonitor::enter(TRAPS) {
+bool ATTR ObjectMonitor::enter(TRAPS) {
   // The following code is ordered to check the most common cases first
   // and to reduce RTS->RTO cache line upgrades on SPARC and IA32 processors.
   Thread * const Self = THREAD ;
@@ -327,13 +335,16 @@ void ATTR ObjectMonitor::enter(TRAPS) {
      assert (_recursions == 0   , "invariant") ;
      assert (_owner      == Self, "invariant") ;
      // CONSIDER: set or assert OwnerIsThread == 1
-     return ;
+     // An uncontended acquisition is not timed.  Discard any stamp left
+     // by a contended owner that released the monitor in compiled code.
+     _acquire_time = 0 ;
+     return true ;
   }
 
   if (cur == Self) {
      // TODO-FIXME: check for integer overflow!  BUGID 6557169.
      _recursions ++ ;
-     return ;
+     return true ;
   }
 
   if (Self->is_lock_owned ((address)cur)) {
@@ -343,7 +354,7 @@ void ATTR ObjectMonitor::enter(TRAPS) {
     // a full-fledged "Thread *".
     _owner = Self ;
     OwnerIsThread = 1 ;
-    return ;
+    return true ;
   }
 
   // We've encountered genuine contention.
@@ -360,7 +371,8 @@ void ATTR ObjectMonitor::enter(TRAPS) {
      assert (_recursions == 0    , "invariant") ;
      assert (((oop)(object()))->mark() == markOopDesc::encode(this), "invariant") ;
      Self->_Stalled = 0 ;
-     return ;
+     StampContendedAcquire () ;
+     return true ;
   }
 
   assert (_owner != Self          , "invariant") ;
@@ -370,13 +382,22 @@ void ATTR ObjectMonitor::enter(TRAPS) {
   assert (!SafepointSynchronize::is_at_safepoint(), "invariant") ;
   assert (jt->thread_state() != _thread_blocked   , "invariant") ;
   assert (this->object() != NULL  , "invariant") ;
-  assert (_count >= 0, "invariant") ;
 
   // Prevent deflation at STW-time.  See deflate_idle_monitors() and is_busy().
   // Ensure the object-monitor relationship remains stable while there's contention.
-  Atomic::inc_ptr(&_count);
+  if (Atomic::add_ptr(1, &_count) <= 0) {
+    // The concurrent deflater has already deflated this monitor, which
+    // no longer belongs to the object.  Help restore the object header in
+    // case the deflater has not done so yet and let the caller inflate again.
+    TEVENT (enter - lost race with async deflation) ;
+    install_displaced_markword_in_object() ;
+    Atomic::dec_ptr(&_count);
+    Self->_Stalled = 0 ;
+    return false ;
+  }
 
   EventJavaMonitorEnter event;
+  int parks = 0 ;
 
   { // Change java thread status to indicate blocked on monitor enter.
     JavaThreadBlockedOnMonitorEnterState jtbmes(jt, this);
@@ -403,7 +424,7 @@ void ATTR ObjectMonitor::enter(TRAPS) {
       // cleared by handle_special_suspend_equivalent_condition()
       // or java_suspend_self()
 
-      EnterI (THREAD) ;
+      parks += EnterI (THREAD) ;
 
       if (!ExitSuspendEquivalent(jt)) break ;
 
@@ -434,6 +455,7 @@ void ATTR ObjectMonitor::enter(TRAPS) {
   Atomic::dec_ptr(&_count);
   assert (_count >= 0, "invariant") ;
   Self->_Stalled = 0 ;
+  StampContendedAcquire () ;
 
   // Must either set _recursions = 0 or ASSERT _recursions == 0.
   assert (_recursions == 0     , "invariant") ;
@@ -468,12 +490,25 @@ void ATTR ObjectMonitor::enter(TRAPS) {
     event.set_klass(((oop)this->object())->klass());
     event.set_previousOwner((TYPE_JAVALANGTHREAD)_previous_owner_tid);
     event.set_address((TYPE_ADDRESS)(uintptr_t)(this->object_addr()));
+    event.set_parks((u4)parks);
     event.commit();
   }
 
   if (ObjectMonitor::_sync_ContendedLockAttempts != NULL) {
      ObjectMonitor::_sync_ContendedLockAttempts->inc() ;
   }
+  return true ;
+}
+
+// Restores the displaced header of a concurrently deflated monitor to the
+// object, unless the deflater (or another thread) has already done so.
+void ObjectMonitor::install_displaced_markword_in_object() {
+  assert (is_being_async_deflated(), "invariant") ;
+  oop obj = (oop) object() ;
+  assert (obj != NULL, "invariant") ;
+  markOop dmw = header() ;
+  assert (dmw->is_neutral(), "invariant") ;
+  Atomic::cmpxchg_ptr (dmw, obj->mark_addr(), markOopDesc::encode(this)) ;
 }
 
 
@@ -499,17 +534,37 @@ int ObjectMonitor::TryLock (Thread * Self) {
    }
 }
 
-void ATTR ObjectMonitor::EnterI (TRAPS) {
+// The concurrent deflater claims an idle monitor by installing
+// DEFLATER_MARKER as its owner before it checks _count, so it may claim
+// the monitor just after Self registered its contention in enter().  Self
+// then cancels the deflation by taking the monitor over.  The deflater
+// notices that it lost the monitor and removes the extra contention added
+// here, which keeps _count positive until it has done so.
+
+int ObjectMonitor::TryCancelDeflation (Thread * Self) {
+   if (_owner != DEFLATER_MARKER) return 0 ;
+   if (Atomic::cmpxchg_ptr (Self, &_owner, DEFLATER_MARKER) != DEFLATER_MARKER) return 0 ;
+   // Self is either counted in _count (enter) or in _waiters (wait).
+   assert (_count > 0 || _waiters > 0, "invariant") ;
+   assert (_recursions == 0, "invariant") ;
+   Atomic::inc_ptr (&_count) ;
+   OwnerIsThread = 1 ;
+   return 1 ;
+}
+
+// Returns the number of times Self parked before it acquired the monitor.
+
+int ATTR ObjectMonitor::EnterI (TRAPS) {
     Thread * Self = THREAD ;
     assert (Self->is_Java_thread(), "invariant") ;
     assert (((JavaThread *) Self)->thread_state() == _thread_blocked   , "invariant") ;
 
     // Try the lock - TATAS
-    if (TryLock (Self) > 0) {
+    if (TryLock (Self) > 0 || TryCancelDeflation (Self) > 0) {
         assert (_succ != Self              , "invariant") ;
         assert (_owner == Self             , "invariant") ;
         assert (_Responsible != Self       , "invariant") ;
-        return ;
+        return 0 ;
     }
 
     DeferredInitialize () ;
@@ -525,7 +580,7 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
         assert (_owner == Self        , "invariant") ;
         assert (_succ != Self         , "invariant") ;
         assert (_Responsible != Self  , "invariant") ;
-        return ;
+        return 0 ;
     }
 
     // The Spin failed -- Enqueue and park the thread ...
@@ -563,7 +618,7 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
             assert (_succ != Self         , "invariant") ;
             assert (_owner == Self        , "invariant") ;
             assert (_Responsible != Self  , "invariant") ;
-            return ;
+            return 0 ;
         }
     }
 
@@ -609,13 +664,20 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
 
     TEVENT (Inflated enter - Contention) ;
     int nWakeups = 0 ;
+    int nParks = 0 ;
     int RecheckInterval = 1 ;
 
     for (;;) {
 
         if (TryLock (Self) > 0) break ;
+        if (TryCancelDeflation (Self) > 0) break ;
         assert (_owner != Self, "invariant") ;
 
+        ++ nParks ;
+        if (ObjectMonitor::_sync_ContendedParks != NULL) {
+           ObjectMonitor::_sync_ContendedParks->inc() ;
+        }
+
         if ((SyncFlags & 2) && _Responsible == NULL) {
            Atomic::cmpxchg_ptr (Self, &_Responsible, NULL) ;
         }
@@ -633,6 +695,7 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
         }
 
         if (TryLock(Self) > 0) break ;
+        if (TryCancelDeflation (Self) > 0) break ;
 
         // The lock is still contested.
         // Keep a tally of the # of futile wakeups.
@@ -737,7 +800,7 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
     if (SyncFlags & 8) {
        OrderAccess::fence() ;
     }
-    return ;
+    return nParks ;
 }
 
 // ReenterI() is a specialized inline form of the latter half of the
@@ -765,6 +828,7 @@ void ATTR ObjectMonitor::ReenterI (Thread * Self, ObjectWaiter * SelfNode) {
 
         if (TryLock (Self) > 0) break ;
         if (TrySpin (Self) > 0) break ;
+        if (TryCancelDeflation (Self) > 0) break ;
 
         TEVENT (Wait Reentry - parking) ;
 
@@ -797,6 +861,7 @@ void ATTR ObjectMonitor::ReenterI (Thread * Self, ObjectWaiter * SelfNode) {
         // successful wakeups.  The following test isn't algorithmically
         // necessary, but it helps us maintain sensible statistics.
         if (TryLock(Self) > 0) break ;
+        if (TryCancelDeflation (Self) > 0) break ;
 
         // The lock is still contested.
         // Keep a tally of the # of futile wakeups.
@@ -984,6 +1049,19 @@ void ATTR ObjectMonitor::exit(bool not_suspended, TRAPS) {
      return ;
    }
 
+   // Tally the hold time of a monitor that was acquired under contention.
+   // The sample is advisory: holds released by the compiled fast paths
+   // are never seen here, and their stamp is discarded on the next
+   // uncontended enter().
+   jlong acquire_time = _acquire_time ;
+   if (acquire_time != 0) {
+     _acquire_time = 0 ;
+     if (ObjectMonitor::_sync_ContendedHoldTicks != NULL) {
+       ObjectMonitor::_sync_ContendedHolds->inc() ;
+       ObjectMonitor::_sync_ContendedHoldTicks->inc(os::elapsed_counter() - acquire_time) ;
+     }
+   }
+
    // Invariant: after setting Responsible=null an thread must execute
    // a MEMBAR or other serializing instruction before fetching EntryList|cxq.
    if ((SyncFlags & 4) == 0) {
@@ -1394,16 +1472,18 @@ intptr_t ObjectMonitor::complete_exit(TRAPS) {
 
 // reenter() enters a lock and sets recursion count
 // complete_exit/reenter operate as a wait without waiting
-void ObjectMonitor::reenter(intptr_t recursions, TRAPS) {
+bool ObjectMonitor::reenter(intptr_t recursions, TRAPS) {
    Thread * const Self = THREAD;
    assert(Self->is_Java_thread(), "Must be Java thread!");
    JavaThread *jt = (JavaThread *)THREAD;
 
    guarantee(_owner != Self, "reenter already owner");
-   enter (THREAD);       // enter the monitor
+   if (!enter (THREAD)) {  // enter the monitor
+     return false;         // deflated concurrently, the caller retries
+   }
    guarantee (_recursions == 0, "reenter recursion");
    _recursions = recursions;
-   return;
+   return true;
 }
 
 
@@ -1644,7 +1724,9 @@ void ObjectMonitor::wait(jlong millis, bool interruptible, TRAPS) {
      assert (_owner != Self, "invariant") ;
      ObjectWaiter::TStates v = node.TState ;
      if (v == ObjectWaiter::TS_RUN) {
-         enter (Self) ;
+         // _waiters is still elevated, so the monitor cannot have been deflated.
+         bool entered = enter (Self) ;
+         guarantee (entered, "invariant") ;
      } else {
          guarantee (v == ObjectWaiter::TS_ENTER || v == ObjectWaiter::TS_CXQ, "invariant") ;
          ReenterI (Self, &node) ;
@@ -2022,6 +2104,18 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
         return 0 ;
     }
 
+    // Spinning is only profitable while the owner is running and can drop
+    // the lock.  Check the owner's run state before any spinning -- even the
+    // short pre-spin -- so that contenders of a descheduled, blocked or
+    // native owner head straight for park().
+    if (Knob_OState && NotRunnable (Self, (Thread *) _owner)) {
+       TEVENT (Spin abort - notrunnable [TOP]);
+       if (ObjectMonitor::_sync_SpinsOwnerNotRunning != NULL) {
+          ObjectMonitor::_sync_SpinsOwnerNotRunning->inc() ;
+       }
+       return 0 ;
+    }
+
     for (ctr = Knob_PreSpin + 1; --ctr >= 0 ; ) {
       if (TryLock(Self) > 0) {
         // Increase _SpinDuration ...
@@ -2032,6 +2126,9 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
            if (x < Knob_Poverty) x = Knob_Poverty ;
            _SpinDuration = x + Knob_BonusB ;
         }
+        if (ObjectMonitor::_sync_SuccessfulSpins != NULL) {
+           ObjectMonitor::_sync_SuccessfulSpins->inc() ;
+        }
         return 1 ;
       }
       SpinPause () ;
@@ -2056,10 +2153,6 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
     if (ctr <= 0) return 0 ;
 
     if (Knob_SuccRestrict && _succ != NULL) return 0 ;
-    if (Knob_OState && NotRunnable (Self, (Thread *) _owner)) {
-       TEVENT (Spin abort - notrunnable [TOP]);
-       return 0 ;
-    }
 
     int MaxSpin = Knob_MaxSpinners ;
     if (MaxSpin >= 0) {
@@ -2170,6 +2263,9 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
                 if (x < Knob_Poverty) x = Knob_Poverty ;
                 _SpinDuration = x + Knob_Bonus ;
             }
+            if (ObjectMonitor::_sync_SuccessfulSpins != NULL) {
+               ObjectMonitor::_sync_SuccessfulSpins->inc() ;
+            }
             return 1 ;
          }
 
@@ -2201,6 +2297,9 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
       // Consider: ctr -= RunnablePenalty ;
       if (Knob_OState && NotRunnable (Self, ox)) {
          TEVENT (Spin abort - notrunnable);
+         if (ObjectMonitor::_sync_SpinsOwnerNotRunning != NULL) {
+            ObjectMonitor::_sync_SpinsOwnerNotRunning->inc() ;
+         }
          goto Abort ;
       }
       if (sss && _succ == NULL ) _succ = Self ;
@@ -2230,7 +2329,15 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
       // in the normal usage of TrySpin(), but it's safest
       // to make TrySpin() as foolproof as possible.
       OrderAccess::fence() ;
-      if (TryLock(Self) > 0) return 1 ;
+      if (TryLock(Self) > 0) {
+         if (ObjectMonitor::_sync_SuccessfulSpins != NULL) {
+            ObjectMonitor::_sync_SuccessfulSpins->inc() ;
+         }
+         return 1 ;
+      }
+   }
+   if (ObjectMonitor::_sync_FailedSpins != NULL) {
+      ObjectMonitor::_sync_FailedSpins->inc() ;
    }
    return 0 ;
 }
@@ -2253,10 +2360,11 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
 // as advisory.
 //
 // Beware too, that _owner is sometimes a BasicLock address and sometimes
-// a thread pointer.  We differentiate the two cases with OwnerIsThread.
-// Alternately, we might tag the type (thread pointer vs basiclock pointer)
-// with the LSB of _owner.  Another option would be to probablistically probe
-// the putative _owner->TypeTag value.
+// a thread pointer.  OwnerIsThread tells the two cases apart only when the
+// runtime installed the owner; the compiled fast paths CAS a Thread* into
+// _owner without setting it.  When OwnerIsThread is clear we therefore
+// probe the putative _owner->_TypeTag value with SafeFetch32() and treat
+// _owner as a thread only if the tag reads 0x2BAD.
 //
 // Checking _thread_state isn't perfect.  Even if the thread is
 // in_java it might be blocked on a page-fault or have been preempted
@@ -2275,11 +2383,17 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
 
 
 int ObjectMonitor::NotRunnable (Thread * Self, Thread * ox) {
-    // Check either OwnerIsThread or ox->TypeTag == 2BAD.
-    if (!OwnerIsThread) return 0 ;
-
     if (ox == NULL) return 0 ;
 
+    // The deflater never hands the monitor to a spinner.
+    if (ox == (Thread *) DEFLATER_MARKER) return 1 ;
+
+    // The owner of an inflated fast lock is not known yet.
+    if (ox == (Thread *) ANONYMOUS_OWNER) return 0 ;
+
+    // Check either OwnerIsThread or ox->TypeTag == 2BAD.
+    if (!OwnerIsThread && SafeFetch32 ((int *) &ox->_TypeTag, 0) != 0x2BAD) return 0 ;
+
     // Avoid transitive spinning ...
     // Say T1 spins or blocks trying to acquire L.  T1._Stalled is set to L.
     // Immediately after T1 acquires L it's possible that T2, also
@@ -2394,6 +2508,10 @@ PerfCounter * ObjectMonitor::_sync_SlowNotify                  = NULL ;
 PerfCounter * ObjectMonitor::_sync_SlowNotifyAll               = NULL ;
 PerfCounter * ObjectMonitor::_sync_FailedSpins                 = NULL ;
 PerfCounter * ObjectMonitor::_sync_SuccessfulSpins             = NULL ;
+PerfCounter * ObjectMonitor::_sync_SpinsOwnerNotRunning        = NULL ;
+PerfCounter * ObjectMonitor::_sync_ContendedParks              = NULL ;
+PerfCounter * ObjectMonitor::_sync_ContendedHolds              = NULL ;
+PerfCounter * ObjectMonitor::_sync_ContendedHoldTicks          = NULL ;
 PerfCounter * ObjectMonitor::_sync_MonInCirculation            = NULL ;
 PerfCounter * ObjectMonitor::_sync_MonScavenged                = NULL ;
 PerfCounter * ObjectMonitor::_sync_Inflations                  = NULL ;
@@ -2426,6 +2544,11 @@ void ObjectMonitor::Initialize () {
       NEWPERFCOUNTER(_sync_SlowNotifyAll) ;
       NEWPERFCOUNTER(_sync_FailedSpins) ;
       NEWPERFCOUNTER(_sync_SuccessfulSpins) ;
+      NEWPERFCOUNTER(_sync_SpinsOwnerNotRunning) ;
+      NEWPERFCOUNTER(_sync_ContendedParks) ;
+      NEWPERFCOUNTER(_sync_ContendedHolds) ;
+      _sync_ContendedHoldTicks = PerfDataManager::create_counter(SUN_RT, "_sync_ContendedHoldTicks",
+                                                                 PerfData::U_Ticks, CHECK);
       NEWPERFCOUNTER(_sync_PrivateA) ;
       NEWPERFCOUNTER(_sync_PrivateB) ;
       NEWPERFCOUNTER(_sync_MonInCirculation) ;
@@ -2446,6 +2569,10 @@ void ObjectMonitor::Initialize () {
 
 void ObjectMonitor::ctAsserts() {
   CTASSERT(offset_of (ObjectMonitor, _header) == 0);
+  // The owner and queue fields each start on a cache line of their own.
+  STATIC_ASSERT(sizeof(PaddedEnd<ObjectMonitorHeaderFields>) % DEFAULT_CACHE_LINE_SIZE == 0);
+  STATIC_ASSERT(sizeof(PaddedEnd<ObjectMonitorOwnerFields>) % DEFAULT_CACHE_LINE_SIZE == 0);
+  STATIC_ASSERT(sizeof(ObjectMonitor) % DEFAULT_CACHE_LINE_SIZE == 0);
 }
 
 
@@ -2546,6 +2673,7 @@ void ObjectMonitor::DeferredInitialize () {
 
   if (Knob_LogSpins == 0) {
      ObjectMonitor::_sync_FailedSpins = NULL ;
+     ObjectMonitor::_sync_SuccessfulSpins = NULL ;
   }
 
   free (knobs) ;
@@ -2572,6 +2700,7 @@ void ObjectMonitor::sanity_checks() {
   u_char *addr_begin  = (u_char*)&dummy;
   u_char *addr_header = (u_char*)&dummy._header;
   u_char *addr_owner  = (u_char*)&dummy._owner;
+  u_char *addr_cxq    = (u_char*)&dummy._cxq;
 
   uint offset_header = (uint)(addr_header - addr_begin);
   if (verbose) tty->print_cr("INFO: offset(_header)=%u", offset_header);
@@ -2579,11 +2708,22 @@ void ObjectMonitor::sanity_checks() {
   uint offset_owner = (uint)(addr_owner - addr_begin);
   if (verbose) tty->print_cr("INFO: offset(_owner)=%u", offset_owner);
 
+  uint offset_cxq = (uint)(addr_cxq - addr_begin);
+  if (verbose) tty->print_cr("INFO: offset(_cxq)=%u", offset_cxq);
+
   if ((uint)(addr_header - addr_begin) != 0) {
     tty->print_cr("ERROR: offset(_header) must be zero (0).");
     error_cnt++;
   }
 
+  // The compiler may place a field in the tail padding of the group
+  // before it, which the sizes checked in ctAsserts() do not catch.
+  if ((offset_owner % DEFAULT_CACHE_LINE_SIZE) != 0 ||
+      (offset_cxq % DEFAULT_CACHE_LINE_SIZE) != 0) {
+    tty->print_cr("ERROR: _owner and _cxq must start a cache line.");
+    error_cnt++;
+  }
+
   if (cache_line_size != 0) {
     // We were able to determine the L1 data cache line size so
     // do some cache line specific sanity checks
@@ -2594,6 +2734,12 @@ void ObjectMonitor::sanity_checks() {
       warning_cnt++;
     }
 
+    if ((offset_cxq - offset_owner) < cache_line_size) {
+      tty->print_cr("WARNING: the _owner and _cxq fields are closer "
+                    "than a cache line which permits false sharing.");
+      warning_cnt++;
+    }
+
     if ((sizeof(ObjectMonitor) % cache_line_size) != 0) {
       tty->print_cr("WARNING: ObjectMonitor size is not a multiple of "
                     "a cache line which permits false sharing.");
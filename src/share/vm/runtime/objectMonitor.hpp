@@ -25,6 +25,7 @@
 #ifndef SHARE_VM_RUNTIME_OBJECTMONITOR_HPP
 #define SHARE_VM_RUNTIME_OBJECTMONITOR_HPP
 
+#include "memory/padded.hpp"
 #include "runtime/os.hpp"
 #include "runtime/park.hpp"
 #include "runtime/perfData.hpp"
@@ -73,8 +74,84 @@ class EventJavaMonitorWait;
 
 // It is also used as RawMonitor by the JVMTI
 
+// Owner value installed by the concurrent monitor deflater while it
+// deflates an idle monitor.  See ObjectSynchronizer::deflate_monitor_using_marker().
+#define DEFLATER_MARKER reinterpret_cast<void*>(-1)
 
-class ObjectMonitor {
+// Owner value of a monitor inflated by another thread than the owner of a
+// fast-locked object (see lockStack.hpp).  The owner, which finds the
+// object on its lock stack, replaces it with itself before using the monitor.
+#define ANONYMOUS_OWNER reinterpret_cast<void*>(1)
+
+class ObjectMonitor;
+
+// The fields of ObjectMonitor are grouped by the threads that write them
+// and each group is padded out to its own cache line: the owner hands the
+// monitor off by storing _owner and _recursions, while contending threads
+// push onto _cxq, spin on _owner and update the spin statistics.  Keeping
+// the two groups apart avoids false sharing between the owner's exit and
+// the arrival of new contenders.  Each group is a base class of the next
+// one, so that PaddedEnd computes the padding from the size of the group.
+// The padding assumes the monitor is cache line aligned; see omAlloc().
+
+class ObjectMonitorHeaderFields {
+ protected:
+  // WARNING: this must be the very first word of ObjectMonitor
+  // This means this class can't use any virtual member functions.
+
+  volatile markOop   _header;       // displaced object header word - mark
+  void*     volatile _object;       // backward object pointer - strong root
+};
+
+// All the following fields must be machine word aligned
+// The VM assumes write ordering wrt these fields, which can be
+// read from other threads.
+
+class ObjectMonitorOwnerFields : public PaddedEnd<ObjectMonitorHeaderFields> {
+ protected:
+  void *  volatile _owner;          // pointer to owning thread OR BasicLock
+  volatile intptr_t  _recursions;   // recursion count, 0 for first entry
+  volatile jlong _previous_owner_tid; // thread id of the previous owner of the monitor
+  jlong _acquire_time ;             // os::elapsed_counter() at contended acquisition, 0 if none
+  int OwnerIsThread ;               // _owner is (Thread *) vs SP/BasicLock
+};
+
+class ObjectMonitorQueueFields : public PaddedEnd<ObjectMonitorOwnerFields> {
+ protected:
+  ObjectWaiter * volatile _cxq ;    // LL of recently-arrived threads blocked on entry.
+                                    // The list is actually composed of WaitNodes, acting
+                                    // as proxies for Threads.
+  ObjectWaiter * volatile _EntryList ;     // Threads blocked on entry or reentry.
+  Thread * volatile _succ ;          // Heir presumptive thread - used for futile wakeup throttling
+  Thread * volatile _Responsible ;
+  volatile intptr_t _SpinState ;    // MCS/CLH list of spinners
+
+  // TODO-FIXME: _count, _waiters and _recursions should be of
+  // type int, or int32_t but not intptr_t.  There's no reason
+  // to use 64-bit fields for these variables on a 64-bit JVM.
+
+  volatile intptr_t  _count;        // reference count to prevent reclaimation/deflation
+                                    // at stop-the-world time.  See deflate_idle_monitors().
+                                    // _count is approximately |_WaitSet| + |_EntryList|
+                                    // Negative once the monitor has been deflated concurrently.
+  volatile intptr_t  _waiters;      // number of waiting threads
+  ObjectWaiter * volatile _WaitSet; // LL of threads wait()ing on the monitor
+
+ public:
+  ObjectMonitor * FreeNext ;        // Free list linkage
+  intptr_t StatA, StatsB ;
+  int _QMix ;                       // Mixed prepend queue discipline
+
+ protected:
+  int _PromptDrain ;                // rqst to drain cxq into EntryList ASAP
+  volatile int _Spinner ;           // for exit->spinner handoff optimization
+  volatile int _SpinFreq ;          // Spin 1-out-of-N attempts: success rate
+  volatile int _SpinClock ;
+  volatile int _SpinDuration ;
+  volatile int _WaitSetLock;        // protects Wait Queue - simple spinlock
+};
+
+class ObjectMonitor : public PaddedEnd<ObjectMonitorQueueFields> {
  public:
   enum {
     OM_OK,                    // no error
@@ -123,6 +200,16 @@ class ObjectMonitor {
   void*     owner() const;
   void      set_owner(void* owner);
 
+  // With UseLightweightLocking, true if the owner of the object still has
+  // it on its lock stack and has not taken over the monitor yet.
+  bool      is_owner_anonymous() const                                 { return _owner == ANONYMOUS_OWNER; }
+  void      set_owner_from_anonymous(Thread* owner, intptr_t recursions);
+
+  // True if the monitor has been deflated concurrently and no longer
+  // belongs to its object.  It is recycled at the next safepoint.
+  bool      is_being_async_deflated() const                            { return _count < 0; }
+  void      install_displaced_markword_in_object();
+
   intptr_t  waiters() const;
 
   intptr_t  count() const;
@@ -155,6 +242,7 @@ class ObjectMonitor {
     _SpinClock    = 0 ;
     OwnerIsThread = 0 ;
     _previous_owner_tid = 0;
+    _acquire_time = 0 ;
   }
 
   ~ObjectMonitor() {
@@ -178,6 +266,7 @@ private:
     _SpinFreq      = 0 ;
     _SpinClock     = 0 ;
     OwnerIsThread  = 0 ;
+    _acquire_time  = 0 ;
   }
 
 public:
@@ -197,7 +286,9 @@ public:
 #endif
 
   bool      try_enter (TRAPS) ;
-  void      enter(TRAPS);
+  // Returns false if the monitor was deflated concurrently; the caller
+  // must inflate the object again and retry.
+  bool      enter(TRAPS);
   void      exit(bool not_suspended, TRAPS);
   void      wait(jlong millis, bool interruptable, TRAPS);
   void      notify(TRAPS);
@@ -205,7 +296,7 @@ public:
 
 // Use the following at your own risk
   intptr_t  complete_exit(TRAPS);
-  void      reenter(intptr_t recursions, TRAPS);
+  bool      reenter(intptr_t recursions, TRAPS);
 
  private:
   void      AddWaiter (ObjectWaiter * waiter) ;
@@ -213,10 +304,12 @@ public:
 
   ObjectWaiter * DequeueWaiter () ;
   void      DequeueSpecificWaiter (ObjectWaiter * waiter) ;
-  void      EnterI (TRAPS) ;
+  int       EnterI (TRAPS) ;
+  void      StampContendedAcquire () ;
   void      ReenterI (Thread * Self, ObjectWaiter * SelfNode) ;
   void      UnlinkAfterAcquire (Thread * Self, ObjectWaiter * SelfNode) ;
   int       TryLock (Thread * Self) ;
+  int       TryCancelDeflation (Thread * Self) ;
   int       NotRunnable (Thread * Self, Thread * Owner) ;
   int       TrySpin_Fixed (Thread * Self) ;
   int       TrySpin_VaryFrequency (Thread * Self) ;
@@ -234,59 +327,6 @@ public:
   friend class ObjectWaiter;
   friend class VMStructs;
 
-  // WARNING: this must be the very first word of ObjectMonitor
-  // This means this class can't use any virtual member functions.
-
-  volatile markOop   _header;       // displaced object header word - mark
-  void*     volatile _object;       // backward object pointer - strong root
-
-  double SharingPad [1] ;           // temp to reduce false sharing
-
-  // All the following fields must be machine word aligned
-  // The VM assumes write ordering wrt these fields, which can be
-  // read from other threads.
-
- protected:                         // protected for jvmtiRawMonitor
-  void *  volatile _owner;          // pointer to owning thread OR BasicLock
-  volatile jlong _previous_owner_tid; // thread id of the previous owner of the monitor
-  volatile intptr_t  _recursions;   // recursion count, 0 for first entry
- private:
-  int OwnerIsThread ;               // _owner is (Thread *) vs SP/BasicLock
-  ObjectWaiter * volatile _cxq ;    // LL of recently-arrived threads blocked on entry.
-                                    // The list is actually composed of WaitNodes, acting
-                                    // as proxies for Threads.
- protected:
-  ObjectWaiter * volatile _EntryList ;     // Threads blocked on entry or reentry.
- private:
-  Thread * volatile _succ ;          // Heir presumptive thread - used for futile wakeup throttling
-  Thread * volatile _Responsible ;
-  int _PromptDrain ;                // rqst to drain cxq into EntryList ASAP
-
-  volatile int _Spinner ;           // for exit->spinner handoff optimization
-  volatile int _SpinFreq ;          // Spin 1-out-of-N attempts: success rate
-  volatile int _SpinClock ;
-  volatile int _SpinDuration ;
-  volatile intptr_t _SpinState ;    // MCS/CLH list of spinners
-
-  // TODO-FIXME: _count, _waiters and _recursions should be of
-  // type int, or int32_t but not intptr_t.  There's no reason
-  // to use 64-bit fields for these variables on a 64-bit JVM.
-
-  volatile intptr_t  _count;        // reference count to prevent reclaimation/deflation
-                                    // at stop-the-world time.  See deflate_idle_monitors().
-                                    // _count is approximately |_WaitSet| + |_EntryList|
- protected:
-  volatile intptr_t  _waiters;      // number of waiting threads
- private:
- protected:
-  ObjectWaiter * volatile _WaitSet; // LL of threads wait()ing on the monitor
- private:
-  volatile int _WaitSetLock;        // protects Wait Queue - simple spinlock
-
- public:
-  int _QMix ;                       // Mixed prepend queue discipline
-  ObjectMonitor * FreeNext ;        // Free list linkage
-  intptr_t StatA, StatsB ;
 
  public:
   static void Initialize () ;
@@ -301,6 +341,10 @@ public:
   static PerfCounter * _sync_SlowNotifyAll ;
   static PerfCounter * _sync_FailedSpins ;
   static PerfCounter * _sync_SuccessfulSpins ;
+  static PerfCounter * _sync_SpinsOwnerNotRunning ;
+  static PerfCounter * _sync_ContendedParks ;
+  static PerfCounter * _sync_ContendedHolds ;
+  static PerfCounter * _sync_ContendedHoldTicks ;
   static PerfCounter * _sync_PrivateA ;
   static PerfCounter * _sync_PrivateB ;
   static PerfCounter * _sync_MonInCirculation ;
@@ -53,7 +53,8 @@ inline intptr_t ObjectMonitor::waiters() const {
 }
 
 inline void* ObjectMonitor::owner() const {
-  return _owner;
+  void* owner = _owner;
+  return owner != DEFLATER_MARKER ? owner : NULL;
 }
 
 inline void ObjectMonitor::clear() {
@@ -109,5 +110,14 @@ inline void ObjectMonitor::set_owner(void* owner) {
   _recursions = 0;
 }
 
+// Only the thread that has the object on its lock stack takes over an
+// anonymously owned monitor, so a plain store suffices.
+inline void ObjectMonitor::set_owner_from_anonymous(Thread* owner, intptr_t recursions) {
+  assert(_owner == ANONYMOUS_OWNER, "invariant");
+  _recursions = recursions;
+  _owner = owner;
+  OwnerIsThread = 1;
+}
+
 
 #endif // SHARE_VM_RUNTIME_OBJECTMONITOR_INLINE_HPP
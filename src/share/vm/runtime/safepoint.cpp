@@ -44,6 +44,7 @@
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/osThread.hpp"
 #include "runtime/safepoint.hpp"
+#include "runtime/safepointProfiler.hpp"
 #include "runtime/signature.hpp"
 #include "runtime/stubCodeGenerator.hpp"
 #include "runtime/stubRoutines.hpp"
@@ -53,6 +54,7 @@
 #include "services/runtimeService.hpp"
 #include "utilities/events.hpp"
 #include "utilities/macros.hpp"
+#include "utilities/workgroup.hpp"
 #ifdef TARGET_ARCH_x86
 # include "nativeInst_x86.hpp"
 # include "vmreg_x86.inline.hpp"
@@ -145,13 +147,10 @@ void SafepointSynchronize::begin() {
   jlong safepoint_limit_time = 0;
   timeout_error_printed = false;
 
-  // PrintSafepointStatisticsTimeout can be specified separately. When
-  // specified, PrintSafepointStatistics will be set to true in
-  // deferred_initialize_stat method. The initialization has to be done
-  // early enough to avoid any races. See bug 6880029 for details.
-  if (PrintSafepointStatistics || PrintSafepointStatisticsTimeout > 0) {
-    deferred_initialize_stat();
-  }
+  // The statistics are allocated by safepoint_init() so that no memory
+  // is allocated while threads are brought to a safepoint.
+  assert(!(PrintSafepointStatistics || PrintSafepointStatisticsTimeout > 0) || _safepoint_stats != NULL,
+         "safepoint statistics must have been initialized");
 
   // Begin the process of bringing the system to a safepoint.
   // Java threads can be in several different states and are
@@ -189,6 +188,10 @@ void SafepointSynchronize::begin() {
   //     between states, the safepointing code will wait for the thread to
   //     block itself when it attempts transitions to a new state.
   //
+  if (TimeToSafepointProfiler::is_enabled()) {
+    TimeToSafepointProfiler::begin_synchronization(_safepoint_counter, nof_threads);
+  }
+
   _state            = _synchronizing;
   OrderAccess::fence();
 
@@ -353,6 +356,10 @@ void SafepointSynchronize::begin() {
   }
   assert(_waiting_to_block == 0, "sanity check");
 
+  if (TimeToSafepointProfiler::is_enabled()) {
+    TimeToSafepointProfiler::end_synchronization();
+  }
+
 #ifndef PRODUCT
   if (SafepointTimeout) {
     jlong current_time = os::javaTimeNanos();
@@ -499,40 +506,129 @@ void SafepointSynchronize::end() {
 bool SafepointSynchronize::is_cleanup_needed() {
   // Need a safepoint if some inline cache buffers is non-empty
   if (!InlineCacheBuffer::is_empty()) return true;
+  // Need a safepoint to recycle the monitors deflated by the ServiceThread
+  if (ObjectSynchronizer::is_cleanup_needed()) return true;
   return false;
 }
 
 
 
-// Various cleaning tasks that should be done periodically at safepoints
-void SafepointSynchronize::do_cleanup_tasks() {
-  {
-    TraceTime t1("deflating idle monitors", TraceSafepointCleanupTime);
-    ObjectSynchronizer::deflate_idle_monitors();
+// Times a cleanup task for TraceSafepointCleanupTime and records its
+// duration for PrintSafepointStatistics.
+class SafepointCleanupTaskTimer : public StackObj {
+ private:
+  TraceTime                                   _tt;
+  SafepointSynchronize::SafepointCleanupTasks _task;
+  jlong                                       _start;
+
+ public:
+  SafepointCleanupTaskTimer(const char* title,
+                            SafepointSynchronize::SafepointCleanupTasks task) :
+    _tt(title, TraceSafepointCleanupTime), _task(task) {
+    _start = PrintSafepointStatistics ? os::javaTimeNanos() : 0;
+  }
+  ~SafepointCleanupTaskTimer() {
+    if (PrintSafepointStatistics) {
+      SafepointSynchronize::update_statistics_on_cleanup_task(_task,
+                                                              os::javaTimeNanos() - _start);
+    }
   }
+};
 
-  {
-    TraceTime t2("updating inline caches", TraceSafepointCleanupTime);
-    InlineCacheBuffer::update_inline_caches();
+// The cleanup tasks are claimed one at a time by the threads of the
+// heap's work gang, or all performed by the VM thread if there is none.
+class ParallelSPCleanupTask : public AbstractGangTask {
+ private:
+  SubTasksDone _subtasks;
+
+  bool claim(SafepointSynchronize::SafepointCleanupTasks task) {
+    return !_subtasks.is_task_claimed(task);
   }
-  {
-    TraceTime t3("compilation policy safepoint handler", TraceSafepointCleanupTime);
-    CompilationPolicy::policy()->do_safepoint_work();
+
+ public:
+  ParallelSPCleanupTask(uint num_workers) :
+    AbstractGangTask("Parallel Safepoint Cleanup"),
+    _subtasks(SafepointSynchronize::SAFEPOINT_CLEANUP_NUM_TASKS) {
+    _subtasks.set_n_threads(num_workers);
   }
 
-  {
-    TraceTime t4("mark nmethods", TraceSafepointCleanupTime);
-    NMethodSweeper::mark_active_nmethods();
+  void work(uint worker_id) {
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_DEFLATE_MONITORS)) {
+      SafepointCleanupTaskTimer t1("deflating idle monitors",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_DEFLATE_MONITORS);
+      ObjectSynchronizer::deflate_idle_monitors();
+    }
+
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_UPDATE_INLINE_CACHES)) {
+      SafepointCleanupTaskTimer t2("updating inline caches",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_UPDATE_INLINE_CACHES);
+      InlineCacheBuffer::update_inline_caches();
+    }
+
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_COMPILATION_POLICY)) {
+      SafepointCleanupTaskTimer t3("compilation policy safepoint handler",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_COMPILATION_POLICY);
+      CompilationPolicy::policy()->do_safepoint_work();
+    }
+
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_MARK_NMETHODS)) {
+      SafepointCleanupTaskTimer t4("mark nmethods",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_MARK_NMETHODS);
+      NMethodSweeper::mark_active_nmethods();
+    }
+
+    // Lock-free readers cannot be in the tables at a safepoint, so what the
+    // service thread unlinked or replaced since the last one can be freed.
+    // This is done by the same thread that may rehash the table afterwards.
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_SYMBOL_TABLE)) {
+      SafepointCleanupTaskTimer t5("freeing and rehashing symbol table",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_SYMBOL_TABLE);
+      SymbolTable::free_deferred();
+      if (SymbolTable::needs_rehashing()) {
+        SymbolTable::rehash_table();
+      }
+    }
+
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_STRING_TABLE)) {
+      SafepointCleanupTaskTimer t6("freeing and rehashing string table",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_STRING_TABLE);
+      StringTable::free_deferred();
+      if (StringTable::needs_rehashing()) {
+        StringTable::rehash_table();
+      }
+    }
+
+    if (claim(SafepointSynchronize::SAFEPOINT_CLEANUP_CLD_PURGE)) {
+      // CMS delays purging the CLDG until the beginning of the next safepoint and to
+      // make sure concurrent sweep is done
+      SafepointCleanupTaskTimer t7("purging class loader data graph",
+                                   SafepointSynchronize::SAFEPOINT_CLEANUP_CLD_PURGE);
+      ClassLoaderDataGraph::purge_if_needed();
+    }
+
+    _subtasks.all_tasks_completed();
+  }
+};
+
+// Various cleaning tasks that should be done periodically at safepoints
+void SafepointSynchronize::do_cleanup_tasks() {
+  FlexibleWorkGang* workers = Universe::heap()->get_safepoint_workers();
+  uint num_workers = 1;
+  if (ParallelSafepointCleanup && workers != NULL && workers->active_workers() > 1) {
+    num_workers = workers->active_workers();
   }
 
-  if (SymbolTable::needs_rehashing()) {
-    TraceTime t5("rehashing symbol table", TraceSafepointCleanupTime);
-    SymbolTable::rehash_table();
+  if (PrintSafepointStatistics) {
+    _safepoint_stats[_cur_stat_index]._nof_cleanup_workers = num_workers;
   }
 
-  if (StringTable::needs_rehashing()) {
-    TraceTime t6("rehashing string table", TraceSafepointCleanupTime);
-    StringTable::rehash_table();
+  ParallelSPCleanupTask cleanup(num_workers);
+  if (num_workers > 1) {
+    // The work gang only runs tasks for the VM thread while it is at a
+    // safepoint, so its threads are idle here.
+    workers->run_task(&cleanup);
+  } else {
+    cleanup.work(0);
   }
 
   // rotate log files?
@@ -540,13 +636,6 @@ void SafepointSynchronize::do_cleanup_tasks() {
     TraceTime t8("rotating gc logs", TraceSafepointCleanupTime);
     gclog_or_tty->rotate_log(false);
   }
-
-  {
-    // CMS delays purging the CLDG until the beginning of the next safepoint and to
-    // make sure concurrent sweep is done
-    TraceTime t7("purging class loader data graph", TraceSafepointCleanupTime);
-    ClassLoaderDataGraph::purge_if_needed();
-  }
 }
 
 
@@ -629,7 +718,13 @@ void SafepointSynchronize::block(JavaThread *thread) {
   // Check that we have a valid thread_state at this point
   switch(state) {
     case _thread_in_vm_trans:
-    case _thread_in_Java:        // From compiled code
+    case _thread_in_Java: {      // From compiled code
+      // Take the arrival time before contending for the Safepoint_lock,
+      // which the VM thread holds while it spins.
+      jlong arrival_time = 0;
+      if (TimeToSafepointProfiler::is_enabled() && is_synchronizing()) {
+        arrival_time = os::javaTimeNanos();
+      }
 
       // We are highly likely to block on the Safepoint_lock. In order to avoid blocking in this case,
       // we pretend we are still in the VM.
@@ -648,6 +743,9 @@ void SafepointSynchronize::block(JavaThread *thread) {
         assert(_waiting_to_block > 0, "sanity check");
         _waiting_to_block--;
         thread->safepoint_state()->set_has_called_back(true);
+        if (arrival_time != 0) {
+          TimeToSafepointProfiler::record_arrival(thread, state, arrival_time, true);
+        }
 
         DEBUG_ONLY(thread->set_visited_for_critical_count(true));
         if (thread->in_critical()) {
@@ -678,6 +776,7 @@ void SafepointSynchronize::block(JavaThread *thread) {
       thread->set_thread_state(state);
       Threads_lock->unlock();
       break;
+    }
 
     case _thread_in_native_trans:
     case _thread_blocked_trans:
@@ -890,6 +989,9 @@ void ThreadSafepointState::roll_forward(suspend_type type) {
   switch(_type) {
     case _at_safepoint:
       SafepointSynchronize::signal_thread_at_safepoint();
+      if (TimeToSafepointProfiler::is_enabled()) {
+        TimeToSafepointProfiler::record_arrival(_thread, _orig_thread_state, os::javaTimeNanos(), false);
+      }
       DEBUG_ONLY(_thread->set_visited_for_critical_count(true));
       if (_thread->in_critical()) {
         // Notice that this thread is in a critical section
@@ -1063,6 +1165,7 @@ static void print_header() {
   tty->print("         vmop                    "
              "[threads: total initially_running wait_to_block]    ");
   tty->print("[time: spin block sync cleanup vmop] ");
+  tty->print("[cleanup us: monitors  ics  policy  nmethods  symbols  strings  cld  workers] ");
 
   // no page armed status printed out if it is always armed.
   if (need_to_track_page_armed_status) {
@@ -1072,6 +1175,17 @@ static void print_header() {
   tty->print_cr("page_trap_count");
 }
 
+void safepoint_init() {
+  // PrintSafepointStatisticsTimeout can be specified separately. When
+  // specified, PrintSafepointStatistics will be set to true in
+  // deferred_initialize_stat method. The initialization has to be done
+  // early enough to avoid any races. See bug 6880029 for details.
+  if (PrintSafepointStatistics || PrintSafepointStatisticsTimeout > 0) {
+    SafepointSynchronize::deferred_initialize_stat();
+  }
+  TimeToSafepointProfiler::initialize();
+}
+
 void SafepointSynchronize::deferred_initialize_stat() {
   if (init_done) return;
 
@@ -1166,6 +1280,14 @@ void SafepointSynchronize::update_statistics_on_sync_end(jlong end_time) {
   }
 
   spstat->_time_to_do_cleanups = end_time;
+  for (int i = 0; i < SAFEPOINT_CLEANUP_NUM_TASKS; i++) {
+    spstat->_time_of_cleanup_task[i] = 0;
+  }
+}
+
+void SafepointSynchronize::update_statistics_on_cleanup_task(SafepointCleanupTasks task, jlong time) {
+  // Each task is claimed by a single thread, so no synchronization is needed.
+  _safepoint_stats[_cur_stat_index]._time_of_cleanup_task[task] = time;
 }
 
 void SafepointSynchronize::update_statistics_on_cleanup_end(jlong end_time) {
@@ -1232,6 +1354,20 @@ void SafepointSynchronize::print_statistics() {
                sstats->_time_to_do_cleanups / MICROUNITS,
                sstats->_time_to_exec_vmop / MICROUNITS);
 
+    // "/ MILLIUNITS" is to convert the unit from nanos to micros.
+    const jlong* task_time = sstats->_time_of_cleanup_task;
+    tty->print("[" INT64_FORMAT_W(9) INT64_FORMAT_W(5) INT64_FORMAT_W(8)
+               INT64_FORMAT_W(10) INT64_FORMAT_W(9) INT64_FORMAT_W(9)
+               INT64_FORMAT_W(5) INT32_FORMAT_W(9) "]  ",
+               task_time[SAFEPOINT_CLEANUP_DEFLATE_MONITORS] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_UPDATE_INLINE_CACHES] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_COMPILATION_POLICY] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_MARK_NMETHODS] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_SYMBOL_TABLE] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_STRING_TABLE] / MILLIUNITS,
+               task_time[SAFEPOINT_CLEANUP_CLD_PURGE] / MILLIUNITS,
+               sstats->_nof_cleanup_workers);
+
     if (need_to_track_page_armed_status) {
       tty->print(INT32_FORMAT "         ", sstats->_page_armed);
     }
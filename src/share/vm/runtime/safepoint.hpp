@@ -56,6 +56,7 @@ class nmethod;
 // Implements roll-forward to safepoint (safepoint synchronization)
 //
 class SafepointSynchronize : AllStatic {
+  friend class SafepointCleanupTaskTimer;
  public:
   enum SynchronizeState {
       _not_synchronized = 0,                   // Threads not synchronized at a safepoint
@@ -75,6 +76,20 @@ class SafepointSynchronize : AllStatic {
     _blocking_timeout = 1
   };
 
+  // The tasks of do_cleanup_tasks(). They are independent of each other
+  // and may be claimed by different GC worker threads.
+  enum SafepointCleanupTasks {
+    SAFEPOINT_CLEANUP_DEFLATE_MONITORS,
+    SAFEPOINT_CLEANUP_UPDATE_INLINE_CACHES,
+    SAFEPOINT_CLEANUP_COMPILATION_POLICY,
+    SAFEPOINT_CLEANUP_MARK_NMETHODS,
+    SAFEPOINT_CLEANUP_SYMBOL_TABLE,
+    SAFEPOINT_CLEANUP_STRING_TABLE,
+    SAFEPOINT_CLEANUP_CLD_PURGE,
+    // Leave this one last.
+    SAFEPOINT_CLEANUP_NUM_TASKS
+  };
+
   typedef struct {
     float  _time_stamp;                        // record when the current safepoint occurs in seconds
     int    _vmop_type;                         // type of VM operation triggers the safepoint
@@ -86,6 +101,8 @@ class SafepointSynchronize : AllStatic {
     jlong  _time_to_spin;                      // total time in millis spent in spinning
     jlong  _time_to_wait_to_block;             // total time in millis spent in waiting for to block
     jlong  _time_to_do_cleanups;               // total time in millis spent in performing cleanups
+    jlong  _time_of_cleanup_task[SAFEPOINT_CLEANUP_NUM_TASKS]; // time in nanos spent in each cleanup task
+    int    _nof_cleanup_workers;               // number of threads that performed the cleanups
     jlong  _time_to_sync;                      // total time in millis spent in getting to _synchronized
     jlong  _time_to_exec_vmop;                 // total time in millis spent in vm operation itself
   } SafepointStats;
@@ -120,6 +137,7 @@ private:
   static void update_statistics_on_spin_end();
   static void update_statistics_on_sync_end(jlong end_time);
   static void update_statistics_on_cleanup_end(jlong end_time);
+  static void update_statistics_on_cleanup_task(SafepointCleanupTasks task, jlong time);
   static void end_statistics(jlong end_time);
   static void print_statistics();
   inline static void inc_page_trap_count() {
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.hpp"
+#include "code/codeCache.hpp"
+#include "code/nmethod.hpp"
+#include "code/scopeDesc.hpp"
+#include "oops/method.hpp"
+#include "runtime/frame.inline.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepointProfiler.hpp"
+#include "runtime/sharedRuntime.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/vmThread.hpp"
+#include "runtime/vm_operations.hpp"
+
+TTSPRecord*   TimeToSafepointProfiler::_records = NULL;
+uint          TimeToSafepointProfiler::_size    = 0;
+volatile jint TimeToSafepointProfiler::_total   = 0;
+TTSPRecord*   TimeToSafepointProfiler::_current = NULL;
+
+static const char* ttsp_thread_state_name(int state) {
+  switch (state) {
+    case _thread_new:             return "new";
+    case _thread_new_trans:       return "new_trans";
+    case _thread_in_native:       return "in_native";
+    case _thread_in_native_trans: return "in_native_trans";
+    case _thread_in_vm:           return "in_vm";
+    case _thread_in_vm_trans:     return "in_vm_trans";
+    case _thread_in_Java:         return "in_Java";
+    case _thread_in_Java_trans:   return "in_Java_trans";
+    case _thread_blocked:         return "blocked";
+    case _thread_blocked_trans:   return "blocked_trans";
+    default:                      return "unknown";
+  }
+}
+
+// -----------------------------------------------------------------------------
+// TTSPArrival
+
+// Finds the Java frame the thread stopped in.  The thread is either the
+// current thread or a thread that the VM thread found in a safe state,
+// so its last Java frame is stable.  Nothing here allocates memory.
+void TTSPArrival::capture_frame(JavaThread* thread) {
+  _frame_kind = no_frame;
+  _method     = NULL;
+  _bci        = -1;
+  _compile_id = 0;
+  _comp_level = 0;
+  _compiler  = "";
+
+  if (!thread->has_last_Java_frame() || !thread->frame_anchor()->walkable()) {
+    return;
+  }
+
+  frame fr = thread->last_frame();
+  address pc = fr.pc();
+  if (fr.is_safepoint_blob_frame()) {
+    // Stopped at a safepoint poll in compiled code.
+    pc = thread->saved_exception_pc();
+  } else if (fr.is_runtime_frame()) {
+    RegisterMap map(thread, false);
+    fr = fr.sender(&map);
+    pc = fr.pc();
+  }
+
+  if (fr.is_interpreted_frame()) {
+    _frame_kind = fr.interpreter_frame_method()->is_native() ? native_frame : interpreted_frame;
+    _method     = fr.interpreter_frame_method();
+    _bci        = fr.interpreter_frame_bci();
+    return;
+  }
+
+  CodeBlob* cb = CodeCache::find_blob_unsafe(pc);
+  if (cb == NULL || !cb->is_nmethod()) {
+    return;
+  }
+  nmethod* nm = (nmethod*) cb;
+  _method     = nm->method();
+  _compile_id = nm->compile_id();
+  _comp_level = nm->comp_level();
+  if (nm->is_compiled_by_jvmci()) {
+    _compiler = "JVMCI";
+  } else if (nm->is_compiled_by_c2()) {
+    _compiler = "C2";
+  } else if (nm->is_compiled_by_c1()) {
+    _compiler = "C1";
+  }
+  if (nm->is_native_method()) {
+    _frame_kind = native_frame;
+    return;
+  }
+  _frame_kind = compiled_frame;
+  if (nm->pc_desc_at(pc) != NULL) {
+    // Report the innermost inlined method.
+    SimpleScopeDesc sd(nm, pc);
+    _method = sd.method();
+    _bci    = sd.bci();
+  }
+}
+
+// Copies the names into the record.  Called by the VM thread once all
+// threads have arrived and while it still holds the Threads_lock, so
+// neither the threads nor the methods can go away.
+void TTSPArrival::resolve_names() {
+  const char* name = NULL;
+  oop thread_obj = _thread->threadObj();
+  if (thread_obj != NULL) {
+    oop name_oop = java_lang_Thread::name(thread_obj);
+    if (name_oop != NULL) {
+      name = java_lang_String::as_utf8_string(name_oop, _thread_name, thread_name_length);
+    }
+  }
+  if (name == NULL) {
+    strncpy(_thread_name, _thread->Thread::name(), thread_name_length);
+    _thread_name[thread_name_length - 1] = '\0';
+  }
+
+  if (_method != NULL) {
+    _method->name_and_sig_as_C_string(_method_name, method_name_length);
+  } else {
+    _method_name[0] = '\0';
+  }
+  _method = NULL;
+  _thread = NULL;
+}
+
+void TTSPArrival::print_on(outputStream* st) const {
+  st->print("    +%8.3f ms \"%s\" #" JLONG_FORMAT " nid=0x%x %-15s %s",
+            (double)_arrival_nanos / MICROUNITS, _thread_name, _java_tid, _os_tid,
+            ttsp_thread_state_name(_state),
+            _self_reported ? "self " : "found");
+  switch (_frame_kind) {
+    case interpreted_frame:
+      st->print_cr(" interpreted %s @ bci %d", _method_name, _bci);
+      break;
+    case compiled_frame:
+      st->print_cr(" compiled (%s id=%d level=%d) %s @ bci %d",
+                   _compiler, _compile_id, _comp_level, _method_name, _bci);
+      break;
+    case native_frame:
+      st->print_cr(" native %s", _method_name);
+      break;
+    default:
+      st->print_cr(" no Java frame");
+      break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// TTSPRecord
+
+void TTSPRecord::print_on(outputStream* st) const {
+  st->print_cr("Safepoint " JLONG_FORMAT " (%s): %.3f ms to safepoint, %d threads, %d arrivals recorded",
+               _safepoint_id,
+               _vmop_type == -1 ? "no vm operation" : VM_Operation::name(_vmop_type),
+               (double)_ttsp_nanos / MICROUNITS, _nof_threads, _nof_arrivals);
+
+  // Print the stragglers latest first.
+  int order[max_stragglers];
+  for (int i = 0; i < _nof_stragglers; i++) {
+    int j = i;
+    while (j > 0 && _stragglers[order[j - 1]].arrival_nanos() < _stragglers[i].arrival_nanos()) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+  }
+  for (int i = 0; i < _nof_stragglers; i++) {
+    _stragglers[order[i]].print_on(st);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// TimeToSafepointProfiler
+
+void TimeToSafepointProfiler::initialize() {
+  assert(_records == NULL, "already initialized");
+  if (!ProfileTimeToSafepoint) {
+    return;
+  }
+  _size = MAX2((uint)TimeToSafepointProfileSize, 1u);
+  _records = NEW_C_HEAP_ARRAY(TTSPRecord, _size, mtInternal);
+  memset(_records, 0, sizeof(TTSPRecord) * _size);
+}
+
+void TimeToSafepointProfiler::begin_synchronization(jlong safepoint_id, int nof_threads) {
+  assert(Thread::current()->is_VM_thread(), "only the VM thread writes records");
+  assert(Safepoint_lock->owned_by_self(), "must hold Safepoint_lock");
+  assert(_current == NULL, "synchronization already in progress");
+
+  TTSPRecord* rec = &_records[(uint)_total % _size];
+  // Invalidate the record for readers before overwriting it.
+  rec->_seq++;
+  OrderAccess::storestore();
+
+  VM_Operation* op = VMThread::vm_operation();
+  rec->_safepoint_id   = safepoint_id;
+  rec->_begin_nanos    = os::javaTimeNanos();
+  rec->_ttsp_nanos     = 0;
+  rec->_vmop_type      = (op != NULL ? op->type() : -1);
+  rec->_nof_threads    = nof_threads;
+  rec->_nof_arrivals   = 0;
+  rec->_nof_stragglers = 0;
+  _current = rec;
+}
+
+void TimeToSafepointProfiler::record_arrival(JavaThread* thread, int state, jlong now, bool self_reported) {
+  assert(Safepoint_lock->owned_by_self(), "arrivals are serialized by Safepoint_lock");
+  TTSPRecord* rec = _current;
+  if (rec == NULL) {
+    return;
+  }
+  jlong arrival = now - rec->_begin_nanos;
+  rec->_nof_arrivals++;
+
+  // Keep the latest arrivals.  Threads that report themselves take their
+  // time stamp before they wait for the Safepoint_lock, so arrivals are
+  // not recorded in time order.
+  TTSPArrival* slot;
+  if (rec->_nof_stragglers < TTSPRecord::max_stragglers) {
+    slot = &rec->_stragglers[rec->_nof_stragglers++];
+  } else {
+    slot = &rec->_stragglers[0];
+    for (int i = 1; i < TTSPRecord::max_stragglers; i++) {
+      if (rec->_stragglers[i]._arrival_nanos < slot->_arrival_nanos) {
+        slot = &rec->_stragglers[i];
+      }
+    }
+    if (slot->_arrival_nanos >= arrival) {
+      return;
+    }
+  }
+
+  slot->_thread        = thread;
+  slot->_java_tid      = SharedRuntime::get_java_tid(thread);
+  slot->_os_tid        = thread->osthread() != NULL ? (int)thread->osthread()->thread_id() : 0;
+  slot->_state         = state;
+  slot->_self_reported = self_reported;
+  slot->_arrival_nanos = arrival;
+  slot->capture_frame(thread);
+}
+
+void TimeToSafepointProfiler::end_synchronization() {
+  assert(Thread::current()->is_VM_thread(), "only the VM thread writes records");
+  TTSPRecord* rec = _current;
+  if (rec == NULL) {
+    return;
+  }
+  rec->_ttsp_nanos = os::javaTimeNanos() - rec->_begin_nanos;
+  for (int i = 0; i < rec->_nof_stragglers; i++) {
+    rec->_stragglers[i].resolve_names();
+  }
+  _current = NULL;
+
+  // Publish the record.
+  OrderAccess::release_store(&rec->_seq, rec->_seq + 1);
+  OrderAccess::release_store(&_total, _total + 1);
+}
+
+// Copies the record at 'index' if it is not being written.  Lock free:
+// the copy is discarded if the VM thread started to overwrite the record
+// while it was copied.
+bool TimeToSafepointProfiler::copy_record(uint index, TTSPRecord* copy) {
+  TTSPRecord* rec = &_records[index % _size];
+  jint seq = OrderAccess::load_acquire(&rec->_seq);
+  if ((seq & 1) != 0) {
+    return false;
+  }
+  memcpy((void*)copy, (const void*)rec, sizeof(TTSPRecord));
+  OrderAccess::loadload();
+  return OrderAccess::load_acquire(&rec->_seq) == seq;
+}
+
+void TimeToSafepointProfiler::print_on(outputStream* st, uint count) {
+  if (!is_enabled()) {
+    st->print_cr("Time to safepoint profiling is disabled, use -XX:+ProfileTimeToSafepoint");
+    return;
+  }
+  uint total = (uint)OrderAccess::load_acquire(&_total);
+  uint available = MIN2(total, _size);
+  count = MIN2(count, available);
+  st->print_cr("Time to safepoint profile: %u of %u safepoints", count, total);
+
+  TTSPRecord copy;
+  for (uint i = 0; i < count; i++) {
+    uint index = total - 1 - i;
+    if (copy_record(index, &copy)) {
+      copy.print_on(st);
+    } else {
+      st->print_cr("Safepoint record overwritten while reading");
+    }
+  }
+}
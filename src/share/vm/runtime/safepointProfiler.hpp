@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
+#define SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/ostream.hpp"
+
+class JavaThread;
+class Method;
+
+// The time-to-safepoint (TTSP) profiler records, for each safepoint,
+// the last threads to reach it: their thread state, the Java frame they
+// were executing when they stopped and how long after the start of the
+// safepoint they arrived.  A thread that arrives late from compiled code
+// usually ran a loop without safepoint polls.
+//
+// The records live in a ring buffer that is allocated at VM startup, so
+// no memory is allocated while threads are brought to a safepoint.  The
+// VM thread is the only writer of a record.  Arrivals are added while
+// holding the Safepoint_lock, either by the VM thread when it finds a
+// thread in a safe state or by the thread itself when it blocks in
+// SafepointSynchronize::block().  Readers such as the
+// VM.safepoint_profile diagnostic command never take a lock: each record
+// carries a sequence number that is odd while the record is written, and
+// a reader retries or skips a record whose sequence number changed while
+// it copied the record.
+
+class TTSPArrival VALUE_OBJ_CLASS_SPEC {
+  friend class TimeToSafepointProfiler;
+ public:
+  enum FrameKind {
+    no_frame,
+    interpreted_frame,
+    compiled_frame,
+    native_frame
+  };
+
+  enum {
+    thread_name_length = 64,
+    method_name_length = 192
+  };
+
+ private:
+  JavaThread*     _thread;
+  jlong           _java_tid;
+  int             _os_tid;
+  int             _state;            // JavaThreadState when the thread arrived
+  bool            _self_reported;    // arrival recorded by the thread itself
+  jlong           _arrival_nanos;    // time since the start of the safepoint
+  FrameKind       _frame_kind;
+  Method*         _method;           // only valid until the record is completed
+  int             _bci;
+  int             _compile_id;
+  int             _comp_level;
+  const char*     _compiler;         // static string naming the compiler
+  char            _thread_name[thread_name_length];
+  char            _method_name[method_name_length];
+
+  void capture_frame(JavaThread* thread);
+  void resolve_names();
+
+ public:
+  jlong arrival_nanos() const { return _arrival_nanos; }
+  void print_on(outputStream* st) const;
+};
+
+class TTSPRecord VALUE_OBJ_CLASS_SPEC {
+  friend class TimeToSafepointProfiler;
+ public:
+  enum {
+    max_stragglers = 8               // number of last arrivals kept per safepoint
+  };
+
+ private:
+  volatile jint   _seq;              // odd while the record is being written
+  jlong           _safepoint_id;
+  jlong           _begin_nanos;      // os::javaTimeNanos() at the start of the safepoint
+  jlong           _ttsp_nanos;       // time until all threads had arrived
+  int             _vmop_type;
+  int             _nof_threads;
+  int             _nof_arrivals;
+  int             _nof_stragglers;
+  TTSPArrival     _stragglers[max_stragglers];
+
+ public:
+  void print_on(outputStream* st) const;
+};
+
+class TimeToSafepointProfiler : AllStatic {
+ private:
+  static TTSPRecord*  _records;
+  static uint         _size;
+  static volatile jint _total;       // number of completed records
+  static TTSPRecord*  _current;      // record of the safepoint in progress
+
+  static bool copy_record(uint index, TTSPRecord* copy);
+
+ public:
+  static void initialize();
+  static bool is_enabled() { return _records != NULL; }
+
+  // Called by the VM thread with the Safepoint_lock held.
+  static void begin_synchronization(jlong safepoint_id, int nof_threads);
+  static void end_synchronization();
+
+  // Called with the Safepoint_lock held, either by the VM thread or by
+  // the arriving thread itself.  'now' is the os::javaTimeNanos() time
+  // of the arrival.
+  static void record_arrival(JavaThread* thread, int state, jlong now, bool self_reported);
+
+  // Prints the most recent 'count' safepoints, newest first.
+  static void print_on(outputStream* st, uint count);
+};
+
+#endif // SHARE_VM_RUNTIME_SAFEPOINTPROFILER_HPP
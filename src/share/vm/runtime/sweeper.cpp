@@ -32,11 +32,13 @@
 #include "oops/method.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/compilationPolicy.hpp"
+#include "runtime/interfaceSupport.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/os.hpp"
 #include "runtime/sweeper.hpp"
 #include "runtime/thread.inline.hpp"
+#include "runtime/vmThread.hpp"
 #include "runtime/vm_operations.hpp"
 #include "trace/tracing.hpp"
 #include "utilities/events.hpp"
@@ -153,6 +155,8 @@ int    NMethodSweeper::_hotness_counter_reset_val       = 0;
 long   NMethodSweeper::_total_nof_methods_reclaimed     = 0;    // Accumulated nof methods flushed
 long   NMethodSweeper::_total_nof_c2_methods_reclaimed  = 0;    // Accumulated nof methods flushed
 size_t NMethodSweeper::_total_flushed_size              = 0;    // Total number of bytes flushed from the code cache
+long   NMethodSweeper::_total_nof_methods_evicted       = 0;    // Accumulated nof methods made not-entrant for their hotness
+long   NMethodSweeper::_total_nof_methods_zombified     = 0;    // Accumulated nof methods made zombie
 Tickspan  NMethodSweeper::_total_time_sweeping;                 // Accumulated time sweeping
 Tickspan  NMethodSweeper::_total_time_this_sweep;               // Total time this sweep
 Tickspan  NMethodSweeper::_peak_sweep_time;                     // Peak time for a full sweep
@@ -165,7 +169,7 @@ public:
   virtual void do_code_blob(CodeBlob* cb) {
     if (cb->is_nmethod()) {
       nmethod* nm = (nmethod*)cb;
-      nm->set_hotness_counter(NMethodSweeper::hotness_counter_reset_val());
+      NMethodSweeper::sample_hotness(nm);
       // If we see an activation belonging to a non_entrant nmethod, we mark it.
       if (nm->is_not_entrant()) {
         nm->mark_as_seen_on_stack();
@@ -180,7 +184,7 @@ public:
   virtual void do_code_blob(CodeBlob* cb) {
     if (cb->is_nmethod()) {
       nmethod* nm = (nmethod*)cb;
-      nm->set_hotness_counter(NMethodSweeper::hotness_counter_reset_val());
+      NMethodSweeper::sample_hotness(nm);
     }
   }
 };
@@ -193,6 +197,64 @@ int NMethodSweeper::hotness_counter_reset_val() {
   }
   return _hotness_counter_reset_val;
 }
+
+/**
+ * Raises the hotness counter of an nmethod that was found on a thread stack.
+ * By default the counter is set back to its reset value. With
+ * -XX:+UseCostAwareCodeCacheFlushing every further sample adds an eighth of
+ * the reset value, up to twice the reset value, so nmethods that are sampled
+ * often survive more sweeps than nmethods that were seen once.
+ */
+void NMethodSweeper::sample_hotness(nmethod* nm) {
+  int reset_val = hotness_counter_reset_val();
+  if (UseCostAwareCodeCacheFlushing) {
+    int hotness = MAX2(nm->hotness_counter(), reset_val) + MAX2(reset_val / 8, 1);
+    nm->set_hotness_counter(MIN2(hotness, 2 * reset_val));
+  } else {
+    nm->set_hotness_counter(reset_val);
+  }
+}
+
+/**
+ * Number of sweeps an nmethod is kept beyond the hotness threshold for the
+ * cost of compiling it again. The cost is the compile time per KB of code,
+ * so evicting cheap, large code frees the most space for the least
+ * recompilation work. It counts on a log scale, up to the hotness reset
+ * value for 64ms per KB. Profiled code gets no credit, since it is
+ * replaced by fully optimized code anyway.
+ */
+double NMethodSweeper::eviction_credit(nmethod* nm) {
+  if (nm->compile_time_us() == 0 ||
+      nm->comp_level() == CompLevel_limited_profile ||
+      nm->comp_level() == CompLevel_full_profile) {
+    return 0.0;
+  }
+  double us_per_kb = (double)nm->compile_time_us() * K / nm->total_size();
+  double doublings = log(1.0 + us_per_kb) / log(2.0);
+  return hotness_counter_reset_val() * MIN2(doublings, 16.0) / 16.0;
+}
+
+void NMethodSweeper::log_eviction(nmethod* nm, double threshold, double credit) {
+  ResourceMark rm;
+  if (PrintCodeCacheEviction) {
+    ttyLocker ttyl;
+    tty->print_cr("### Evicting nmethod %d/" PTR_FORMAT " %s (level %d): %d bytes, compile time %dus,"
+                  " hotness %d/%d, threshold %.1f, credit %.1f",
+                  nm->compile_id(), nm, nm->method()->name_and_sig_as_C_string(), nm->comp_level(),
+                  nm->total_size(), nm->compile_time_us(), nm->hotness_counter(),
+                  hotness_counter_reset_val(), threshold, credit);
+  }
+  if (LogCompilation && (xtty != NULL)) {
+    ttyLocker ttyl;
+    xtty->begin_elem("sweeper_evict compile_id='%d' level='%d' size='%d' compile_time_us='%d' hotness='%d' threshold='%.1f' credit='%.1f'",
+                     nm->compile_id(), nm->comp_level(), nm->total_size(), nm->compile_time_us(),
+                     nm->hotness_counter(), threshold, credit);
+    xtty->method(nm->method());
+    xtty->stamp();
+    xtty->end_elem();
+  }
+}
+
 bool NMethodSweeper::sweep_in_progress() {
   return (_current != NULL);
 }
@@ -215,7 +277,8 @@ void NMethodSweeper::mark_active_nmethods() {
   assert(CodeCache::find_blob_unsafe(_current) == _current, "Sweeper nmethod cached state invalid");
   if (!sweep_in_progress()) {
     _seen = 0;
-    _sweep_fractions_left = NmethodSweepFraction;
+    // The sweeper thread does a whole pass at once
+    _sweep_fractions_left = UseCodeCacheSweeperThread ? 1 : NmethodSweepFraction;
     _current = CodeCache::first_nmethod();
     _traversals += 1;
     _total_time_this_sweep = Tickspan();
@@ -232,6 +295,54 @@ void NMethodSweeper::mark_active_nmethods() {
 
   OrderAccess::storestore();
 }
+
+/**
+ * Forces a safepoint, at which mark_active_nmethods() scans the stacks and
+ * starts a new traversal. The sweeper thread uses this to advance the state
+ * of nmethods without waiting for a safepoint requested by someone else.
+ * Compiled code only polls the global safepoint page, so scanning the
+ * stacks thread by thread with handshakes would end up at a safepoint for
+ * every thread running Java code anyway.
+ */
+void NMethodSweeper::do_stack_scanning() {
+  assert(!CodeCache_lock->owned_by_self(), "just checking");
+  VM_ForceSafepoint op;
+  VMThread::execute(&op);
+}
+
+/**
+ * Loop of the sweeper thread. It waits until it is notified that a code heap
+ * is getting full, or for NmethodSweepCheckInterval seconds, and then sweeps
+ * if possibly_sweep() finds a reason to. While compilation is stopped for lack
+ * of space, it checks every 100ms.
+ */
+void NMethodSweeper::sweeper_loop() {
+  JavaThread* thread = JavaThread::current();
+  while (true) {
+    {
+      ThreadBlockInVM tbivm(thread);
+      MutexLockerEx waiter(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+      long wait_time = CompileBroker::should_compile_new_jobs() ? NmethodSweepCheckInterval * 1000 : 100;
+      CodeCache_lock->wait(Mutex::_no_safepoint_check_flag, wait_time);
+    }
+    possibly_sweep();
+  }
+}
+
+/**
+ * Wakes up the sweeper thread if less than StartAggressiveSweepingAt percent
+ * of the code heap for code_blob_type is free. Blobs allocated at a safepoint
+ * without the CodeCache_lock are picked up at the next periodic check.
+ */
+void NMethodSweeper::notify(int code_blob_type) {
+  if (UseCodeCacheSweeperThread && CodeCache_lock->owned_by_self() &&
+      CodeCache::reverse_free_ratio(code_blob_type) >= 100.0 / StartAggressiveSweepingAt) {
+    // Sweep right away instead of waiting for enough state changes.
+    _should_sweep = true;
+    CodeCache_lock->notify();
+  }
+}
+
 /**
  * This function invokes the sweeper if at least one of the three conditions is met:
  *    (1) The code cache is getting full
@@ -240,8 +351,23 @@ void NMethodSweeper::mark_active_nmethods() {
  */
 void NMethodSweeper::possibly_sweep() {
   assert(JavaThread::current()->thread_state() == _thread_in_vm, "must run in vm mode");
-  // Only compiler threads are allowed to sweep
-  if (!MethodFlushing || !sweep_in_progress() NOT_JVMCI(|| !Thread::current()->is_Compiler_thread()) JVMCI_ONLY(|| !Thread::current()->is_Java_thread())) {
+  if (!MethodFlushing) {
+    return;
+  }
+  Thread* thread = Thread::current();
+  if (UseCodeCacheSweeperThread) {
+    // Only the sweeper thread is allowed to sweep
+    if (!thread->is_Code_cache_sweeper_thread()) {
+      return;
+    }
+    if (!sweep_in_progress() && _should_sweep) {
+      do_stack_scanning();
+    }
+  } else if (NOT_JVMCI(!thread->is_Compiler_thread()) JVMCI_ONLY(!thread->is_Java_thread())) {
+    // Only compiler threads are allowed to sweep
+    return;
+  }
+  if (!sweep_in_progress()) {
     return;
   }
 
@@ -271,7 +397,9 @@ void NMethodSweeper::possibly_sweep() {
     // an unsigned type would cause an underflow (wait_until_next_sweep becomes a large positive
     // value) that disables the intended periodic sweeps.
     const int max_wait_time = ReservedCodeCacheSize / (16 * M);
-    double wait_until_next_sweep = max_wait_time - time_since_last_sweep - CodeCache::reverse_free_ratio();
+    double wait_until_next_sweep = max_wait_time - time_since_last_sweep -
+        MAX2(CodeCache::reverse_free_ratio(CodeBlobType::MethodProfiled),
+             CodeCache::reverse_free_ratio(CodeBlobType::MethodNonProfiled));
     assert(wait_until_next_sweep <= (double)max_wait_time, "Calculation of code cache sweeper interval is incorrect");
 
     if ((wait_until_next_sweep <= 0.0) || !CompileBroker::should_compile_new_jobs()) {
@@ -391,6 +519,7 @@ void NMethodSweeper::sweep_code_cache() {
   _peak_sweep_fraction_time = MAX2(sweep_time, _peak_sweep_fraction_time);
   _total_flushed_size += freed_memory;
   _total_nof_methods_reclaimed += _flushed_count;
+  _total_nof_methods_zombified += _zombified_count;
 
   EventSweepCodeCache event(UNTIMED);
   if (event.should_commit()) {
@@ -459,18 +588,10 @@ void NMethodSweeper::possibly_enable_sweeper() {
 
 class NMethodMarker: public StackObj {
  private:
-#if INCLUDE_JVMCI
   JavaThread* _thread;
-#else
-  CompilerThread* _thread;
-#endif
  public:
   NMethodMarker(nmethod* nm) {
-#if INCLUDE_JVMCI
     _thread = JavaThread::current();
-#else
-    _thread = CompilerThread::current();
-#endif
     if (!nm->is_zombie() && !nm->is_unloaded()) {
       // Only expose live nmethods for scanning
       _thread->set_scanned_nmethod(nm);
@@ -602,7 +723,10 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
         // ReservedCodeCacheSize
         int reset_val = hotness_counter_reset_val();
         int time_since_reset = reset_val - nm->hotness_counter();
-        double threshold = -reset_val + (CodeCache::reverse_free_ratio() * NmethodSweepActivity);
+        double threshold = -reset_val + (CodeCache::reverse_free_ratio(CodeCache::get_code_blob_type(nm)) * NmethodSweepActivity);
+        // Code that is expensive to compile again is kept longer
+        double credit = UseCostAwareCodeCacheFlushing ? eviction_credit(nm) : 0.0;
+        threshold -= credit;
         // The less free space in the code cache we have - the bigger reverse_free_ratio() is.
         // I.e., 'threshold' increases with lower available space in the code cache and a higher
         // NmethodSweepActivity. If the current hotness counter - which decreases from its initial
@@ -616,6 +740,8 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
           //    sizes (e.g., <10m) and the code cache size is too small to hold all hot methods.
           //    The second condition ensures that methods are not immediately made not-entrant
           //    after compilation.
+          log_eviction(nm, threshold, credit);
+          _total_nof_methods_evicted++;
           nm->make_not_entrant();
           // Code cache state change is tracked in make_not_entrant()
           if (PrintMethodFlushing && Verbose) {
@@ -683,4 +809,6 @@ void NMethodSweeper::print() {
   tty->print_cr("  Total number of flushed methods: %ld(%ld C2 methods)", _total_nof_methods_reclaimed,
                                                     _total_nof_c2_methods_reclaimed);
   tty->print_cr("  Total size of flushed methods:   " SIZE_FORMAT "kB", _total_flushed_size/K);
+  tty->print_cr("  Total number of zombified methods: %ld", _total_nof_methods_zombified);
+  tty->print_cr("  Total number of evicted methods: %ld", _total_nof_methods_evicted);
 }
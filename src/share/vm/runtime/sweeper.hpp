@@ -52,6 +52,12 @@
 //     nmethod's space is freed. Sweeping is currently done by compiler threads between
 //     compilations or at least each 5 sec (NmethodSweepCheckInterval) when the code cache
 //     is full.
+//
+// With -XX:+UseCodeCacheSweeperThread a dedicated thread sweeps instead of the compiler
+// threads. It sweeps the whole code cache in one go, yielding to safepoints, and starts
+// the next stack traversal with a safepoint of its own instead of waiting for the next
+// one. It is woken up when a code heap gets less than StartAggressiveSweepingAt percent
+// free, so cold nmethods are reclaimed before the code cache is full.
 
 class NMethodSweeper : public AllStatic {
   static long      _traversals;                     // Stack scan count, also sweep ID.
@@ -75,6 +81,8 @@ class NMethodSweeper : public AllStatic {
   static long      _total_nof_methods_reclaimed;    // Accumulated nof methods flushed
   static long      _total_nof_c2_methods_reclaimed; // Accumulated nof C2-compiled methods flushed
   static size_t    _total_flushed_size;             // Total size of flushed methods
+  static long      _total_nof_methods_evicted;      // Accumulated nof methods made not-entrant for their hotness
+  static long      _total_nof_methods_zombified;    // Accumulated nof methods made zombie
   static int       _hotness_counter_reset_val;
 
   static Tickspan  _total_time_sweeping;            // Accumulated time sweeping
@@ -85,8 +93,12 @@ class NMethodSweeper : public AllStatic {
   static int  process_nmethod(nmethod *nm);
   static void release_nmethod(nmethod* nm);
 
+  static double eviction_credit(nmethod* nm);
+  static void   log_eviction(nmethod* nm, double threshold, double credit);
+
   static bool sweep_in_progress();
   static void sweep_code_cache();
+  static void do_stack_scanning();
 
  public:
   static long traversal_count()              { return _traversals; }
@@ -107,8 +119,11 @@ class NMethodSweeper : public AllStatic {
 
   static void mark_active_nmethods();      // Invoked at the end of each safepoint
   static void possibly_sweep();            // Compiler threads call this to sweep
+  static void sweeper_loop();              // Entry of the sweeper thread
+  static void notify(int code_blob_type);  // Possibly wakes up the sweeper thread
 
   static int hotness_counter_reset_val();
+  static void sample_hotness(nmethod* nm);   // nm was found on a thread stack
   static void report_state_change(nmethod* nm);
   static void possibly_enable_sweeper();
   static void print();   // Printing/debugging
@@ -33,6 +33,7 @@
 #include "runtime/mutexLocker.hpp"
 #include "runtime/objectMonitor.hpp"
 #include "runtime/objectMonitor.inline.hpp"
+#include "runtime/orderAccess.inline.hpp"
 #include "runtime/osThread.hpp"
 #include "runtime/stubRoutines.hpp"
 #include "runtime/synchronizer.hpp"
@@ -153,11 +154,19 @@ ObjectMonitor * ObjectSynchronizer::gBlockList = NULL ;
 ObjectMonitor * volatile ObjectSynchronizer::gFreeList  = NULL ;
 ObjectMonitor * volatile ObjectSynchronizer::gOmInUseList  = NULL ;
 int ObjectSynchronizer::gOmInUseCount = 0;
+ObjectMonitor * volatile ObjectSynchronizer::gDeflatedList = NULL ;
+int ObjectSynchronizer::gDeflatedCount = 0;
 static volatile intptr_t ListLock = 0 ;      // protects global monitor free-list cache
 static volatile int MonitorFreeCount  = 0 ;      // # on gFreeList
 static volatile int MonitorPopulation = 0 ;      // # Extant -- in circulation
 #define CHAINMARKER (cast_to_oop<intptr_t>(-1))
 
+// With UseLightweightLocking, true if Self has the object fast-locked or
+// still has it on its lock stack after another thread inflated it.
+static bool is_lock_stack_owner(Thread* Self, oop obj) {
+  return Self->is_Java_thread() && ((JavaThread*)Self)->lock_stack().contains(obj);
+}
+
 // -----------------------------------------------------------------------------
 //  Fast Monitor Enter/Exit
 // This the fast monitor enter. The interpreter and compiler use
@@ -184,6 +193,22 @@ void ObjectSynchronizer::fast_enter(Handle obj, BasicLock* lock, bool attempt_re
 
 void ObjectSynchronizer::fast_exit(oop object, BasicLock* lock, TRAPS) {
   assert(!object->mark()->has_bias_pattern(), "should not see bias pattern here");
+  if (UseLightweightLocking) {
+    // The BasicLock is not used.
+    markOop mark = object->mark() ;
+    if (mark->is_fast_locked() && is_lock_stack_owner(THREAD, object)) {
+      // Only another thread inflating the object can change the header
+      // while we have it fast-locked.
+      if ((markOop) Atomic::cmpxchg_ptr (mark->set_unlocked(), object->mark_addr(), mark) == mark) {
+        ((JavaThread*)THREAD)->lock_stack().remove(object) ;
+        TEVENT (fast_exit: release fast-lock) ;
+        return ;
+      }
+    }
+    // inflate() hands a monitor that is still owned anonymously over to us.
+    ObjectSynchronizer::inflate(THREAD, object)->exit (true, THREAD) ;
+    return ;
+  }
   // if displaced header is null, the previous enter is recursive enter, no-op
   markOop dhw = lock->displaced_header();
   markOop mark ;
@@ -227,6 +252,23 @@ void ObjectSynchronizer::slow_enter(Handle obj, BasicLock* lock, TRAPS) {
   markOop mark = obj->mark();
   assert(!mark->has_bias_pattern(), "should not see bias pattern here");
 
+  if (UseLightweightLocking) {
+    // The BasicLock is not used. Swing the header from neutral to
+    // fast-locked and push the object onto our lock stack.
+    if (THREAD->is_Java_thread() && ((JavaThread*)THREAD)->lock_stack().can_push()) {
+      while (mark->is_neutral()) {
+        markOop cmp = (markOop) Atomic::cmpxchg_ptr(mark->set_fast_locked(), obj()->mark_addr(), mark);
+        if (cmp == mark) {
+          ((JavaThread*)THREAD)->lock_stack().push(obj());
+          TEVENT (slow_enter: fast-lock) ;
+          return ;
+        }
+        // Other bits of the header, e.g. the hash, changed -- retry.
+        mark = cmp ;
+      }
+    }
+    // Recursive locking, contention and a full lock stack inflate.
+  } else
   if (mark->is_neutral()) {
     // Anticipate successful CAS -- the ST of the displaced mark must
     // be visible <= the ST performed by the CAS.
@@ -257,7 +299,11 @@ void ObjectSynchronizer::slow_enter(Handle obj, BasicLock* lock, TRAPS) {
   // must be non-zero to avoid looking like a re-entrant lock,
   // and must not look locked either.
   lock->set_displaced_header(markOopDesc::unused_mark());
-  ObjectSynchronizer::inflate(THREAD, obj())->enter(THREAD);
+  // An idle monitor can be deflated concurrently before we manage to
+  // enter it.  Inflate the object again in that case.
+  while (!ObjectSynchronizer::inflate(THREAD, obj())->enter(THREAD)) {
+    TEVENT (slow_enter: retry after async deflation) ;
+  }
 }
 
 // This routine is used to handle interpreter/compiler slow case
@@ -300,9 +346,13 @@ void ObjectSynchronizer::reenter(Handle obj, intptr_t recursion, TRAPS) {
     assert(!obj->mark()->has_bias_pattern(), "biases should be revoked by now");
   }
 
-  ObjectMonitor* monitor = ObjectSynchronizer::inflate(THREAD, obj());
-
-  monitor->reenter(recursion, THREAD);
+  while (true) {
+    ObjectMonitor* monitor = ObjectSynchronizer::inflate(THREAD, obj());
+    if (monitor->reenter(recursion, THREAD)) {
+      return;
+    }
+    // The monitor was deflated concurrently; inflate again.
+  }
 }
 // -----------------------------------------------------------------------------
 // JNI locks on java objects
@@ -315,7 +365,9 @@ void ObjectSynchronizer::jni_enter(Handle obj, TRAPS) { // possible entry from j
     assert(!obj->mark()->has_bias_pattern(), "biases should be revoked by now");
   }
   THREAD->set_current_pending_monitor_is_from_java(false);
-  ObjectSynchronizer::inflate(THREAD, obj())->enter(THREAD);
+  while (!ObjectSynchronizer::inflate(THREAD, obj())->enter(THREAD)) {
+    // The monitor was deflated concurrently; inflate again.
+  }
   THREAD->set_current_pending_monitor_is_from_java(true);
 }
 
@@ -326,8 +378,19 @@ bool ObjectSynchronizer::jni_try_enter(Handle obj, Thread* THREAD) {
     assert(!obj->mark()->has_bias_pattern(), "biases should be revoked by now");
   }
 
-  ObjectMonitor* monitor = ObjectSynchronizer::inflate_helper(obj());
-  return monitor->try_enter(THREAD);
+  while (true) {
+    ObjectMonitor* monitor = ObjectSynchronizer::inflate_helper(obj());
+    if (monitor->try_enter(THREAD)) {
+      return true;
+    }
+    if (monitor->is_being_async_deflated()) {
+      // The monitor is no longer associated with the object.
+      monitor->install_displaced_markword_in_object();
+    } else if (monitor->_owner != DEFLATER_MARKER) {
+      return false;
+    }
+    // The deflater is looking at the idle monitor; retry.
+  }
 }
 
 
@@ -416,6 +479,10 @@ void ObjectSynchronizer::notify(Handle obj, TRAPS) {
   if (mark->has_locker() && THREAD->is_lock_owned((address)mark->locker())) {
     return;
   }
+  if (UseLightweightLocking && mark->is_fast_locked() && is_lock_stack_owner(THREAD, obj())) {
+    // Not inflated, so there are no waiters to notify.
+    return;
+  }
   ObjectSynchronizer::inflate(THREAD, obj())->notify(THREAD);
 }
 
@@ -430,6 +497,10 @@ void ObjectSynchronizer::notifyall(Handle obj, TRAPS) {
   if (mark->has_locker() && THREAD->is_lock_owned((address)mark->locker())) {
     return;
   }
+  if (UseLightweightLocking && mark->is_fast_locked() && is_lock_stack_owner(THREAD, obj())) {
+    // Not inflated, so there are no waiters to notify.
+    return;
+  }
   ObjectSynchronizer::inflate(THREAD, obj())->notifyAll(THREAD);
 }
 
@@ -470,6 +541,7 @@ struct SharedGlobals {
 static SharedGlobals GVars ;
 static int MonitorScavengeThreshold = 1000000 ;
 static volatile int ForceMonitorScavenge = 0 ; // Scavenge required and pending
+static jlong LastAsyncDeflation = 0 ;          // javaTimeNanos() of the last async deflation
 
 static markOop ReadStableMark (oop obj) {
   markOop mark = obj->mark() ;
@@ -637,75 +709,102 @@ intptr_t ObjectSynchronizer::FastHashCode (Thread * Self, oop obj) {
   ObjectMonitor* monitor = NULL;
   markOop temp, test;
   intptr_t hash;
-  markOop mark = ReadStableMark (obj);
 
-  // object should remain ineligible for biased locking
-  assert (!mark->has_bias_pattern(), "invariant") ;
+  // With AsyncDeflateIdleMonitors, the monitor we look at can be deflated
+  // concurrently.  A hash found in or installed into such a monitor may not
+  // have made it back into the object header, so it must not be returned.
+  // We retry with the restored header instead.
+  while (true) {
+    markOop mark = ReadStableMark (obj);
 
-  if (mark->is_neutral()) {
-    hash = mark->hash();              // this is a normal header
-    if (hash) {                       // if it has hash, just return it
-      return hash;
-    }
-    hash = get_next_hash(Self, obj);  // allocate a new hash code
-    temp = mark->copy_set_hash(hash); // merge the hash code into header
-    // use (machine word version) atomic operation to install the hash
-    test = (markOop) Atomic::cmpxchg_ptr(temp, obj->mark_addr(), mark);
-    if (test == mark) {
-      return hash;
-    }
-    // If atomic operation failed, we must inflate the header
-    // into heavy weight monitor. We could add more code here
-    // for fast path, but it does not worth the complexity.
-  } else if (mark->has_monitor()) {
-    monitor = mark->monitor();
-    temp = monitor->header();
-    assert (temp->is_neutral(), "invariant") ;
-    hash = temp->hash();
-    if (hash) {
-      return hash;
+    // object should remain ineligible for biased locking
+    assert (!mark->has_bias_pattern(), "invariant") ;
+
+    if (mark->is_neutral()) {
+      hash = mark->hash();              // this is a normal header
+      if (hash) {                       // if it has hash, just return it
+        return hash;
+      }
+      hash = get_next_hash(Self, obj);  // allocate a new hash code
+      temp = mark->copy_set_hash(hash); // merge the hash code into header
+      // use (machine word version) atomic operation to install the hash
+      test = (markOop) Atomic::cmpxchg_ptr(temp, obj->mark_addr(), mark);
+      if (test == mark) {
+        return hash;
+      }
+      // If atomic operation failed, we must inflate the header
+      // into heavy weight monitor. We could add more code here
+      // for fast path, but it does not worth the complexity.
+    } else if (mark->has_monitor()) {
+      monitor = mark->monitor();
+      temp = monitor->header();
+      assert (temp->is_neutral(), "invariant") ;
+      hash = temp->hash();
+      if (hash) {
+        // Order the load of the header before the load of _count.
+        OrderAccess::loadload();
+        if (monitor->is_being_async_deflated()) {
+          monitor->install_displaced_markword_in_object();
+          continue;
+        }
+        return hash;
+      }
+      // Skip to the following code to reduce code size
+    } else if (UseLightweightLocking && mark->is_fast_locked()) {
+      hash = mark->hash();              // a fast-locked object keeps its
+      if (hash) {                       // header, so return its hash code
+        return hash;
+      }
+      // Inflate to install the hash code.  The owner would otherwise have
+      // to cope with a header that changes while it holds the lock.
+    } else if (Self->is_lock_owned((address)mark->locker())) {
+      temp = mark->displaced_mark_helper(); // this is a lightweight monitor owned
+      assert (temp->is_neutral(), "invariant") ;
+      hash = temp->hash();              // by current thread, check if the displaced
+      if (hash) {                       // header contains hash code
+        return hash;
+      }
+      // WARNING:
+      //   The displaced header is strictly immutable.
+      // It can NOT be changed in ANY cases. So we have
+      // to inflate the header into heavyweight monitor
+      // even the current thread owns the lock. The reason
+      // is the BasicLock (stack slot) will be asynchronously
+      // read by other threads during the inflate() function.
+      // Any change to stack may not propagate to other threads
+      // correctly.
     }
-    // Skip to the following code to reduce code size
-  } else if (Self->is_lock_owned((address)mark->locker())) {
-    temp = mark->displaced_mark_helper(); // this is a lightweight monitor owned
-    assert (temp->is_neutral(), "invariant") ;
-    hash = temp->hash();              // by current thread, check if the displaced
-    if (hash) {                       // header contains hash code
-      return hash;
+
+    // Inflate the monitor to set hash code
+    monitor = ObjectSynchronizer::inflate(Self, obj);
+    // Load displaced header and check it has hash code
+    mark = monitor->header();
+    assert (mark->is_neutral(), "invariant") ;
+    hash = mark->hash();
+    if (hash == 0) {
+      hash = get_next_hash(Self, obj);
+      temp = mark->copy_set_hash(hash); // merge hash code into header
+      assert (temp->is_neutral(), "invariant") ;
+      test = (markOop) Atomic::cmpxchg_ptr(temp, monitor, mark);
+      if (test != mark) {
+        // The only update to the header in the monitor (outside GC)
+        // is install the hash code. If someone add new usage of
+        // displaced header, please update this code
+        hash = test->hash();
+        assert (test->is_neutral(), "invariant") ;
+        assert (hash != 0, "Trivial unexpected object/monitor header usage.");
+      }
+    } else {
+      // Order the load of the header before the load of _count.
+      OrderAccess::loadload();
     }
-    // WARNING:
-    //   The displaced header is strictly immutable.
-    // It can NOT be changed in ANY cases. So we have
-    // to inflate the header into heavyweight monitor
-    // even the current thread owns the lock. The reason
-    // is the BasicLock (stack slot) will be asynchronously
-    // read by other threads during the inflate() function.
-    // Any change to stack may not propagate to other threads
-    // correctly.
-  }
-
-  // Inflate the monitor to set hash code
-  monitor = ObjectSynchronizer::inflate(Self, obj);
-  // Load displaced header and check it has hash code
-  mark = monitor->header();
-  assert (mark->is_neutral(), "invariant") ;
-  hash = mark->hash();
-  if (hash == 0) {
-    hash = get_next_hash(Self, obj);
-    temp = mark->copy_set_hash(hash); // merge hash code into header
-    assert (temp->is_neutral(), "invariant") ;
-    test = (markOop) Atomic::cmpxchg_ptr(temp, monitor, mark);
-    if (test != mark) {
-      // The only update to the header in the monitor (outside GC)
-      // is install the hash code. If someone add new usage of
-      // displaced header, please update this code
-      hash = test->hash();
-      assert (test->is_neutral(), "invariant") ;
-      assert (hash != 0, "Trivial unexpected object/monitor header usage.");
+    if (monitor->is_being_async_deflated()) {
+      monitor->install_displaced_markword_in_object();
+      continue;
     }
+    // We finally get the hash
+    return hash;
   }
-  // We finally get the hash
-  return hash;
 }
 
 // Deprecated -- use FastHashCode() instead.
@@ -731,9 +830,16 @@ bool ObjectSynchronizer::current_thread_holds_lock(JavaThread* thread,
   if (mark->has_locker()) {
     return thread->is_lock_owned((address)mark->locker());
   }
+  // Uncontended case, object is on the owner's lock stack
+  if (UseLightweightLocking && mark->is_fast_locked()) {
+    return thread->lock_stack().contains(obj);
+  }
   // Contended case, header points to ObjectMonitor (tagged pointer)
   if (mark->has_monitor()) {
     ObjectMonitor* monitor = mark->monitor();
+    if (UseLightweightLocking && monitor->is_owner_anonymous()) {
+      return thread->lock_stack().contains(obj);
+    }
     return monitor->is_entered(thread) != 0 ;
   }
   // Unlocked case, header in place
@@ -772,12 +878,20 @@ ObjectSynchronizer::LockOwnership ObjectSynchronizer::query_lock_ownership
       owner_self : owner_other;
   }
 
+  // CASE: fast-locked.  The object is on the owner's lock stack.
+  if (UseLightweightLocking && mark->is_fast_locked()) {
+    return self->lock_stack().contains(obj) ? owner_self : owner_other;
+  }
+
   // CASE: inflated. Mark (tagged pointer) points to an objectMonitor.
   // The Object:ObjectMonitor relationship is stable as long as we're
   // not at a safepoint.
   if (mark->has_monitor()) {
     void * owner = mark->monitor()->_owner ;
     if (owner == NULL) return owner_none ;
+    if (owner == ANONYMOUS_OWNER) {
+      return self->lock_stack().contains(obj) ? owner_self : owner_other;
+    }
     return (owner == self ||
             self->is_lock_owned((address)owner)) ? owner_self : owner_other;
   }
@@ -808,10 +922,18 @@ JavaThread* ObjectSynchronizer::get_lock_owner(Handle h_obj, bool doLock) {
     owner = (address) mark->locker();
   }
 
+  // Uncontended case, object is on the owner's lock stack
+  if (UseLightweightLocking && mark->is_fast_locked()) {
+    return Threads::owning_thread_from_object(obj, doLock);
+  }
+
   // Contended case, header points to ObjectMonitor (tagged pointer)
   if (mark->has_monitor()) {
     ObjectMonitor* monitor = mark->monitor();
     assert(monitor != NULL, "monitor should be non-null");
+    if (UseLightweightLocking && monitor->is_owner_anonymous()) {
+      return Threads::owning_thread_from_object(obj, doLock);
+    }
     owner = (address) monitor->owner();
   }
 
@@ -875,6 +997,9 @@ void ObjectSynchronizer::oops_do(OopClosure* f) {
 // associates them with objects.  Deflation -- which occurs at
 // STW-time -- disassociates idle monitors from objects.  Such
 // scavenged monitors are returned to the gFreeList.
+// With AsyncDeflateIdleMonitors, the ServiceThread deflates idle
+// monitors while the mutators run and parks them on gDeflatedList;
+// they are returned to the gFreeList at the next safepoint.
 //
 // The global list is protected by ListLock.  All the critical sections
 // are short and operate in constant-time.
@@ -886,6 +1011,8 @@ void ObjectSynchronizer::oops_do(OopClosure* f) {
 // --   unassigned and on a thread's private omFreeList
 // --   assigned to an object.  The object is inflated and the mark refers
 //      to the objectmonitor.
+// --   deflated by the ServiceThread and on gDeflatedList, waiting for
+//      the next safepoint.
 //
 
 
@@ -913,6 +1040,15 @@ static void InduceScavenge (Thread * Self, const char * Whence) {
   // of active monitors passes the specified threshold.
   // TODO: assert thread state is reasonable
 
+  if (AsyncDeflateIdleMonitors) {
+    // No safepoint is needed: the ServiceThread notices the request when
+    // it next checks is_async_deflation_needed().
+    if (ForceMonitorScavenge == 0) {
+      Atomic::xchg (1, &ForceMonitorScavenge) ;
+    }
+    return ;
+  }
+
   if (ForceMonitorScavenge == 0 && Atomic::xchg (1, &ForceMonitorScavenge) == 0) {
     if (ObjectMonitor::Knob_Verbose) {
       ::printf ("Monitor scavenge - Induced STW @%s (%d)\n", Whence, ForceMonitorScavenge) ;
@@ -969,10 +1105,16 @@ ObjectMonitor * ATTR ObjectSynchronizer::omAlloc (Thread * Self) {
            // CONSIDER: set m->FreeNext = BAD -- diagnostic hygiene
            guarantee (m->object() == NULL, "invariant") ;
            if (MonitorInUseLists) {
+             if (AsyncDeflateIdleMonitors) {
+               Thread::muxAcquire (&Self->omInUseLock, "omAlloc") ;
+             }
              m->FreeNext = Self->omInUseList;
              Self->omInUseList = m;
              Self->omInUseCount ++;
              // verifyInUse(Self);
+             if (AsyncDeflateIdleMonitors) {
+               Thread::muxRelease (&Self->omInUseLock) ;
+             }
            } else {
              m->FreeNext = NULL;
            }
@@ -1003,8 +1145,9 @@ ObjectMonitor * ATTR ObjectSynchronizer::omAlloc (Thread * Self) {
             if (Self->omFreeProvision > MAXPRIVATE ) Self->omFreeProvision = MAXPRIVATE ;
             TEVENT (omFirst - reprovision) ;
 
+            // Monitors deflated by the ServiceThread are as good as free.
             const int mx = MonitorBound ;
-            if (mx > 0 && (MonitorPopulation-MonitorFreeCount) > mx) {
+            if (mx > 0 && (MonitorPopulation-MonitorFreeCount-gDeflatedCount) > mx) {
               // We can't safely induce a STW safepoint from omAlloc() as our thread
               // state may not be appropriate for such activities and callers may hold
               // naked oops, so instead we defer the action.
@@ -1016,16 +1159,24 @@ ObjectMonitor * ATTR ObjectSynchronizer::omAlloc (Thread * Self) {
         // 3: allocate a block of new ObjectMonitors
         // Both the local and global free lists are empty -- resort to malloc().
         // In the current implementation objectMonitors are TSM - immortal.
+        // The block is aligned to a cache line so that the padding between
+        // the owner and waiter fields of each ObjectMonitor is effective.
         assert (_BLOCKSIZE > 1, "invariant") ;
-        ObjectMonitor * temp = new ObjectMonitor[_BLOCKSIZE];
+        size_t neededsize = sizeof(ObjectMonitor) * _BLOCKSIZE ;
+        size_t aligned_size = neededsize + (DEFAULT_CACHE_LINE_SIZE - 1) ;
+        void * real_malloc_addr = (void *) NEW_C_HEAP_ARRAY_RETURN_NULL(char, aligned_size, mtInternal) ;
 
         // NOTE: (almost) no way to recover if allocation failed.
         // We might be able to induce a STW safepoint and scavenge enough
         // objectMonitors to permit progress.
-        if (temp == NULL) {
-            vm_exit_out_of_memory (sizeof (ObjectMonitor[_BLOCKSIZE]), OOM_MALLOC_ERROR,
+        if (real_malloc_addr == NULL) {
+            vm_exit_out_of_memory (aligned_size, OOM_MALLOC_ERROR,
                                    "Allocate ObjectMonitors");
         }
+        ObjectMonitor * temp = (ObjectMonitor *) align_ptr_up(real_malloc_addr, DEFAULT_CACHE_LINE_SIZE) ;
+        for (int i = 0; i < _BLOCKSIZE; i++) {
+            ::new ((void *) &temp[i]) ObjectMonitor() ;
+        }
 
         // Format the block.
         // initialize the linked list, each monitor points to its next
@@ -1082,6 +1233,9 @@ void ObjectSynchronizer::omRelease (Thread * Self, ObjectMonitor * m, bool fromP
 
     // Remove from omInUseList
     if (MonitorInUseLists && fromPerThreadAlloc) {
+      if (AsyncDeflateIdleMonitors) {
+        Thread::muxAcquire (&Self->omInUseLock, "omRelease") ;
+      }
       ObjectMonitor* curmidinuse = NULL;
       for (ObjectMonitor* mid = Self->omInUseList; mid != NULL; ) {
        if (m == mid) {
@@ -1099,6 +1253,9 @@ void ObjectSynchronizer::omRelease (Thread * Self, ObjectMonitor * m, bool fromP
          mid = mid->FreeNext;
       }
     }
+    if (AsyncDeflateIdleMonitors) {
+      Thread::muxRelease (&Self->omInUseLock) ;
+    }
   }
 
   // FreeNext is used for both onInUseList and omFreeList, so clear old before setting new
@@ -1145,6 +1302,9 @@ void ObjectSynchronizer::omFlush (Thread * Self) {
       guarantee (Tail != NULL && List != NULL, "invariant") ;
     }
 
+    // Self has been removed from the thread list under the Threads_lock,
+    // which the ServiceThread holds while it walks a thread's omInUseList,
+    // so the list is no longer shared and needs no omInUseLock.
     ObjectMonitor * InUseList = Self->omInUseList;
     ObjectMonitor * InUseTail = NULL ;
     int InUseTally = 0;
@@ -1207,6 +1367,7 @@ ObjectMonitor * ATTR ObjectSynchronizer::inflate (Thread * Self, oop object) {
       // The mark can be in one of the following states:
       // *  Inflated     - just return
       // *  Stack-locked - coerce it to inflated
+      // *  Fast-locked  - coerce it to inflated (UseLightweightLocking)
       // *  INFLATING    - busy wait for conversion to complete
       // *  Neutral      - aggressively inflate the object.
       // *  BIASED       - Illegal.  We should never see this
@@ -1217,6 +1378,12 @@ ObjectMonitor * ATTR ObjectSynchronizer::inflate (Thread * Self, oop object) {
           assert (inf->header()->is_neutral(), "invariant");
           assert (inf->object() == object, "invariant") ;
           assert (ObjectSynchronizer::verify_objmon_isinpool(inf), "monitor is invalid");
+          if (UseLightweightLocking && inf->is_owner_anonymous() &&
+              is_lock_stack_owner(Self, object)) {
+            // Another thread inflated the object while we had it fast-locked.
+            int removed = ((JavaThread*)Self)->lock_stack().remove(object) ;
+            inf->set_owner_from_anonymous(Self, removed - 1) ;
+          }
           return inf ;
       }
 
@@ -1226,12 +1393,54 @@ ObjectMonitor * ATTR ObjectSynchronizer::inflate (Thread * Self, oop object) {
       // The INFLATING value is transient.
       // Currently, we spin/yield/park and poll the markword, waiting for inflation to finish.
       // We could always eliminate polling by parking the thread on some auxiliary list.
-      if (mark == markOopDesc::INFLATING()) {
+      if (mark->is_being_inflated()) {
          TEVENT (Inflate: spin while INFLATING) ;
          ReadStableMark(object) ;
          continue ;
       }
 
+      // CASE: fast-locked
+      // Could be fast-locked either by this thread or by some other thread.
+      // The header stays in the object while it is fast-locked, so unlike
+      // the stack-locked case the monitor is installed with a single CAS
+      // and INFLATING is not needed.  If we don't own the lock, the monitor
+      // is owned anonymously until the owner takes it over.
+      if (UseLightweightLocking && mark->is_fast_locked()) {
+          ObjectMonitor * m = omAlloc (Self) ;
+          m->Recycle();
+          m->set_header(mark->set_unlocked());
+          m->set_object(object);
+          bool own = is_lock_stack_owner(Self, object);
+          m->set_owner(own ? (void*) Self : ANONYMOUS_OWNER);
+          m->OwnerIsThread = own ? 1 : 0 ;
+          m->_Responsible  = NULL ;
+          m->_SpinDuration = ObjectMonitor::Knob_SpinLimit ;   // Consider: maintain by type/class
+
+          if (Atomic::cmpxchg_ptr (markOopDesc::encode(m), object->mark_addr(), mark) != mark) {
+             m->set_object (NULL) ;
+             m->set_owner  (NULL) ;
+             m->OwnerIsThread = 0 ;
+             m->Recycle() ;
+             omRelease (Self, m, true) ;
+             continue ;       // Interference -- just retry
+          }
+          if (own) {
+             m->_recursions = ((JavaThread*)Self)->lock_stack().remove(object) - 1 ;
+          }
+
+          if (ObjectMonitor::_sync_Inflations != NULL) ObjectMonitor::_sync_Inflations->inc() ;
+          TEVENT(Inflate: overwrite fast-lock) ;
+          if (TraceMonitorInflation) {
+            if (object->is_instance()) {
+              ResourceMark rm;
+              tty->print_cr("Inflating object " INTPTR_FORMAT " , mark " INTPTR_FORMAT " , type %s",
+                (void *) object, (intptr_t) object->mark(),
+                object->klass()->external_name());
+            }
+          }
+          return m ;
+      }
+
       // CASE: stack-locked
       // Could be stack-locked either by this thread or by some other thread.
       //
@@ -1467,9 +1676,11 @@ bool ObjectSynchronizer::deflate_monitor(ObjectMonitor* mid, oop obj,
   return deflated;
 }
 
-// Caller acquires ListLock
+// Caller acquires ListLock, or the owning thread's omInUseLock for a
+// per-thread list that is walked concurrently (using_marker).
 int ObjectSynchronizer::walk_monitor_list(ObjectMonitor** listheadp,
-                                          ObjectMonitor** FreeHeadp, ObjectMonitor** FreeTailp) {
+                                          ObjectMonitor** FreeHeadp, ObjectMonitor** FreeTailp,
+                                          bool using_marker) {
   ObjectMonitor* mid;
   ObjectMonitor* next;
   ObjectMonitor* curmidinuse = NULL;
@@ -1478,7 +1689,9 @@ int ObjectSynchronizer::walk_monitor_list(ObjectMonitor** listheadp,
   for (mid = *listheadp; mid != NULL; ) {
      oop obj = (oop) mid->object();
      bool deflated = false;
-     if (obj != NULL) {
+     if (using_marker) {
+       deflated = deflate_monitor_using_marker(mid, FreeHeadp, FreeTailp);
+     } else if (obj != NULL) {
        deflated = deflate_monitor(mid, obj, FreeHeadp, FreeTailp);
      }
      if (deflated) {
@@ -1516,7 +1729,30 @@ void ObjectSynchronizer::deflate_idle_monitors() {
   // See e.g. 6320749
   Thread::muxAcquire (&ListLock, "scavenge - return") ;
 
-  if (MonitorInUseLists) {
+  if (AsyncDeflateIdleMonitors) {
+    // The ServiceThread deflates the idle monitors.  The ones it deflated
+    // since the last safepoint can be reused now: a thread that found one
+    // of them before it was deflated has noticed that by now, as it cannot
+    // reach a safepoint in between (see ObjectMonitor::enter).
+    for (ObjectMonitor* mid = gDeflatedList; mid != NULL; mid = mid->FreeNext) {
+      guarantee (mid->_owner == DEFLATER_MARKER, "invariant") ;
+      guarantee (mid->_count == -max_jint, "invariant") ;
+      mid->_owner = NULL ;
+      mid->_count = 0 ;
+      mid->clear() ;
+      FreeTail = mid ;
+      nScavenged ++ ;
+    }
+    FreeHead = gDeflatedList ;
+    gDeflatedList = NULL ;
+    gDeflatedCount = 0 ;
+    for (JavaThread* cur = Threads::first(); cur != NULL; cur = cur->next()) {
+      nInuse += cur->omInUseCount;
+    }
+    nInuse += gOmInUseCount;
+    nInCirculation = nInuse + nScavenged;
+
+  } else if (MonitorInUseLists) {
     int inUse = 0;
     for (JavaThread* cur = Threads::first(); cur != NULL; cur = cur->next()) {
       nInCirculation+= cur->omInUseCount;
@@ -1574,7 +1810,9 @@ void ObjectSynchronizer::deflate_idle_monitors() {
     ::fflush(stdout) ;
   }
 
-  ForceMonitorScavenge = 0;    // Reset
+  if (!AsyncDeflateIdleMonitors) {
+    ForceMonitorScavenge = 0;    // Reset; the ServiceThread resets it otherwise
+  }
 
   // Move the scavenged monitors back to the global free list.
   if (FreeHead != NULL) {
@@ -1595,6 +1833,190 @@ void ObjectSynchronizer::deflate_idle_monitors() {
   GVars.stwCycle ++ ;
 }
 
+// Async deflation
+// ---------------
+// With AsyncDeflateIdleMonitors the ServiceThread deflates idle monitors
+// while the mutators run, so safepoints no longer pay for walking all
+// monitors in circulation.  The monitors it deflates are parked on
+// gDeflatedList and returned to the free list by deflate_idle_monitors()
+// at the next safepoint; is_cleanup_needed() makes sure one happens.
+
+// Deflates mid if it is idle.  Called by the ServiceThread with the lock
+// that protects the list holding mid.  Returns true if deflated.
+//
+// The other threads keep running, so the deflation takes two steps,
+// each of which makes the monitor look busy to everybody else:
+//  1. An unowned monitor is claimed by installing DEFLATER_MARKER as its
+//     owner.  Threads that try to lock it see it as owned.  A thread
+//     that has already registered its contention in _count takes the
+//     monitor over instead, cancelling the deflation
+//     (ObjectMonitor::TryCancelDeflation).
+//  2. If there are still no contending or waiting threads, the zero
+//     _count is made negative.  An entering thread increments _count
+//     before it queues up, so from now on it notices that it lost the
+//     race and inflates the object again (ObjectMonitor::enter).
+// The displaced header, which cannot change anymore, is then restored to
+// the object.  The monitor keeps DEFLATER_MARKER as its owner until it is
+// recycled.
+bool ObjectSynchronizer::deflate_monitor_using_marker(ObjectMonitor* mid,
+                                                      ObjectMonitor** FreeHeadp, ObjectMonitor** FreeTailp) {
+  oop obj = (oop) mid->object();
+  if (obj == NULL || obj->mark() != markOopDesc::encode(mid)) {
+    // Not (yet) associated with an object.  See inflate().
+    return false;
+  }
+  if (mid->is_busy()) {
+    return false;
+  }
+
+  // Step 1
+  if (Atomic::cmpxchg_ptr(DEFLATER_MARKER, &mid->_owner, NULL) != NULL) {
+    return false;
+  }
+
+  // Step 2
+  if (mid->_waiters != 0 || mid->_cxq != NULL || mid->_EntryList != NULL ||
+      Atomic::cmpxchg_ptr((intptr_t)-max_jint, &mid->_count, (intptr_t)0) != 0) {
+    // The monitor is in use after all.  Give it back, unless an entering
+    // thread has already taken it over; that thread added an extra
+    // contention for us to remove.  Threads that saw the monitor owned
+    // may have parked, so it is given back through a regular exit, which
+    // wakes a successor.
+    Thread* self = Thread::current();
+    if (Atomic::cmpxchg_ptr(self, &mid->_owner, DEFLATER_MARKER) != DEFLATER_MARKER) {
+      Atomic::dec_ptr(&mid->_count);
+    } else {
+      mid->OwnerIsThread = 1;
+      mid->exit(true, self);
+    }
+    return false;
+  }
+  assert (mid->_owner == DEFLATER_MARKER, "only the deflater can own the monitor now") ;
+
+  TEVENT (deflate_idle_monitors - async scavenge) ;
+  markOop dmw = mid->header();
+  guarantee (dmw->is_neutral(), "invariant") ;
+  if (TraceMonitorInflation) {
+    if (obj->is_instance()) {
+      ResourceMark rm;
+      tty->print_cr("Deflating object " INTPTR_FORMAT " , mark " INTPTR_FORMAT " , type %s",
+                    (void *) obj, (intptr_t) obj->mark(), obj->klass()->external_name());
+    }
+  }
+
+  // Restore the header back to obj, unless an entering thread has
+  // already done it for us.
+  Atomic::cmpxchg_ptr(dmw, obj->mark_addr(), markOopDesc::encode(mid));
+
+  // Move the monitor to the working list defined by FreeHead,FreeTail.
+  if (*FreeHeadp == NULL) *FreeHeadp = mid;
+  if (*FreeTailp != NULL) {
+    ObjectMonitor * prevtail = *FreeTailp;
+    assert(prevtail->FreeNext == NULL, "cleaned up deflated?");
+    prevtail->FreeNext = mid;
+  }
+  *FreeTailp = mid;
+  return true;
+}
+
+bool ObjectSynchronizer::is_async_deflation_needed() {
+  if (!AsyncDeflateIdleMonitors) {
+    return false;
+  }
+  if (ForceMonitorScavenge != 0) {
+    // MonitorBound has been exceeded.  See InduceScavenge().
+    return true;
+  }
+  if (AsyncDeflationInterval > 0 &&
+      (os::javaTimeNanos() - LastAsyncDeflation) / NANOSECS_PER_MILLISEC >= AsyncDeflationInterval) {
+    // Only if some monitors are in circulation.
+    return MonitorPopulation - MonitorFreeCount - gDeflatedCount > 0;
+  }
+  return false;
+}
+
+bool ObjectSynchronizer::is_cleanup_needed() {
+  return gDeflatedCount > 0;
+}
+
+// Called by the ServiceThread.  Walks the per-thread in-use lists, and the
+// list of monitors inherited from exited threads, and deflates the idle
+// monitors.  A thread's list is protected by its omInUseLock, which its
+// owner only takes to add or remove a monitor.
+//
+// The Threads_lock keeps the threads alive while their lists are walked.
+// It is held for ThreadsPerChunk threads at a time, so that a pending
+// safepoint is not held up for long.  Threads that start or exit in
+// between can make the walk skip or revisit a few threads; the skipped
+// ones are handled by the next walk.
+void ObjectSynchronizer::deflate_idle_monitors_using_marker(JavaThread* self) {
+  assert(AsyncDeflateIdleMonitors, "sanity check");
+  assert(self == JavaThread::current(), "must be current thread");
+  assert(self->thread_state() == _thread_in_vm, "must be in VM");
+
+  const int ThreadsPerChunk = 64;
+  // Requests that arrive during the walk are served by the next one.
+  ForceMonitorScavenge = 0;
+  jlong start = os::javaTimeNanos();
+  int nInCirculation = 0;
+  int nScavenged = 0;
+  int processed = 0;
+  bool done = false;
+
+  while (!done) {
+    ObjectMonitor * FreeHead = NULL ;  // Local SLL of deflated monitors
+    ObjectMonitor * FreeTail = NULL ;
+    int deflated = 0;
+    {
+      MutexLocker ml(Threads_lock);
+      JavaThread* cur = Threads::first();
+      for (int i = 0; cur != NULL && i < processed; i++) {
+        cur = cur->next();
+      }
+      for (int n = 0; cur != NULL && n < ThreadsPerChunk; n++, cur = cur->next()) {
+        Thread::muxAcquire (&cur->omInUseLock, "deflate_idle_monitors_using_marker") ;
+        nInCirculation += cur->omInUseCount;
+        int deflatedcount = walk_monitor_list(cur->omInUseList_addr(), &FreeHead, &FreeTail, true);
+        cur->omInUseCount -= deflatedcount;
+        Thread::muxRelease (&cur->omInUseLock) ;
+        deflated += deflatedcount;
+        processed++;
+      }
+      done = (cur == NULL);
+    }
+
+    Thread::muxAcquire (&ListLock, "deflate_idle_monitors_using_marker") ;
+    if (done && gOmInUseList != NULL) {
+      // For moribund threads, scan gOmInUseList
+      nInCirculation += gOmInUseCount;
+      int deflatedcount = walk_monitor_list((ObjectMonitor **)&gOmInUseList, &FreeHead, &FreeTail, true);
+      gOmInUseCount -= deflatedcount;
+      deflated += deflatedcount;
+    }
+    if (FreeHead != NULL) {
+      guarantee (FreeTail != NULL && deflated > 0, "invariant") ;
+      assert (FreeTail->FreeNext == NULL, "invariant") ;
+      FreeTail->FreeNext = gDeflatedList ;
+      gDeflatedList = FreeHead ;
+      gDeflatedCount += deflated ;
+    }
+    Thread::muxRelease (&ListLock) ;
+    nScavenged += deflated;
+
+    if (!done) {
+      // Let a pending safepoint proceed.
+      ThreadBlockInVM tbivm(self);
+    }
+  }
+
+  LastAsyncDeflation = os::javaTimeNanos();
+  if (TraceMonitorInflation) {
+    tty->print_cr("Async deflation: deflated %d of %d monitors in use by %d threads in %.3f ms",
+                  nScavenged, nInCirculation, processed,
+                  (double)(LastAsyncDeflation - start) / NANOSECS_PER_MILLISEC);
+  }
+}
+
 // Monitor cleanup on JavaThread::exit
 
 // Iterate through monitor cache and attempt to release thread's monitors
@@ -115,9 +115,17 @@ class ObjectSynchronizer : AllStatic {
   static void deflate_idle_monitors();
   static int walk_monitor_list(ObjectMonitor** listheadp,
                                ObjectMonitor** FreeHeadp,
-                               ObjectMonitor** FreeTailp);
+                               ObjectMonitor** FreeTailp,
+                               bool using_marker = false);
   static bool deflate_monitor(ObjectMonitor* mid, oop obj, ObjectMonitor** FreeHeadp,
                               ObjectMonitor** FreeTailp);
+  // With AsyncDeflateIdleMonitors, idle monitors are deflated by the
+  // ServiceThread and only recycled by deflate_idle_monitors().
+  static bool is_async_deflation_needed();
+  static bool is_cleanup_needed();
+  static void deflate_idle_monitors_using_marker(JavaThread* self);
+  static bool deflate_monitor_using_marker(ObjectMonitor* mid, ObjectMonitor** FreeHeadp,
+                                           ObjectMonitor** FreeTailp);
   static void oops_do(OopClosure* f);
 
   // debugging
@@ -135,6 +143,8 @@ class ObjectSynchronizer : AllStatic {
   static ObjectMonitor * volatile gFreeList;
   static ObjectMonitor * volatile gOmInUseList; // for moribund thread, so monitors they inflated still get scanned
   static int gOmInUseCount;
+  static ObjectMonitor * volatile gDeflatedList; // deflated concurrently, recycled at the next safepoint
+  static int gDeflatedCount;
 
 };
 
@@ -54,6 +54,7 @@
 #include "runtime/deoptimization.hpp"
 #include "runtime/fprofiler.hpp"
 #include "runtime/frame.inline.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/init.hpp"
 #include "runtime/interfaceSupport.hpp"
 #include "runtime/java.hpp"
@@ -62,12 +63,14 @@
 #include "runtime/memprofiler.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/objectMonitor.hpp"
+#include "runtime/objectMonitor.inline.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/osThread.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/statSampler.hpp"
 #include "runtime/stubRoutines.hpp"
+#include "runtime/sweeper.hpp"
 #include "runtime/task.hpp"
 #include "runtime/thread.inline.hpp"
 #include "runtime/threadCritical.hpp"
@@ -224,6 +227,7 @@ Thread::Thread() {
   set_stack_size(0);
   set_self_raw_id(0);
   set_lgrp_id(-1);
+  _medium_tlab.set_medium();
 
   // allocated data structures
   set_osthread(NULL);
@@ -261,6 +265,7 @@ Thread::Thread() {
   omFreeProvision = 32 ;
   omInUseList = NULL ;
   omInUseCount = 0 ;
+  omInUseLock = 0 ;
 
 #ifdef ASSERT
   _visited_for_critical_count = false;
@@ -877,6 +882,7 @@ void Thread::print_on(outputStream* st) const {
 void Thread::print_on_error(outputStream* st, char* buf, int buflen) const {
   if      (is_VM_thread())                  st->print("VMThread");
   else if (is_Compiler_thread())            st->print("CompilerThread");
+  else if (is_Code_cache_sweeper_thread())  st->print("CodeCacheSweeperThread");
   else if (is_Java_thread())                st->print("JavaThread");
   else if (is_GC_task_thread())             st->print("GCTaskThread");
   else if (is_Watcher_thread())             st->print("WatcherThread");
@@ -1584,6 +1590,8 @@ void JavaThread::initialize() {
   _pending_jni_exception_check_fn = NULL;
   _do_not_unlock_if_synchronized = false;
   _cached_monitor_info = NULL;
+  _handshake_operation = NULL;
+  _handshake_state = 0;
   _parker = Parker::Allocate(this) ;
   _scanned_nmethod = NULL;
 
@@ -2032,6 +2040,7 @@ void JavaThread::exit(bool destroy_vm, ExitType exit_type) {
 
   if (UseTLAB) {
     tlab().make_parsable(true);  // retire TLAB
+    medium_tlab().make_parsable(true);
   }
 
   if (JvmtiEnv::environments_might_exist()) {
@@ -2111,6 +2120,7 @@ void JavaThread::cleanup_failed_attach_current_thread() {
 
   if (UseTLAB) {
     tlab().make_parsable(true);  // retire TLAB, if any
+    medium_tlab().make_parsable(true);
   }
 
 #if INCLUDE_ALL_GCS
@@ -2537,6 +2547,10 @@ void JavaThread::check_safepoint_and_suspend_for_native_trans(JavaThread *thread
     SafepointSynchronize::block(curJT);
   }
 
+  if (thread->has_handshake() && curJT == thread) {
+    Handshake::process_by_self(thread);
+  }
+
   if (thread->is_deopt_suspend()) {
     thread->clear_deopt_suspend();
     RegisterMap map(thread, false);
@@ -2913,6 +2927,7 @@ void JavaThread::oops_do(OopClosure* f, CLDClosure* cld_f, CodeBlobClosure* cf)
   f->do_oop((oop*) &_vm_result);
   f->do_oop((oop*) &_exception_oop);
   f->do_oop((oop*) &_pending_async_exception);
+  _lock_stack.oops_do(f);
 
   if (jvmti_thread_state() != NULL) {
     jvmti_thread_state()->oops_do(f);
@@ -3376,7 +3391,6 @@ CompilerThread::CompilerThread(CompileQueue* queue, CompilerCounters* counters)
   _queue = queue;
   _counters = counters;
   _buffer_blob = NULL;
-  _scanned_nmethod = NULL;
   _compiler = NULL;
 
   // Compiler uses resource area for compilation, let's bias it to mtCompiler
@@ -3393,14 +3407,14 @@ bool CompilerThread::can_call_java() const {
 }
 #endif // INCLUDE_JVMCI
 
-void CompilerThread::oops_do(OopClosure* f, CLDClosure* cld_f, CodeBlobClosure* cf) {
-  JavaThread::oops_do(f, cld_f, cf);
-  if (_scanned_nmethod != NULL && cf != NULL) {
-    // Safepoints can occur when the sweeper is scanning an nmethod so
-    // process it here to make sure it isn't unloaded in the middle of
-    // a scan.
-    cf->do_code_blob(_scanned_nmethod);
-  }
+static void sweeper_thread_entry(JavaThread* thread, TRAPS) {
+  assert(thread->is_Code_cache_sweeper_thread(), "must be sweeper thread");
+  NMethodSweeper::sweeper_loop();
+}
+
+// Create a CodeCacheSweeperThread
+CodeCacheSweeperThread::CodeCacheSweeperThread()
+: JavaThread(&sweeper_thread_entry) {
 }
 
 
@@ -4471,6 +4485,29 @@ JavaThread *Threads::owning_thread_from_monitor_owner(address owner, bool doLock
   return the_owner;
 }
 
+JavaThread *Threads::owning_thread_from_object(oop obj, bool doLock) {
+  assert(UseLightweightLocking, "only used for lightweight locking");
+  assert(doLock ||
+         Threads_lock->owned_by_self() ||
+         SafepointSynchronize::is_at_safepoint(),
+         "must grab Threads_lock or be at safepoint");
+
+  MutexLockerEx ml(doLock ? Threads_lock : NULL);
+  ALL_JAVA_THREADS(p) {
+    if (p->lock_stack().contains(obj)) {
+      return p;
+    }
+  }
+  return NULL;
+}
+
+JavaThread *Threads::owning_thread_from_monitor(ObjectMonitor* monitor, bool doLock) {
+  if (UseLightweightLocking && monitor->is_owner_anonymous()) {
+    return owning_thread_from_object((oop)monitor->object(), doLock);
+  }
+  return owning_thread_from_monitor_owner((address)monitor->owner(), doLock);
+}
+
 // Threads::print_on() is called at safepoint by VM_PrintThreads operation.
 void Threads::print_on(outputStream* st, bool print_stacks, bool internal_format, bool print_concurrent_locks) {
   char buf[32];
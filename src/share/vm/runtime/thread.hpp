@@ -33,6 +33,7 @@
 #include "runtime/frame.hpp"
 #include "runtime/javaFrameAnchor.hpp"
 #include "runtime/jniHandles.hpp"
+#include "runtime/lockStack.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "runtime/osThread.hpp"
@@ -78,6 +79,7 @@ class jvmtiDeferredLocalVariableSet;
 
 class GCTaskQueue;
 class ThreadClosure;
+class HandshakeClosure;
 class IdealGraphPrinter;
 
 class JVMCIEnv;
@@ -198,7 +200,8 @@ class Thread: public ThreadShadow {
     _deopt_suspend          = 0x10000000U, // thread needs to self suspend for deopt
 
     _has_async_exception    = 0x00000001U, // there is a pending async exception
-    _critical_native_unlock = 0x00000002U  // Must call back to unlock JNI critical lock
+    _critical_native_unlock = 0x00000002U, // Must call back to unlock JNI critical lock
+    _has_handshake          = 0x00000004U  // a handshake is armed (see handshake.hpp)
   };
 
   // various suspension related flags - atomically updated
@@ -265,6 +268,7 @@ class Thread: public ThreadShadow {
   friend class GC_locker;
 
   ThreadLocalAllocBuffer _tlab;                 // Thread-local eden
+  ThreadLocalAllocBuffer _medium_tlab;          // Objects that miss a retained _tlab
   jlong _allocated_bytes;                       // Cumulative number of bytes allocated on
                                                 // the Java heap
 
@@ -292,6 +296,7 @@ class Thread: public ThreadShadow {
   int omFreeProvision;                          // reload chunk size
   ObjectMonitor* omInUseList;                   // SLL to track monitors in circulation
   int omInUseCount;                             // length of omInUseList
+  volatile intptr_t omInUseLock;                // protects omInUseList from the async deflater
 
 #ifdef ASSERT
  private:
@@ -321,6 +326,7 @@ class Thread: public ThreadShadow {
   virtual bool is_VM_thread()       const            { return false; }
   virtual bool is_Java_thread()     const            { return false; }
   virtual bool is_Compiler_thread() const            { return false; }
+  virtual bool is_Code_cache_sweeper_thread() const  { return false; }
   virtual bool is_hidden_from_external_view() const  { return false; }
   virtual bool is_jvmti_agent_thread() const         { return false; }
   // True iff the thread can perform GC operations at a safepoint.
@@ -393,6 +399,10 @@ class Thread: public ThreadShadow {
   void set_critical_native_unlock() {
     set_suspend_flag(_critical_native_unlock);
   }
+
+  bool has_handshake() const { return (_suspend_flags & _has_handshake) != 0; }
+  void set_has_handshake()   { set_suspend_flag(_has_handshake); }
+  void clear_has_handshake() { clear_suspend_flag(_has_handshake); }
   void clear_critical_native_unlock() {
     clear_suspend_flag(_critical_native_unlock);
   }
@@ -444,9 +454,11 @@ class Thread: public ThreadShadow {
 
   // Thread-Local Allocation Buffer (TLAB) support
   ThreadLocalAllocBuffer& tlab()                 { return _tlab; }
+  ThreadLocalAllocBuffer& medium_tlab()          { return _medium_tlab; }
   void initialize_tlab() {
     if (UseTLAB) {
       tlab().initialize();
+      medium_tlab().initialize();
     }
   }
 
@@ -627,6 +639,7 @@ protected:
   static ByteSize tlab_##name##_offset()         { return byte_offset_of(Thread, _tlab) + ThreadLocalAllocBuffer::name##_offset(); }
 
   TLAB_FIELD_OFFSET(start)
+  static ByteSize medium_tlab_start_offset()     { return byte_offset_of(Thread, _medium_tlab) + ThreadLocalAllocBuffer::start_offset(); }
   TLAB_FIELD_OFFSET(end)
   TLAB_FIELD_OFFSET(top)
   TLAB_FIELD_OFFSET(pf_top)
@@ -1856,6 +1869,25 @@ public:
   GrowableArray<MonitorInfo*>* cached_monitor_info() { return _cached_monitor_info; }
   void set_cached_monitor_info(GrowableArray<MonitorInfo*>* info) { _cached_monitor_info = info; }
 
+  // Thread-local handshake support (see handshake.hpp)
+private:
+  HandshakeClosure* volatile _handshake_operation;
+  volatile jint              _handshake_state;
+public:
+  HandshakeClosure* handshake_operation() const      { return _handshake_operation; }
+  void set_handshake_operation(HandshakeClosure* cl) { _handshake_operation = cl; }
+  jint handshake_state() const                       { return _handshake_state; }
+  volatile jint* handshake_state_addr()              { return &_handshake_state; }
+
+  // Lightweight locking support (see lockStack.hpp)
+private:
+  LockStack _lock_stack;
+public:
+  LockStack& lock_stack()                  { return _lock_stack; }
+  static ByteSize lock_stack_offset()      { return byte_offset_of(JavaThread, _lock_stack); }
+  static ByteSize lock_stack_top_offset()  { return lock_stack_offset() + LockStack::top_offset(); }
+  static ByteSize lock_stack_base_offset() { return lock_stack_offset() + LockStack::base_offset(); }
+
   // clearing/querying jni attach status
   bool is_attaching_via_jni() const { return _jni_attach_state == _attaching_via_jni; }
   bool has_attached_via_jni() const { return is_attaching_via_jni() || _jni_attach_state == _attached_via_jni; }
@@ -1923,7 +1955,6 @@ class CompilerThread : public JavaThread {
   CompileQueue*     _queue;
   BufferBlob*       _buffer_blob;
 
-  nmethod*          _scanned_nmethod;  // nmethod being scanned by the sweeper
   AbstractCompiler* _compiler;
 
  public:
@@ -1964,11 +1995,6 @@ class CompilerThread : public JavaThread {
     _log = log;
   }
 
-  // GC support
-  // Apply "f->do_oop" to all root oops in "this".
-  // Apply "cf->do_code_blob" (if !NULL) to all code blobs active in frames
-  void oops_do(OopClosure* f, CLDClosure* cld_f, CodeBlobClosure* cf);
-
 #ifndef PRODUCT
 private:
   IdealGraphPrinter *_ideal_graph_printer;
@@ -1980,18 +2006,23 @@ public:
   // Get/set the thread's current task
   CompileTask*  task()                           { return _task; }
   void          set_task(CompileTask* task)      { _task = task; }
-
-  // Track the nmethod currently being scanned by the sweeper
-  void          set_scanned_nmethod(nmethod* nm) {
-    assert(_scanned_nmethod == NULL || nm == NULL, "should reset to NULL before writing a new value");
-    _scanned_nmethod = nm;
-  }
 };
 
 inline CompilerThread* CompilerThread::current() {
   return JavaThread::current()->as_CompilerThread();
 }
 
+// Dedicated thread to sweep the code cache, used with -XX:+UseCodeCacheSweeperThread
+class CodeCacheSweeperThread : public JavaThread {
+ public:
+  CodeCacheSweeperThread();
+
+  bool is_Code_cache_sweeper_thread() const      { return true; }
+
+  // Hide sweeper thread from external view.
+  bool is_hidden_from_external_view() const      { return true; }
+};
+
 
 // The active thread queue. It also keeps track of the current used
 // thread priorities.
@@ -2082,6 +2113,15 @@ class Threads: AllStatic {
   static JavaThread *owning_thread_from_monitor_owner(address owner,
     bool doLock);
 
+  // Get the owning Java thread of an object that is fast-locked with
+  // UseLightweightLocking, i.e. the thread that has it on its lock stack.
+  static JavaThread *owning_thread_from_object(oop obj, bool doLock);
+
+  // Get the owning Java thread of an inflated monitor, which may still be
+  // owned anonymously if lightweight locking is used.
+  static JavaThread *owning_thread_from_monitor(ObjectMonitor* monitor,
+    bool doLock);
+
   // Number of threads on the active threads list
   static int number_of_threads()                 { return _number_of_threads; }
   // Number of non-daemon threads on the active threads list
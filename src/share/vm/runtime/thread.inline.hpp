@@ -53,7 +53,11 @@ inline jlong Thread::cooked_allocated_bytes() {
     if ((ssize_t)used_bytes > 0) {
       // More-or-less valid tlab. The load_acquire above should ensure
       // that the result of the add is <= the instantaneous value.
-      return allocated_bytes + used_bytes;
+      allocated_bytes += used_bytes;
+    }
+    used_bytes = medium_tlab().used_bytes();
+    if ((ssize_t)used_bytes > 0) {
+      allocated_bytes += used_bytes;
     }
   }
   return allocated_bytes;
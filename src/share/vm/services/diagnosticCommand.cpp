@@ -25,8 +25,11 @@
 #include "precompiled.hpp"
 #include "classfile/classLoaderStats.hpp"
 #include "gc_implementation/shared/vmGCOperations.hpp"
+#include "memory/metaspace.hpp"
+#include "memory/threadLocalAllocBuffer.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/os.hpp"
+#include "runtime/safepointProfiler.hpp"
 #include "services/diagnosticArgument.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/diagnosticFramework.hpp"
@@ -51,9 +54,12 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<PrintVMFlagsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<VMDynamicLibrariesDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<VMUptimeDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SafepointProfileDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<MetaspaceDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SystemGCDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<TLABStatsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<FinalizerInfoDCmd>(full_export, true, false));
 #if INCLUDE_SERVICES // Heap dumping/inspection supported
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapDumpDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
@@ -262,6 +268,36 @@ int VMUptimeDCmd::num_arguments() {
   }
 }
 
+SafepointProfileDCmd::SafepointProfileDCmd(outputStream* output, bool heap) :
+                                           DCmdWithParser(output, heap),
+  _count("count", "Number of most recent safepoints to print", "INT", false, "10") {
+  _dcmdparser.add_dcmd_argument(&_count);
+}
+
+void SafepointProfileDCmd::execute(DCmdSource source, TRAPS) {
+  jlong count = _count.value();
+  if (count < 0) {
+    output()->print_cr("Invalid count: " JLONG_FORMAT, count);
+    return;
+  }
+  TimeToSafepointProfiler::print_on(output(), (uint)MIN2(count, (jlong)max_juint));
+}
+
+int SafepointProfileDCmd::num_arguments() {
+  ResourceMark rm;
+  SafepointProfileDCmd* dcmd = new SafepointProfileDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
+void MetaspaceDCmd::execute(DCmdSource source, TRAPS) {
+  MetaspaceAux::print_report(output());
+}
+
 void SystemGCDCmd::execute(DCmdSource source, TRAPS) {
   if (!DisableExplicitGC) {
     Universe::heap()->collect(GCCause::_java_lang_system_gc);
@@ -284,6 +320,14 @@ void HeapInfoDCmd::execute(DCmdSource source, TRAPS) {
   Universe::heap()->print_on(output());
 }
 
+void TLABStatsDCmd::execute(DCmdSource source, TRAPS) {
+  if (!UseTLAB) {
+    output()->print_cr("TLABs are not in use.");
+    return;
+  }
+  ThreadLocalAllocBuffer::print_all_on(output());
+}
+
 void FinalizerInfoDCmd::execute(DCmdSource source, TRAPS) {
   ResourceMark rm;
 
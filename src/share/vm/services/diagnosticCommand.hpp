@@ -171,6 +171,47 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class SafepointProfileDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<jlong> _count;
+public:
+  SafepointProfileDCmd(outputStream* output, bool heap);
+  static const char* name() { return "VM.safepoint_profile"; }
+  static const char* description() {
+    return "Print the last threads to reach recent safepoints and where "
+           "they were executing. Requires -XX:+ProfileTimeToSafepoint.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class MetaspaceDCmd : public DCmd {
+public:
+  MetaspaceDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
+  static const char* name() { return "VM.metaspace"; }
+  static const char* description() {
+    return "Print committed and used Metaspace and the free chunk lists.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments() { return 0; }
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 class SystemGCDCmd : public DCmd {
 public:
   SystemGCDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
@@ -219,6 +260,26 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class TLABStatsDCmd : public DCmd {
+public:
+  TLABStatsDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
+  static const char* name() { return "GC.tlab_stats"; }
+  static const char* description() {
+    return "Print per-thread TLAB sizes, refills and waste since the last GC.";
+  }
+  static const char* impact() {
+    return "Low: Depends on the number of threads.";
+  }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+      "monitor", NULL};
+      return p;
+  }
+
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 class FinalizerInfoDCmd : public DCmd {
 public:
   FinalizerInfoDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
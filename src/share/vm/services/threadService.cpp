@@ -338,8 +338,8 @@ DeadlockCycle* ThreadService::find_deadlocks_at_safepoint(bool concurrent_locks)
       if (waitingToLockMonitor != NULL) {
         address currentOwner = (address)waitingToLockMonitor->owner();
         if (currentOwner != NULL) {
-          currentThread = Threads::owning_thread_from_monitor_owner(
-                            currentOwner,
+          currentThread = Threads::owning_thread_from_monitor(
+                            waitingToLockMonitor,
                             false /* no locking needed */);
           if (currentThread == NULL) {
             // This function is called at a safepoint so the JavaThread
@@ -899,8 +899,8 @@ void DeadlockCycle::print_on(outputStream* st) const {
         // No Java object associated - a JVMTI raw monitor
         owner_desc = " (JVMTI raw monitor),\n  which is held by";
       }
-      currentThread = Threads::owning_thread_from_monitor_owner(
-                        (address)waitingToLockMonitor->owner(),
+      currentThread = Threads::owning_thread_from_monitor(
+                        waitingToLockMonitor,
                         false /* no locking needed */);
       if (currentThread == NULL) {
         // The deadlock was detected at a safepoint so the JavaThread
@@ -102,6 +102,8 @@ template <class T, MEMFLAGS F> juint RehashableHashtable<T, F>::_seed = 0;
 
 template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::move_to(RehashableHashtable<T, F>* new_table) {
 
+  assert(!is_resizing(), "cannot rehash while resizing");
+
   // Initialize the global seed for hashing.
   _seed = AltHashing::compute_seed();
   assert(seed() != 0, "shouldn't be zero");
@@ -142,6 +144,104 @@ template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::move_to(Rehashabl
   BasicHashtable<F>::free_buckets();
 }
 
+template <class T, MEMFLAGS F> bool RehashableHashtable<T, F>::needs_resize(uintx load_factor) {
+  if (load_factor == 0 || DumpSharedSpaces || is_resizing() || _retired_buckets != NULL) {
+    return false;
+  }
+  int size = this->table_size();
+  return size <= max_resize_table_size / 2 &&
+         (uintx)this->number_of_entries() > (uintx)size * load_factor;
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::start_resize() {
+  assert(!is_resizing() && _retired_buckets == NULL, "resize already in progress");
+  int old_size = this->table_size();
+  int new_size = old_size * 2;
+  HashtableBucket<F>* old_buckets = this->buckets();
+  HashtableBucket<F>* new_buckets = NEW_C_HEAP_ARRAY2(HashtableBucket<F>, new_size, F, CURRENT_PC);
+  for (int i = 0; i < old_size; i++) {
+    *new_buckets[i].entry_addr() = old_buckets[i].get_entry();
+    *new_buckets[old_size + i].entry_addr() = HashtableBucket<F>::make_redirect(i);
+  }
+  _resize_old_size = old_size;
+  _resize_next = 0;
+  // Readers that loaded the old size may still be using the old array.
+  _retired_buckets = old_buckets;
+  this->set_buckets(new_buckets, new_size);
+}
+
+// Moves the entries of the lower bucket 'index' that belong to the upper
+// half into the upper bucket. Both chains keep their order and the links
+// only ever skip forward, so concurrent readers walking the old chain
+// still reach its end.
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::split_bucket(int index) {
+  assert(index < _resize_old_size, "not a lower bucket");
+  HashtableBucket<F>* b = this->buckets();
+  if (!b[index + _resize_old_size].is_redirect()) {
+    return;
+  }
+  BasicHashtableEntry<F>* lower_head = NULL;
+  BasicHashtableEntry<F>* lower_tail = NULL;
+  BasicHashtableEntry<F>* upper_head = NULL;
+  BasicHashtableEntry<F>* upper_tail = NULL;
+  for (BasicHashtableEntry<F>* e = b[index].get_entry(); e != NULL; ) {
+    BasicHashtableEntry<F>* next = e->next();
+    if (this->hash_to_index(e->hash()) == index) {
+      if (lower_tail == NULL) {
+        lower_head = e;
+      } else {
+        lower_tail->relink(e);
+      }
+      lower_tail = e;
+    } else {
+      if (upper_tail == NULL) {
+        upper_head = e;
+      } else {
+        upper_tail->relink(e);
+      }
+      upper_tail = e;
+    }
+    e = next;
+  }
+  if (lower_tail != NULL) {
+    lower_tail->relink(NULL);
+  }
+  if (upper_tail != NULL) {
+    upper_tail->relink(NULL);
+  }
+  // Publish the upper chain first; until the lower bucket is replaced,
+  // readers of either bucket can still walk the whole chain.
+  b[index + _resize_old_size].set_entry(upper_head);
+  b[index].set_entry(lower_head);
+}
+
+template <class T, MEMFLAGS F> bool RehashableHashtable<T, F>::resize_step(int count) {
+  assert(is_resizing(), "not resizing");
+  int end = MIN2(_resize_next + count, _resize_old_size);
+  for (int i = _resize_next; i < end; i++) {
+    split_bucket(i);
+  }
+  _resize_next = end;
+  if (end < _resize_old_size) {
+    return true;
+  }
+  _resize_old_size = 0;
+  _resize_next = 0;
+  return false;
+}
+
+template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::free_retired_buckets() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  HashtableBucket<F>* retired = _retired_buckets;
+  if (retired != NULL) {
+    _retired_buckets = NULL;
+    if (!UseSharedSpaces ||
+        !FileMapInfo::current_info()->is_in_shared_space(retired)) {
+      FREE_C_HEAP_ARRAY(HashtableBucket, retired, F);
+    }
+  }
+}
+
 template <MEMFLAGS F> void BasicHashtable<F>::free_buckets() {
   if (NULL != _buckets) {
     // Don't delete the buckets in the shared space.  They aren't
@@ -290,6 +390,10 @@ template <class T, MEMFLAGS F> void RehashableHashtable<T, F>::dump_table(output
   int literal_bytes = 0;
   for (int i = 0; i < this->table_size(); ++i) {
     int count = 0;
+    if (is_redirect(i)) {
+      // Counted with the lower bucket until it is split
+      continue;
+    }
     for (HashtableEntry<T, F>* e = this->bucket(i);
        e != NULL; e = e->next()) {
       count++;
@@ -344,6 +448,9 @@ template <class T, MEMFLAGS F> void Hashtable<T, F>::print() {
   ResourceMark rm;
 
   for (int i = 0; i < BasicHashtable<F>::table_size(); i++) {
+    if (this->buckets()[i].is_redirect()) {
+      continue;
+    }
     HashtableEntry<T, F>* entry = bucket(i);
     while(entry != NULL) {
       tty->print("%d : ", i);
@@ -358,6 +465,9 @@ template <class T, MEMFLAGS F> void Hashtable<T, F>::print() {
 template <MEMFLAGS F> void BasicHashtable<F>::verify() {
   int count = 0;
   for (int i = 0; i < table_size(); i++) {
+    if (buckets()[i].is_redirect()) {
+      continue;
+    }
     for (BasicHashtableEntry<F>* p = bucket(i); p != NULL; p = p->next()) {
       ++count;
     }
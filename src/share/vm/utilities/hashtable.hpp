@@ -93,6 +93,11 @@ public:
   void set_shared() {
     _next = (BasicHashtableEntry<F>*)((intptr_t)_next | 1);
   }
+
+  // Changes the link with a single store, keeping the shared bit.
+  void relink(BasicHashtableEntry<F>* next) {
+    _next = (BasicHashtableEntry<F>*)((intptr_t)next | ((intptr_t)_next & 1));
+  }
 };
 
 
@@ -135,6 +140,21 @@ public:
 
   // The following method is not MT-safe and must be done under lock.
   BasicHashtableEntry<F>** entry_addr()  { return &_entry; }
+
+  // While a table is being resized, the upper half of the new bucket
+  // array consists of redirects to the lower bucket whose chain still
+  // holds the entries of both halves. A redirect is tagged with bit 0,
+  // which is never set in an entry pointer.
+  static bool is_redirect(BasicHashtableEntry<F>* e) {
+    return ((intptr_t)e & 1) != 0;
+  }
+  static int redirect_index(BasicHashtableEntry<F>* e) {
+    return (int)((intptr_t)e >> 1);
+  }
+  static BasicHashtableEntry<F>* make_redirect(int index) {
+    return (BasicHashtableEntry<F>*)(((intptr_t)index << 1) | 1);
+  }
+  bool is_redirect() const            { return is_redirect(get_entry()); }
 };
 
 
@@ -152,8 +172,9 @@ public:
 
   // Bucket handling
   int hash_to_index(unsigned int full_hash) {
-    int h = full_hash % _table_size;
-    assert(h >= 0 && h < _table_size, "Illegal hash value");
+    int table_size = _table_size;
+    int h = full_hash % table_size;
+    assert(h >= 0 && h < table_size, "Illegal hash value");
     return h;
   }
 
@@ -162,8 +183,8 @@ public:
 
 private:
   // Instance variables
-  int               _table_size;
-  HashtableBucket<F>*     _buckets;
+  volatile int      _table_size;
+  HashtableBucket<F>* volatile _buckets;
   BasicHashtableEntry<F>* volatile _free_list;
   char*             _first_free_entry;
   char*             _end_block;
@@ -183,6 +204,11 @@ protected:
   // Accessor
   int entry_size() const { return _entry_size; }
 
+  // Bucket array access for resizing. Lock-free readers load the size
+  // before the bucket array, so a new array is published before its size.
+  HashtableBucket<F>* buckets() const;
+  void set_buckets(HashtableBucket<F>* buckets, int table_size);
+
   // The following method is MT-safe and may be used with caution.
   BasicHashtableEntry<F>* bucket(int i);
 
@@ -300,16 +326,68 @@ template <class T, MEMFLAGS F> class RehashableHashtable : public Hashtable<T, F
     rehash_multiple = 60
   };
 
+  enum {
+    max_resize_table_size = 16 * M   // resizing stops at this many buckets
+  };
+
   // Check that the table is unbalanced
   bool check_rehash_table(int count);
 
+  // Online resizing. The table is doubled by publishing a new bucket
+  // array whose upper half redirects to the lower half, after which the
+  // buckets are split one at a time under the table lock. Splitting keeps
+  // the order of each chain and only moves links forward, so a lock-free
+  // reader never loops or faults; it can however miss an entry that was
+  // moved to the upper bucket, and has to retry under the lock if it
+  // raced with a resize.
+  int                 _resize_old_size;     // size before doubling, 0 if not resizing
+  int                 _resize_next;         // next lower bucket to split
+  HashtableBucket<F>* _retired_buckets;     // freed at the next safepoint
+
+  void split_bucket(int index);
+
  public:
   RehashableHashtable(int table_size, int entry_size)
-    : Hashtable<T, F>(table_size, entry_size) { }
+    : Hashtable<T, F>(table_size, entry_size),
+      _resize_old_size(0), _resize_next(0), _retired_buckets(NULL) { }
 
   RehashableHashtable(int table_size, int entry_size,
                    HashtableBucket<F>* buckets, int number_of_entries)
-    : Hashtable<T, F>(table_size, entry_size, buckets, number_of_entries) { }
+    : Hashtable<T, F>(table_size, entry_size, buckets, number_of_entries),
+      _resize_old_size(0), _resize_next(0), _retired_buckets(NULL) { }
+
+  // True if the average chain is longer than the load factor and the
+  // table can be doubled. Must be called with the table lock held.
+  bool needs_resize(uintx load_factor);
+  bool is_resizing() const               { return _resize_old_size != 0; }
+
+  // Resizing steps, all called with the table lock held. start_resize()
+  // doubles the table, resize_step() splits up to 'count' buckets and
+  // returns false once all buckets have been split.
+  void start_resize();
+  bool resize_step(int count);
+
+  // Must be called before adding an entry to the bucket 'index' of a
+  // table that is being resized.
+  void prepare_add(int index) {
+    if (is_resizing()) {
+      split_bucket(index % _resize_old_size);
+    }
+  }
+
+  // True if bucket 'i' only redirects to a bucket that has not been
+  // split yet. Iterations over all buckets must skip such buckets.
+  bool is_redirect(int i)                { return this->buckets()[i].is_redirect(); }
+
+  // The bucket whose chain holds entries with the given hash.
+  int chain_index(unsigned int hash) {
+    int index = this->hash_to_index(hash);
+    return is_redirect(index) ? index - _resize_old_size : index;
+  }
+
+  // Frees the bucket array replaced by the last resize. Called at a
+  // safepoint, when no lock-free reader can still be using it.
+  void free_retired_buckets();
 
 
   // Function to move these elements into the new table.
@@ -73,7 +73,26 @@ template <MEMFLAGS F> inline void BasicHashtable<F>::initialize(int table_size,
 
 // The following method is MT-safe and may be used with caution.
 template <MEMFLAGS F> inline BasicHashtableEntry<F>* BasicHashtable<F>::bucket(int i) {
-  return _buckets[i].get_entry();
+  // The index was computed from _table_size, which a resize stores after
+  // the larger bucket array.
+  OrderAccess::loadload();
+  HashtableBucket<F>* b = _buckets;
+  BasicHashtableEntry<F>* e = b[i].get_entry();
+  if (HashtableBucket<F>::is_redirect(e)) {
+    e = b[HashtableBucket<F>::redirect_index(e)].get_entry();
+  }
+  return e;
+}
+
+
+template <MEMFLAGS F> inline HashtableBucket<F>* BasicHashtable<F>::buckets() const {
+  return (HashtableBucket<F>*)OrderAccess::load_ptr_acquire(&_buckets);
+}
+
+
+template <MEMFLAGS F> inline void BasicHashtable<F>::set_buckets(HashtableBucket<F>* buckets, int table_size) {
+  OrderAccess::release_store_ptr(&_buckets, buckets);
+  OrderAccess::release_store(&_table_size, table_size);
 }
 
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Fill a small code cache with -XX:+UseCostAwareCodeCacheFlushing
+ *      and check that the methods that are always running are not evicted
+ *      and that profiled code gets no credit for its compile time.
+ * @library /testlibrary
+ * @run main CheckCostAwareFlushing
+ */
+import com.oracle.java.testlibrary.*;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+public class CheckCostAwareFlushing {
+  private static final Pattern EVICTED = Pattern.compile("Total number of evicted methods: (\\d+)");
+  private static final Pattern EVICTION = Pattern.compile(
+      "### Evicting nmethod \\d+/\\S+ (\\S+) \\(level (\\d)\\): .*, credit (\\d+\\.\\d)");
+
+  private static OutputAnalyzer run(String policy, String tiered) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions", policy, "-XX:+PrintCodeCacheEviction",
+        "-XX:+PrintMethodFlushingStatistics", tiered,
+        // Keep the hot methods out of their callers, so that their own
+        // nmethods are the ones running
+        "-XX:CompileCommand=dontinline,CheckCostAwareFlushing$Targets::m0",
+        "-XX:CompileCommand=dontinline,CheckCostAwareFlushing$Targets::m1",
+        "-XX:ReservedCodeCacheSize=3m", Workload.class.getName());
+    OutputAnalyzer out = new OutputAnalyzer(pb.start());
+    out.shouldHaveExitValue(0);
+    out.shouldContain("Code cache sweeper statistics");
+    return out;
+  }
+
+  private static String evicted(OutputAnalyzer out) {
+    Matcher m = EVICTED.matcher(out.getStdout());
+    return m.find() ? m.group(1) : "?";
+  }
+
+  private static void verifyEvictions(OutputAnalyzer out) {
+    Matcher m = EVICTION.matcher(out.getStdout());
+    while (m.find()) {
+      String method = m.group(1);
+      int level = Integer.parseInt(m.group(2));
+      double credit = Double.parseDouble(m.group(3));
+      if (method.startsWith("CheckCostAwareFlushing$Targets.m0(") ||
+          method.startsWith("CheckCostAwareFlushing$Targets.m1(")) {
+        throw new RuntimeException("Method that is always running was evicted: " + m.group());
+      }
+      if ((level == 2 || level == 3) && credit != 0.0) {
+        throw new RuntimeException("Profiled code was credited: " + m.group());
+      }
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    OutputAnalyzer plain = run("-XX:-UseCostAwareCodeCacheFlushing", "-XX:-TieredCompilation");
+    OutputAnalyzer costAware = run("-XX:+UseCostAwareCodeCacheFlushing", "-XX:-TieredCompilation");
+    verifyEvictions(costAware);
+    OutputAnalyzer tiered = run("-XX:+UseCostAwareCodeCacheFlushing", "-XX:+TieredCompilation");
+    verifyEvictions(tiered);
+    System.out.println("Evicted nmethods with a 3m code cache: hotness only " + evicted(plain) +
+                       ", cost aware " + evicted(costAware) + ", cost aware tiered " + evicted(tiered));
+  }
+
+  static class Workload {
+    public static void main(String[] args) throws Exception {
+      // m0 and m1 run nearly all the time, so every stack traversal
+      // finds them; the others are used every other round only
+      for (int round = 0; round < 40; round++) {
+        for (int i = 0; i < 20000; i++) {
+          Targets.m1(i);
+          if (round % 2 == 0) {
+            Targets.m2(i);
+            Targets.m3(i);
+          } else {
+            Targets.m4(i);
+            Targets.m5(i);
+          }
+          Targets.m6(i + round);
+          Targets.m7(i - round);
+        }
+        Thread.sleep(50);
+      }
+    }
+  }
+
+  static class Targets {
+    static int m0(int i) {
+      int s = i;
+      for (int j = 0; j < 200; j++) {
+        s = ((s * 31) ^ (s >>> 3)) + j;
+      }
+      return s;
+    }
+    static int m1(int i) { return Integer.bitCount(i) + m0(i) + m0(i + 1); }
+    static int m2(int i) { StringBuilder sb = new StringBuilder(); sb.append(i); return sb.length(); }
+    static int m3(int i) { return String.valueOf(i).hashCode(); }
+    static int m4(int i) { long l = i; return (int)(l * l % 1000003); }
+    static int m5(int i) { return Long.toHexString(i).length(); }
+    static int m6(int i) { return Math.abs(i) % 17; }
+    static int m7(int i) { return Integer.reverse(i) >>> 7; }
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Checks the code heaps of -XX:+SegmentedCodeCache and the
+ *      validation of the code heap sizes
+ * @library /testlibrary
+ *
+ */
+import com.oracle.java.testlibrary.*;
+
+public class CheckSegmentedCodeCache {
+  private static final String NON_METHOD   = "CodeHeap 'non-nmethods'";
+  private static final String PROFILED     = "CodeHeap 'profiled nmethods'";
+  private static final String NON_PROFILED = "CodeHeap 'non-profiled nmethods'";
+
+  private static OutputAnalyzer run(String... flags) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(flags);
+    return new OutputAnalyzer(pb.start());
+  }
+
+  private static void verifySegmented(OutputAnalyzer out, boolean profiled) throws Exception {
+    out.shouldHaveExitValue(0);
+    out.shouldContain(NON_METHOD);
+    out.shouldContain(NON_PROFILED);
+    if (profiled) {
+      out.shouldContain(PROFILED);
+    } else {
+      out.shouldNotContain(PROFILED);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    OutputAnalyzer out;
+
+    // A single code heap by default, even for large code caches
+    out = run("-XX:+TieredCompilation", "-XX:ReservedCodeCacheSize=240m",
+              "-XX:+PrintCodeCache", "-version");
+    out.shouldHaveExitValue(0);
+    out.shouldContain("CodeCache: size=");
+    out.shouldNotContain(NON_METHOD);
+
+    // Three code heaps with tiered compilation
+    out = run("-XX:+TieredCompilation", "-XX:+SegmentedCodeCache",
+              "-XX:ReservedCodeCacheSize=240m", "-XX:+PrintCodeCache", "-version");
+    verifySegmented(out, true);
+
+    // No profiled code heap when no code is profiled
+    out = run("-XX:+TieredCompilation", "-XX:TieredStopAtLevel=1", "-XX:+SegmentedCodeCache",
+              "-XX:ReservedCodeCacheSize=240m", "-XX:+PrintCodeCache", "-version");
+    verifySegmented(out, false);
+    out = run("-XX:-TieredCompilation", "-XX:+SegmentedCodeCache",
+              "-XX:ReservedCodeCacheSize=240m", "-XX:+PrintCodeCache", "-version");
+    verifySegmented(out, false);
+
+    // Explicit code heap sizes that add up to the code cache size
+    out = run("-XX:+TieredCompilation", "-XX:+SegmentedCodeCache",
+              "-XX:ReservedCodeCacheSize=100m", "-XX:NonNMethodCodeHeapSize=10m",
+              "-XX:ProfiledCodeHeapSize=40m", "-XX:NonProfiledCodeHeapSize=50m",
+              "-XX:+PrintCodeCache", "-version");
+    verifySegmented(out, true);
+
+    // Code heap sizes that do not add up to the code cache size
+    out = run("-XX:+TieredCompilation", "-XX:+SegmentedCodeCache",
+              "-XX:ReservedCodeCacheSize=100m", "-XX:NonNMethodCodeHeapSize=10m",
+              "-XX:ProfiledCodeHeapSize=40m", "-XX:NonProfiledCodeHeapSize=60m",
+              "-version");
+    out.shouldContain("Invalid code heap sizes");
+    out.shouldHaveExitValue(1);
+
+    // A non-method code heap too small for the VM stubs
+    out = run("-XX:+SegmentedCodeCache", "-XX:ReservedCodeCacheSize=100m",
+              "-XX:NonNMethodCodeHeapSize=64k", "-version");
+    out.shouldContain("Invalid code heap sizes");
+    out.shouldHaveExitValue(1);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Sweep the code cache with -XX:+UseCodeCacheSweeperThread while
+ *      compiled code is invalidated, and check StartAggressiveSweepingAt
+ * @library /testlibrary
+ * @run main CheckSweeperThread
+ */
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.*;
+
+public class CheckSweeperThread {
+  private static OutputAnalyzer run(String... flags) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(flags);
+    return new OutputAnalyzer(pb.start());
+  }
+
+  private static long statistic(OutputAnalyzer out, String name) {
+    Matcher m = Pattern.compile("Total number of " + name + " methods:\\s+(\\d+)").matcher(out.getOutput());
+    if (!m.find()) {
+      throw new RuntimeException("No count of " + name + " methods in the output");
+    }
+    return Long.parseLong(m.group(1));
+  }
+
+  private static void verifySwept(OutputAnalyzer out) {
+    out.shouldHaveExitValue(0);
+    out.shouldContain("Code cache sweeper statistics");
+    if (statistic(out, "zombified") == 0 || statistic(out, "flushed") == 0) {
+      System.out.println(out.getOutput());
+      throw new RuntimeException("The sweeper thread did not reclaim the invalidated code");
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    OutputAnalyzer out;
+
+    // Compiled code made not entrant by class loading is swept by the thread
+    out = run("-XX:+UnlockDiagnosticVMOptions", "-XX:+UseCodeCacheSweeperThread",
+              "-XX:+PrintMethodFlushingStatistics", "-XX:NmethodSweepCheckInterval=1",
+              "-XX:StartAggressiveSweepingAt=50", "-XX:ReservedCodeCacheSize=16m",
+              Workload.class.getName());
+    verifySwept(out);
+
+    // A notification for low free space starts a stack traversal and a sweep
+    // of its own, without waiting for a safepoint
+    out = run("-XX:+UnlockDiagnosticVMOptions", "-XX:+UseCodeCacheSweeperThread",
+              "-XX:+PrintMethodFlushingStatistics", "-XX:NmethodSweepCheckInterval=1",
+              "-XX:StartAggressiveSweepingAt=100", "-XX:ReservedCodeCacheSize=16m",
+              Workload.class.getName());
+    verifySwept(out);
+
+    // The percentage must be usable as a divisor
+    out = run("-XX:+UseCodeCacheSweeperThread", "-XX:StartAggressiveSweepingAt=0", "-version");
+    out.shouldContain("StartAggressiveSweepingAt of 0 is invalid");
+    out.shouldHaveExitValue(1);
+  }
+
+  static class Base {
+    int value() { return 1; }
+  }
+
+  static class Workload {
+    static final int CLASSES = 8;
+
+    static int call(Base b) {
+      int sum = 0;
+      for (int i = 0; i < 100; i++) {
+        sum += b.value();
+      }
+      return sum;
+    }
+
+    public static void main(String[] args) throws Exception {
+      Base b = new Base();
+      for (int c = 0; c < CLASSES; c++) {
+        for (int i = 0; i < 20000; i++) {
+          call(b);
+        }
+        // Loading a subclass invalidates the compiled code that inlined Base.value()
+        b = (Base)Class.forName(CheckSweeperThread.class.getName() + "$Sub" + c).newInstance();
+        Thread.sleep(500);
+      }
+      // Each safepoint starts another stack traversal, which the sweeper
+      // thread then completes; it takes a few to flush not-entrant code.
+      for (int i = 0; i < 5; i++) {
+        System.gc();
+        Thread.sleep(1100);
+      }
+    }
+  }
+
+  static class Sub0 extends Base { int value() { return 2; } }
+  static class Sub1 extends Base { int value() { return 3; } }
+  static class Sub2 extends Base { int value() { return 4; } }
+  static class Sub3 extends Base { int value() { return 5; } }
+  static class Sub4 extends Base { int value() { return 6; } }
+  static class Sub5 extends Base { int value() { return 7; } }
+  static class Sub6 extends Base { int value() { return 8; } }
+  static class Sub7 extends Base { int value() { return 9; } }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Run methods with rarely taken paths, implicit null checks and
+ *      exception handlers compiled with -XX:+SplitColdCode, which moves the
+ *      uncommon blocks behind the frequent ones. Debug builds also check
+ *      with -XX:+PrintOptoAssembly that the uncommon traps come after the
+ *      return of the method, and before it with -XX:-SplitColdCode.
+ *
+ * @library /testlibrary
+ * @run main/othervm -Xbatch -XX:-TieredCompilation -XX:+SplitColdCode
+ *      -XX:CompileCommand=compileonly,TestSplitColdCode::* TestSplitColdCode
+ * @run main/othervm TestSplitColdCode layout
+ */
+
+import java.util.List;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestSplitColdCode {
+  static final int ITERATIONS = 20000;
+
+  static int[] array = new int[16];
+
+  static int rarePath(int i, int[] a) {
+    int sum = a.length;
+    if (i == ITERATIONS - 1) {
+      // Taken once, after compilation
+      sum += 1000;
+    }
+    for (int j = 0; j < a.length; j++) {
+      sum += a[j] + i;
+    }
+    return sum;
+  }
+
+  static int nullCheck(Object o) {
+    return o.hashCode() & 1;
+  }
+
+  static int handler(int[] a, int i) {
+    try {
+      return a[i];
+    } catch (ArrayIndexOutOfBoundsException e) {
+      return -1;
+    }
+  }
+
+  static void check(int actual, int expected, String what) {
+    if (actual != expected) {
+      throw new RuntimeException(what + ": " + actual + " != " + expected);
+    }
+  }
+
+  // Returns the line numbers of the last return and of the first uncommon
+  // trap in the listing of rarePath.
+  static int[] compileRarePath(String splitColdCode) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+        "-Xbatch", "-XX:-TieredCompilation", "-XX:-UseOnStackReplacement",
+        splitColdCode, "-XX:+PrintOptoAssembly",
+        "-XX:CompileCommand=compileonly,TestSplitColdCode::rarePath",
+        "TestSplitColdCode");
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+    output.shouldHaveExitValue(0);
+
+    Pattern ret = Pattern.compile("^\\s*[0-9a-f]+\\s+ret\\b");
+    List<String> lines = output.asLines();
+    int lastRet = -1;
+    int firstTrap = -1;
+    for (int i = 0; i < lines.size(); i++) {
+      String line = lines.get(i);
+      if (ret.matcher(line).find()) {
+        lastRet = i;
+      } else if (firstTrap < 0 && line.contains("wrapper for: uncommon_trap")) {
+        firstTrap = i;
+      }
+    }
+    if (lastRet < 0 || firstTrap < 0) {
+      System.out.println(output.getOutput());
+      throw new RuntimeException("No return or uncommon trap in the listing of rarePath " +
+                                 "with " + splitColdCode);
+    }
+    return new int[] { lastRet, firstTrap };
+  }
+
+  static void checkLayout() throws Exception {
+    if (!Platform.isDebugBuild()) {
+      System.out.println("PrintOptoAssembly is not available, layout not checked");
+      return;
+    }
+    int[] split = compileRarePath("-XX:+SplitColdCode");
+    if (split[1] < split[0]) {
+      throw new RuntimeException("Uncommon trap at line " + split[1] +
+                                 " is placed before the return at line " + split[0] +
+                                 " with -XX:+SplitColdCode");
+    }
+    // The frequency based layout appends the trap to the trace of the
+    // test that guards it, ahead of the return.
+    int[] inline = compileRarePath("-XX:-SplitColdCode");
+    if (inline[1] > inline[0]) {
+      throw new RuntimeException("Uncommon trap at line " + inline[1] +
+                                 " is placed after the return at line " + inline[0] +
+                                 " with -XX:-SplitColdCode");
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 0 && args[0].equals("layout")) {
+      checkLayout();
+      return;
+    }
+    Object o = new Object();
+    int expectedHash = o.hashCode() & 1;
+    for (int i = 0; i < ITERATIONS; i++) {
+      int expected = array.length + array.length * i + (i == ITERATIONS - 1 ? 1000 : 0);
+      check(rarePath(i, array), expected, "rarePath");
+      check(nullCheck(o), expectedHash, "nullCheck");
+      check(handler(array, i & 15), 0, "handler");
+    }
+    check(handler(array, 16), -1, "handler");
+    try {
+      nullCheck(null);
+      throw new RuntimeException("no NullPointerException");
+    } catch (NullPointerException e) {
+      // expected
+    }
+  }
+}
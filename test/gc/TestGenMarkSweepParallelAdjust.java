@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* This code is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License version 2 only, as
+* published by the Free Software Foundation.
+*
+* This code is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* version 2 for more details (a copy is included in the LICENSE file that
+* accompanied this code).
+*
+* You should have received a copy of the GNU General Public License version
+* 2 along with this work; if not, write to the Free Software Foundation,
+* Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+*
+* Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+* or visit www.oracle.com if you need additional information or have any
+* questions.
+*/
+
+/*
+ * @test TestGenMarkSweepParallelAdjust
+ * @key gc
+ * @requires vm.gc=="null"
+ * @summary Run full collections of the serial and CMS collectors with parallel pointer adjustment
+ * @run main/othervm -XX:+UseParNewGC -XX:ParallelGCThreads=4 -XX:+GenMarkSweepParallelAdjustEnabled -XX:+UnlockDiagnosticVMOptions -XX:+VerifyAfterGC TestGenMarkSweepParallelAdjust
+ * @run main/othervm -XX:+UseConcMarkSweepGC -XX:ParallelGCThreads=4 -XX:+GenMarkSweepParallelAdjustEnabled -XX:+UnlockDiagnosticVMOptions -XX:+VerifyAfterGC TestGenMarkSweepParallelAdjust
+ * @run main/othervm -XX:+UseConcMarkSweepGC -XX:ParallelGCThreads=4 TestGenMarkSweepParallelAdjust
+ */
+
+public class TestGenMarkSweepParallelAdjust {
+    static class Node {
+        Node next;
+        Object payload;
+        int id;
+    }
+
+    public static void main(String args[]) throws Exception {
+        // Build a long list interleaved with garbage so that full
+        // collections move objects and have many pointers to adjust.
+        Node head = null;
+        Object garbage = null;
+        for (int i = 0; i < 500_000; i++) {
+            Node n = new Node();
+            n.id = i;
+            n.payload = new int[i % 16];
+            n.next = head;
+            head = n;
+            garbage = new byte[32];
+        }
+        for (int round = 0; round < 3; round++) {
+            System.gc();
+            int expected = 499_999;
+            for (Node n = head; n != null; n = n.next) {
+                if (n.id != expected || ((int[])n.payload).length != expected % 16) {
+                    throw new RuntimeException("Corrupted list at " + expected + ": " + n.id);
+                }
+                expected--;
+            }
+            if (expected != -1) {
+                throw new RuntimeException("List too short: " + expected);
+            }
+        }
+    }
+}
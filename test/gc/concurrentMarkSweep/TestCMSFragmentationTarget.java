@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/**
+ * @test TestCMSFragmentationTarget
+ * @summary Run defragmenting CMS sweeps with a low CMSFragmentationTarget
+ * @key gc
+ * @requires vm.gc=="ConcMarkSweep" | vm.gc=="null"
+ * @library /testlibrary
+ * @run main/othervm TestCMSFragmentationTarget
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestCMSFragmentationTarget {
+  public static void main(String args[]) throws Exception {
+
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+      "-XX:+UseConcMarkSweepGC",
+      "-XX:+ExplicitGCInvokesConcurrent",
+      "-XX:CMSFragmentationTarget=1",
+      "-XX:PrintFLSStatistics=1",
+      "-XX:MaxTenuringThreshold=0",
+      "-Xmn8m",
+      "-Xmx64m",
+      "TestCMSFragmentationTarget$Fragmenter"
+      );
+
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+
+    output.shouldContain("CMS: fragmentation at sweep");
+    // The interleaved free blocks must push at least one sweep over
+    // the 1% target and make it coalesce them.
+    output.shouldMatch("CMS: fragmentation at sweep [0-9.]+%, defragmenting");
+    output.shouldHaveExitValue(0);
+  }
+
+  static class Fragmenter {
+    public static void main(String [] args) throws Exception {
+      // Promote objects of varying small sizes and free every other
+      // one, leaving free blocks interleaved with live ones.
+      Object[] live = new Object[20_000];
+      for (int i = 0; i < live.length; i++) {
+        live[i] = new byte[16 + (i % 32) * 8];
+      }
+      System.gc();
+      Thread.sleep(1000);
+      for (int i = 0; i < live.length; i += 2) {
+        live[i] = null;
+      }
+      for (int i = 0; i < 3; i++) {
+        System.gc();
+        Thread.sleep(1000);
+      }
+    }
+  }
+}
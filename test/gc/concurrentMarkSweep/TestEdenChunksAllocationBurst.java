@@ -0,0 +1,58 @@
+/*
+* Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* This code is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License version 2 only, as
+* published by the Free Software Foundation.
+*
+* This code is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* version 2 for more details (a copy is included in the LICENSE file that
+* accompanied this code).
+*
+* You should have received a copy of the GNU General Public License version
+* 2 along with this work; if not, write to the Free Software Foundation,
+* Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+*
+* Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+* or visit www.oracle.com if you need additional information or have any
+* questions.
+*/
+
+/*
+ * @test TestEdenChunksAllocationBurst
+ * @key gc
+ * @requires vm.gc=="ConcMarkSweep" | vm.gc=="null"
+ * @summary Run parallel CMS initial mark and remark while many threads refill their TLABs at once
+ * @run main/othervm -XX:+UseConcMarkSweepGC -XX:+CMSParallelInitialMarkEnabled -XX:+CMSParallelRemarkEnabled -XX:+CMSEdenChunksRecordAlways -XX:+ExplicitGCInvokesConcurrent -XX:ParallelGCThreads=4 -Xmn64m -Xmx256m -XX:+UnlockDiagnosticVMOptions -XX:+VerifyDuringGC TestEdenChunksAllocationBurst
+ */
+
+public class TestEdenChunksAllocationBurst {
+    static volatile Object sink;
+
+    public static void main(String args[]) throws Exception {
+        Thread[] threads = new Thread[16];
+        for (int i = 0; i < threads.length; i++) {
+            threads[i] = new Thread() {
+                public void run() {
+                    long startTime = System.currentTimeMillis();
+                    while (System.currentTimeMillis() - startTime < 5_000) {
+                        sink = new Object[64];
+                    }
+                }
+            };
+        }
+        for (Thread t : threads) {
+            t.start();
+        }
+        for (int i = 0; i < 10; i++) {
+            System.gc();
+            Thread.sleep(200);
+        }
+        for (Thread t : threads) {
+            t.join();
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*
+* Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* This code is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License version 2 only, as
+* published by the Free Software Foundation.
+*
+* This code is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* version 2 for more details (a copy is included in the LICENSE file that
+* accompanied this code).
+*
+* You should have received a copy of the GNU General Public License version
+* 2 along with this work; if not, write to the Free Software Foundation,
+* Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+*
+* Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+* or visit www.oracle.com if you need additional information or have any
+* questions.
+*/
+
+/*
+ * @test TestParPromoteReserve
+ * @key gc
+ * @requires vm.gc=="ConcMarkSweep" | vm.gc=="null"
+ * @summary Run CMS promoting medium sized objects from per-worker reserved ranges
+ * @run main/othervm -XX:+UseConcMarkSweepGC -XX:+UseParNewGC -XX:ParallelGCThreads=4 -XX:CMSParPromoteReserveSize=64k -XX:MaxTenuringThreshold=0 -Xmn16m -Xmx256m -XX:+PrintOldPLAB -XX:+UnlockDiagnosticVMOptions -XX:+VerifyAfterGC TestParPromoteReserve
+ */
+
+public class TestParPromoteReserve {
+    public static void main(String args[]) throws Exception {
+        // Keep a sliding window of objects larger than the indexed free
+        // lists alive so that they get promoted by the parallel workers.
+        Object live[] = new Object[2_000];
+        long startTime = System.currentTimeMillis();
+        int i = 0;
+        while (System.currentTimeMillis() - startTime < 10_000) {
+            live[i++ % live.length] = new byte[2048 + (i % 8) * 512];
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestG1NUMASimulatedNodes
+ * @summary Check that NUMA-aware G1 allocation works with simulated nodes.
+ * @key gc
+ * @library /testlibrary
+ */
+
+import com.oracle.java.testlibrary.ProcessTools;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+public class TestG1NUMASimulatedNodes {
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder("-XX:+UseG1GC",
+                                                              "-Xmx128m",
+                                                              "-XX:+UnlockDiagnosticVMOptions",
+                                                              "-XX:G1NUMASimulatedNodes=4",
+                                                              "-XX:+PrintHeapAtGC",
+                                                              "-XX:+VerifyAfterGC",
+                                                              AllocatingThreads.class.getName());
+
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+
+    System.out.println("Output:\n" + output.getOutput());
+
+    output.shouldContain("NUMA nodes 4 (simulated)");
+    output.shouldHaveExitValue(0);
+
+    // Use the counts of the last heap printout. The eight threads are spread
+    // over the nodes, so regions must have been requested for more than one
+    // node, and some of them must have been found on the requested node.
+    Matcher line = Pattern.compile("region allocations local/remote:(.*)").matcher(output.getStdout());
+    String counts = null;
+    while (line.find()) {
+      counts = line.group(1);
+    }
+    if (counts == null) {
+      throw new RuntimeException("No per-node region allocation counts printed");
+    }
+    Matcher node = Pattern.compile(" (\\d+): (\\d+)/(\\d+)").matcher(counts);
+    int nodes = 0;
+    int nodesWithAllocations = 0;
+    long local = 0;
+    while (node.find()) {
+      long l = Long.parseLong(node.group(2));
+      long r = Long.parseLong(node.group(3));
+      nodes++;
+      if (l + r > 0) {
+        nodesWithAllocations++;
+      }
+      local += l;
+    }
+    if (nodes != 4) {
+      throw new RuntimeException("Expected counts for 4 nodes: " + counts);
+    }
+    if (nodesWithAllocations < 2) {
+      throw new RuntimeException("Regions were requested for " + nodesWithAllocations + " node(s) only: " + counts);
+    }
+    if (local == 0) {
+      throw new RuntimeException("No node-local region allocations: " + counts);
+    }
+  }
+
+  static class AllocatingThreads {
+    public static Object sink;
+
+    public static void main(String[] args) throws Exception {
+      Thread[] threads = new Thread[8];
+      for (int i = 0; i < threads.length; i++) {
+        threads[i] = new Thread() {
+          public void run() {
+            for (int j = 0; j < 200 * 1024; j++) {
+              sink = new byte[128];
+            }
+          }
+        };
+        threads[i].start();
+      }
+      for (Thread t : threads) {
+        t.join();
+      }
+      System.gc();
+    }
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Load classes from a boot class path of 300 jars through the
+ *      package index of -XX:+UseClassPathIndex, and compare the startup
+ *      time with the linear search.
+ * @library /testlibrary
+ * @build ClassPathIndexHello ClassPathIndexHelper
+ * @run main ClassPathIndexStartup
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.io.File;
+import java.io.FileOutputStream;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.jar.JarEntry;
+import java.util.jar.JarOutputStream;
+import java.util.zip.CRC32;
+
+public class ClassPathIndexStartup {
+  static final int JARS = 300;
+  static final int RUNS = 5;
+
+  static byte[] classBytes(String name) throws Exception {
+    return Files.readAllBytes(Paths.get(System.getProperty("test.classes"), name + ".class"));
+  }
+
+  static void addEntry(JarOutputStream out, String name, byte[] bytes, boolean stored) throws Exception {
+    JarEntry entry = new JarEntry(name);
+    if (stored) {
+      CRC32 crc = new CRC32();
+      crc.update(bytes);
+      entry.setMethod(JarEntry.STORED);
+      entry.setSize(bytes.length);
+      entry.setCompressedSize(bytes.length);
+      entry.setCrc(crc.getValue());
+    }
+    out.putNextEntry(entry);
+    out.write(bytes);
+    out.closeEntry();
+  }
+
+  static OutputAnalyzer run(String bootClassPath, String... flags) throws Exception {
+    String[] args = new String[flags.length + 2];
+    args[0] = "-Xbootclasspath/a:" + bootClassPath;
+    System.arraycopy(flags, 0, args, 1, flags.length);
+    args[args.length - 1] = "ClassPathIndexHello";
+    OutputAnalyzer output = new OutputAnalyzer(ProcessTools.createJavaProcessBuilder(args).start());
+    output.shouldContain("Hello from ClassPathIndexHello");
+    output.shouldHaveExitValue(0);
+    return output;
+  }
+
+  static long averageStartup(String bootClassPath, String flag) throws Exception {
+    long total = 0;
+    for (int i = 0; i < RUNS; i++) {
+      long start = System.nanoTime();
+      run(bootClassPath, flag);
+      total += System.nanoTime() - start;
+    }
+    return total / RUNS / 1000000;
+  }
+
+  public static void main(String[] args) throws Exception {
+    byte[] hello = classBytes("ClassPathIndexHello");
+    byte[] helper = classBytes("ClassPathIndexHelper");
+
+    // Every jar has a package of its own. The helper is stored in jar 100,
+    // the main class is deflated in jar 200 and shadows a copy in the last jar.
+    StringBuilder bootClassPath = new StringBuilder();
+    for (int i = 0; i < JARS; i++) {
+      String jar = "cpi" + i + ".jar";
+      try (JarOutputStream out = new JarOutputStream(new FileOutputStream(jar))) {
+        addEntry(out, "pkg" + i + "/Filler" + i + ".class", helper, i % 2 == 0);
+        if (i == 100) {
+          addEntry(out, "ClassPathIndexHelper.class", helper, true);
+        }
+        if (i == 200 || i == JARS - 1) {
+          addEntry(out, "ClassPathIndexHello.class", hello, false);
+        }
+      }
+      if (i > 0) {
+        bootClassPath.append(File.pathSeparator);
+      }
+      bootClassPath.append(jar);
+    }
+    String path = bootClassPath.toString();
+
+    OutputAnalyzer output = run(path, "-XX:+UseClassPathIndex", "-XX:+TraceClassLoading",
+                                "-XX:+TraceClassPaths");
+    output.shouldContain("[Indexed cpi0.jar: 1 packages]");
+    output.shouldContain("[Indexed cpi200.jar: 2 packages]");
+    output.shouldMatch("Loaded ClassPathIndexHelper from .*cpi100\\.jar");
+    output.shouldMatch("Loaded ClassPathIndexHello from .*cpi200\\.jar");
+
+    // The same classes are found without the index.
+    output = run(path, "-XX:+TraceClassLoading");
+    output.shouldMatch("Loaded ClassPathIndexHelper from .*cpi100\\.jar");
+    output.shouldMatch("Loaded ClassPathIndexHello from .*cpi200\\.jar");
+
+    // A directory ahead of the jars is still searched first.
+    File dir = new File("cpidir");
+    dir.mkdir();
+    Files.write(Paths.get("cpidir", "ClassPathIndexHello.class"), hello);
+    output = run("cpidir" + File.pathSeparator + path, "-XX:+UseClassPathIndex",
+                 "-XX:+TraceClassLoading");
+    output.shouldMatch("Loaded ClassPathIndexHello from .*cpidir");
+
+    // Startup benchmark; the times are reported, not checked.
+    long linear = averageStartup(path, "-XX:-UseClassPathIndex");
+    long indexed = averageStartup(path, "-XX:+UseClassPathIndex");
+    System.out.println("Startup with " + JARS + " boot class path jars: linear search " +
+                       linear + " ms, package index " + indexed + " ms (average of " +
+                       RUNS + " runs)");
+  }
+}
+
+class ClassPathIndexHello {
+  public static void main(String[] args) {
+    System.out.println("Hello from " + new ClassPathIndexHelper().name());
+  }
+}
+
+class ClassPathIndexHelper {
+  String name() {
+    return "ClassPathIndexHello";
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Resolve already loaded classes from many threads at once and
+ *      check that every thread sees the same class. The lookups take
+ *      the lock-free path in the SystemDictionary.
+ * @run main/othervm ConcurrentForName
+ */
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.atomic.AtomicReference;
+
+public class ConcurrentForName {
+    static final String[] NAMES = {
+        "java.util.ArrayList", "java.util.HashMap", "java.util.concurrent.ConcurrentHashMap",
+        "java.lang.StringBuilder", "java.io.File", "ConcurrentForName",
+        "ConcurrentForName$Resolver", "java.util.concurrent.CountDownLatch",
+    };
+    static final int THREADS = 32;
+    static final int ROUNDS = 2000;
+
+    static class Resolver extends Thread {
+        final CountDownLatch start;
+        final Class<?>[] expected;
+        final AtomicReference<Throwable> failure;
+
+        Resolver(CountDownLatch start, Class<?>[] expected, AtomicReference<Throwable> failure) {
+            this.start = start;
+            this.expected = expected;
+            this.failure = failure;
+        }
+
+        public void run() {
+            try {
+                start.await();
+                ClassLoader loader = ConcurrentForName.class.getClassLoader();
+                for (int round = 0; round < ROUNDS; round++) {
+                    for (int i = 0; i < NAMES.length; i++) {
+                        Class<?> c = Class.forName(NAMES[i], false, loader);
+                        if (c != expected[i]) {
+                            throw new RuntimeException("Resolved a different " + NAMES[i]);
+                        }
+                    }
+                }
+            } catch (Throwable t) {
+                failure.compareAndSet(null, t);
+            }
+        }
+    }
+
+    public static void main(String[] args) throws Throwable {
+        Class<?>[] expected = new Class<?>[NAMES.length];
+        for (int i = 0; i < NAMES.length; i++) {
+            expected[i] = Class.forName(NAMES[i]);
+        }
+
+        CountDownLatch start = new CountDownLatch(1);
+        AtomicReference<Throwable> failure = new AtomicReference<>();
+        Thread[] threads = new Thread[THREADS];
+        for (int t = 0; t < THREADS; t++) {
+            threads[t] = new Resolver(start, expected, failure);
+            threads[t].start();
+        }
+        start.countDown();
+        for (Thread t : threads) {
+            t.join();
+        }
+        if (failure.get() != null) {
+            throw failure.get();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Perform the safepoint cleanup tasks on the GC worker threads
+ *      and report their times with -XX:+PrintSafepointStatistics.
+ *
+ * @library /testlibrary
+ * @run main/othervm TestParallelSafepointCleanup
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestParallelSafepointCleanup {
+    static void test(boolean parallel, String workers) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UseG1GC",
+            "-XX:ParallelGCThreads=4",
+            "-XX:" + (parallel ? "+" : "-") + "ParallelSafepointCleanup",
+            "-XX:+PrintSafepointStatistics",
+            "-XX:PrintSafepointStatisticsCount=1",
+            "-XX:+TraceSafepointCleanupTime",
+            "TestParallelSafepointCleanup$Collector");
+
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("[cleanup us: monitors");
+        output.shouldContain("deflating idle monitors");
+        output.shouldMatch("\\s" + workers + "\\]");
+        output.shouldHaveExitValue(0);
+    }
+
+    public static void main(String[] args) throws Exception {
+        test(true, "4");
+        test(false, "1");
+    }
+
+    static class Collector {
+        public static void main(String[] args) {
+            for (int i = 0; i < 3; i++) {
+                System.gc();
+            }
+        }
+    }
+}
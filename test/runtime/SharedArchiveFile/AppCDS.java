@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Archive a class of the app class path with -XX:+UseAppCDS and
+ *      load it from the archive with the system class loader.
+ * @library /testlibrary
+ * @build AppCDSHello
+ * @run main AppCDS
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.io.File;
+import java.io.PrintWriter;
+
+public class AppCDS {
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb = new ProcessBuilder(JDKToolFinder.getJDKTool("jar"),
+        "cf", "hello.jar", "-C", System.getProperty("test.classes"), "AppCDSHello.class");
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+    output.shouldHaveExitValue(0);
+
+    try (PrintWriter classlist = new PrintWriter("hello.classlist")) {
+      classlist.println("AppCDSHello");
+    }
+
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseAppCDS", "-XX:SharedArchiveFile=./appcds.jsa",
+        "-XX:ExtraSharedClassListFile=hello.classlist",
+        "-cp", "hello.jar", "-Xshare:dump");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("Loading classes to share");
+    output.shouldHaveExitValue(0);
+
+    // The archived class is used by the system class loader.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseAppCDS", "-XX:SharedArchiveFile=./appcds.jsa", "-Xshare:on",
+        "-XX:+TraceClassLoading", "-cp", "hello.jar", "AppCDSHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("[Loaded AppCDSHello from shared objects file by");
+    output.shouldContain("Hello from AppCDSHello");
+    output.shouldHaveExitValue(0);
+
+    // Without -XX:+UseAppCDS the class is read from the jar.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:SharedArchiveFile=./appcds.jsa", "-Xshare:on",
+        "-XX:+TraceClassLoading", "-cp", "hello.jar", "AppCDSHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldNotContain("[Loaded AppCDSHello from shared objects file");
+    output.shouldContain("Hello from AppCDSHello");
+    output.shouldHaveExitValue(0);
+
+    // The dump time app class path must be a prefix of the run time one.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseAppCDS", "-XX:SharedArchiveFile=./appcds.jsa", "-Xshare:on",
+        "-XX:+TraceClassPaths", "-cp", "other.jar" + File.pathSeparator + "hello.jar", "AppCDSHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("APP classpath mismatch");
+    output.shouldHaveExitValue(1);
+  }
+}
+
+class AppCDSHello {
+  public static void main(String[] args) {
+    System.out.println("Hello from AppCDSHello");
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Dump a CDS archive with the classes of a run at exit, and load
+ *      them from it in a later run.
+ * @library /testlibrary
+ * @build ArchiveAtExitHello
+ * @run main ArchiveClassesAtExit
+ */
+
+import com.oracle.java.testlibrary.*;
+import java.io.File;
+
+public class ArchiveClassesAtExit {
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb = new ProcessBuilder(JDKToolFinder.getJDKTool("jar"),
+        "cf", "atexit.jar", "-C", System.getProperty("test.classes"), "ArchiveAtExitHello.class");
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+    output.shouldHaveExitValue(0);
+
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UseAppCDS", "-XX:ArchiveClassesAtExit=./atexit.jsa",
+        "-XX:+PrintSharedSpaces", "-cp", "atexit.jar", "ArchiveAtExitHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("Hello from ArchiveAtExitHello");
+    output.shouldContain("Dumped the CDS archive ./atexit.jsa with the");
+    output.shouldHaveExitValue(0);
+    if (new File("atexit.jsa.classlist").exists() || new File("atexit.jsa.log").exists()) {
+      throw new RuntimeException("The class list and the dump log are left behind");
+    }
+
+    // The boot and the app classes of the run are archived.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseAppCDS", "-XX:SharedArchiveFile=./atexit.jsa", "-Xshare:on",
+        "-XX:+TraceClassLoading", "-cp", "atexit.jar", "ArchiveAtExitHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("[Loaded java.util.concurrent.Phaser from shared objects file]");
+    output.shouldContain("[Loaded ArchiveAtExitHello from shared objects file by");
+    output.shouldContain("Hello from ArchiveAtExitHello");
+    output.shouldHaveExitValue(0);
+
+    // The archive is checked against the app class path of the run.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseAppCDS", "-XX:SharedArchiveFile=./atexit.jsa", "-Xshare:on",
+        "-XX:+TraceClassPaths", "-cp", "other.jar" + File.pathSeparator + "atexit.jar",
+        "ArchiveAtExitHello");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("APP classpath mismatch");
+    output.shouldHaveExitValue(1);
+  }
+}
+
+class ArchiveAtExitHello {
+  public static void main(String[] args) {
+    // Boot classes that are not in the default class list.
+    new java.util.concurrent.Phaser(1).arriveAndDeregister();
+    new java.util.concurrent.Exchanger<String>();
+    System.out.println("Hello from ArchiveAtExitHello");
+  }
+}
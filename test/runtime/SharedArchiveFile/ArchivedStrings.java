@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Archive the interned strings of the shared classes with G1 and
+ *      use them from a mapped heap region across young and full GCs.
+ * @library /testlibrary
+ * @run main ArchivedStrings
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class ArchivedStrings {
+  public static void main(String[] args) throws Exception {
+    ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseG1GC", "-XX:+UseCompressedOops", "-XX:+UseCompressedClassPointers",
+        "-XX:SharedArchiveFile=./strings.jsa", "-Xshare:dump");
+    OutputAnalyzer output = new OutputAnalyzer(pb.start());
+    output.shouldContain("st space:");
+    output.shouldHaveExitValue(0);
+
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseG1GC", "-XX:+UseCompressedOops", "-XX:+UseCompressedClassPointers",
+        "-XX:SharedArchiveFile=./strings.jsa", "-Xshare:on", "-XX:+PrintSharedSpaces",
+        "-XX:+VerifyBeforeGC", "-XX:+VerifyAfterGC",
+        "ArchivedStrings$Check");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("Shared strings mapped at");
+    output.shouldContain("Archived strings OK");
+    output.shouldHaveExitValue(0);
+
+    // Full GCs must leave the mark words of archived strings alone.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseG1GC", "-XX:+UseCompressedOops", "-XX:+UseCompressedClassPointers",
+        "-XX:SharedArchiveFile=./strings.jsa", "-Xshare:on", "-XX:+PrintSharedSpaces",
+        "-XX:+VerifyBeforeGC", "-XX:+VerifyAfterGC",
+        "ArchivedStrings$HashAndLock");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("Shared strings mapped at");
+    output.shouldContain("Hashed and locked archived string OK");
+    output.shouldHaveExitValue(0);
+
+    // Other collectors share the classes but not the strings.
+    pb = ProcessTools.createJavaProcessBuilder(
+        "-XX:+UnlockDiagnosticVMOptions",
+        "-XX:+UseParallelGC", "-XX:+UseCompressedOops", "-XX:+UseCompressedClassPointers",
+        "-XX:SharedArchiveFile=./strings.jsa", "-Xshare:on", "-XX:+PrintSharedSpaces",
+        "ArchivedStrings$Check");
+    output = new OutputAnalyzer(pb.start());
+    output.shouldContain("Shared strings are not used");
+    output.shouldContain("Archived strings OK");
+    output.shouldHaveExitValue(0);
+  }
+
+  static class Check {
+    public static void main(String[] args) {
+      // Literals of shared classes and of this class resolve to the same
+      // interned instances, before and after the heap is collected.
+      String s = new StringBuilder("java.").append("lang.Object").toString();
+      String interned = s.intern();
+      for (int i = 0; i < 3; i++) {
+        System.gc();
+        if (interned != "java.lang.Object" || s.intern() != interned ||
+            !Object.class.getName().equals(interned)) {
+          throw new RuntimeException("Interned string identity lost");
+        }
+      }
+      System.out.println("Archived strings OK");
+    }
+  }
+
+  static class HashAndLock {
+    static Object holder;
+
+    public static void main(String[] args) throws Exception {
+      // An archived string with an identity hash and an inflated monitor
+      // in its mark word.
+      final String archived = "java.lang.Object";
+      holder = archived;
+      int hash = System.identityHashCode(archived);
+      synchronized (archived) {
+        archived.wait(1);
+        System.gc();
+        if (System.identityHashCode(archived) != hash) {
+          throw new RuntimeException("Identity hash lost while locked");
+        }
+      }
+      for (int i = 0; i < 3; i++) {
+        System.gc();
+        if (holder != archived || System.identityHashCode(archived) != hash ||
+            archived.intern() != archived) {
+          throw new RuntimeException("Archived string damaged by full GC");
+        }
+      }
+      System.out.println("Hashed and locked archived string OK");
+    }
+  }
+}
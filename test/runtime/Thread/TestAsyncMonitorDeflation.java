@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Deflate idle monitors in the ServiceThread and check that the
+ *      identity hash codes and locking of the objects survive it.
+ *
+ * @library /testlibrary
+ * @run main/othervm TestAsyncMonitorDeflation
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestAsyncMonitorDeflation {
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+AsyncDeflateIdleMonitors",
+            "-XX:AsyncDeflationInterval=10",
+            "-XX:+TraceMonitorInflation",
+            "TestAsyncMonitorDeflation$Deflatee");
+
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("Deflating object");
+        output.shouldMatch("Async deflation: deflated [1-9][0-9]* of");
+        output.shouldHaveExitValue(0);
+    }
+
+    static class Deflatee {
+        static final int COUNT = 1000;
+        static final Object[] locks = new Object[COUNT];
+        static final int[] hashes = new int[COUNT];
+        static final int[] counters = new int[COUNT];
+
+        static void lockAll() {
+            for (int i = 0; i < COUNT; i++) {
+                synchronized (locks[i]) {
+                    counters[i]++;
+                }
+            }
+        }
+
+        public static void main(String[] args) throws Exception {
+            for (int i = 0; i < COUNT; i++) {
+                locks[i] = new Object();
+                synchronized (locks[i]) {
+                    // Waiting inflates the monitor.
+                    locks[i].wait(1);
+                }
+                hashes[i] = System.identityHashCode(locks[i]);
+            }
+
+            for (int round = 0; round < 10; round++) {
+                // Give the ServiceThread time to deflate the idle monitors
+                // and then contend on them again.
+                Thread.sleep(50);
+                Thread[] threads = new Thread[4];
+                for (int t = 0; t < threads.length; t++) {
+                    threads[t] = new Thread() {
+                        public void run() {
+                            lockAll();
+                        }
+                    };
+                    threads[t].start();
+                }
+                for (Thread t : threads) {
+                    t.join();
+                }
+                for (int i = 0; i < COUNT; i++) {
+                    if (System.identityHashCode(locks[i]) != hashes[i]) {
+                        throw new RuntimeException("Identity hash code of object " + i + " changed");
+                    }
+                }
+            }
+            for (int i = 0; i < COUNT; i++) {
+                synchronized (locks[i]) {
+                    if (counters[i] != 10 * 4) {
+                        throw new RuntimeException("Lost updates under monitor " + i + ": " + counters[i]);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Revoke the bias of an object biased toward a blocked thread
+ *      with a thread-local handshake instead of a safepoint.
+ *
+ * @library /testlibrary
+ * @run main/othervm TestBiasRevocationHandshake
+ */
+
+import java.util.concurrent.CountDownLatch;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestBiasRevocationHandshake {
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UseBiasedLocking",
+            "-XX:BiasedLockingStartupDelay=0",
+            "-XX:+ThreadLocalHandshakes",
+            "-XX:+TraceBiasedLocking",
+            "TestBiasRevocationHandshake$Revoker");
+
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("Revoking bias with thread-local handshake");
+        output.shouldHaveExitValue(0);
+    }
+
+    static class Revoker {
+        static final Object lock = new Object();
+
+        public static void main(String[] args) throws Exception {
+            final CountDownLatch biased = new CountDownLatch(1);
+            final CountDownLatch done = new CountDownLatch(1);
+            Thread owner = new Thread() {
+                public void run() {
+                    synchronized (lock) {
+                        // Bias the lock toward this thread
+                    }
+                    biased.countDown();
+                    try {
+                        // Stay alive and blocked while the bias is revoked
+                        done.await();
+                    } catch (InterruptedException e) {
+                        throw new RuntimeException(e);
+                    }
+                }
+            };
+            owner.start();
+            biased.await();
+            // Computing the identity hash code revokes the bias
+            System.identityHashCode(lock);
+            done.countDown();
+            owner.join();
+        }
+    }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/*
+ * @test
+ * @summary Lock objects with -XX:+UseLightweightLocking in the interpreter
+ *      and in compiled code, covering recursion, nesting deeper than the
+ *      lock stack, contention, wait/notify, hash codes and holdsLock.
+ *
+ * @library /testlibrary
+ * @run main/othervm TestLightweightLocking
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestLightweightLocking {
+    public static void main(String[] args) throws Exception {
+        String[][] modes = {
+            { "-Xint" },
+            { "-Xcomp", "-XX:TieredStopAtLevel=1" },
+            { "-Xcomp", "-XX:-TieredCompilation" },
+            { "-Xmixed" },
+        };
+        for (String[] mode : modes) {
+            for (String flag : new String[] { "-XX:+UseLightweightLocking",
+                                              "-XX:-UseLightweightLocking" }) {
+                String[] vmArgs = new String[mode.length + 2];
+                System.arraycopy(mode, 0, vmArgs, 0, mode.length);
+                vmArgs[mode.length] = flag;
+                vmArgs[mode.length + 1] = "TestLightweightLocking$Locker";
+                ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(vmArgs);
+                OutputAnalyzer output = new OutputAnalyzer(pb.start());
+                System.out.println(output.getStdout());
+                output.shouldContain("Uncontended locking took");
+                output.shouldHaveExitValue(0);
+            }
+        }
+    }
+
+    static class Locker {
+        static final int THREADS = 4;
+        static final int ITERATIONS = 100000;
+        static int counter;
+
+        static void check(boolean condition, String message) {
+            if (!condition) {
+                throw new RuntimeException(message);
+            }
+        }
+
+        static synchronized void syncMethod(Object o) {
+            synchronized (o) {
+                check(Thread.holdsLock(o), "must hold the lock on o");
+                check(Thread.holdsLock(Locker.class), "must hold the class lock");
+            }
+        }
+
+        static void recurse(Object o, int depth) {
+            synchronized (o) {
+                if (depth > 0) {
+                    recurse(o, depth - 1);
+                }
+                check(Thread.holdsLock(o), "must hold a recursive lock");
+            }
+        }
+
+        static void nest(Object[] locks, int i) {
+            if (i == locks.length) {
+                for (Object o : locks) {
+                    check(Thread.holdsLock(o), "must hold all nested locks");
+                }
+                return;
+            }
+            synchronized (locks[i]) {
+                nest(locks, i + 1);
+            }
+        }
+
+        public static void main(String[] args) throws Exception {
+            final Object lock = new Object();
+
+            // Uncontended locking, also timed to compare the locking modes.
+            long start = System.nanoTime();
+            for (int i = 0; i < ITERATIONS; i++) {
+                synchronized (lock) {
+                    counter++;
+                }
+            }
+            long elapsed = System.nanoTime() - start;
+            System.out.println("Uncontended locking took " + elapsed / ITERATIONS + " ns per lock");
+            check(!Thread.holdsLock(lock), "must not hold the lock");
+
+            // Hash codes survive locking and inflation.
+            int hash = System.identityHashCode(lock);
+            synchronized (lock) {
+                check(System.identityHashCode(lock) == hash, "hash changed while locked");
+                recurse(lock, 3);
+            }
+            check(System.identityHashCode(lock) == hash, "hash changed after inflation");
+
+            // Recursion and nesting deeper than the lock stack.
+            for (int i = 0; i < 1000; i++) {
+                syncMethod(new Object());
+                recurse(new Object(), 5);
+                Object[] locks = new Object[20];
+                for (int j = 0; j < locks.length; j++) {
+                    locks[j] = new Object();
+                }
+                nest(locks, 0);
+            }
+
+            // Contention.
+            counter = 0;
+            Thread[] threads = new Thread[THREADS];
+            for (int t = 0; t < THREADS; t++) {
+                threads[t] = new Thread() {
+                    public void run() {
+                        for (int i = 0; i < ITERATIONS; i++) {
+                            synchronized (lock) {
+                                counter++;
+                            }
+                        }
+                    }
+                };
+                threads[t].start();
+            }
+            for (Thread t : threads) {
+                t.join();
+            }
+            check(counter == THREADS * ITERATIONS, "lost updates: " + counter);
+
+            // Wait and notify.
+            final Object monitor = new Object();
+            final boolean[] ready = new boolean[1];
+            Thread waiter = new Thread() {
+                public void run() {
+                    synchronized (monitor) {
+                        while (!ready[0]) {
+                            try {
+                                monitor.wait();
+                            } catch (InterruptedException e) {
+                                throw new RuntimeException(e);
+                            }
+                        }
+                    }
+                }
+            };
+            waiter.start();
+            synchronized (monitor) {
+                monitor.notify();       // nobody may be waiting yet
+                ready[0] = true;
+                monitor.notifyAll();
+            }
+            waiter.join();
+
+            try {
+                monitor.notify();
+                throw new RuntimeException("notify without the lock must throw");
+            } catch (IllegalMonitorStateException e) {
+                // expected
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/*
+ * @test
+ * @summary Check that contended monitor enters are tallied in the
+ *      spin, park and hold time performance counters.
+ *
+ * @library /testlibrary
+ * @run main/othervm -Xint -XX:+UsePerfData TestMonitorContentionCounters
+ */
+
+import java.util.concurrent.CountDownLatch;
+
+import com.oracle.java.testlibrary.*;
+import static com.oracle.java.testlibrary.Asserts.*;
+
+public class TestMonitorContentionCounters {
+    static final Object lock = new Object();
+
+    static long counter(String name) throws Exception {
+        return PerfCounters.findByName("sun.rt." + name).longValue();
+    }
+
+    public static void main(String[] args) throws Exception {
+        long notRunning = counter("_sync_SpinsOwnerNotRunning");
+        long parks = counter("_sync_ContendedParks");
+        long holds = counter("_sync_ContendedHolds");
+        long holdTicks = counter("_sync_ContendedHoldTicks");
+
+        for (int i = 0; i < 10; i++) {
+            final CountDownLatch locked = new CountDownLatch(1);
+            Thread owner = new Thread() {
+                public void run() {
+                    synchronized (lock) {
+                        try {
+                            // Waiting inflates the monitor and makes this
+                            // thread its owner on return.
+                            lock.wait(1);
+                            locked.countDown();
+                            // Sleep while holding the monitor so that the
+                            // contender sees a blocked owner and parks.
+                            Thread.sleep(100);
+                        } catch (InterruptedException e) {
+                            throw new RuntimeException(e);
+                        }
+                    }
+                }
+            };
+            owner.start();
+            locked.await();
+            synchronized (lock) {
+                // Hold the contended monitor for a while
+                Thread.sleep(10);
+            }
+            owner.join();
+        }
+
+        assertGT(counter("_sync_SpinsOwnerNotRunning"), notRunning,
+                 "Spinning on a blocked owner was not abandoned");
+        assertGT(counter("_sync_ContendedParks"), parks,
+                 "Contended enters did not park");
+        assertGT(counter("_sync_ContendedHolds"), holds,
+                 "Contended holds were not counted");
+        assertGT(counter("_sync_ContendedHoldTicks"), holdTicks,
+                 "Contended hold time was not accumulated");
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test StringTableResize
+ * @summary Grow a small StringTable concurrently while other threads
+ *      keep interning and looking up strings.
+ * @library /testlibrary
+ * @run main/othervm StringTableResize
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class StringTableResize {
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:StringTableSize=1009",
+            "-XX:TableResizeLoadFactor=2",
+            "-XX:+TraceTableResizing",
+            "StringTableResize$Interner");
+
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("StringTable resized from 1009 to 2018 buckets");
+        output.shouldHaveExitValue(0);
+    }
+
+    static class Interner {
+        static final int THREADS = 4;
+        static final int STRINGS = 50000;
+        static volatile String lost;
+
+        public static void main(String[] args) throws Exception {
+            Thread[] threads = new Thread[THREADS];
+            for (int t = 0; t < THREADS; t++) {
+                final int id = t;
+                threads[t] = new Thread() {
+                    public void run() {
+                        String[] interned = new String[STRINGS];
+                        for (int i = 0; i < STRINGS; i++) {
+                            interned[i] = ("s" + id + "_" + i).intern();
+                        }
+                        // Every lookup must find the same string while the
+                        // table is being resized.
+                        for (int round = 0; round < 5; round++) {
+                            for (int i = 0; i < STRINGS; i++) {
+                                String s = new String("s" + id + "_" + i);
+                                if (s.intern() != interned[i]) {
+                                    lost = s;
+                                }
+                            }
+                        }
+                    }
+                };
+                threads[t].start();
+            }
+            for (Thread t : threads) {
+                t.join();
+            }
+            if (lost != null) {
+                throw new RuntimeException("Lost interned string " + lost);
+            }
+        }
+    }
+}
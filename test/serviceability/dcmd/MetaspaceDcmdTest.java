@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Test of VM.metaspace diagnostic command via MBean, and that the
+ *      Metaspace freed by class unloading is uncommitted
+ * @library /testlibrary
+ * @compile DcmdUtil.java
+ * @run main/othervm MetaspaceDcmdTest true
+ * @run main/othervm -XX:-MetaspaceUncommitFreeChunks MetaspaceDcmdTest false
+ */
+
+import java.io.File;
+import java.nio.file.Files;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+public class MetaspaceDcmdTest {
+    static final int LOADERS = 2000;
+    static final String PAYLOAD = "MetaspaceDcmdTest$Payload";
+
+    public static class Payload implements Runnable {
+        static final String[] NAMES = { "alpha", "beta", "gamma", "delta", "epsilon" };
+        int count;
+
+        public void run() {
+            for (String s : NAMES) {
+                count += s.length() + first(s) + last(s);
+            }
+        }
+
+        int first(String s) { return s.charAt(0); }
+        int last(String s)  { return s.charAt(s.length() - 1); }
+    }
+
+    static class PayloadLoader extends ClassLoader {
+        final byte[] bytes;
+
+        PayloadLoader(byte[] bytes) {
+            this.bytes = bytes;
+        }
+
+        protected Class<?> loadClass(String name, boolean resolve) throws ClassNotFoundException {
+            if (!PAYLOAD.equals(name)) {
+                return super.loadClass(name, resolve);
+            }
+            Class<?> c = findLoadedClass(name);
+            if (c == null) {
+                c = defineClass(name, bytes, 0, bytes.length);
+            }
+            return c;
+        }
+    }
+
+    static long uncommittedKB(String report) throws Exception {
+        Matcher m = Pattern.compile("Non-class space:.*?uncommitted (\\d+)K", Pattern.DOTALL).matcher(report);
+        if (!m.find()) {
+            throw new Exception("No uncommitted memory reported: " + report);
+        }
+        return Long.parseLong(m.group(1));
+    }
+
+    public static void main(String[] args) throws Exception {
+        boolean uncommit = Boolean.parseBoolean(args[0]);
+        byte[] bytes = Files.readAllBytes(new File(System.getProperty("test.classes", "."),
+                                                   PAYLOAD + ".class").toPath());
+
+        // Fill some Metaspace with classes of loaders that then die.
+        for (int i = 0; i < LOADERS; i++) {
+            Class<?> c = new PayloadLoader(bytes).loadClass(PAYLOAD);
+            ((Runnable)c.newInstance()).run();
+        }
+        System.gc();
+        System.gc();
+
+        String result = DcmdUtil.executeDcmd("VM.metaspace");
+        if (result == null || !result.contains("Non-class space:")) {
+            throw new Exception("Unexpected output: " + result);
+        }
+        for (String s : new String[] { "committed", "used", "free chunks:", "specialized",
+                                       "humongous", "fragmentation" }) {
+            if (!result.contains(s)) {
+                throw new Exception("Missing \"" + s + "\": " + result);
+            }
+        }
+
+        long uncommitted = uncommittedKB(result);
+        if (uncommit && uncommitted == 0) {
+            throw new Exception("The free chunks of the unloaded classes were not uncommitted: " + result);
+        }
+        if (!uncommit && uncommitted != 0) {
+            throw new Exception("Memory was uncommitted with -XX:-MetaspaceUncommitFreeChunks: " + result);
+        }
+    }
+}
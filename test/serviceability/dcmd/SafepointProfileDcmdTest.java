@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+/*
+ * @test
+ * @summary Test of VM.safepoint_profile diagnostic command via MBean
+ * @library /testlibrary
+ * @compile DcmdUtil.java
+ * @run main/othervm -XX:+ProfileTimeToSafepoint SafepointProfileDcmdTest
+ */
+
+public class SafepointProfileDcmdTest {
+    static volatile boolean done;
+    static volatile long sink;
+
+    public static void main(String[] args) throws Exception {
+        // Keep a thread running so that the safepoints have to wait for it.
+        Thread spinner = new Thread() {
+            public void run() {
+                long sum = 0;
+                while (!done) {
+                    for (int i = 0; i < 100000; i++) {
+                        sum += i ^ sum;
+                    }
+                    sink = sum;
+                }
+            }
+        };
+        spinner.setName("SafepointProfileSpinner");
+        spinner.start();
+        for (int i = 0; i < 5; i++) {
+            System.gc();
+        }
+        done = true;
+        spinner.join();
+
+        String result = DcmdUtil.executeDcmd("VM.safepoint_profile", "128");
+        if (result == null || !result.contains("Time to safepoint profile:")) {
+            throw new Exception("Unexpected output: " + result);
+        }
+        if (!result.contains("ms to safepoint")) {
+            throw new Exception("No safepoint records printed: " + result);
+        }
+        if (!result.contains("\"SafepointProfileSpinner\"")) {
+            throw new Exception("The running thread was not among the last arrivals: " + result);
+        }
+    }
+}
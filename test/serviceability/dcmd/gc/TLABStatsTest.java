@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+import com.oracle.java.testlibrary.JDKToolFinder;
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.ProcessTools;
+
+/*
+ * @test
+ * @summary Test of diagnostic command GC.tlab_stats with TLABs that are
+ *      resized on refill and a medium-object buffer
+ * @library /testlibrary
+ * @run main/othervm -XX:+UseTLAB -XX:+ResizeTLAB -XX:+ResizeTLABOnRefill -XX:+UseMediumTLAB TLABStatsTest
+ */
+public class TLABStatsTest {
+    static volatile Object sink;
+
+    public static void main(String[] args) throws Exception {
+        Thread allocator = new Thread() {
+            public void run() {
+                // Mix small objects with arrays large enough to miss
+                // a TLAB that is still too full to be discarded.
+                for (int i = 0; i < 200000; i++) {
+                    sink = new Object();
+                    if (i % 16 == 0) {
+                        sink = new byte[1024 + (i % 4096)];
+                    }
+                }
+            }
+        };
+        allocator.setName("TLABStatsAllocator");
+        allocator.start();
+        allocator.join();
+
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        ProcessBuilder pb = new ProcessBuilder();
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "GC.tlab_stats"});
+        OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldContain("\"main\"");
+        output.shouldMatch("tlab: desired_size: [0-9]+KB refills: [0-9]+");
+        output.shouldContain("medium: desired_size:");
+        output.shouldHaveExitValue(0);
+    }
+}